@@ -0,0 +1,184 @@
+#ifndef APP_INCLUDE_APP_BACKTEST_PARAMETER_SWEEP_H_
+#define APP_INCLUDE_APP_BACKTEST_PARAMETER_SWEEP_H_
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "app/event_handler_base.h"
+#include "boost/asio/post.hpp"
+#include "boost/asio/thread_pool.hpp"
+namespace ccapi {
+/**
+ * Runs many backtests over the same historical market data with different parameters in one process. The market data are read and decoded only once, in
+ * batches of batchSize events, and every batch is handed to all event handlers in parallel on a thread pool before the next one is decoded. An event handler
+ * is only used by one thread at a time and sees the events in their original order, so each run produces the same results as a separate backtest would.
+ */
+class BacktestParameterSweep {
+ public:
+  // Each event handler must have been initialized by its GET_INSTRUMENT response with replayHistoricalMarketData set to false. They all share the historical
+  // market data settings of the first one.
+  BacktestParameterSweep(const std::vector<EventHandlerBase*>& eventHandlerList, size_t numThreads, size_t batchSize)
+      : eventHandlerList(eventHandlerList), threadPool(numThreads), batchSize(batchSize) {
+    this->eventBatch.reserve(batchSize);
+  }
+  void run() {
+    if (this->eventHandlerList.empty()) {
+      return;
+    }
+    HistoricalMarketDataEventProcessor historicalMarketDataEventProcessor([that = this](const Event& event) -> bool {
+      that->eventBatch.push_back(event);
+      if (that->eventBatch.size() >= that->batchSize) {
+        that->processEventBatch();
+      }
+      return true;
+    });
+    this->eventHandlerList.front()->initHistoricalMarketDataEventProcessor(historicalMarketDataEventProcessor);
+    historicalMarketDataEventProcessor.processEvent();
+    this->processEventBatch();
+    this->forEachEventHandler([](EventHandlerBase* eventHandler) { eventHandler->finishBacktest(); });
+    this->threadPool.join();
+  }
+  // The first line names the parameters, e.g. "SPREAD_PROPORTION_MINIMUM,ORDER_QUANTITY_PROPORTION", and every further non-empty line holds the values of one
+  // run.
+  static std::vector<std::map<std::string, std::string> > readParameterFile(const std::string& filePath) {
+    std::ifstream ifs(filePath);
+    if (!ifs) {
+      throw std::runtime_error("cannot open " + filePath);
+    }
+    std::string line;
+    std::getline(ifs, line);
+    auto nameList = UtilString::split(UtilString::rtrim(line, "\r"), ',');
+    std::vector<std::map<std::string, std::string> > parameterList;
+    while (std::getline(ifs, line)) {
+      line = UtilString::rtrim(line, "\r");
+      if (line.empty()) {
+        continue;
+      }
+      auto valueList = UtilString::split(line, ',');
+      if (valueList.size() != nameList.size()) {
+        throw std::runtime_error("line " + line + " in " + filePath + " doesn't have " + std::to_string(nameList.size()) + " values");
+      }
+      std::map<std::string, std::string> parameter;
+      for (size_t i = 0; i < nameList.size(); ++i) {
+        parameter.emplace(nameList.at(i), valueList.at(i));
+      }
+      parameterList.push_back(std::move(parameter));
+    }
+    return parameterList;
+  }
+  // Overrides a parameter named after its environment variable in app/src/spot_market_making/config.env.example. Only the parameters of the spread, the
+  // order quantity, the inventory target, the adverse selection guard and the kill switch can be swept.
+  static void setParameter(EventHandlerBase& eventHandler, const std::string& name, const std::string& value) {
+    static const std::map<std::string, double EventHandlerBase::*> doubleParameterMap{
+        {"ORDER_QUANTITY_PROPORTION", &EventHandlerBase::orderQuantityProportion},
+        {"KILL_SWITCH_MAXIMUM_DRAWDOWN", &EventHandlerBase::killSwitchMaximumDrawdown},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_ROC_MINIMUM", &EventHandlerBase::adverseSelectionGuardTriggerRocMinimum},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_ROC_MAXIMUM", &EventHandlerBase::adverseSelectionGuardTriggerRocMaximum},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_RSI_MINIMUM", &EventHandlerBase::adverseSelectionGuardTriggerRsiMinimum},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_RSI_MAXIMUM", &EventHandlerBase::adverseSelectionGuardTriggerRsiMaximum},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_ROLL_CORRELATION_COEFFICIENT_MAXIMUM",
+         &EventHandlerBase::adverseSelectionGuardTriggerRollCorrelationCoefficientMaximum},
+        {"ADVERSE_SELECTION_GUARD_ACTION_ORDER_QUANTITY_PROPORTION", &EventHandlerBase::adverseSelectionGuardActionOrderQuantityProportion},
+    };
+    static const std::map<std::string, double EventHandlerBase::*> halfDoubleParameterMap{
+        {"SPREAD_PROPORTION_MINIMUM", &EventHandlerBase::halfSpreadMinimum},
+        {"SPREAD_PROPORTION_MAXIMUM", &EventHandlerBase::halfSpreadMaximum},
+    };
+    static const std::map<std::string, double EventHandlerBase::*> ratioParameterMap{
+        {"INVENTORY_BASE_QUOTE_RATIO_TARGET", &EventHandlerBase::inventoryBasePortionTarget},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_INVENTORY_BASE_QUOTE_RATIO_MINIMUM", &EventHandlerBase::adverseSelectionGuardTriggerInventoryBasePortionMinimum},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_INVENTORY_BASE_QUOTE_RATIO_MAXIMUM", &EventHandlerBase::adverseSelectionGuardTriggerInventoryBasePortionMaximum},
+    };
+    static const std::map<std::string, int EventHandlerBase::*> intParameterMap{
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_ROC_NUM_OBSERVATIONS", &EventHandlerBase::adverseSelectionGuardTriggerRocNumObservations},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_RSI_NUM_OBSERVATIONS", &EventHandlerBase::adverseSelectionGuardTriggerRsiNumObservations},
+        {"ADVERSE_SELECTION_GUARD_TRIGGER_ROLL_CORRELATION_COEFFICIENT_NUM_OBSERVATIONS",
+         &EventHandlerBase::adverseSelectionGuardTriggerRollCorrelationCoefficientNumObservations},
+        {"ADVERSE_SELECTION_GUARD_ACTION_ORDER_REFRESH_INTERVAL_SECONDS", &EventHandlerBase::adverseSelectionGuardActionOrderRefreshIntervalSeconds},
+    };
+    static const std::map<std::string, bool EventHandlerBase::*> boolParameterMap{
+        {"USE_WEIGHTED_MID_PRICE", &EventHandlerBase::useWeightedMidPrice},
+        {"ENABLE_ADVERSE_SELECTION_GUARD", &EventHandlerBase::enableAdverseSelectionGuard},
+        {"ENABLE_ADVERSE_SELECTION_GUARD_BY_ROC", &EventHandlerBase::enableAdverseSelectionGuardByRoc},
+        {"ENABLE_ADVERSE_SELECTION_GUARD_BY_RSI", &EventHandlerBase::enableAdverseSelectionGuardByRsi},
+        {"ENABLE_ADVERSE_SELECTION_GUARD_BY_ROLL_CORRELATION_COEFFICIENT", &EventHandlerBase::enableAdverseSelectionGuardByRollCorrelationCoefficient},
+        {"ENABLE_ADVERSE_SELECTION_GUARD_BY_INVENTORY_LIMIT", &EventHandlerBase::enableAdverseSelectionGuardByInventoryLimit},
+        {"ENABLE_ADVERSE_SELECTION_GUARD_BY_INVENTORY_DEPLETION", &EventHandlerBase::enableAdverseSelectionGuardByInventoryDepletion},
+    };
+    if (doubleParameterMap.find(name) != doubleParameterMap.end()) {
+      eventHandler.*doubleParameterMap.at(name) = std::stod(value);
+    } else if (halfDoubleParameterMap.find(name) != halfDoubleParameterMap.end()) {
+      eventHandler.*halfDoubleParameterMap.at(name) = std::stod(value) / 2;
+    } else if (ratioParameterMap.find(name) != ratioParameterMap.end()) {
+      double a = std::stod(value);
+      eventHandler.*ratioParameterMap.at(name) = a / (a + 1);
+    } else if (intParameterMap.find(name) != intParameterMap.end()) {
+      eventHandler.*intParameterMap.at(name) = std::stoi(value);
+    } else if (boolParameterMap.find(name) != boolParameterMap.end()) {
+      eventHandler.*boolParameterMap.at(name) = UtilString::toLower(value) == "true";
+    } else if (name == "ADVERSE_SELECTION_GUARD_ACTION_TYPE") {
+      eventHandler.adverseSelectionGuardActionType = value == "take"   ? EventHandlerBase::AdverseSelectionGuardActionType::TAKE
+                                                     : value == "make" ? EventHandlerBase::AdverseSelectionGuardActionType::MAKE
+                                                                       : EventHandlerBase::AdverseSelectionGuardActionType::NONE;
+    } else if (name == "PRIVATE_DATA_FILE_SUFFIX") {
+      eventHandler.privateDataFileSuffix = value;
+    } else {
+      throw std::invalid_argument("parameter " + name + " can't be swept");
+    }
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  void processEventBatch() {
+    if (this->eventBatch.empty()) {
+      return;
+    }
+    this->forEachEventHandler([that = this](EventHandlerBase* eventHandler) {
+      for (const auto& event : that->eventBatch) {
+        eventHandler->processEvent(event, nullptr);
+      }
+    });
+    this->eventBatch.clear();
+  }
+  // Calls f for every event handler on the thread pool, waits for all of them and rethrows the first exception.
+  template <typename F>
+  void forEachEventHandler(F f) {
+    std::mutex m;
+    std::condition_variable cv;
+    size_t numRemaining = this->eventHandlerList.size();
+    std::exception_ptr exceptionPtr;
+    for (auto eventHandler : this->eventHandlerList) {
+      boost::asio::post(this->threadPool, [&, eventHandler]() {
+        std::exception_ptr currentExceptionPtr;
+        try {
+          f(eventHandler);
+        } catch (...) {
+          currentExceptionPtr = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(m);
+        if (currentExceptionPtr && !exceptionPtr) {
+          exceptionPtr = currentExceptionPtr;
+        }
+        if (--numRemaining == 0) {
+          cv.notify_one();
+        }
+      });
+    }
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&numRemaining]() { return numRemaining == 0; });
+    if (exceptionPtr) {
+      std::rethrow_exception(exceptionPtr);
+    }
+  }
+  std::vector<EventHandlerBase*> eventHandlerList;
+  boost::asio::thread_pool threadPool;
+  size_t batchSize;
+  std::vector<Event> eventBatch;
+};
+} /* namespace ccapi */
+#endif  // APP_INCLUDE_APP_BACKTEST_PARAMETER_SWEEP_H_
@@ -87,15 +87,16 @@ namespace ccapi {
 class AppUtil {
  public:
   static double generateRandomDouble(double lowerBound, double upperBound) {
-    static std::uniform_real_distribution<double> unif(lowerBound, upperBound);
-    static std::default_random_engine re;
+    // the distribution is cheap and holds the bounds, so only the engine is kept per thread
+    static thread_local std::default_random_engine re;
+    std::uniform_real_distribution<double> unif(lowerBound, upperBound);
     return unif(re);
   }
   static std::string generateUuidV4() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
+    static thread_local std::random_device rd;
+    static thread_local std::mt19937 gen(rd());
+    static thread_local std::uniform_int_distribution<> dis(0, 15);
+    static thread_local std::uniform_int_distribution<> dis2(8, 11);
     std::stringstream ss;
     int i;
     ss << std::hex;
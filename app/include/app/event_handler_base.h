@@ -82,6 +82,17 @@ class EventHandlerBase : public EventHandler {
     IS,
   };
   virtual ~EventHandlerBase() {}
+  // Copies eventHandler for another run, e.g. of a parameter sweep. The copy doesn't share the CSV writers, which belong to eventHandler, and opens its own
+  // when it processes its instrument.
+  template <typename T>
+  static std::unique_ptr<T> clone(const T& eventHandler) {
+    std::unique_ptr<T> output(new T(eventHandler));
+    EventHandlerBase& base = *output;
+    base.privateTradeCsvWriter = nullptr;
+    base.orderUpdateCsvWriter = nullptr;
+    base.accountBalanceCsvWriter = nullptr;
+    return output;
+  }
   virtual void onInit(Session* session) {}
   bool processEvent(const Event& event, Session* session) override {
     if (this->skipProcessEvent) {
@@ -320,23 +331,16 @@ class EventHandlerBase : public EventHandler {
         this->snapshotBid.clear();
         this->snapshotAsk.clear();
         for (const auto& element : message.getElementList()) {
-          const auto& elementNameValueMap = element.getNameValueMap();
-          {
-            auto it = elementNameValueMap.find(CCAPI_BEST_BID_N_PRICE);
-            if (it != elementNameValueMap.end()) {
-              auto price = it->second;
-              if (price != CCAPI_BEST_BID_N_PRICE_EMPTY) {
-                this->snapshotBid[Decimal(price)] = elementNameValueMap.at(CCAPI_BEST_BID_N_SIZE);
-              }
+          if (element.has(CCAPI_BEST_BID_N_PRICE)) {
+            auto price = element.getValue(CCAPI_BEST_BID_N_PRICE);
+            if (price != CCAPI_BEST_BID_N_PRICE_EMPTY) {
+              this->snapshotBid[Decimal(price)] = element.getValue(CCAPI_BEST_BID_N_SIZE);
             }
           }
-          {
-            auto it = elementNameValueMap.find(CCAPI_BEST_ASK_N_PRICE);
-            if (it != elementNameValueMap.end()) {
-              auto price = it->second;
-              if (price != CCAPI_BEST_ASK_N_PRICE_EMPTY) {
-                this->snapshotAsk[Decimal(price)] = elementNameValueMap.at(CCAPI_BEST_ASK_N_SIZE);
-              }
+          if (element.has(CCAPI_BEST_ASK_N_PRICE)) {
+            auto price = element.getValue(CCAPI_BEST_ASK_N_PRICE);
+            if (price != CCAPI_BEST_ASK_N_PRICE_EMPTY) {
+              this->snapshotAsk[Decimal(price)] = element.getValue(CCAPI_BEST_ASK_N_SIZE);
             }
           }
           if (this->snapshotBid.empty()) {
@@ -587,71 +591,12 @@ class EventHandlerBase : public EventHandler {
         const auto& element = firstMessage.getElementList().at(0);
         this->extractInstrumentInfo(element);
         if (this->tradingMode == TradingMode::BACKTEST) {
-          HistoricalMarketDataEventProcessor historicalMarketDataEventProcessor(
-              std::bind(&EventHandlerBase::processEvent, this, std::placeholders::_1, nullptr));
-          historicalMarketDataEventProcessor.exchange = this->exchange;
-          historicalMarketDataEventProcessor.baseAsset = UtilString::toLower(this->baseAsset);
-          historicalMarketDataEventProcessor.quoteAsset = UtilString::toLower(this->quoteAsset);
-          historicalMarketDataEventProcessor.historicalMarketDataStartDateTp = this->historicalMarketDataStartDateTp;
-          historicalMarketDataEventProcessor.historicalMarketDataEndDateTp = this->historicalMarketDataEndDateTp;
-          historicalMarketDataEventProcessor.historicalMarketDataDirectory = this->historicalMarketDataDirectory;
-          historicalMarketDataEventProcessor.historicalMarketDataFilePrefix = this->historicalMarketDataFilePrefix;
-          historicalMarketDataEventProcessor.historicalMarketDataFileSuffix = this->historicalMarketDataFileSuffix;
-          historicalMarketDataEventProcessor.clockStepSeconds = this->clockStepMilliseconds / 1000;
-          historicalMarketDataEventProcessor.startTimeTp = this->startTimeTp;
-          historicalMarketDataEventProcessor.totalDurationSeconds = this->totalDurationSeconds;
-          historicalMarketDataEventProcessor.processEvent();
-          std::string prefix;
-          if (!this->privateDataFilePrefix.empty()) {
-            prefix = this->privateDataFilePrefix;
-          }
-          std::string suffix;
-          if (!this->privateDataFileSuffix.empty()) {
-            suffix = this->privateDataFileSuffix;
-          }
-          std::string privateDataSummaryCsvFilename(
-              prefix + this->exchange + "__" + UtilString::toLower(this->baseAsset) + "-" + UtilString::toLower(this->quoteAsset) + "__" +
-              UtilTime::getISOTimestamp(this->historicalMarketDataStartDateTp).substr(0, 10) + "__" +
-              UtilTime::getISOTimestamp(this->historicalMarketDataEndDateTp).substr(0, 10) + "__summary" + suffix + ".csv");
-          if (!this->privateDataDirectory.empty()) {
-            privateDataSummaryCsvFilename = this->privateDataDirectory + "/" + privateDataSummaryCsvFilename;
-          }
-          CsvWriter* privateDataFinalSummaryCsvWriter = new CsvWriter();
-          {
-            struct stat buffer;
-            if (stat(privateDataSummaryCsvFilename.c_str(), &buffer) != 0) {
-              privateDataFinalSummaryCsvWriter->open(privateDataSummaryCsvFilename, std::ios_base::app);
-              privateDataFinalSummaryCsvWriter->writeRow({
-                  "BASE_AVAILABLE_BALANCE",
-                  "QUOTE_AVAILABLE_BALANCE",
-                  "BEST_BID_PRICE",
-                  "BEST_ASK_PRICE",
-                  "TRADE_VOLUME_IN_BASE_SUM",
-                  "TRADE_VOLUME_IN_QUOTE_SUM",
-                  "TRADE_FEE_IN_BASE_SUM",
-                  "TRADE_FEE_IN_QUOTE_SUM",
-              });
-              privateDataFinalSummaryCsvWriter->flush();
-            } else {
-              privateDataFinalSummaryCsvWriter->open(privateDataSummaryCsvFilename, std::ios_base::app);
-            }
-          }
-          privateDataFinalSummaryCsvWriter->writeRow({
-              Decimal(UtilString::printDoubleScientific(this->baseBalance)).toString(),
-              Decimal(UtilString::printDoubleScientific(this->quoteBalance)).toString(),
-              this->bestBidPrice,
-              this->bestAskPrice,
-              Decimal(UtilString::printDoubleScientific(this->privateTradeVolumeInBaseSum)).toString(),
-              Decimal(UtilString::printDoubleScientific(this->privateTradeVolumeInQuoteSum)).toString(),
-              Decimal(UtilString::printDoubleScientific(this->privateTradeFeeInBaseSum)).toString(),
-              Decimal(UtilString::printDoubleScientific(this->privateTradeFeeInQuoteSum)).toString(),
-          });
-          privateDataFinalSummaryCsvWriter->flush();
-          delete privateDataFinalSummaryCsvWriter;
-          try {
-            this->promisePtr->set_value();
-          } catch (const std::future_error& e) {
-            APP_LOGGER_DEBUG(e.what());
+          if (this->replayHistoricalMarketData) {
+            HistoricalMarketDataEventProcessor historicalMarketDataEventProcessor(
+                std::bind(&EventHandlerBase::processEvent, this, std::placeholders::_1, nullptr));
+            this->initHistoricalMarketDataEventProcessor(historicalMarketDataEventProcessor);
+            historicalMarketDataEventProcessor.processEvent();
+            this->finishBacktest();
           }
         } else {
           std::vector<Subscription> subscriptionList;
@@ -997,6 +942,75 @@ class EventHandlerBase : public EventHandler {
     }
     return true;
   }
+  void initHistoricalMarketDataEventProcessor(HistoricalMarketDataEventProcessor& historicalMarketDataEventProcessor) const {
+    historicalMarketDataEventProcessor.exchange = this->exchange;
+    historicalMarketDataEventProcessor.baseAsset = UtilString::toLower(this->baseAsset);
+    historicalMarketDataEventProcessor.quoteAsset = UtilString::toLower(this->quoteAsset);
+    historicalMarketDataEventProcessor.historicalMarketDataStartDateTp = this->historicalMarketDataStartDateTp;
+    historicalMarketDataEventProcessor.historicalMarketDataEndDateTp = this->historicalMarketDataEndDateTp;
+    historicalMarketDataEventProcessor.historicalMarketDataDirectory = this->historicalMarketDataDirectory;
+    historicalMarketDataEventProcessor.historicalMarketDataFilePrefix = this->historicalMarketDataFilePrefix;
+    historicalMarketDataEventProcessor.historicalMarketDataFileSuffix = this->historicalMarketDataFileSuffix;
+    historicalMarketDataEventProcessor.historicalMarketDataFileFormat = this->historicalMarketDataFileFormat;
+    historicalMarketDataEventProcessor.clockStepSeconds = this->clockStepMilliseconds / 1000;
+    historicalMarketDataEventProcessor.startTimeTp = this->startTimeTp;
+    historicalMarketDataEventProcessor.totalDurationSeconds = this->totalDurationSeconds;
+  }
+  // Writes the final summary of a backtest and fulfills promisePtr.
+  void finishBacktest() {
+    std::string prefix;
+    if (!this->privateDataFilePrefix.empty()) {
+      prefix = this->privateDataFilePrefix;
+    }
+    std::string suffix;
+    if (!this->privateDataFileSuffix.empty()) {
+      suffix = this->privateDataFileSuffix;
+    }
+    std::string privateDataSummaryCsvFilename(
+        prefix + this->exchange + "__" + UtilString::toLower(this->baseAsset) + "-" + UtilString::toLower(this->quoteAsset) + "__" +
+        UtilTime::getISOTimestamp(this->historicalMarketDataStartDateTp).substr(0, 10) + "__" +
+        UtilTime::getISOTimestamp(this->historicalMarketDataEndDateTp).substr(0, 10) + "__summary" + suffix + ".csv");
+    if (!this->privateDataDirectory.empty()) {
+      privateDataSummaryCsvFilename = this->privateDataDirectory + "/" + privateDataSummaryCsvFilename;
+    }
+    CsvWriter* privateDataFinalSummaryCsvWriter = new CsvWriter();
+    {
+      struct stat buffer;
+      if (stat(privateDataSummaryCsvFilename.c_str(), &buffer) != 0) {
+        privateDataFinalSummaryCsvWriter->open(privateDataSummaryCsvFilename, std::ios_base::app);
+        privateDataFinalSummaryCsvWriter->writeRow({
+            "BASE_AVAILABLE_BALANCE",
+            "QUOTE_AVAILABLE_BALANCE",
+            "BEST_BID_PRICE",
+            "BEST_ASK_PRICE",
+            "TRADE_VOLUME_IN_BASE_SUM",
+            "TRADE_VOLUME_IN_QUOTE_SUM",
+            "TRADE_FEE_IN_BASE_SUM",
+            "TRADE_FEE_IN_QUOTE_SUM",
+        });
+        privateDataFinalSummaryCsvWriter->flush();
+      } else {
+        privateDataFinalSummaryCsvWriter->open(privateDataSummaryCsvFilename, std::ios_base::app);
+      }
+    }
+    privateDataFinalSummaryCsvWriter->writeRow({
+        Decimal(UtilString::printDoubleScientific(this->baseBalance)).toString(),
+        Decimal(UtilString::printDoubleScientific(this->quoteBalance)).toString(),
+        this->bestBidPrice,
+        this->bestAskPrice,
+        Decimal(UtilString::printDoubleScientific(this->privateTradeVolumeInBaseSum)).toString(),
+        Decimal(UtilString::printDoubleScientific(this->privateTradeVolumeInQuoteSum)).toString(),
+        Decimal(UtilString::printDoubleScientific(this->privateTradeFeeInBaseSum)).toString(),
+        Decimal(UtilString::printDoubleScientific(this->privateTradeFeeInQuoteSum)).toString(),
+    });
+    privateDataFinalSummaryCsvWriter->flush();
+    delete privateDataFinalSummaryCsvWriter;
+    try {
+      this->promisePtr->set_value();
+    } catch (const std::future_error& e) {
+      APP_LOGGER_DEBUG(e.what());
+    }
+  }
   AppMode appMode{AppMode::MARKET_MAKING};
   std::string previousMessageTimeISODate, exchange, instrumentRest, instrumentWebsocket, baseAsset, quoteAsset, accountId, orderPriceIncrement,
       orderQuantityIncrement, privateDataDirectory, privateDataFilePrefix, privateDataFileSuffix, bestBidPrice, bestBidSize, bestAskPrice, bestAskSize,
@@ -1045,7 +1059,10 @@ class EventHandlerBase : public EventHandler {
 
   // start: only applicable to backtest
   TimePoint historicalMarketDataStartDateTp{std::chrono::seconds{0}}, historicalMarketDataEndDateTp{std::chrono::seconds{0}};
-  std::string historicalMarketDataDirectory, historicalMarketDataFilePrefix, historicalMarketDataFileSuffix;
+  std::string historicalMarketDataDirectory, historicalMarketDataFilePrefix, historicalMarketDataFileSuffix, historicalMarketDataFileFormat;
+  // If false, the GET_INSTRUMENT response only initializes the backtest and the caller is expected to feed the historical market data events to processEvent
+  // and then call finishBacktest, e.g. to share them between the runs of a parameter sweep.
+  bool replayHistoricalMarketData{true};
   // end: only applicable to backtest
 
  protected:
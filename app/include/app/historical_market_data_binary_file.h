@@ -0,0 +1,345 @@
+#ifndef APP_INCLUDE_APP_HISTORICAL_MARKET_DATA_BINARY_FILE_H_
+#define APP_INCLUDE_APP_HISTORICAL_MARKET_DATA_BINARY_FILE_H_
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "ccapi_cpp/ccapi_util_private.h"
+namespace ccapi {
+/**
+ * The decoded values of one row of a HistoricalMarketDataBinaryFile. Every value is a fixed-point number, i.e. value = valueList[i] /
+ * 10^numDecimalPlacesList[i]. For a trade file the columns are time, price, size and is_buyer_maker. For a market depth file the columns are time, the number
+ * of bid levels, the number of ask levels and then bid price, bid size, ask price and ask size of each level. A row is meant to be reused so that reading
+ * doesn't allocate once its vectors have grown to the number of columns.
+ */
+struct HistoricalMarketDataRow {
+  static constexpr size_t timeColumn = 0;
+  static constexpr size_t tradePriceColumn = 1;
+  static constexpr size_t tradeSizeColumn = 2;
+  static constexpr size_t tradeIsBuyerMakerColumn = 3;
+  static constexpr size_t marketDepthNumBidLevelsColumn = 1;
+  static constexpr size_t marketDepthNumAskLevelsColumn = 2;
+  static size_t getMarketDepthBidPriceColumn(size_t level) { return 3 + 4 * level; }
+  static size_t getMarketDepthBidSizeColumn(size_t level) { return 4 + 4 * level; }
+  static size_t getMarketDepthAskPriceColumn(size_t level) { return 5 + 4 * level; }
+  static size_t getMarketDepthAskSizeColumn(size_t level) { return 6 + 4 * level; }
+  // Truncates towards zero like std::stoi does for the CSV files.
+  long long getSeconds() const { return this->valueList.at(timeColumn) / pow10(this->numDecimalPlacesList.at(timeColumn)); }
+  std::pair<long long, long long> getSecondsAndNanoseconds() const {
+    int numDecimalPlaces = this->numDecimalPlacesList.at(timeColumn);
+    int64_t scale = pow10(numDecimalPlaces);
+    return std::make_pair(this->valueList.at(timeColumn) / scale, this->valueList.at(timeColumn) % scale * pow10(9 - numDecimalPlaces));
+  }
+  int64_t getInteger(size_t column) const { return this->valueList.at(column) / pow10(this->numDecimalPlacesList.at(column)); }
+  // Writes the value in plain decimal notation without trailing zeros into buffer, which must hold at least 24 characters, and returns the length.
+  size_t format(size_t column, char* buffer) const {
+    int64_t value = this->valueList.at(column);
+    int numDecimalPlaces = this->numDecimalPlacesList.at(column);
+    bool isNegative = value < 0;
+    uint64_t magnitude = isNegative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    char digits[20];
+    int numDigits = 0;
+    do {
+      digits[numDigits++] = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    int firstDigit = 0;
+    while (firstDigit < numDecimalPlaces && (firstDigit >= numDigits || digits[firstDigit] == '0')) {
+      ++firstDigit;
+    }
+    size_t length = 0;
+    if (isNegative) {
+      buffer[length++] = '-';
+    }
+    if (numDigits <= numDecimalPlaces) {
+      buffer[length++] = '0';
+    } else {
+      for (int i = numDigits - 1; i >= numDecimalPlaces; --i) {
+        buffer[length++] = digits[i];
+      }
+    }
+    if (firstDigit < numDecimalPlaces) {
+      buffer[length++] = '.';
+      for (int i = numDecimalPlaces - 1; i >= firstDigit; --i) {
+        buffer[length++] = i < numDigits ? digits[i] : '0';
+      }
+    }
+    return length;
+  }
+  std::string getString(size_t column) const {
+    char buffer[32];
+    return std::string(buffer, this->format(column, buffer));
+  }
+  static int64_t pow10(int exponent) {
+    int64_t result = 1;
+    for (int i = 0; i < exponent; ++i) {
+      result *= 10;
+    }
+    return result;
+  }
+  std::vector<int64_t> valueList;
+  std::vector<int> numDecimalPlacesList;
+};
+/**
+ * A compact, columnar binary copy of one daily historical market data CSV file (see app/src/spot_market_making/config.env.example for the CSV formats), read
+ * through a read-only memory mapping. Prices, sizes and timestamps are stored as fixed-point integers with a number of decimal places chosen per column, so
+ * that no string has to be parsed during a backtest. Each column is a contiguous stream of zigzag varint encoded deltas from the previous row, which keeps
+ * slowly moving columns like timestamps and prices to one or two bytes per row. Values are written back in plain decimal notation without trailing zeros,
+ * e.g. "2272.50" in a CSV file becomes "2272.5".
+ */
+class HistoricalMarketDataBinaryFile CCAPI_FINAL {
+ public:
+  enum class Type : uint32_t {
+    UNKNOWN = 0,
+    MARKET_DEPTH = 1,
+    TRADE = 2,
+  };
+  HistoricalMarketDataBinaryFile() {}
+  HistoricalMarketDataBinaryFile(const HistoricalMarketDataBinaryFile&) = delete;
+  HistoricalMarketDataBinaryFile& operator=(const HistoricalMarketDataBinaryFile&) = delete;
+  // Returns false if the file doesn't exist or can't be mapped, like std::ifstream::open. Throws if the file exists but isn't a valid binary file.
+  bool open(const std::string& filePath) {
+    if (!std::ifstream(filePath).good()) {
+      return false;
+    }
+    try {
+      this->fileMapping = boost::interprocess::file_mapping(filePath.c_str(), boost::interprocess::read_only);
+      this->mappedRegion = boost::interprocess::mapped_region(this->fileMapping, boost::interprocess::read_only);
+    } catch (const boost::interprocess::interprocess_exception&) {
+      return false;
+    }
+    const char* data = static_cast<const char*>(this->mappedRegion.get_address());
+    size_t size = this->mappedRegion.get_size();
+    if (size < sizeof(Header)) {
+      throw std::runtime_error(filePath + " is not a historical market data binary file");
+    }
+    std::memcpy(&this->header, data, sizeof(Header));
+    if (std::memcmp(this->header.magic, magic, sizeof(magic)) != 0 || size < sizeof(Header) + this->header.numColumns * sizeof(ColumnHeader)) {
+      throw std::runtime_error(filePath + " is not a historical market data binary file");
+    }
+    this->columnList.clear();
+    for (uint32_t i = 0; i < this->header.numColumns; ++i) {
+      ColumnHeader columnHeader;
+      std::memcpy(&columnHeader, data + sizeof(Header) + i * sizeof(ColumnHeader), sizeof(ColumnHeader));
+      if (columnHeader.offset + columnHeader.numBytes > size) {
+        throw std::runtime_error(filePath + " is truncated");
+      }
+      this->columnList.push_back({data + columnHeader.offset, data + columnHeader.offset + columnHeader.numBytes, columnHeader.numDecimalPlaces, 0});
+    }
+    this->numRowsRead = 0;
+    return true;
+  }
+  Type getType() const { return static_cast<Type>(this->header.type); }
+  uint64_t getNumRows() const { return this->header.numRows; }
+  size_t getNumColumns() const { return this->columnList.size(); }
+  // Decodes the next row into row and returns false at the end of the file.
+  bool read(HistoricalMarketDataRow& row) {
+    if (this->numRowsRead >= this->header.numRows) {
+      return false;
+    }
+    size_t numColumns = this->columnList.size();
+    row.valueList.resize(numColumns);
+    row.numDecimalPlacesList.resize(numColumns);
+    for (size_t i = 0; i < numColumns; ++i) {
+      Column& column = this->columnList[i];
+      uint64_t zigzag = 0;
+      int shift = 0;
+      uint8_t byte;
+      do {
+        if (column.current == column.end) {
+          throw std::runtime_error("historical market data binary file column " + std::to_string(i) + " ended early");
+        }
+        byte = static_cast<uint8_t>(*column.current++);
+        zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+      } while ((byte & 0x80) && shift < 64);
+      column.value += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+      row.valueList[i] = column.value;
+      row.numDecimalPlacesList[i] = column.numDecimalPlaces;
+    }
+    ++this->numRowsRead;
+    return true;
+  }
+  // Converts a CSV file, whose first line is a header, into a binary file. A line with three fields is a market depth row and a line with four fields is a
+  // trade row. Throws if a value isn't a plain decimal number.
+  static void convertCsv(const std::string& csvFilePath, const std::string& binaryFilePath) {
+    std::ifstream ifs(csvFilePath);
+    if (!ifs) {
+      throw std::runtime_error("cannot open " + csvFilePath);
+    }
+    Type type = Type::UNKNOWN;
+    std::vector<std::vector<std::pair<int64_t, int> > > columnList;
+    std::string line;
+    std::getline(ifs, line);
+    while (std::getline(ifs, line) && !line.empty()) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      auto fieldList = UtilString::split(line, ',');
+      Type lineType = fieldList.size() == 4 ? Type::TRADE : fieldList.size() == 3 ? Type::MARKET_DEPTH : Type::UNKNOWN;
+      if (lineType == Type::UNKNOWN || (type != Type::UNKNOWN && lineType != type)) {
+        throw std::runtime_error("unexpected line " + line + " in " + csvFilePath);
+      }
+      type = lineType;
+      size_t numRows = columnList.empty() ? 0 : columnList.front().size();
+      std::vector<std::pair<int64_t, int> > valueList;
+      valueList.push_back(parseFixedPoint(fieldList.at(0)));
+      if (type == Type::TRADE) {
+        for (size_t i = 1; i < 4; ++i) {
+          valueList.push_back(parseFixedPoint(fieldList.at(i)));
+        }
+      } else {
+        std::vector<std::string> bidLevelList, askLevelList;
+        if (!fieldList.at(1).empty()) {
+          bidLevelList = UtilString::split(fieldList.at(1), '|');
+        }
+        if (!fieldList.at(2).empty()) {
+          askLevelList = UtilString::split(fieldList.at(2), '|');
+        }
+        valueList.emplace_back(bidLevelList.size(), 0);
+        valueList.emplace_back(askLevelList.size(), 0);
+        for (size_t level = 0; level < std::max(bidLevelList.size(), askLevelList.size()); ++level) {
+          for (const auto* levelList : {&bidLevelList, &askLevelList}) {
+            if (level < levelList->size()) {
+              const auto& priceSize = levelList->at(level);
+              auto found = priceSize.find('_');
+              if (found == std::string::npos) {
+                throw std::runtime_error("unexpected line " + line + " in " + csvFilePath);
+              }
+              valueList.push_back(parseFixedPoint(priceSize.substr(0, found)));
+              valueList.push_back(parseFixedPoint(priceSize.substr(found + 1)));
+            } else {
+              valueList.emplace_back(0, 0);
+              valueList.emplace_back(0, 0);
+            }
+          }
+        }
+        // The number of columns follows the deepest row and the levels missing from the other rows are stored as zero.
+        if (valueList.size() > columnList.size()) {
+          columnList.resize(valueList.size(), std::vector<std::pair<int64_t, int> >(numRows, std::make_pair(int64_t(0), 0)));
+        }
+        valueList.resize(columnList.size(), std::make_pair(int64_t(0), 0));
+      }
+      if (columnList.empty()) {
+        columnList.resize(valueList.size());
+      }
+      for (size_t i = 0; i < valueList.size(); ++i) {
+        columnList[i].push_back(valueList[i]);
+      }
+    }
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.type = static_cast<uint32_t>(type);
+    header.numColumns = static_cast<uint32_t>(columnList.size());
+    header.numRows = columnList.empty() ? 0 : columnList.front().size();
+    std::vector<ColumnHeader> columnHeaderList;
+    std::string body;
+    uint64_t offset = sizeof(Header) + columnList.size() * sizeof(ColumnHeader);
+    for (size_t i = 0; i < columnList.size(); ++i) {
+      int numDecimalPlaces = 0;
+      for (const auto& x : columnList[i]) {
+        numDecimalPlaces = std::max(numDecimalPlaces, x.second);
+      }
+      if (i == HistoricalMarketDataRow::timeColumn && numDecimalPlaces > 9) {
+        throw std::runtime_error("time in " + csvFilePath + " is more precise than nanoseconds");
+      }
+      size_t bodySize = body.size();
+      int64_t previous = 0;
+      for (const auto& x : columnList[i]) {
+        int64_t scale = HistoricalMarketDataRow::pow10(numDecimalPlaces - x.second);
+        if (x.first > INT64_MAX / scale || x.first < INT64_MIN / scale) {
+          throw std::runtime_error("value out of range in " + csvFilePath);
+        }
+        int64_t value = x.first * scale;
+        int64_t delta = static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous));
+        uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        while (zigzag >= 0x80) {
+          body.push_back(static_cast<char>((zigzag & 0x7f) | 0x80));
+          zigzag >>= 7;
+        }
+        body.push_back(static_cast<char>(zigzag));
+        previous = value;
+      }
+      columnHeaderList.push_back({offset + bodySize, body.size() - bodySize, numDecimalPlaces, 0});
+    }
+    std::ofstream ofs(binaryFilePath, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    ofs.write(reinterpret_cast<const char*>(columnHeaderList.data()), columnHeaderList.size() * sizeof(ColumnHeader));
+    ofs.write(body.data(), body.size());
+    if (!ofs.good()) {
+      throw std::runtime_error("cannot write " + binaryFilePath);
+    }
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  static constexpr char magic[8] = {'C', 'C', 'A', 'P', 'I', 'H', 'M', '1'};
+  struct Header {
+    char magic[8];
+    uint32_t type;
+    uint32_t numColumns;
+    uint64_t numRows;
+  };
+  struct ColumnHeader {
+    uint64_t offset;
+    uint64_t numBytes;
+    int32_t numDecimalPlaces;
+    uint32_t reserved;
+  };
+  struct Column {
+    const char* current;
+    const char* end;
+    int numDecimalPlaces;
+    int64_t value;
+  };
+  // Parses a plain decimal number such as "-2271.58" into (227158, 2) without going through a floating point number.
+  static std::pair<int64_t, int> parseFixedPoint(const std::string& input) {
+    size_t i = 0;
+    bool isNegative = false;
+    if (i < input.size() && (input[i] == '-' || input[i] == '+')) {
+      isNegative = input[i] == '-';
+      ++i;
+    }
+    uint64_t mantissa = 0;
+    int numDecimalPlaces = 0;
+    bool hasDigit = false;
+    bool hasPoint = false;
+    for (; i < input.size(); ++i) {
+      char c = input[i];
+      if (c == '.' && !hasPoint) {
+        hasPoint = true;
+      } else if (c >= '0' && c <= '9') {
+        if (mantissa > (static_cast<uint64_t>(INT64_MAX) - (c - '0')) / 10) {
+          throw std::runtime_error("too many digits in " + input);
+        }
+        mantissa = mantissa * 10 + (c - '0');
+        hasDigit = true;
+        if (hasPoint) {
+          ++numDecimalPlaces;
+        }
+      } else {
+        throw std::runtime_error("not a plain decimal number: " + input);
+      }
+    }
+    if (!hasDigit) {
+      throw std::runtime_error("not a plain decimal number: " + input);
+    }
+    return std::make_pair(isNegative ? -static_cast<int64_t>(mantissa) : static_cast<int64_t>(mantissa), numDecimalPlaces);
+  }
+  boost::interprocess::file_mapping fileMapping;
+  boost::interprocess::mapped_region mappedRegion;
+  Header header{};
+  std::vector<Column> columnList;
+  uint64_t numRowsRead{};
+};
+} /* namespace ccapi */
+#endif  // APP_INCLUDE_APP_HISTORICAL_MARKET_DATA_BINARY_FILE_H_
@@ -4,83 +4,125 @@
 #include <iostream>
 
 #include "app/common.h"
+#include "app/historical_market_data_binary_file.h"
 #include "ccapi_cpp/ccapi_event.h"
 namespace ccapi {
+/**
+ * The row source of a historical market data CSV file, which has the same interface as HistoricalMarketDataBinaryFile: open returns false if the file can't
+ * be opened and read decodes the next row, here the comma separated fields of a line, and returns false at the end of the file.
+ */
+class HistoricalMarketDataCsvFile CCAPI_FINAL {
+ public:
+  bool open(const std::string& filePath) {
+    this->filePath = filePath;
+    this->ifs.open(filePath);
+    if (!this->ifs) {
+      return false;
+    }
+    this->ifs.ignore(INT_MAX, '\n');
+    return true;
+  }
+  bool read(std::vector<std::string>& splittedLine) {
+    if (!std::getline(this->ifs, this->line) || this->line.empty()) {
+      return false;
+    }
+    APP_LOGGER_DEBUG("File " + this->filePath + " next line is " + this->line + ".");
+    splittedLine = UtilString::split(this->line, ',');
+    return true;
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  std::string filePath;
+  std::ifstream ifs;
+  std::string line;
+};
 class HistoricalMarketDataEventProcessor {
  public:
   explicit HistoricalMarketDataEventProcessor(std::function<bool(const Event& event)> eventHandler) : eventHandler(eventHandler) {}
   void processEvent() {
+    if (this->historicalMarketDataFileFormat == "binary") {
+      this->processEvent<HistoricalMarketDataBinaryFile, HistoricalMarketDataRow>(".bin");
+    } else {
+      this->processEvent<HistoricalMarketDataCsvFile, std::vector<std::string> >(".csv");
+    }
+  }
+  TimePoint historicalMarketDataStartDateTp{std::chrono::seconds{0}}, historicalMarketDataEndDateTp{std::chrono::seconds{0}},
+      startTimeTp{std::chrono::seconds{0}};
+  std::string exchange, baseAsset, quoteAsset, historicalMarketDataDirectory, historicalMarketDataFilePrefix, historicalMarketDataFileSuffix;
+  // "csv" (the default) or "binary" for files converted by HistoricalMarketDataBinaryFile::convertCsv, which are named like the CSV files but end with ".bin".
+  std::string historicalMarketDataFileFormat;
+  int clockStepSeconds{}, clockSeconds{}, totalDurationSeconds{};
+
+ private:
+  // Steps the clock through the market depth rows of each day, filling the seconds without a row with the previous one, and emits the trades before each
+  // tick. File is the row source of a file format, see HistoricalMarketDataCsvFile, and Row is what it decodes one row into. Rows are reused across reads.
+  template <typename File, typename Row>
+  void processEvent(const std::string& fileExtension) {
     this->clockSeconds = 0;
     auto currentDateTp = this->historicalMarketDataStartDateTp;
-    std::string lineMarketDepth;
-    std::string lineTrade;
+    const long long startSeconds = std::chrono::duration_cast<std::chrono::seconds>(this->startTimeTp.time_since_epoch()).count();
+    Row rowMarketDepth, previousRowMarketDepth, rowTrade;
+    bool hasRowTrade{};
     bool shouldContinueTrade{true};
-    std::vector<std::string> previousSplittedMarketDepth;
     while (currentDateTp < this->historicalMarketDataEndDateTp) {
       const auto& currentDateISO = UtilTime::getISOTimestamp<std::chrono::seconds>(currentDateTp).substr(0, 10);
       APP_LOGGER_INFO("Start processing " + currentDateISO + ".");
       std::string fileNameWithDirBase = this->historicalMarketDataDirectory + "/" + this->historicalMarketDataFilePrefix + this->exchange + "__" +
                                         this->baseAsset + "-" + this->quoteAsset + "__" + currentDateISO + "__";
-      std::ifstream fMarketDepth;
-      std::ifstream fTrade;
-      fMarketDepth.open(fileNameWithDirBase + "market-depth" + this->historicalMarketDataFileSuffix + ".csv");
-      APP_LOGGER_INFO("Opening file " + fileNameWithDirBase + "market-depth" + this->historicalMarketDataFileSuffix + ".csv.");
-      fTrade.open(fileNameWithDirBase + "trade" + this->historicalMarketDataFileSuffix + ".csv");
-      APP_LOGGER_INFO("Opening file " + fileNameWithDirBase + "trade" + this->historicalMarketDataFileSuffix + ".csv.");
-      if (fMarketDepth && fTrade) {
-        APP_LOGGER_INFO("Opened file " + fileNameWithDirBase + "market-depth" + this->historicalMarketDataFileSuffix + ".csv.");
-        APP_LOGGER_INFO("Opened file " + fileNameWithDirBase + "trade" + this->historicalMarketDataFileSuffix + ".csv.");
-        fMarketDepth.ignore(INT_MAX, '\n');
-        fTrade.ignore(INT_MAX, '\n');
-        while (std::getline(fMarketDepth, lineMarketDepth) && !lineMarketDepth.empty()) {
-          APP_LOGGER_DEBUG("File market-depth next line is " + lineMarketDepth + ".");
-          auto splittedMarketDepth = UtilString::split(lineMarketDepth, ',');
-          int currentSecondsMarketDepth = std::stoi(splittedMarketDepth.at(0));
-          if (currentSecondsMarketDepth < std::chrono::duration_cast<std::chrono::seconds>(this->startTimeTp.time_since_epoch()).count()) {
+      File fMarketDepth;
+      File fTrade;
+      APP_LOGGER_INFO("Opening file " + fileNameWithDirBase + "market-depth" + this->historicalMarketDataFileSuffix + fileExtension + ".");
+      bool isMarketDepthOpen = fMarketDepth.open(fileNameWithDirBase + "market-depth" + this->historicalMarketDataFileSuffix + fileExtension);
+      APP_LOGGER_INFO("Opening file " + fileNameWithDirBase + "trade" + this->historicalMarketDataFileSuffix + fileExtension + ".");
+      bool isTradeOpen = fTrade.open(fileNameWithDirBase + "trade" + this->historicalMarketDataFileSuffix + fileExtension);
+      if (isMarketDepthOpen && isTradeOpen) {
+        APP_LOGGER_INFO("Opened file " + fileNameWithDirBase + "market-depth" + this->historicalMarketDataFileSuffix + fileExtension + ".");
+        APP_LOGGER_INFO("Opened file " + fileNameWithDirBase + "trade" + this->historicalMarketDataFileSuffix + fileExtension + ".");
+        while (fMarketDepth.read(rowMarketDepth)) {
+          long long currentSecondsMarketDepth = getSeconds(rowMarketDepth);
+          if (currentSecondsMarketDepth < startSeconds) {
             continue;
           }
-          if (currentSecondsMarketDepth >=
-              std::chrono::duration_cast<std::chrono::seconds>(this->startTimeTp.time_since_epoch()).count() + this->totalDurationSeconds) {
+          if (currentSecondsMarketDepth >= startSeconds + this->totalDurationSeconds) {
             return;
           }
           if (this->clockSeconds == 0) {
             this->clockSeconds = currentSecondsMarketDepth;
             APP_LOGGER_DEBUG("Clock unix timestamp is " + std::to_string(this->clockSeconds) + " seconds.");
-            this->advanceTradeIterator(shouldContinueTrade, fTrade, lineTrade);
-            this->processMarketDataEventMarketDepth(splittedMarketDepth);
+            this->advanceTradeIterator(shouldContinueTrade, fTrade, rowTrade, hasRowTrade);
+            this->processMarketDataEventMarketDepth(rowMarketDepth, currentSecondsMarketDepth);
           } else {
             this->clockSeconds += this->clockStepSeconds;
             APP_LOGGER_DEBUG("Clock unix timestamp is " + std::to_string(this->clockSeconds) + " seconds.");
             while (this->clockSeconds < currentSecondsMarketDepth) {
-              this->advanceTradeIterator(shouldContinueTrade, fTrade, lineTrade);
-              previousSplittedMarketDepth[0] = std::to_string(this->clockSeconds);
-              this->processMarketDataEventMarketDepth(previousSplittedMarketDepth);
+              this->advanceTradeIterator(shouldContinueTrade, fTrade, rowTrade, hasRowTrade);
+              this->processMarketDataEventMarketDepth(previousRowMarketDepth, this->clockSeconds);
               this->clockSeconds += this->clockStepSeconds;
               APP_LOGGER_DEBUG("Clock unix timestamp is " + std::to_string(this->clockSeconds) + " seconds.");
             }
-            this->advanceTradeIterator(shouldContinueTrade, fTrade, lineTrade);
-            this->processMarketDataEventMarketDepth(splittedMarketDepth);
+            this->advanceTradeIterator(shouldContinueTrade, fTrade, rowTrade, hasRowTrade);
+            this->processMarketDataEventMarketDepth(rowMarketDepth, currentSecondsMarketDepth);
           }
-          previousSplittedMarketDepth = std::move(splittedMarketDepth);
+          std::swap(previousRowMarketDepth, rowMarketDepth);
         }
         this->clockSeconds += this->clockStepSeconds;
         APP_LOGGER_DEBUG("Clock unix timestamp is " + std::to_string(this->clockSeconds) + " seconds.");
         while (this->clockSeconds < std::chrono::duration_cast<std::chrono::seconds>((currentDateTp + std::chrono::hours(24)).time_since_epoch()).count()) {
-          if (this->clockSeconds - this->clockStepSeconds < std::chrono::duration_cast<std::chrono::seconds>(this->startTimeTp.time_since_epoch()).count()) {
+          if (this->clockSeconds - this->clockStepSeconds < startSeconds) {
             this->clockSeconds += this->clockStepSeconds;
             continue;
           }
-          if (this->clockSeconds - this->clockStepSeconds >=
-              std::chrono::duration_cast<std::chrono::seconds>(this->startTimeTp.time_since_epoch()).count() + this->totalDurationSeconds) {
+          if (this->clockSeconds - this->clockStepSeconds >= startSeconds + this->totalDurationSeconds) {
             return;
           }
-          this->advanceTradeIterator(shouldContinueTrade, fTrade, lineTrade);
-          previousSplittedMarketDepth[0] = std::to_string(this->clockSeconds);
-          this->processMarketDataEventMarketDepth(previousSplittedMarketDepth);
+          this->advanceTradeIterator(shouldContinueTrade, fTrade, rowTrade, hasRowTrade);
+          this->processMarketDataEventMarketDepth(previousRowMarketDepth, this->clockSeconds);
           this->clockSeconds += this->clockStepSeconds;
           APP_LOGGER_DEBUG("Clock unix timestamp is " + std::to_string(this->clockSeconds) + " seconds.");
         }
-        this->advanceTradeIterator(shouldContinueTrade, fTrade, lineTrade);
+        this->advanceTradeIterator(shouldContinueTrade, fTrade, rowTrade, hasRowTrade);
         this->clockSeconds -= this->clockStepSeconds;
       } else {
         APP_LOGGER_INFO("Warning: unable to open file for date " + UtilTime::getISOTimestamp(currentDateTp));
@@ -89,32 +131,83 @@ class HistoricalMarketDataEventProcessor {
       currentDateTp += std::chrono::hours(24);
     }
   }
-  TimePoint historicalMarketDataStartDateTp{std::chrono::seconds{0}}, historicalMarketDataEndDateTp{std::chrono::seconds{0}},
-      startTimeTp{std::chrono::seconds{0}};
-  std::string exchange, baseAsset, quoteAsset, historicalMarketDataDirectory, historicalMarketDataFilePrefix, historicalMarketDataFileSuffix;
-  int clockStepSeconds{}, clockSeconds{}, totalDurationSeconds{};
-
- private:
-  void advanceTradeIterator(bool& shouldContinueTrade, std::ifstream& fTrade, std::string& lineTrade) {
-    if (!shouldContinueTrade && !lineTrade.empty()) {
-      auto splittedTrade = UtilString::split(lineTrade, ',');
-      int currentSecondsTrade = std::stoi(splittedTrade.at(0));
-      if (currentSecondsTrade < this->clockSeconds) {
-        this->processMarketDataEventTrade(splittedTrade);
+  template <typename File, typename Row>
+  void advanceTradeIterator(bool& shouldContinueTrade, File& fTrade, Row& rowTrade, bool& hasRowTrade) {
+    if (!shouldContinueTrade && hasRowTrade) {
+      if (getSeconds(rowTrade) < this->clockSeconds) {
+        this->processMarketDataEventTrade(rowTrade);
         shouldContinueTrade = true;
       }
     }
-    while (shouldContinueTrade && std::getline(fTrade, lineTrade) && !lineTrade.empty()) {
-      APP_LOGGER_DEBUG("File trade next line is " + lineTrade + ".");
-      auto splittedTrade = UtilString::split(lineTrade, ',');
-      int currentSecondsTrade = std::stoi(splittedTrade.at(0));
-      if (currentSecondsTrade < this->clockSeconds) {
-        this->processMarketDataEventTrade(splittedTrade);
+    while (shouldContinueTrade && (hasRowTrade = fTrade.read(rowTrade))) {
+      if (getSeconds(rowTrade) < this->clockSeconds) {
+        this->processMarketDataEventTrade(rowTrade);
       } else {
         shouldContinueTrade = false;
       }
     }
   }
+  static long long getSeconds(const HistoricalMarketDataRow& row) { return row.getSeconds(); }
+  static long long getSeconds(const std::vector<std::string>& splittedLine) { return std::stoi(splittedLine.at(0)); }
+  // A fresh Event is built for each row rather than refilling a scratch one: Element::insert never overwrites a value and Event and Message only hand out
+  // their lists as const, so refilling would mean rebuilding the same strings anyway.
+  void processMarketDataEventTrade(const HistoricalMarketDataRow& row) {
+    Event event;
+    event.setType(Event::Type::SUBSCRIPTION_DATA);
+    Message message;
+    message.setType(exchange.rfind("binance", 0) == 0 ? Message::Type::MARKET_DATA_EVENTS_AGG_TRADE : Message::Type::MARKET_DATA_EVENTS_TRADE);
+    message.setRecapType(Message::RecapType::NONE);
+    TimePoint messageTime = UtilTime::makeTimePoint(row.getSecondsAndNanoseconds());
+    message.setTime(messageTime);
+    message.setTimeReceived(messageTime);
+    message.setCorrelationIdList({PUBLIC_SUBSCRIPTION_DATA_TRADE_CORRELATION_ID});
+    std::vector<Element> elementList;
+    Element element;
+    element.reserve(3);
+    element.insert(CCAPI_LAST_PRICE, row.getString(HistoricalMarketDataRow::tradePriceColumn));
+    element.insert(CCAPI_LAST_SIZE, row.getString(HistoricalMarketDataRow::tradeSizeColumn));
+    element.insert(CCAPI_IS_BUYER_MAKER, row.getString(HistoricalMarketDataRow::tradeIsBuyerMakerColumn));
+    elementList.emplace_back(std::move(element));
+    message.setElementList(elementList);
+    event.addMessage(message);
+    APP_LOGGER_DEBUG("Generated a backtest event: " + event.toStringPretty());
+    this->eventHandler(event);
+  }
+  void processMarketDataEventMarketDepth(const HistoricalMarketDataRow& row, long long seconds) {
+    Event event;
+    event.setType(Event::Type::SUBSCRIPTION_DATA);
+    Message message;
+    message.setType(Message::Type::MARKET_DATA_EVENTS_MARKET_DEPTH);
+    message.setRecapType(Message::RecapType::NONE);
+    TimePoint messageTime = UtilTime::makeTimePoint(std::make_pair(seconds, 0));
+    message.setTime(messageTime);
+    message.setTimeReceived(messageTime);
+    message.setCorrelationIdList({PUBLIC_SUBSCRIPTION_DATA_MARKET_DEPTH_CORRELATION_ID});
+    std::vector<Element> elementList;
+    if (!row.valueList.empty()) {
+      size_t numBidLevels = row.getInteger(HistoricalMarketDataRow::marketDepthNumBidLevelsColumn);
+      size_t numAskLevels = row.getInteger(HistoricalMarketDataRow::marketDepthNumAskLevelsColumn);
+      elementList.reserve(numBidLevels + numAskLevels);
+      for (size_t level = 0; level < numBidLevels; ++level) {
+        Element element;
+        element.reserve(2);
+        element.insert(CCAPI_BEST_BID_N_PRICE, row.getString(HistoricalMarketDataRow::getMarketDepthBidPriceColumn(level)));
+        element.insert(CCAPI_BEST_BID_N_SIZE, row.getString(HistoricalMarketDataRow::getMarketDepthBidSizeColumn(level)));
+        elementList.emplace_back(std::move(element));
+      }
+      for (size_t level = 0; level < numAskLevels; ++level) {
+        Element element;
+        element.reserve(2);
+        element.insert(CCAPI_BEST_ASK_N_PRICE, row.getString(HistoricalMarketDataRow::getMarketDepthAskPriceColumn(level)));
+        element.insert(CCAPI_BEST_ASK_N_SIZE, row.getString(HistoricalMarketDataRow::getMarketDepthAskSizeColumn(level)));
+        elementList.emplace_back(std::move(element));
+      }
+    }
+    message.setElementList(elementList);
+    event.addMessage(message);
+    APP_LOGGER_DEBUG("Generated a backtest event: " + event.toStringPretty());
+    this->eventHandler(event);
+  }
   void processMarketDataEventTrade(const std::vector<std::string>& splittedLine) {
     Event event;
     event.setType(Event::Type::SUBSCRIPTION_DATA);
@@ -136,13 +229,13 @@ class HistoricalMarketDataEventProcessor {
     APP_LOGGER_DEBUG("Generated a backtest event: " + event.toStringPretty());
     this->eventHandler(event);
   }
-  void processMarketDataEventMarketDepth(const std::vector<std::string>& splittedLine) {
+  void processMarketDataEventMarketDepth(const std::vector<std::string>& splittedLine, long long seconds) {
     Event event;
     event.setType(Event::Type::SUBSCRIPTION_DATA);
     Message message;
     message.setType(Message::Type::MARKET_DATA_EVENTS_MARKET_DEPTH);
     message.setRecapType(Message::RecapType::NONE);
-    TimePoint messageTime = UtilTime::makeTimePoint(std::make_pair(std::stol(splittedLine.at(0)), 0));
+    TimePoint messageTime = UtilTime::makeTimePoint(std::make_pair(seconds, 0));
     message.setTime(messageTime);
     message.setTimeReceived(messageTime);
     message.setCorrelationIdList({PUBLIC_SUBSCRIPTION_DATA_MARKET_DEPTH_CORRELATION_ID});
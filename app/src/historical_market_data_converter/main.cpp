@@ -0,0 +1,28 @@
+#include <iostream>
+
+#include "app/historical_market_data_binary_file.h"
+using ::ccapi::HistoricalMarketDataBinaryFile;
+// Converts historical market data CSV files into the binary format read by backtests with HISTORICAL_MARKET_DATA_FILE_FORMAT=binary. Each file is written
+// next to its CSV file with the extension ".csv" replaced by ".bin".
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <csv file>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+  int exitCode = EXIT_SUCCESS;
+  for (int i = 1; i < argc; ++i) {
+    std::string csvFilePath(argv[i]);
+    std::string binaryFilePath = (csvFilePath.size() > 4 && csvFilePath.compare(csvFilePath.size() - 4, 4, ".csv") == 0
+                                      ? csvFilePath.substr(0, csvFilePath.size() - 4)
+                                      : csvFilePath) +
+                                 ".bin";
+    try {
+      HistoricalMarketDataBinaryFile::convertCsv(csvFilePath, binaryFilePath);
+      std::cout << "Converted " << csvFilePath << " to " << binaryFilePath << std::endl;
+    } catch (const std::exception& e) {
+      std::cerr << "Failed to convert " << csvFilePath << ": " << e.what() << std::endl;
+      exitCode = EXIT_FAILURE;
+    }
+  }
+  return exitCode;
+}
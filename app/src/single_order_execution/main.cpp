@@ -112,6 +112,7 @@ int main(int argc, char** argv) {
     eventHandler.historicalMarketDataDirectory = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_DIRECTORY");
     eventHandler.historicalMarketDataFilePrefix = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_FILE_PREFIX");
     eventHandler.historicalMarketDataFileSuffix = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_FILE_SUFFIX");
+    eventHandler.historicalMarketDataFileFormat = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_FILE_FORMAT", "csv");
   }
   std::string tradingStrategy = UtilSystem::getEnvAsString("TRADING_STRATEGY");
   APP_LOGGER_INFO("******** Trading strategy is " + tradingStrategy + "! ********");
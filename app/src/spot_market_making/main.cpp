@@ -3,6 +3,7 @@
 #else
 #include "app/event_handler_base.h"
 #endif
+#include "app/backtest_parameter_sweep.h"
 namespace ccapi {
 AppLogger appLogger;
 AppLogger* AppLogger::logger = &appLogger;
@@ -10,6 +11,7 @@ CcapiLogger ccapiLogger;
 Logger* Logger::logger = &ccapiLogger;
 } /* namespace ccapi */
 using ::ccapi::AppLogger;
+using ::ccapi::BacktestParameterSweep;
 using ::ccapi::CcapiLogger;
 using ::ccapi::Element;
 using ::ccapi::Event;
@@ -159,6 +161,7 @@ int main(int argc, char** argv) {
     eventHandler.historicalMarketDataDirectory = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_DIRECTORY");
     eventHandler.historicalMarketDataFilePrefix = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_FILE_PREFIX");
     eventHandler.historicalMarketDataFileSuffix = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_FILE_SUFFIX");
+    eventHandler.historicalMarketDataFileFormat = UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_FILE_FORMAT", "csv");
   }
   std::set<std::string> useGetAccountsToGetAccountBalancesExchangeSet{"coinbase", "kucoin"};
   if (useGetAccountsToGetAccountBalancesExchangeSet.find(eventHandler.exchange) != useGetAccountsToGetAccountBalancesExchangeSet.end()) {
@@ -239,7 +242,40 @@ int main(int argc, char** argv) {
     elementList.emplace_back(std::move(element));
     message.setElementList(elementList);
     virtualEvent.setMessageList({message});
-    eventHandler.processEvent(virtualEvent, &session);
+    std::string parameterSweepFile = UtilSystem::getEnvAsString("PARAMETER_SWEEP_FILE");
+    if (parameterSweepFile.empty()) {
+      eventHandler.processEvent(virtualEvent, &session);
+    } else {
+      auto parameterList = BacktestParameterSweep::readParameterFile(parameterSweepFile);
+      APP_LOGGER_INFO("Parameter sweep of " + std::to_string(parameterList.size()) + " runs.");
+      std::vector<std::unique_ptr<decltype(eventHandler)>> sweepEventHandlerList;
+      std::vector<EventHandlerBase*> sweepEventHandlerPtrList;
+      for (size_t i = 0; i < parameterList.size(); ++i) {
+        sweepEventHandlerList.push_back(EventHandlerBase::clone(eventHandler));
+        auto& sweepEventHandler = *sweepEventHandlerList.back();
+        sweepEventHandler.privateDataFileSuffix = eventHandler.privateDataFileSuffix + "__sweep_" + std::to_string(i);
+        sweepEventHandler.promisePtr = std::make_shared<std::promise<void>>();
+        for (const auto& kv : parameterList.at(i)) {
+          BacktestParameterSweep::setParameter(sweepEventHandler, kv.first, kv.second);
+        }
+        sweepEventHandler.replayHistoricalMarketData = false;
+        sweepEventHandler.processEvent(virtualEvent, &session);
+        sweepEventHandlerPtrList.push_back(&sweepEventHandler);
+      }
+      int numThreads = UtilSystem::getEnvAsInt("PARAMETER_SWEEP_NUM_THREADS");
+      if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      BacktestParameterSweep backtestParameterSweep(sweepEventHandlerPtrList, numThreads, UtilSystem::getEnvAsInt("PARAMETER_SWEEP_BATCH_SIZE", 10000));
+      backtestParameterSweep.run();
+      session.stop();
+      return EXIT_SUCCESS;
+    }
+  } else if (!UtilSystem::getEnvAsString("PARAMETER_SWEEP_FILE").empty()) {
+    APP_LOGGER_ERROR("PARAMETER_SWEEP_FILE requires TRADING_MODE=backtest and BASE_ASSET_OVERRIDE, QUOTE_ASSET_OVERRIDE, ORDER_PRICE_INCREMENT_OVERRIDE and "
+                     "ORDER_QUANTITY_INCREMENT_OVERRIDE.");
+    session.stop();
+    return EXIT_FAILURE;
   } else {
     session.sendRequest(request);
   }
@@ -1,136 +1,75 @@
 #ifndef INCLUDE_CCAPI_CPP_CCAPI_DECIMAL_H_
 #define INCLUDE_CCAPI_CPP_CCAPI_DECIMAL_H_
+#include <climits>
+#include <cstring>
 #include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 #include "ccapi_cpp/ccapi_logger.h"
 #include "ccapi_cpp/ccapi_util_private.h"
 namespace ccapi {
 /**
- * This class provides a numeric type for representing an arbitrary precision decimal number. It is minimalistic for the purpose of high performance.
- * Furthermore, unlike double, it is suitable for being used as the key of a map.
+ * This class provides a numeric type for representing a decimal number with up to 19 integral and 19 fractional digits. It is minimalistic for the purpose of
+ * high performance: parsing does not allocate and comparison takes a couple of integer operations. Furthermore, unlike double, it is suitable for being used
+ * as the key of a map.
  */
 class Decimal CCAPI_FINAL {
  public:
+  static constexpr int maxFracLength = 19;
+  static constexpr unsigned long long fracScale = 10000000000000000000ULL;
   Decimal() {}
   explicit Decimal(const std::string& originalValue, bool keepTrailingZero = false) {
-    if (originalValue.empty()) {
-      CCAPI_LOGGER_FATAL("Decimal constructor input value cannot be empty");
-    }
-    // std::string originalValue = originalValue;
-    // this->sign = true;
-    if (originalValue.at(0) == '-') {
-      // originalValue.erase(0, 1);
-      this->sign = false;
-    }
-    auto foundE = originalValue.find('E');
-    if (foundE != std::string::npos || originalValue.find('e') != std::string::npos) {
-      if (foundE == std::string::npos) {
-        foundE = originalValue.find('e');
-      }
-      std::string fixedPointValue = originalValue.substr(this->sign ? 0 : 1, this->sign ? foundE : foundE - 1);
-      auto foundDot = fixedPointValue.find('.');
-      if (foundDot != std::string::npos) {
-        fixedPointValue.erase(fixedPointValue.find_last_not_of('0') + 1);
-        fixedPointValue.erase(fixedPointValue.find_last_not_of('.') + 1);
-      }
-      std::string exponent = originalValue.substr(foundE + 1);
-      if (exponent.at(0) == '+') {
-        exponent.erase(0, 1);
-      }
-      exponent.erase(0, exponent.find_first_not_of('0'));
-      if (exponent.empty()) {
-        exponent = "0";
-      }
-      if (exponent != "0") {
-        foundDot = fixedPointValue.find('.');
-        if (foundDot != std::string::npos) {
-          if (exponent.at(0) != '-') {
-            if (std::stoi(exponent) < fixedPointValue.substr(foundDot + 1).length()) {
-              fixedPointValue = fixedPointValue.substr(0, foundDot) + fixedPointValue.substr(foundDot + 1).substr(0, std::stoi(exponent)) + "." +
-                                fixedPointValue.substr(foundDot + 1).substr(std::stoi(exponent));
-            } else {
-              fixedPointValue = fixedPointValue.substr(0, foundDot) + fixedPointValue.substr(foundDot + 1) +
-                                std::string(std::stoi(exponent) - fixedPointValue.substr(foundDot + 1).length(), '0');
-            }
-          } else {
-            fixedPointValue = "0." + std::string(-std::stoi(exponent) - 1, '0') + fixedPointValue.substr(0, foundDot) + fixedPointValue.substr(foundDot + 1);
-          }
-        } else {
-          if (exponent.at(0) != '-') {
-            fixedPointValue += std::string(std::stoi(exponent), '0');
-          } else {
-            fixedPointValue = "0." + std::string(-std::stoi(exponent) - 1, '0') + fixedPointValue;
-          }
-        }
-      }
-      foundDot = fixedPointValue.find('.');
-      // TODO(cryptochassis): replace with std::from_chars() once upgrade to C++17
-      this->before = std::stoull(fixedPointValue.substr(0, foundDot));
-      if (foundDot != std::string::npos) {
-        this->frac = fixedPointValue.substr(foundDot + 1);
-        if (!keepTrailingZero) {
-          this->frac.erase(this->frac.find_last_not_of('0') + 1);
-        }
-      }
-    } else {
-      auto found = originalValue.find('.');
-      // TODO(cryptochassis): replace with std::from_chars() once upgrade to C++17
-      this->before = std::stoull(originalValue.substr(this->sign ? 0 : 1, found));
-      if (found != std::string::npos) {
-        this->frac = originalValue.substr(found + 1);
-        if (!keepTrailingZero) {
-          this->frac.erase(this->frac.find_last_not_of('0') + 1);
-        }
-      }
-    }
+    this->parse(originalValue.data(), originalValue.size(), keepTrailingZero);
+  }
+  explicit Decimal(const char* originalValue, bool keepTrailingZero = false) { this->parse(originalValue, std::strlen(originalValue), keepTrailingZero); }
+  Decimal(const char* data, size_t length, bool keepTrailingZero) { this->parse(data, length, keepTrailingZero); }
+#if __cplusplus >= 201703L
+  explicit Decimal(std::string_view originalValue, bool keepTrailingZero = false) {
+    this->parse(originalValue.data(), originalValue.size(), keepTrailingZero);
   }
+#endif
   std::string toString() const {
-    std::string stringValue;
-    if (!this->sign) {
-      stringValue += "-";
+    char buffer[2 * maxFracLength + 4];
+    char* end = buffer + sizeof(buffer);
+    char* p = end;
+    if (this->fracLength > 0) {
+      unsigned long long frac = this->frac / pow10(maxFracLength - this->fracLength);
+      for (int i = 0; i < this->fracLength; ++i) {
+        *--p = '0' + frac % 10;
+        frac /= 10;
+      }
+      *--p = '.';
     }
-    stringValue += std::to_string(this->before);
-    if (!this->frac.empty()) {
-      stringValue += ".";
-      stringValue += this->frac;
+    unsigned long long before = this->before;
+    do {
+      *--p = '0' + before % 10;
+      before /= 10;
+    } while (before != 0);
+    if (!this->sign) {
+      *--p = '-';
     }
-    return stringValue;
+    return std::string(p, end - p);
   }
   double toDouble() const { return std::stod(this->toString()); }
   friend bool operator<(const Decimal& l, const Decimal& r) {
-    if (l.sign && r.sign) {
-      if (l.before < r.before) {
-        return true;
-      } else if (l.before > r.before) {
-        return false;
-      } else {
-        return l.frac < r.frac;
-      }
-    } else if (l.sign && !r.sign) {
-      return false;
-    } else if (!l.sign && r.sign) {
-      if (l.before == 0 && l.frac.empty() && r.before == 0 && r.frac.empty()) {
-        return false;
-      } else {
-        return true;
-      }
-    } else {
-      Decimal nl = l;
-      nl.sign = true;
-      Decimal nr = r;
-      nr.sign = true;
-      return nl > nr;
+    if (l.sign != r.sign) {
+      return !l.sign && !(l.isZero() && r.isZero());
     }
+    bool absoluteLess = l.before < r.before || (l.before == r.before && l.frac < r.frac);
+    bool absoluteGreater = l.before > r.before || (l.before == r.before && l.frac > r.frac);
+    return l.sign ? absoluteLess : absoluteGreater;
   }
   friend bool operator>(const Decimal& l, const Decimal& r) { return r < l; }
   friend bool operator<=(const Decimal& l, const Decimal& r) { return !(l > r); }
   friend bool operator>=(const Decimal& l, const Decimal& r) { return !(l < r); }
-  friend bool operator==(const Decimal& l, const Decimal& r) { return !(l > r) && !(l < r); }
+  friend bool operator==(const Decimal& l, const Decimal& r) {
+    return l.before == r.before && l.frac == r.frac && (l.sign == r.sign || l.isZero());
+  }
   friend bool operator!=(const Decimal& l, const Decimal& r) { return !(l == r); }
   Decimal negate() const {
-    Decimal o;
-    o.before = this->before;
-    o.frac = this->frac;
+    Decimal o = *this;
     o.sign = !this->sign;
     return o;
   }
@@ -138,49 +77,12 @@ class Decimal CCAPI_FINAL {
     if (this->sign && x.sign) {
       Decimal o;
       o.sign = true;
-      o.before = this->before + x.before;
-      if (this->frac.empty()) {
-        o.frac = x.frac;
-      } else if (x.frac.empty()) {
-        o.frac = this->frac;
-      } else {
-        auto l1 = this->frac.length();
-        auto l2 = x.frac.length();
-        if (l1 > l2) {
-          auto a = std::to_string(std::stoull(this->frac) + std::stoull(UtilString::rightPadTo(x.frac, l1, '0')));
-          if (a.length() < l1) {
-            a = UtilString::leftPadTo(a, l1, '0');
-          }
-          if (a.length() == l1) {
-            o.frac = UtilString::rtrim(a, "0");
-          } else {
-            o.frac = UtilString::rtrim(a.substr(a.length() - l1), "0");
-            o.before += std::stoull(a.substr(0, a.length() - l1));
-          }
-        } else if (l1 < l2) {
-          auto a = std::to_string(std::stoull(UtilString::rightPadTo(this->frac, l2, '0')) + std::stoull(x.frac));
-          if (a.length() < l2) {
-            a = UtilString::leftPadTo(a, l2, '0');
-          }
-          if (a.length() == l2) {
-            o.frac = UtilString::rtrim(a, "0");
-          } else {
-            o.frac = UtilString::rtrim(a.substr(a.length() - l2), "0");
-            o.before += std::stoull(a.substr(0, a.length() - l2));
-          }
-        } else {
-          auto a = std::to_string(std::stoull(this->frac) + std::stoull(x.frac));
-          if (a.length() < l1) {
-            a = UtilString::leftPadTo(a, l1, '0');
-          }
-          if (a.length() == l1) {
-            o.frac = UtilString::rtrim(a, "0");
-          } else {
-            o.frac = UtilString::rtrim(a.substr(a.length() - l1), "0");
-            o.before += std::stoull(a.substr(0, a.length() - l1));
-          }
-        }
-      }
+      // frac is below 10^19 so the sum might wrap around 2^64, in which case the modular subtraction below still yields the right remainder
+      unsigned long long frac = this->frac + x.frac;
+      bool carry = frac < this->frac || frac >= fracScale;
+      o.frac = carry ? frac - fracScale : frac;
+      o.before = this->before + x.before + (carry ? 1 : 0);
+      o.trimFracLength();
       return o;
     } else if (!this->sign && x.sign) {
       return x.subtract(this->negate());
@@ -195,22 +97,10 @@ class Decimal CCAPI_FINAL {
       if (*this >= x) {
         Decimal o;
         o.sign = true;
-        if (this->frac >= x.frac) {
-          o.before = this->before - x.before;
-        } else {
-          o.before = this->before - 1 - x.before;
-        }
-        auto l1 = this->frac.length();
-        auto l2 = x.frac.length();
-        auto lmax = std::max(l1, l2);
-        auto a = lmax > 0 ? std::to_string(std::stoull(UtilString::rightPadTo(this->frac, lmax, '0')) +
-                                           (this->frac >= x.frac ? (unsigned)0 : std::stoull(UtilString::rightPadTo("1", 1 + lmax, '0'))) -
-                                           std::stoull(UtilString::rightPadTo(x.frac, lmax, '0')))
-                          : "";
-        if (a.length() < lmax) {
-          a = UtilString::leftPadTo(a, lmax, '0');
-        }
-        o.frac = UtilString::rtrim(a, "0");
+        bool borrow = this->frac < x.frac;
+        o.frac = borrow ? this->frac + (fracScale - x.frac) : this->frac - x.frac;
+        o.before = this->before - x.before - (borrow ? 1 : 0);
+        o.trimFracLength();
         return o;
       } else {
         return x.subtract(*this).negate();
@@ -223,11 +113,130 @@ class Decimal CCAPI_FINAL {
       return x.negate().subtract(this->negate());
     }
   }
+  bool isZero() const { return this->before == 0 && this->frac == 0; }
   // {-}bbbb.aaaa
   unsigned long long before{};
-  std::string frac;
+  // the fractional digits scaled by 10^19, e.g. 0.25 has frac = 2500000000000000000
+  unsigned long long frac{};
+  // the number of fractional digits printed by toString
+  int fracLength{};
   // false means negative sign needed
   bool sign{true};
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  static unsigned long long pow10(int n) {
+    static const unsigned long long table[] = {1ULL,
+                                               10ULL,
+                                               100ULL,
+                                               1000ULL,
+                                               10000ULL,
+                                               100000ULL,
+                                               1000000ULL,
+                                               10000000ULL,
+                                               100000000ULL,
+                                               1000000000ULL,
+                                               10000000000ULL,
+                                               100000000000ULL,
+                                               1000000000000ULL,
+                                               10000000000000ULL,
+                                               100000000000000ULL,
+                                               1000000000000000ULL,
+                                               10000000000000000ULL,
+                                               100000000000000000ULL,
+                                               1000000000000000000ULL,
+                                               10000000000000000000ULL};
+    return table[n];
+  }
+  // The digits of the coefficient are data[integralBegin, integralEnd) followed by data[fractionalBegin, fractionalEnd). The decimal point sits after the
+  // first pointPosition of them, which can be negative or beyond the last digit for values in scientific notation.
+  void parse(const char* data, size_t length, bool keepTrailingZero) {
+    if (length == 0) {
+      CCAPI_LOGGER_FATAL("Decimal constructor input value cannot be empty");
+    }
+    size_t i = 0;
+    if (data[0] == '-' || data[0] == '+') {
+      this->sign = data[0] == '+';
+      ++i;
+    }
+    const size_t integralBegin = i;
+    while (i < length && data[i] >= '0' && data[i] <= '9') {
+      ++i;
+    }
+    const size_t integralEnd = i;
+    size_t fractionalBegin = i;
+    if (i < length && data[i] == '.') {
+      fractionalBegin = ++i;
+      while (i < length && data[i] >= '0' && data[i] <= '9') {
+        ++i;
+      }
+    }
+    const size_t fractionalEnd = i;
+    const long integralLength = integralEnd - integralBegin;
+    const long coefficientLength = integralLength + (fractionalEnd - fractionalBegin);
+    if (coefficientLength == 0) {
+      CCAPI_LOGGER_FATAL("Decimal constructor input value is invalid: " + std::string(data, length));
+    }
+    long pointPosition = integralLength;
+    const bool isScientific = i < length && (data[i] == 'e' || data[i] == 'E');
+    if (isScientific) {
+      ++i;
+      bool exponentSign = true;
+      if (i < length && (data[i] == '-' || data[i] == '+')) {
+        exponentSign = data[i] == '+';
+        ++i;
+      }
+      if (i == length) {
+        CCAPI_LOGGER_FATAL("Decimal constructor input value is invalid: " + std::string(data, length));
+      }
+      long exponent = 0;
+      for (; i < length && data[i] >= '0' && data[i] <= '9' && exponent < 1000; ++i) {
+        exponent = exponent * 10 + (data[i] - '0');
+      }
+      pointPosition += exponentSign ? exponent : -exponent;
+    }
+    if (i != length) {
+      CCAPI_LOGGER_FATAL("Decimal constructor input value is invalid: " + std::string(data, length));
+    }
+    auto digitAt = [&](long k) -> int {
+      if (k < 0 || k >= coefficientLength) {
+        return 0;
+      }
+      return k < integralLength ? data[integralBegin + k] - '0' : data[fractionalBegin + k - integralLength] - '0';
+    };
+    for (long k = 0; k < pointPosition; ++k) {
+      const int digit = digitAt(k);
+      if (this->before > (ULLONG_MAX - digit) / 10) {
+        CCAPI_LOGGER_FATAL("Decimal constructor input value is too large: " + std::string(data, length));
+      }
+      this->before = this->before * 10 + digit;
+    }
+    long fracLength = std::max(coefficientLength - pointPosition, 0L);
+    if (isScientific || !keepTrailingZero) {
+      while (fracLength > 0 && digitAt(pointPosition + fracLength - 1) == 0) {
+        --fracLength;
+      }
+    }
+    if (fracLength > maxFracLength) {
+      CCAPI_LOGGER_FATAL("Decimal constructor input value has too many fractional digits: " + std::string(data, length));
+    }
+    for (long k = 0; k < fracLength; ++k) {
+      this->frac = this->frac * 10 + digitAt(pointPosition + k);
+    }
+    this->frac *= pow10(maxFracLength - fracLength);
+    this->fracLength = fracLength;
+  }
+  void trimFracLength() {
+    this->fracLength = maxFracLength;
+    if (this->frac == 0) {
+      this->fracLength = 0;
+    } else {
+      while (this->frac % pow10(maxFracLength - this->fracLength + 1) == 0) {
+        --this->fracLength;
+      }
+    }
+  }
 };
 } /* namespace ccapi */
 #endif  // INCLUDE_CCAPI_CPP_CCAPI_DECIMAL_H_
@@ -1,54 +1,123 @@
 #ifndef INCLUDE_CCAPI_CPP_CCAPI_ELEMENT_H_
 #define INCLUDE_CCAPI_CPP_CCAPI_ELEMENT_H_
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ccapi_cpp/ccapi_util_private.h"
 namespace ccapi {
 /**
  * Element represents an item in a message. The value(s) in an Element can be queried in a number of ways. Use the getValue() functions to retrieve a single
- * value. Use the getNameValueMap() function (or getTagValueMap() function for FIX API) to retrieve all the values.
+ * value. Use the getNameValueMap() function (or getTagValueMap() function for FIX API) to retrieve all the values. An Element usually holds only a few short
+ * name value pairs, so they are stored contiguously in insertion order and looked up linearly. Use getNameValueList() (or getTagValueList() for FIX API) to
+ * iterate over them without building a map. The map returned by getNameValueMap() (or getTagValueMap()) is built on the first call and kept until the
+ * Element is modified.
  */
 class Element CCAPI_FINAL {
  public:
   explicit Element(bool isFix = false) : isFix(isFix) {}
-  void insert(const std::string& name, const std::string& value) { this->nameValueMap.insert(std::pair<std::string, std::string>(name, value)); }
-  void insert(int tag, const std::string& value) { this->tagValueMap.insert(std::pair<int, std::string>(tag, value)); }
-  void emplace(std::string& name, std::string& value) { this->nameValueMap.emplace(std::move(name), std::move(value)); }
-  void emplace(int tag, std::string& value) { this->tagValueMap.emplace(std::move(tag), std::move(value)); }
-  bool has(const std::string& name) const { return this->nameValueMap.find(name) != this->nameValueMap.end(); }
-  bool has(int tag) const { return this->tagValueMap.find(tag) != this->tagValueMap.end(); }
+  // As with std::map::insert, a name (or tag) which is already present isn't overwritten.
+  void insert(const std::string& name, const std::string& value) {
+    if (!this->has(name)) {
+      this->nameValueList.emplace_back(name, value);
+      this->nameValueMap.reset();
+    }
+  }
+  void insert(int tag, const std::string& value) {
+    if (!this->has(tag)) {
+      this->tagValueList.emplace_back(tag, value);
+      this->tagValueMap.reset();
+    }
+  }
+  void emplace(std::string& name, std::string& value) {
+    if (!this->has(name)) {
+      this->nameValueList.emplace_back(std::move(name), std::move(value));
+      this->nameValueMap.reset();
+    }
+  }
+  void emplace(int tag, std::string& value) {
+    if (!this->has(tag)) {
+      this->tagValueList.emplace_back(tag, std::move(value));
+      this->tagValueMap.reset();
+    }
+  }
+  void reserve(size_t n) {
+    if (this->isFix) {
+      this->tagValueList.reserve(n);
+    } else {
+      this->nameValueList.reserve(n);
+    }
+  }
+  bool has(const std::string& name) const { return this->find(name) != nullptr; }
+  bool has(int tag) const { return this->find(tag) != nullptr; }
   std::string getValue(const std::string& name, const std::string valueDefault = "") const {
-    auto it = this->nameValueMap.find(name);
-    return it == this->nameValueMap.end() ? valueDefault : it->second;
+    const std::string* value = this->find(name);
+    return value ? *value : valueDefault;
   }
   std::string getValue(int tag, const std::string valueDefault = "") const {
-    auto it = this->tagValueMap.find(tag);
-    return it == this->tagValueMap.end() ? valueDefault : it->second;
+    const std::string* value = this->find(tag);
+    return value ? *value : valueDefault;
   }
   std::string toString() const {
-    std::string output =
-        isFix ? "Element [tagValueMap = " + ccapi::toString(tagValueMap) + "]" : "Element [nameValueMap = " + ccapi::toString(nameValueMap) + "]";
+    std::string output = isFix ? "Element [tagValueMap = " + ccapi::toString(this->getTagValueMap()) + "]"
+                               : "Element [nameValueMap = " + ccapi::toString(this->getNameValueMap()) + "]";
     return output;
   }
   std::string toStringPretty(const int space = 2, const int leftToIndent = 0, const bool indentFirstLine = true) const {
     std::string sl(leftToIndent, ' ');
     std::string ss(leftToIndent + space, ' ');
     std::string output = isFix ? (indentFirstLine ? sl : "") + "Element [\n" + ss +
-                                     "tagValueMap = " + ccapi::toStringPretty(tagValueMap, space, space + leftToIndent, false) + "\n" + sl + "]"
+                                     "tagValueMap = " + ccapi::toStringPretty(this->getTagValueMap(), space, space + leftToIndent, false) + "\n" + sl + "]"
                                : (indentFirstLine ? sl : "") + "Element [\n" + ss +
-                                     "nameValueMap = " + ccapi::toStringPretty(nameValueMap, space, space + leftToIndent, false) + "\n" + sl + "]";
+                                     "nameValueMap = " + ccapi::toStringPretty(this->getNameValueMap(), space, space + leftToIndent, false) + "\n" + sl + "]";
     return output;
   }
-  const std::map<std::string, std::string>& getNameValueMap() const { return nameValueMap; }
-  const std::map<int, std::string>& getTagValueMap() const { return tagValueMap; }
+  // The returned reference stays valid until the Element is modified.
+  const std::map<std::string, std::string>& getNameValueMap() const { return getMap(this->nameValueMap, this->nameValueList); }
+  const std::map<int, std::string>& getTagValueMap() const { return getMap(this->tagValueMap, this->tagValueList); }
+  const std::vector<std::pair<std::string, std::string> >& getNameValueList() const { return nameValueList; }
+  const std::vector<std::pair<int, std::string> >& getTagValueList() const { return tagValueList; }
 #ifndef CCAPI_EXPOSE_INTERNAL
 
  private:
 #endif
+  const std::string* find(const std::string& name) const {
+    for (const auto& x : this->nameValueList) {
+      if (x.first == name) {
+        return &x.second;
+      }
+    }
+    return nullptr;
+  }
+  const std::string* find(int tag) const {
+    for (const auto& x : this->tagValueList) {
+      if (x.first == tag) {
+        return &x.second;
+      }
+    }
+    return nullptr;
+  }
+  // Const member functions may be called concurrently, so the map is published atomically. If two threads build it at the same time, one of them is kept.
+  template <typename K>
+  static const std::map<K, std::string>& getMap(std::shared_ptr<const std::map<K, std::string> >& cache,
+                                                const std::vector<std::pair<K, std::string> >& list) {
+    auto map = std::atomic_load(&cache);
+    if (!map) {
+      std::shared_ptr<const std::map<K, std::string> > expected;
+      map = std::make_shared<const std::map<K, std::string> >(list.begin(), list.end());
+      if (!std::atomic_compare_exchange_strong(&cache, &expected, map)) {
+        map = expected;
+      }
+    }
+    return *map;
+  }
   bool isFix;
-  std::map<std::string, std::string> nameValueMap;
-  std::map<int, std::string> tagValueMap;
+  std::vector<std::pair<std::string, std::string> > nameValueList;
+  std::vector<std::pair<int, std::string> > tagValueList;
+  mutable std::shared_ptr<const std::map<std::string, std::string> > nameValueMap;
+  mutable std::shared_ptr<const std::map<int, std::string> > tagValueMap;
 };
 } /* namespace ccapi */
 #endif  // INCLUDE_CCAPI_CPP_CCAPI_ELEMENT_H_
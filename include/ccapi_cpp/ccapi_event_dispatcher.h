@@ -1,12 +1,17 @@
 #ifndef INCLUDE_CCAPI_CPP_CCAPI_EVENT_DISPATCHER_H_
 #define INCLUDE_CCAPI_CPP_CCAPI_EVENT_DISPATCHER_H_
+#ifndef CCAPI_EVENT_DISPATCHER_SHARD_BATCH_SIZE
+#define CCAPI_EVENT_DISPATCHER_SHARD_BATCH_SIZE 64
+#endif
 #include <stddef.h>
 
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -17,30 +22,56 @@ namespace ccapi {
  * Dispatches events from one or more Sessions through callbacks. EventDispatcher objects are optionally specified when Session objects are constructed. A
  * single EventDispatcher can be shared by multiple Session objects. The EventDispatcher provides an event-driven interface, generating callbacks from one or
  * more internal threads for one or more sessions.
+ *
+ * If numShards is 0, all operations share a single queue and are executed in dispatch order only when there is one dispatcher thread. If numShards is
+ * positive, an operation dispatched with a key (e.g. a correlation id) is put onto the lock-free queue of the shard that the key hashes to. A shard is executed
+ * by at most one dispatcher thread at a time, so operations with the same key stay in dispatch order while different shards are executed in parallel. Each
+ * dispatcher thread starts scanning from its own shards and idle dispatcher threads take over whole shards which aren't being executed.
  */
 
 class EventDispatcher CCAPI_FINAL {
  public:
-  explicit EventDispatcher(const int numDispatcherThreads = 1) : numDispatcherThreads(numDispatcherThreads) {
+  explicit EventDispatcher(const int numDispatcherThreads = 1, const int numShards = 0)
+      : numDispatcherThreads(numDispatcherThreads), numShards(numShards > 0 ? numShards : 0), shardList(new Shard[this->numShards]) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     CCAPI_LOGGER_TRACE("numDispatcherThreads = " + size_tToString(numDispatcherThreads));
+    CCAPI_LOGGER_TRACE("numShards = " + size_tToString(this->numShards));
     this->start();
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
   ~EventDispatcher() {
     CCAPI_LOGGER_FUNCTION_ENTER;
+    for (size_t i = 0; i < this->numShards; ++i) {
+      while (Node* node = this->shardList[i].pop()) {
+        delete node;
+      }
+    }
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
-  void dispatch(const std::function<void()>& op) {
+  void dispatch(const std::function<void()>& op) { this->dispatch(std::string(), op); }
+  // Operations dispatched with the same key are executed in dispatch order. The key is ignored if numShards is 0.
+  void dispatch(const std::string& key, const std::function<void()>& op) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     if (this->shouldContinue.load()) {
       CCAPI_LOGGER_TRACE("start to dispatch an operation");
-      std::unique_lock<std::mutex> lock(this->lock);
-      this->queue.push(op);
-      // Manual unlocking is done before notifying, to avoid waking up
-      // the waiting thread only to block again (see notify_one for details)
-      lock.unlock();
-      this->cv.notify_all();
+      if (this->numShards > 0) {
+        Node* node = new Node();
+        node->op = op;
+        this->shardList[std::hash<std::string>()(key) % this->numShards].push(node);
+        this->generation.fetch_add(1);
+        if (this->numSleepingThreads.load() > 0) {
+          // Acquiring the lock guarantees that a thread which has just decided to sleep is already waiting.
+          { std::lock_guard<std::mutex> lock(this->lock); }
+          this->cv.notify_one();
+        }
+      } else {
+        std::unique_lock<std::mutex> lock(this->lock);
+        this->queue.push(op);
+        // Manual unlocking is done before notifying, to avoid waking up
+        // the waiting thread only to block again (see notify_one for details)
+        lock.unlock();
+        this->cv.notify_one();
+      }
     } else {
       CCAPI_LOGGER_WARN("dispatching of events were paused");
     }
@@ -49,7 +80,11 @@ class EventDispatcher CCAPI_FINAL {
   void start() {
     this->shouldContinue = true;
     for (size_t i = 0; i < numDispatcherThreads; i++) {
-      this->dispatcherThreads.push_back(std::thread(&EventDispatcher::dispatch_thread_handler, this));
+      if (this->numShards > 0) {
+        this->dispatcherThreads.push_back(std::thread(&EventDispatcher::dispatch_sharded_thread_handler, this, i));
+      } else {
+        this->dispatcherThreads.push_back(std::thread(&EventDispatcher::dispatch_thread_handler, this));
+      }
     }
   }
   void resume() { this->shouldContinue = true; }
@@ -57,16 +92,62 @@ class EventDispatcher CCAPI_FINAL {
   void stop() {
     std::unique_lock<std::mutex> lock(this->lock);
     this->quit = true;
+    this->quitFlag.store(true, std::memory_order_release);
     lock.unlock();
     this->cv.notify_all();
     for (auto& dispatcherThread : this->dispatcherThreads) {
       dispatcherThread.join();
     }
   }
+  size_t getNumShards() const { return this->numShards; }
 #ifndef CCAPI_EXPOSE_INTERNAL
 
  private:
 #endif
+  struct Node {
+    std::atomic<Node*> next{};
+    std::function<void()> op;
+  };
+  // An intrusive multiple producer single consumer queue. The dispatcher thread which has claimed the shard is its only consumer.
+  struct Shard {
+    Shard() : head(&stub), tail(&stub) {}
+    void push(Node* node) {
+      node->next.store(nullptr, std::memory_order_relaxed);
+      Node* previous = this->head.exchange(node, std::memory_order_acq_rel);
+      previous->next.store(node, std::memory_order_release);
+    }
+    // Returns nullptr if the shard is empty or if a producer is in the middle of a push.
+    Node* pop() {
+      Node* tail = this->tail;
+      Node* next = tail->next.load(std::memory_order_acquire);
+      if (tail == &this->stub) {
+        if (!next) {
+          return nullptr;
+        }
+        this->tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+      }
+      if (next) {
+        this->tail = next;
+        return tail;
+      }
+      if (tail != this->head.load(std::memory_order_acquire)) {
+        return nullptr;
+      }
+      this->push(&this->stub);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next) {
+        this->tail = next;
+        return tail;
+      }
+      return nullptr;
+    }
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) Node* tail;
+    Node stub;
+    std::atomic<bool> claimed{};
+  };
   void dispatch_thread_handler() {
     CCAPI_LOGGER_FUNCTION_ENTER;
     std::unique_lock<std::mutex> lock(this->lock);
@@ -85,13 +166,51 @@ class EventDispatcher CCAPI_FINAL {
     } while (!this->quit);
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
+  void dispatch_sharded_thread_handler(size_t threadIndex) {
+    CCAPI_LOGGER_FUNCTION_ENTER;
+    size_t firstShardIndex = threadIndex * this->numShards / this->numDispatcherThreads;
+    while (!this->quitFlag.load(std::memory_order_acquire)) {
+      auto generation = this->generation.load();
+      bool executed = false;
+      for (size_t i = 0; i < this->numShards; ++i) {
+        Shard& shard = this->shardList[(firstShardIndex + i) % this->numShards];
+        if (shard.claimed.load(std::memory_order_relaxed) || shard.claimed.exchange(true, std::memory_order_acquire)) {
+          continue;
+        }
+        for (int j = 0; j < CCAPI_EVENT_DISPATCHER_SHARD_BATCH_SIZE; ++j) {
+          Node* node = shard.pop();
+          if (!node) {
+            break;
+          }
+          executed = true;
+          std::function<void()> op = std::move(node->op);
+          delete node;
+          op();
+        }
+        shard.claimed.store(false, std::memory_order_release);
+      }
+      if (!executed) {
+        // Shards which were claimed by other dispatcher threads during the scan are rescanned by those threads before they go to sleep.
+        std::unique_lock<std::mutex> lock(this->lock);
+        this->numSleepingThreads.fetch_add(1);
+        this->cv.wait(lock, [&] { return this->quit || this->generation.load() != generation; });
+        this->numSleepingThreads.fetch_sub(1);
+      }
+    }
+    CCAPI_LOGGER_FUNCTION_EXIT;
+  }
   size_t numDispatcherThreads;
+  size_t numShards;
+  std::unique_ptr<Shard[]> shardList;
   std::atomic<bool> shouldContinue{};
   std::vector<std::thread> dispatcherThreads;
   std::mutex lock;
   std::queue<std::function<void()> > queue;
   std::condition_variable cv;
   bool quit{};
+  std::atomic<bool> quitFlag{};
+  std::atomic<size_t> generation{};
+  std::atomic<size_t> numSleepingThreads{};
 };
 } /* namespace ccapi */
 #endif  // INCLUDE_CCAPI_CPP_CCAPI_EVENT_DISPATCHER_H_
@@ -0,0 +1,54 @@
+#ifndef INCLUDE_CCAPI_CPP_CCAPI_FIX_HANDLER_H_
+#define INCLUDE_CCAPI_CPP_CCAPI_FIX_HANDLER_H_
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ccapi_cpp/ccapi_util_private.h"
+namespace ccapi {
+/**
+ * The commonly used fields of an ExecutionReport (msgType '8'), OrderCancelReject ('9'), Reject ('3') or BusinessMessageReject ('j') as sent by the exchange.
+ * The string fields refer to the received bytes (empty if absent) and are only valid during the callback. Prices and quantities are kept as sent so that they
+ * can be parsed with the precision the application needs. rejectReason holds OrdRejReason (103), CxlRejReason (102), SessionRejectReason (373) or
+ * BusinessRejectReason (380), whichever applies to msgType. Single character fields are '\0' if absent.
+ */
+struct FixReport {
+  const std::vector<std::string>* correlationIdList{};
+  char msgType{};
+  int64_t msgSeqNum{};
+  std::string_view sendingTime;
+  std::string_view clOrdId;
+  std::string_view origClOrdId;
+  std::string_view orderId;
+  std::string_view execId;
+  char execType{};
+  char ordStatus{};
+  std::string_view symbol;
+  char side{};
+  std::string_view price;
+  std::string_view orderQty;
+  std::string_view lastPx;
+  std::string_view lastQty;
+  std::string_view leavesQty;
+  std::string_view cumQty;
+  std::string_view avgPx;
+  std::string_view transactTime;
+  std::string_view rejectReason;
+  int64_t refSeqNum{};
+  std::string_view refMsgType;
+  std::string_view text;
+  TimePoint recvTs{std::chrono::seconds{0}};
+};
+/**
+ * Defines the typed FIX callback supplied by latency sensitive applications. It is invoked synchronously on the thread which reads the FIX connection, directly
+ * from the received bytes without building an Element, so it must not block.
+ */
+class FixHandler {
+ public:
+  virtual ~FixHandler() {}
+  virtual void onFixReport(const FixReport& fixReport) {}
+};
+} /* namespace ccapi */
+#endif  // INCLUDE_CCAPI_CPP_CCAPI_FIX_HANDLER_H_
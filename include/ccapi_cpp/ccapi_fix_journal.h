@@ -0,0 +1,119 @@
+#ifndef INCLUDE_CCAPI_CPP_CCAPI_FIX_JOURNAL_H_
+#define INCLUDE_CCAPI_CPP_CCAPI_FIX_JOURNAL_H_
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "ccapi_cpp/ccapi_macro.h"
+namespace ccapi {
+/**
+ * A memory-mapped, append-only journal of one FIX session. It keeps the raw bytes of every outbound message with its MsgSeqNum, together with the last
+ * MsgSeqNum sent and received, so that a reconnect (also from a restarted process) can resume the session and answer a ResendRequest. The file is created with
+ * a fixed size; once it is full, messages are no longer journaled but the sequence numbers are still tracked. Data is written to the mapped pages, i.e. it
+ * survives the process but is only guaranteed to reach the disk after flush().
+ */
+class FixJournal CCAPI_FINAL {
+ public:
+  explicit FixJournal(const std::string& filePath, size_t sizeBytes = 1 << 26) {
+    std::ifstream ifs(filePath, std::ios::binary | std::ios::ate);
+    bool isNew = !ifs.good() || static_cast<size_t>(ifs.tellg()) < sizeof(Header);
+    ifs.close();
+    if (isNew) {
+      std::ofstream ofs(filePath, std::ios::binary | std::ios::trunc);
+      ofs.seekp(std::max(sizeBytes, sizeof(Header)) - 1);
+      ofs.put('\0');
+      if (!ofs.good()) {
+        throw std::runtime_error("cannot create FIX journal " + filePath);
+      }
+    }
+    this->fileMapping = boost::interprocess::file_mapping(filePath.c_str(), boost::interprocess::read_write);
+    this->mappedRegion = boost::interprocess::mapped_region(this->fileMapping, boost::interprocess::read_write);
+    this->data = static_cast<char*>(this->mappedRegion.get_address());
+    this->capacity = this->mappedRegion.get_size();
+    if (isNew) {
+      this->reset();
+    } else if (std::memcmp(this->header().magic, magic, sizeof(magic)) != 0 || this->header().numBytesUsed > this->capacity) {
+      throw std::runtime_error(filePath + " is not a FIX journal");
+    }
+    size_t offset = sizeof(Header);
+    while (offset + sizeof(RecordHeader) <= this->header().numBytesUsed) {
+      RecordHeader recordHeader;
+      std::memcpy(&recordHeader, this->data + offset, sizeof(RecordHeader));
+      this->offsetBySequenceList.emplace_back(recordHeader.msgSeqNum, offset);
+      offset += sizeof(RecordHeader) + recordHeader.numBytes;
+    }
+  }
+  FixJournal(const FixJournal&) = delete;
+  FixJournal& operator=(const FixJournal&) = delete;
+  int64_t getLastSequenceSent() const { return this->header().lastSequenceSent; }
+  int64_t getLastSequenceReceived() const { return this->header().lastSequenceReceived; }
+  void setLastSequenceReceived(int64_t msgSeqNum) { this->header().lastSequenceReceived = msgSeqNum; }
+  size_t getNumMessages() const { return this->offsetBySequenceList.size(); }
+  // Records an outbound message and returns false if it didn't fit, in which case only the last MsgSeqNum sent is updated.
+  bool append(int64_t msgSeqNum, const char* message, size_t numBytes) {
+    this->header().lastSequenceSent = msgSeqNum;
+    size_t offset = this->header().numBytesUsed;
+    if (offset + sizeof(RecordHeader) + numBytes > this->capacity) {
+      return false;
+    }
+    RecordHeader recordHeader{static_cast<uint32_t>(numBytes), msgSeqNum};
+    std::memcpy(this->data + offset, &recordHeader, sizeof(RecordHeader));
+    std::memcpy(this->data + offset + sizeof(RecordHeader), message, numBytes);
+    // The record becomes visible only after it has been completely written, so that a crash in between doesn't leave a torn record.
+    this->header().numBytesUsed = offset + sizeof(RecordHeader) + numBytes;
+    this->offsetBySequenceList.emplace_back(msgSeqNum, offset);
+    return true;
+  }
+  // Calls f(msgSeqNum, message, numBytes) for the journaled outbound messages with beginSeqNo <= msgSeqNum <= endSeqNo (endSeqNo 0 means infinity) in order.
+  template <typename F>
+  void forEachMessage(int64_t beginSeqNo, int64_t endSeqNo, F f) const {
+    auto it = std::lower_bound(this->offsetBySequenceList.begin(), this->offsetBySequenceList.end(), std::make_pair(beginSeqNo, size_t(0)));
+    for (; it != this->offsetBySequenceList.end() && (endSeqNo == 0 || it->first <= endSeqNo); ++it) {
+      RecordHeader recordHeader;
+      std::memcpy(&recordHeader, this->data + it->second, sizeof(RecordHeader));
+      f(recordHeader.msgSeqNum, this->data + it->second + sizeof(RecordHeader), static_cast<size_t>(recordHeader.numBytes));
+    }
+  }
+  // Discards all messages and sequence numbers, e.g. when the session is reset by a logon with ResetSeqNumFlag.
+  void reset() {
+    Header& header = this->header();
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.numBytesUsed = sizeof(Header);
+    header.lastSequenceSent = 0;
+    header.lastSequenceReceived = 0;
+    this->offsetBySequenceList.clear();
+  }
+  void flush() { this->mappedRegion.flush(); }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  static constexpr char magic[8] = {'C', 'C', 'A', 'P', 'I', 'F', 'J', '1'};
+  struct Header {
+    char magic[8];
+    uint64_t numBytesUsed;
+    int64_t lastSequenceSent;
+    int64_t lastSequenceReceived;
+  };
+  struct RecordHeader {
+    uint32_t numBytes;
+    int64_t msgSeqNum;
+  };
+  Header& header() { return *reinterpret_cast<Header*>(this->data); }
+  const Header& header() const { return *reinterpret_cast<const Header*>(this->data); }
+  boost::interprocess::file_mapping fileMapping;
+  boost::interprocess::mapped_region mappedRegion;
+  char* data{};
+  size_t capacity{};
+  std::vector<std::pair<int64_t, size_t> > offsetBySequenceList;
+};
+} /* namespace ccapi */
+#endif  // INCLUDE_CCAPI_CPP_CCAPI_FIX_JOURNAL_H_
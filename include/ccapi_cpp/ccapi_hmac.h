@@ -2493,8 +2493,15 @@ inline int hmacResult(HMACContext *ctx, uint8_t *digest) {
          USHAResult(&ctx->shaContext, digest);
 }
 }
+#include <cstring>
+#include <string_view>
+
 #include "ccapi_cpp/ccapi_logger.h"
 #include "ccapi_cpp/ccapi_macro.h"
+#include "ccapi_cpp/ccapi_util_private.h"
+#ifdef CCAPI_SHA_USE_OPENSSL
+#include <openssl/sha.h>
+#endif
 namespace ccapi {
 class Hmac CCAPI_FINAL {
   // https://github.com/Yubico/yubico-c-client/blob/ykclient-2.15/sha384-512.c
@@ -2507,51 +2514,139 @@ class Hmac CCAPI_FINAL {
     SHA384,
     SHA512,
   };
-  static std::string hmacYubico(const ShaVersion shaVersion, const std::string &key, const std::string &msg, bool returnHex = false) {
-    yubico::SHAversion whichSha{};
-    int shaHashSize{};
+  /**
+   * The key schedule of an hmac key, i.e. the hash states after absorbing the key XORed with the inner and the outer pad. Signing a message copies these
+   * states and hashes only the message and the inner digest, so it doesn't need the key, allocates nothing and is safe to call concurrently.
+   */
+  class Key CCAPI_FINAL {
+   public:
+    Key() {}
+    Key(const ShaVersion shaVersion, const std::string &key) {
+#ifdef CCAPI_SHA_USE_OPENSSL
+      if (shaVersion == ShaVersion::SHA256) {
+        this->useOpenssl = true;
+        this->hashSize = SHA256_DIGEST_LENGTH;
+        unsigned char keyBlock[SHA256_CBLOCK]{};
+        if (key.length() > SHA256_CBLOCK) {
+          SHA256(reinterpret_cast<const unsigned char *>(key.data()), key.length(), keyBlock);
+        } else {
+          std::memcpy(keyBlock, key.data(), key.length());
+        }
+        unsigned char pad[SHA256_CBLOCK];
+        for (int i = 0; i < SHA256_CBLOCK; ++i) {
+          pad[i] = keyBlock[i] ^ 0x36;
+        }
+        SHA256_Init(&this->opensslInnerContext);
+        SHA256_Update(&this->opensslInnerContext, pad, SHA256_CBLOCK);
+        for (int i = 0; i < SHA256_CBLOCK; ++i) {
+          pad[i] = keyBlock[i] ^ 0x5c;
+        }
+        SHA256_Init(&this->opensslOuterContext);
+        SHA256_Update(&this->opensslOuterContext, pad, SHA256_CBLOCK);
+        return;
+      }
+#endif
+      yubico::SHAversion whichSha = toYubicoShaVersion(shaVersion);
+      yubico::HMACContext context;
+      int err = yubico::hmacReset(&context, whichSha, reinterpret_cast<const unsigned char *>(key.data()), key.length()) ||
+                yubico::USHAReset(&this->outerContext, whichSha) || yubico::USHAInput(&this->outerContext, context.k_opad, context.blockSize);
+      if (err != yubico::shaSuccess) {
+        throw std::runtime_error("hmac sha error");
+      }
+      this->innerContext = context.shaContext;
+      this->hashSize = context.hashSize;
+    }
+    // Writes the raw signature of message into digest, which must have room for yubico::USHAMaxHashSize bytes, and returns its length.
+    size_t computeDigest(std::string_view message, unsigned char *digest) const {
+#ifdef CCAPI_SHA_USE_OPENSSL
+      if (this->useOpenssl) {
+        SHA256_CTX context = this->opensslInnerContext;
+        SHA256_Update(&context, message.data(), message.length());
+        SHA256_Final(digest, &context);
+        context = this->opensslOuterContext;
+        SHA256_Update(&context, digest, SHA256_DIGEST_LENGTH);
+        SHA256_Final(digest, &context);
+        return this->hashSize;
+      }
+#endif
+      yubico::USHAContext context = this->innerContext;
+      int err = yubico::USHAInput(&context, reinterpret_cast<const uint8_t *>(message.data()), message.length()) || yubico::USHAResult(&context, digest);
+      context = this->outerContext;
+      err = err || yubico::USHAInput(&context, digest, this->hashSize) || yubico::USHAResult(&context, digest);
+      if (err != yubico::shaSuccess) {
+        throw std::runtime_error("hmac sha error");
+      }
+      return this->hashSize;
+    }
+    // Appends the hex encoded signature of message to output. message may refer to output.
+    void appendHex(std::string &output, std::string_view message) const {
+      unsigned char digest[yubico::USHAMaxHashSize];
+      size_t digestSize = this->computeDigest(message, digest);
+      UtilAlgorithm::appendHex(output, digest, digestSize);
+    }
+    // Appends the base64 encoded signature of message to output. message may refer to output.
+    void appendBase64(std::string &output, std::string_view message) const {
+      unsigned char digest[yubico::USHAMaxHashSize];
+      size_t digestSize = this->computeDigest(message, digest);
+      UtilAlgorithm::appendBase64(output, digest, digestSize);
+    }
+    std::string sign(std::string_view message, bool returnHex = false) const {
+      unsigned char digest[yubico::USHAMaxHashSize];
+      size_t digestSize = this->computeDigest(message, digest);
+      std::string output;
+      if (returnHex) {
+        UtilAlgorithm::appendHex(output, digest, digestSize);
+      } else {
+        output.assign(reinterpret_cast<const char *>(digest), digestSize);
+      }
+      return output;
+    }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+   private:
+#endif
+    yubico::USHAContext innerContext{};
+    yubico::USHAContext outerContext{};
+    int hashSize{};
+#ifdef CCAPI_SHA_USE_OPENSSL
+    bool useOpenssl{};
+    SHA256_CTX opensslInnerContext{};
+    SHA256_CTX opensslOuterContext{};
+#endif
+  };
+  static yubico::SHAversion toYubicoShaVersion(const ShaVersion shaVersion) {
     switch (shaVersion) {
       case ShaVersion::SHA1:
-        whichSha = yubico::SHAversion::SHA1;
-        shaHashSize = yubico::SHA1HashSize;
-        break;
+        return yubico::SHAversion::SHA1;
       case ShaVersion::SHA224:
-        whichSha = yubico::SHAversion::SHA224;
-        shaHashSize = yubico::SHA224HashSize;
-        break;
+        return yubico::SHAversion::SHA224;
       case ShaVersion::SHA256:
-        whichSha = yubico::SHAversion::SHA256;
-        shaHashSize = yubico::SHA256HashSize;
-        break;
+        return yubico::SHAversion::SHA256;
       case ShaVersion::SHA384:
-        whichSha = yubico::SHAversion::SHA384;
-        shaHashSize = yubico::SHA384HashSize;
-        break;
+        return yubico::SHAversion::SHA384;
       case ShaVersion::SHA512:
-        whichSha = yubico::SHAversion::SHA512;
-        shaHashSize = yubico::SHA512HashSize;
-        break;
+        return yubico::SHAversion::SHA512;
       default:
         CCAPI_LOGGER_FATAL(CCAPI_UNSUPPORTED_VALUE);
     }
+    return yubico::SHAversion::SHA256;
+  }
+  static std::string hmacYubico(const ShaVersion shaVersion, const std::string &key, const std::string &msg, bool returnHex = false) {
+    yubico::SHAversion whichSha = toYubicoShaVersion(shaVersion);
     uint8_t digest[yubico::USHAMaxHashSize];
     int err = yubico::hmac(whichSha, reinterpret_cast<unsigned char *>(const_cast<char *>(msg.c_str())), msg.length(),
                            reinterpret_cast<unsigned char *>(const_cast<char *>(key.c_str())), key.length(), digest);
     if (err != yubico::shaSuccess) {
       throw std::runtime_error("hmac sha error");
     }
-    std::stringstream ss;
+    int shaHashSize = yubico::USHAHashSize(whichSha);
+    std::string output;
     if (returnHex) {
-      ss << std::hex << std::setfill('0');
-      for (int i = 0; i < shaHashSize; i++) {
-        ss << std::hex << std::setw(2) << (unsigned int)digest[i];
-      }
+      UtilAlgorithm::appendHex(output, digest, shaHashSize);
     } else {
-      for (int i = 0; i < shaHashSize; i++) {
-        ss << (char)digest[i];
-      }
+      output.assign(reinterpret_cast<const char *>(digest), shaHashSize);
     }
-    return ss.str();
+    return output;
   }
   static std::string hmac(const ShaVersion shaVersion, const std::string &key, const std::string &msg, bool returnHex = false) {
 #ifdef CCAPI_SHA_USE_OPENSSL
@@ -2563,18 +2658,13 @@ class Hmac CCAPI_FINAL {
       unsigned int len = 32;
       HMAC_Final(hmac, hash, &len);
       HMAC_CTX_free(hmac);
-      std::stringstream ss;
+      std::string output;
       if (returnHex) {
-        ss << std::hex << std::setfill('0');
-        for (int i = 0; i < len; i++) {
-          ss << std::hex << std::setw(2) << (unsigned int)hash[i];
-        }
+        UtilAlgorithm::appendHex(output, hash, len);
       } else {
-        for (int i = 0; i < len; i++) {
-          ss << (char)hash[i];
-        }
+        output.assign(reinterpret_cast<const char *>(hash), len);
       }
-      return (ss.str());
+      return output;
     } else {
       return hmacYubico(shaVersion, key, msg, returnHex);
     }
@@ -0,0 +1,141 @@
+#ifndef INCLUDE_CCAPI_CPP_CCAPI_LATENCY_HISTOGRAM_H_
+#define INCLUDE_CCAPI_CPP_CCAPI_LATENCY_HISTOGRAM_H_
+#ifndef CCAPI_LATENCY_HISTOGRAM_SUB_BUCKET_BITS
+#define CCAPI_LATENCY_HISTOGRAM_SUB_BUCKET_BITS 5
+#endif
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include "ccapi_cpp/ccapi_logger.h"
+namespace ccapi {
+/**
+ * An HDR-style histogram of non-negative latencies in nanoseconds. Values below 2^CCAPI_LATENCY_HISTOGRAM_SUB_BUCKET_BITS are recorded exactly. Larger values
+ * are recorded into one of 2^(CCAPI_LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1) linear sub-buckets per power of two, i.e. with a relative error below 2^-(
+ * CCAPI_LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1). Recording is wait-free and the counts can be read from other threads at any time.
+ */
+class LatencyHistogram CCAPI_FINAL {
+ public:
+  enum class Stage {
+    DECOMPRESS,                        // inflating a compressed websocket message
+    PROCESS_TEXT_MESSAGE,              // parsing a websocket text message into market data messages
+    PROCESS_MARKET_DATA_MESSAGE_LIST,  // updating states and building events from market data messages
+    EVENT_HANDLER,                     // handing an event from a service to its session (e.g. enqueueing it onto the event dispatcher)
+    ON_MESSAGE,                        // the whole handling of a websocket message after it has been read from the socket
+    DISPATCH,                          // from an event being enqueued onto the event dispatcher to its processing starting
+  };
+  static constexpr int numStages = 6;
+  static std::string stageToString(Stage stage) {
+    std::string output;
+    switch (stage) {
+      case Stage::DECOMPRESS:
+        output = "DECOMPRESS";
+        break;
+      case Stage::PROCESS_TEXT_MESSAGE:
+        output = "PROCESS_TEXT_MESSAGE";
+        break;
+      case Stage::PROCESS_MARKET_DATA_MESSAGE_LIST:
+        output = "PROCESS_MARKET_DATA_MESSAGE_LIST";
+        break;
+      case Stage::EVENT_HANDLER:
+        output = "EVENT_HANDLER";
+        break;
+      case Stage::ON_MESSAGE:
+        output = "ON_MESSAGE";
+        break;
+      case Stage::DISPATCH:
+        output = "DISPATCH";
+        break;
+      default:
+        CCAPI_LOGGER_FATAL(CCAPI_UNSUPPORTED_VALUE);
+    }
+    return output;
+  }
+  void record(int64_t nanoseconds) {
+    if (nanoseconds < 0) {
+      nanoseconds = 0;
+    }
+    this->countList[bucketIndex(static_cast<uint64_t>(nanoseconds))].fetch_add(1, std::memory_order_relaxed);
+    this->count.fetch_add(1, std::memory_order_relaxed);
+    int64_t max = this->max.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !this->max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+  }
+  void record(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    this->record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+  uint64_t getCount() const { return this->count.load(std::memory_order_relaxed); }
+  int64_t getMax() const { return this->max.load(std::memory_order_relaxed); }
+  // Returns the highest value equivalent to the bucket containing the given percentile (between 0 and 100) of recorded values, or 0 if there is none.
+  int64_t getValueAtPercentile(double percentile) const {
+    uint64_t total = 0;
+    for (int i = 0; i < numBuckets; ++i) {
+      total += this->countList[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+      return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100 * total));
+    if (target == 0) {
+      target = 1;
+    }
+    uint64_t cumulative = 0;
+    int64_t max = this->getMax();
+    for (int i = 0; i < numBuckets; ++i) {
+      cumulative += this->countList[i].load(std::memory_order_relaxed);
+      if (cumulative >= target) {
+        int64_t value = static_cast<int64_t>(highestEquivalentValue(i));
+        return value < max ? value : max;
+      }
+    }
+    return max;
+  }
+  void reset() {
+    for (int i = 0; i < numBuckets; ++i) {
+      this->countList[i].store(0, std::memory_order_relaxed);
+    }
+    this->count.store(0, std::memory_order_relaxed);
+    this->max.store(0, std::memory_order_relaxed);
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  static constexpr int subBucketBits = CCAPI_LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+  static constexpr int halfSubBucketCount = 1 << (subBucketBits - 1);
+  static constexpr int numBuckets = (64 - subBucketBits + 1) * halfSubBucketCount + 2 * halfSubBucketCount;
+  static int mostSignificantBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int msb = 0;
+    while (value >>= 1) {
+      ++msb;
+    }
+    return msb;
+#endif
+  }
+  static int bucketIndex(uint64_t value) {
+    if (value < (uint64_t(1) << subBucketBits)) {
+      return static_cast<int>(value);
+    }
+    int shift = mostSignificantBit(value) - subBucketBits + 1;
+    return shift * halfSubBucketCount + static_cast<int>(value >> shift);
+  }
+  static uint64_t highestEquivalentValue(int index) {
+    if (index < (1 << subBucketBits)) {
+      return index;
+    }
+    int shift = index / halfSubBucketCount - 1;
+    uint64_t subBucket = index - shift * halfSubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+  }
+  std::atomic<uint64_t> countList[numBuckets]{};
+  std::atomic<uint64_t> count{};
+  std::atomic<int64_t> max{};
+};
+} /* namespace ccapi */
+#endif  // INCLUDE_CCAPI_CPP_CCAPI_LATENCY_HISTOGRAM_H_
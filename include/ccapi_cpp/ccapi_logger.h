@@ -123,7 +123,10 @@ class Logger {
                          const std::string& fileName, const std::string& lineNumber, const std::string& message) {
     std::stringstream ss;
     ss << threadId;
-    this->logMessage(severity, ss.str(), UtilTime::getISOTimestamp(time), fileName, lineNumber, message);
+    thread_local TimestampFormatter timestampFormatter;
+    thread_local std::string timeISO;
+    timestampFormatter.format(time, timeISO);
+    this->logMessage(severity, ss.str(), timeISO, fileName, lineNumber, message);
   }
 };
 } /* namespace ccapi */
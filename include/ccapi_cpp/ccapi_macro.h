@@ -392,9 +392,63 @@
 #ifndef CCAPI_CONNECTION_ID
 #define CCAPI_CONNECTION_ID "CONNECTION_ID"
 #endif
+#ifndef CCAPI_LATENCY_SERVICE_NAME
+#define CCAPI_LATENCY_SERVICE_NAME "SERVICE_NAME"
+#endif
+#ifndef CCAPI_LATENCY_EXCHANGE
+#define CCAPI_LATENCY_EXCHANGE "EXCHANGE"
+#endif
+#ifndef CCAPI_LATENCY_STAGE
+#define CCAPI_LATENCY_STAGE "STAGE"
+#endif
+#ifndef CCAPI_LATENCY_COUNT
+#define CCAPI_LATENCY_COUNT "COUNT"
+#endif
+#ifndef CCAPI_LATENCY_P50_NANOSECONDS
+#define CCAPI_LATENCY_P50_NANOSECONDS "P50_NANOSECONDS"
+#endif
+#ifndef CCAPI_LATENCY_P90_NANOSECONDS
+#define CCAPI_LATENCY_P90_NANOSECONDS "P90_NANOSECONDS"
+#endif
+#ifndef CCAPI_LATENCY_P99_NANOSECONDS
+#define CCAPI_LATENCY_P99_NANOSECONDS "P99_NANOSECONDS"
+#endif
+#ifndef CCAPI_LATENCY_P999_NANOSECONDS
+#define CCAPI_LATENCY_P999_NANOSECONDS "P999_NANOSECONDS"
+#endif
+#ifndef CCAPI_LATENCY_MAX_NANOSECONDS
+#define CCAPI_LATENCY_MAX_NANOSECONDS "MAX_NANOSECONDS"
+#endif
 #ifndef CCAPI_CONNECTION_URL
 #define CCAPI_CONNECTION_URL "CONNECTION_URL"
 #endif
+#ifndef CCAPI_SERVICE_NAME
+#define CCAPI_SERVICE_NAME "SERVICE_NAME"
+#endif
+#ifndef CCAPI_EXCHANGE
+#define CCAPI_EXCHANGE "EXCHANGE"
+#endif
+#ifndef CCAPI_HTTP_CONNECTION_POOL_NUM_HITS
+#define CCAPI_HTTP_CONNECTION_POOL_NUM_HITS "HTTP_CONNECTION_POOL_NUM_HITS"
+#endif
+#ifndef CCAPI_HTTP_CONNECTION_POOL_NUM_MISSES
+#define CCAPI_HTTP_CONNECTION_POOL_NUM_MISSES "HTTP_CONNECTION_POOL_NUM_MISSES"
+#endif
+#ifndef CCAPI_HTTP_CONNECTION_POOL_NUM_WARM_UPS
+#define CCAPI_HTTP_CONNECTION_POOL_NUM_WARM_UPS "HTTP_CONNECTION_POOL_NUM_WARM_UPS"
+#endif
+#ifndef CCAPI_WRITE_QUEUE_SIZE
+#define CCAPI_WRITE_QUEUE_SIZE "WRITE_QUEUE_SIZE"
+#endif
+#ifndef CCAPI_WRITE_QUEUE_NUM_BYTES
+#define CCAPI_WRITE_QUEUE_NUM_BYTES "WRITE_QUEUE_NUM_BYTES"
+#endif
+#ifndef CCAPI_WRITE_QUEUE_PEAK_SIZE
+#define CCAPI_WRITE_QUEUE_PEAK_SIZE "WRITE_QUEUE_PEAK_SIZE"
+#endif
+#ifndef CCAPI_WRITE_QUEUE_PEAK_NUM_BYTES
+#define CCAPI_WRITE_QUEUE_PEAK_NUM_BYTES "WRITE_QUEUE_PEAK_NUM_BYTES"
+#endif
 #ifndef CCAPI_REASON
 #define CCAPI_REASON "REASON"
 #endif
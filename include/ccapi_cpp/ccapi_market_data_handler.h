@@ -0,0 +1,59 @@
+#ifndef INCLUDE_CCAPI_CPP_CCAPI_MARKET_DATA_HANDLER_H_
+#define INCLUDE_CCAPI_CPP_CCAPI_MARKET_DATA_HANDLER_H_
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ccapi_cpp/ccapi_util_private.h"
+namespace ccapi {
+/**
+ * A single price level of an order book update as sent by the exchange. The price is priceTicks * 10^-priceScale and the size is sizeLots * 10^-sizeScale. A
+ * size of 0 means the level is removed. If isSnapshot is true, the levels delivered for the same message replace the whole side they belong to (e.g. an
+ * initial snapshot). isLastInMessage is true for the last level delivered for an exchange message, which is a consistent point to read the book at.
+ */
+struct BookUpdate {
+  size_t instrumentHandle{};
+  const std::vector<std::string>* correlationIdList{};
+  bool isBid{};
+  int64_t priceTicks{};
+  int priceScale{};
+  int64_t sizeLots{};
+  int sizeScale{};
+  bool isSnapshot{};
+  bool isLastInMessage{};
+  TimePoint exchangeTs{std::chrono::seconds{0}};
+  TimePoint recvTs{std::chrono::seconds{0}};
+};
+/**
+ * A single trade (or aggregated trade) as sent by the exchange. The price and size are encoded as in BookUpdate. tradeId refers to the exchange provided id
+ * (empty if none) and is only valid during the callback.
+ */
+struct Trade {
+  size_t instrumentHandle{};
+  const std::vector<std::string>* correlationIdList{};
+  int64_t priceTicks{};
+  int priceScale{};
+  int64_t sizeLots{};
+  int sizeScale{};
+  bool isBuyerMaker{};
+  bool isAggregated{};
+  std::string_view tradeId;
+  TimePoint exchangeTs{std::chrono::seconds{0}};
+  TimePoint recvTs{std::chrono::seconds{0}};
+};
+/**
+ * Defines the typed market data callbacks supplied by latency sensitive applications. They are invoked synchronously on the thread which processes the
+ * websocket messages of the subscription, directly from the parsed exchange data, so they must not block. instrumentHandle identifies a subscription and stays
+ * the same until its connection is closed; use correlationIdList to map it to the application's own instrument the first time it is seen.
+ */
+class MarketDataHandler {
+ public:
+  virtual ~MarketDataHandler() {}
+  virtual void onBookUpdate(const BookUpdate& bookUpdate) {}
+  virtual void onTrade(const Trade& trade) {}
+};
+} /* namespace ccapi */
+#endif  // INCLUDE_CCAPI_CPP_CCAPI_MARKET_DATA_HANDLER_H_
@@ -1,5 +1,7 @@
 #ifndef INCLUDE_CCAPI_CPP_CCAPI_MARKET_DATA_MESSAGE_H_
 #define INCLUDE_CCAPI_CPP_CCAPI_MARKET_DATA_MESSAGE_H_
+#include <string_view>
+
 #include "ccapi_cpp/ccapi_logger.h"
 #include "ccapi_cpp/ccapi_util_private.h"
 // #include "ccapi_message.h"
@@ -170,6 +172,23 @@ class MarketDataMessage CCAPI_FINAL {
     output1 += "}";
     return output1;
   }
+  /**
+   * A price level (BID or ASK) or a trade (TRADE or AGG_TRADE) in typed form. Prices and sizes are decimal strings as received from the exchange. The string
+   * views refer to characters owned by the parsed text message (e.g. its rapidjson document), so a Record is only valid while that text message is being
+   * processed. A MarketDataMessage which has to outlive it must use 'data' instead.
+   */
+  struct Record {
+    DataType dataType{};
+    std::string_view price;
+    std::string_view size;
+    std::string_view tradeId;
+    bool isBuyerMaker{};
+  };
+  typedef std::vector<Record> RecordList;
+  static std::string recordToString(const Record& record) {
+    return "Record [dataType = " + dataTypeToString(record.dataType) + ", price = " + std::string(record.price) + ", size = " + std::string(record.size) +
+           ", tradeId = " + std::string(record.tradeId) + ", isBuyerMaker = " + ccapi::toString(record.isBuyerMaker) + "]";
+  }
   static std::string typeToString(Type type) {
     std::string output;
     switch (type) {
@@ -195,14 +214,70 @@ class MarketDataMessage CCAPI_FINAL {
   }
   std::string toString() const {
     std::string output = "MarketDataMessage [type = " + typeToString(type) + ", recapType = " + recapTypeToString(recapType) + ", tp = " + ccapi::toString(tp) +
-                         ", exchangeSubscriptionId = " + exchangeSubscriptionId + ", data = " + dataToString(data) + "]";
+                         ", exchangeSubscriptionId = " + exchangeSubscriptionId + ", data = " + dataToString(data);
+    if (this->recordList) {
+      output += ", recordList = [";
+      for (size_t i = this->recordBegin; i < this->recordEnd; ++i) {
+        if (i > this->recordBegin) {
+          output += ", ";
+        }
+        output += recordToString((*this->recordList)[i]);
+      }
+      output += "]";
+    }
+    output += "]";
     return output;
   }
+  // Make this message refer to the records appended to recordList since it had the size 'begin'.
+  void setRecords(const RecordList& recordList, size_t begin) {
+    this->recordList = &recordList;
+    this->recordBegin = begin;
+    this->recordEnd = recordList.size();
+  }
+  bool hasDataType(DataType dataType) const {
+    if (this->recordList) {
+      for (size_t i = this->recordBegin; i < this->recordEnd; ++i) {
+        if ((*this->recordList)[i].dataType == dataType) {
+          return true;
+        }
+      }
+    }
+    return this->data.find(dataType) != this->data.end();
+  }
+  // Call f(record) for each price level and trade of this message, whether it is held by records or by 'data'.
+  template <class F>
+  void forEachRecord(F f) const {
+    if (this->recordList) {
+      for (size_t i = this->recordBegin; i < this->recordEnd; ++i) {
+        f((*this->recordList)[i]);
+      }
+    }
+    for (const auto& x : this->data) {
+      const auto dataType = x.first;
+      if (dataType == DataType::CANDLESTICK) {
+        continue;
+      }
+      Record record;
+      record.dataType = dataType;
+      for (const auto& y : x.second) {
+        record.price = y.at(DataFieldType::PRICE);
+        record.size = y.at(DataFieldType::SIZE);
+        auto it = y.find(dataType == DataType::AGG_TRADE ? DataFieldType::AGG_TRADE_ID : DataFieldType::TRADE_ID);
+        record.tradeId = it != y.end() ? std::string_view(it->second) : std::string_view();
+        it = y.find(DataFieldType::IS_BUYER_MAKER);
+        record.isBuyerMaker = it != y.end() && it->second == "1";
+        f(record);
+      }
+    }
+  }
   Type type{Type::UNKNOWN};
   RecapType recapType{RecapType::UNKNOWN};
   TimePoint tp{std::chrono::seconds{0}};
   std::string exchangeSubscriptionId;
   TypeForData data;
+  const RecordList* recordList{nullptr};
+  size_t recordBegin{};
+  size_t recordEnd{};
 };
 } /* namespace ccapi */
 #endif  // INCLUDE_CCAPI_CPP_CCAPI_MARKET_DATA_MESSAGE_H_
@@ -54,6 +54,8 @@ class Message CCAPI_FINAL {
     SUBSCRIPTION_FAILURE,
     SESSION_CONNECTION_UP,
     SESSION_CONNECTION_DOWN,
+    SESSION_LATENCY_STATISTICS,
+    WEBSOCKET_WRITE_QUEUE_HIGH_WATER_MARK,
     INCORRECT_STATE_FOUND,
     CREATE_ORDER,
     CANCEL_ORDER,
@@ -130,6 +132,12 @@ class Message CCAPI_FINAL {
       case Type::SESSION_CONNECTION_DOWN:
         output = "SESSION_CONNECTION_DOWN";
         break;
+      case Type::SESSION_LATENCY_STATISTICS:
+        output = "SESSION_LATENCY_STATISTICS";
+        break;
+      case Type::WEBSOCKET_WRITE_QUEUE_HIGH_WATER_MARK:
+        output = "WEBSOCKET_WRITE_QUEUE_HIGH_WATER_MARK";
+        break;
       case Type::INCORRECT_STATE_FOUND:
         output = "INCORRECT_STATE_FOUND";
         break;
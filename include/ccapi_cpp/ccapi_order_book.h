@@ -0,0 +1,469 @@
+#ifndef INCLUDE_CCAPI_CPP_CCAPI_ORDER_BOOK_H_
+#define INCLUDE_CCAPI_CPP_CCAPI_ORDER_BOOK_H_
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ccapi_cpp/ccapi_logger.h"
+#include "ccapi_cpp/ccapi_util_private.h"
+namespace ccapi {
+/**
+ * This class provides a price level order book with fixed point prices and sizes. Prices are stored as integer ticks of 10^-priceScale shared by both sides and
+ * sizes as integer mantissas, each together with its number of fractional digits so that it can be printed back exactly as it was received. Each side is a
+ * contiguous vector sorted so that the best level is at the back (i.e. bids ascending, asks descending). It is minimalistic for the purpose of high
+ * performance: updates near the top of the book only touch the tail of the vector and never allocate once the vector has grown to the size of the book.
+ */
+class OrderBook CCAPI_FINAL {
+ public:
+  struct Level {
+    int64_t price{};
+    int64_t size{};
+    uint8_t priceDigits{};
+    uint8_t sizeDigits{};
+  };
+  typedef std::vector<Level> Side;
+  static constexpr int maxDigits = 18;
+  // Parse a decimal string (optionally in scientific notation) into a mantissa and its number of fractional digits without allocating. Scientific notation and
+  // values parsed without keepTrailingZero are normalized by dropping fractional trailing zeros.
+  static void parse(const char* data, size_t length, int64_t& mantissa, int& digits, bool keepTrailingZero) {
+    if (length == 0) {
+      CCAPI_LOGGER_FATAL("OrderBook input value cannot be empty");
+    }
+    size_t i = 0;
+    bool negative = false;
+    if (data[0] == '-' || data[0] == '+') {
+      negative = data[0] == '-';
+      ++i;
+    }
+    uint64_t value = 0;
+    int fractionalDigits = 0;
+    int significantDigits = 0;
+    bool afterDot = false;
+    for (; i < length; ++i) {
+      const char c = data[i];
+      if (c >= '0' && c <= '9') {
+        if ((value != 0 || c != '0') && ++significantDigits > maxDigits) {
+          CCAPI_LOGGER_FATAL("OrderBook input value has too many significant digits: " + std::string(data, length));
+        }
+        value = value * 10 + (c - '0');
+        if (afterDot) {
+          ++fractionalDigits;
+        }
+      } else if (c == '.' && !afterDot) {
+        afterDot = true;
+      } else if (c == 'e' || c == 'E') {
+        break;
+      } else {
+        CCAPI_LOGGER_FATAL("OrderBook input value is invalid: " + std::string(data, length));
+      }
+    }
+    const bool isScientific = i < length;
+    if (isScientific) {
+      ++i;
+      bool exponentNegative = false;
+      if (i < length && (data[i] == '-' || data[i] == '+')) {
+        exponentNegative = data[i] == '-';
+        ++i;
+      }
+      if (i == length) {
+        CCAPI_LOGGER_FATAL("OrderBook input value is invalid: " + std::string(data, length));
+      }
+      int exponent = 0;
+      for (; i < length; ++i) {
+        const char c = data[i];
+        if (c < '0' || c > '9' || exponent > 1000) {
+          CCAPI_LOGGER_FATAL("OrderBook input value is invalid: " + std::string(data, length));
+        }
+        exponent = exponent * 10 + (c - '0');
+      }
+      fractionalDigits += exponentNegative ? exponent : -exponent;
+      while (fractionalDigits < 0) {
+        if (value != 0 && ++significantDigits > maxDigits) {
+          CCAPI_LOGGER_FATAL("OrderBook input value has too many significant digits: " + std::string(data, length));
+        }
+        value *= 10;
+        ++fractionalDigits;
+      }
+    }
+    if (isScientific || !keepTrailingZero) {
+      while (fractionalDigits > 0 && value % 10 == 0) {
+        value /= 10;
+        --fractionalDigits;
+      }
+    }
+    if (fractionalDigits > maxDigits) {
+      CCAPI_LOGGER_FATAL("OrderBook input value has too many fractional digits: " + std::string(data, length));
+    }
+    mantissa = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    digits = fractionalDigits;
+  }
+  static void append(std::string& output, int64_t mantissa, int digits) {
+    uint64_t value = mantissa < 0 ? -static_cast<uint64_t>(mantissa) : static_cast<uint64_t>(mantissa);
+    char buffer[2 * maxDigits + 4];
+    char* end = buffer + sizeof(buffer);
+    char* p = end;
+    for (int i = 0; i < digits; ++i) {
+      *--p = '0' + value % 10;
+      value /= 10;
+    }
+    if (digits > 0) {
+      *--p = '.';
+    }
+    do {
+      *--p = '0' + value % 10;
+      value /= 10;
+    } while (value != 0);
+    if (mantissa < 0) {
+      *--p = '-';
+    }
+    output.append(p, end - p);
+  }
+  std::string toString() const {
+    std::string output("OrderBook [priceScale = " + std::to_string(this->priceScale) + ", bid = ");
+    this->appendSide(output, this->bids, this->bids.size());
+    output += ", ask = ";
+    this->appendSide(output, this->asks, this->asks.size());
+    output += "]";
+    return output;
+  }
+  std::string topNToString(size_t n) const {
+    std::string output("OrderBook [priceScale = " + std::to_string(this->priceScale) + ", bid = ");
+    this->appendSide(output, this->bids, n);
+    output += ", ask = ";
+    this->appendSide(output, this->asks, n);
+    output += "]";
+    return output;
+  }
+  const Side& getBids() const { return this->bids; }
+  const Side& getAsks() const { return this->asks; }
+  const Side& getSide(bool isBid) const { return isBid ? this->bids : this->asks; }
+  int getPriceScale() const { return this->priceScale; }
+  bool empty() const { return this->bids.empty() && this->asks.empty(); }
+  void clear() {
+    this->clear(true);
+    this->clear(false);
+  }
+  void clear(bool isBid) {
+    Side& side = isBid ? this->bids : this->asks;
+    if (this->topN > 0) {
+      this->trackErase(isBid, side, side.size());
+    }
+    side.clear();
+  }
+  // Insert, replace or (if size is zero) remove a price level.
+  void update(bool isBid, std::string_view price, std::string_view size, bool keepTrailingZero = false) {
+    Level level;
+    this->parseLevel(level, price, size, keepTrailingZero);
+    Side& side = isBid ? this->bids : this->asks;
+    auto it = this->lowerBound(side, isBid, level.price);
+    if (this->topN > 0) {
+      this->trackUpdate(isBid, side, it, level.price);
+    }
+    if (it != side.end() && it->price == level.price) {
+      if (level.size == 0) {
+        side.erase(it);
+      } else {
+        *it = level;
+      }
+    } else if (level.size != 0) {
+      side.insert(it, level);
+    }
+  }
+  // Append a price level without keeping the side sorted. Used for bulk loading a snapshot and must be followed by a call to 'sort'.
+  void insertUnsorted(bool isBid, std::string_view price, std::string_view size, bool keepTrailingZero = false) {
+    Level level;
+    this->parseLevel(level, price, size, keepTrailingZero);
+    (isBid ? this->bids : this->asks).push_back(level);
+  }
+  // Sort both sides after bulk loading. For duplicate prices the first inserted level wins. Levels with zero size are dropped.
+  void sort() {
+    this->sortSide(this->bids, true);
+    this->sortSide(this->asks, false);
+  }
+  void keepTopN(size_t n) {
+    if (this->bids.size() > n) {
+      if (this->topN > 0) {
+        this->trackErase(true, this->bids, this->bids.size() - n);
+      }
+      this->bids.erase(this->bids.begin(), this->bids.end() - n);
+    }
+    if (this->asks.size() > n) {
+      if (this->topN > 0) {
+        this->trackErase(false, this->asks, this->asks.size() - n);
+      }
+      this->asks.erase(this->asks.begin(), this->asks.end() - n);
+    }
+  }
+  void copyTopN(OrderBook& copy, size_t n) const {
+    copy.priceScale = this->priceScale;
+    copy.bids.assign(this->bids.end() - std::min(n, this->bids.size()), this->bids.end());
+    copy.asks.assign(this->asks.end() - std::min(n, this->asks.size()), this->asks.end());
+  }
+  // Whether the best n levels (or all levels if either side has fewer) of one side are identical in both books.
+  bool topNSame(bool isBid, const OrderBook& other, size_t n) const {
+    const Side& side = this->getSide(isBid);
+    const Side& otherSide = other.getSide(isBid);
+    if (std::min(side.size(), n) != std::min(otherSide.size(), n)) {
+      return false;
+    }
+    auto it = side.rbegin();
+    auto otherIt = otherSide.rbegin();
+    for (size_t i = 0; i < n && it != side.rend(); ++i, ++it, ++otherIt) {
+      if (this->comparePrice(*it, other, *otherIt) != 0 || it->size != otherIt->size || it->sizeDigits != otherIt->sizeDigits ||
+          it->priceDigits != otherIt->priceDigits) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Start recording how the best n levels of both sides change through 'update', 'clear' and 'keepTopN' (but not 'insertUnsorted' and 'sort'), so that
+  // 'topNChanged' and 'forEachTopNChange' can compare them with their current state without keeping a copy of them. Only the previous state of levels that
+  // are touched within the best n levels is saved, which doesn't allocate once the buffers have grown.
+  void startTrackingTopN(size_t n) {
+    this->topN = n;
+    this->startTrackingTopN(this->bidTopNTracker, this->bids, n);
+    this->startTrackingTopN(this->askTopNTracker, this->asks, n);
+  }
+  void stopTrackingTopN() { this->topN = 0; }
+  // Whether the best n levels of one side differ from when tracking was started. Equivalent to 'topNSame' against a copy made by 'copyTopN' at that time.
+  bool topNChanged(bool isBid) const {
+    return !this->visitTopNChange(isBid, [](const Level&, bool) { return false; });
+  }
+  // Call f(level, isRemoved) for each level of one side which differs between its best n levels now and when tracking was started, in ascending price order.
+  // A level which is no longer among the best n levels is passed with its previous state and isRemoved set to true.
+  template <class F>
+  void forEachTopNChange(bool isBid, F f) const {
+    this->topNChangeBuffer.clear();
+    this->visitTopNChange(isBid, [this](const Level& level, bool isRemoved) {
+      this->topNChangeBuffer.emplace_back(level, isRemoved);
+      return true;
+    });
+    std::sort(this->topNChangeBuffer.begin(), this->topNChangeBuffer.end(),
+              [](const std::pair<Level, bool>& a, const std::pair<Level, bool>& b) { return a.first.price < b.first.price; });
+    for (const auto& x : this->topNChangeBuffer) {
+      f(x.first, x.second);
+    }
+  }
+  // Compare the price of a level of this book with the price of a level of the other book, which might use a different price scale. Returns a negative
+  // number, zero or a positive number.
+  int comparePrice(const Level& level, const OrderBook& other, const Level& otherLevel) const {
+    int64_t price = level.price;
+    int64_t otherPrice = otherLevel.price;
+    if (this->priceScale < other.priceScale) {
+      price = scaleUp(price, other.priceScale - this->priceScale);
+    } else if (this->priceScale > other.priceScale) {
+      otherPrice = scaleUp(otherPrice, this->priceScale - other.priceScale);
+    }
+    return price < otherPrice ? -1 : price > otherPrice ? 1 : 0;
+  }
+  bool isCrossed() const { return !this->bids.empty() && !this->asks.empty() && this->bids.back().price >= this->asks.back().price; }
+  void appendPrice(std::string& output, const Level& level) const {
+    append(output, level.price / pow10(this->priceScale - level.priceDigits), level.priceDigits);
+  }
+  static void appendSize(std::string& output, const Level& level) { append(output, level.size, level.sizeDigits); }
+  std::string priceToString(const Level& level) const {
+    std::string output;
+    this->appendPrice(output, level);
+    return output;
+  }
+  static std::string sizeToString(const Level& level) {
+    std::string output;
+    appendSize(output, level);
+    return output;
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  static int64_t pow10(int n) {
+    static const int64_t table[] = {1LL,
+                                    10LL,
+                                    100LL,
+                                    1000LL,
+                                    10000LL,
+                                    100000LL,
+                                    1000000LL,
+                                    10000000LL,
+                                    100000000LL,
+                                    1000000000LL,
+                                    10000000000LL,
+                                    100000000000LL,
+                                    1000000000000LL,
+                                    10000000000000LL,
+                                    100000000000000LL,
+                                    1000000000000000LL,
+                                    10000000000000000LL,
+                                    100000000000000000LL,
+                                    1000000000000000000LL};
+    return table[n];
+  }
+  static int64_t scaleUp(int64_t value, int n) {
+    if (n > maxDigits || (value > 0 ? value > INT64_MAX / pow10(n) : value < -INT64_MAX / pow10(n))) {
+      CCAPI_LOGGER_FATAL("OrderBook price overflow: value = " + std::to_string(value) + ", n = " + std::to_string(n));
+    }
+    return value * pow10(n);
+  }
+  struct TopNTracker {
+    bool previousFull{};
+    int64_t previousBoundaryPrice{};
+    std::vector<Level> previousLevelList;  // the previous state of each touched level, with size 0 if it didn't exist
+  };
+  static bool sameLevel(const Level& a, const Level& b) {
+    return a.size == b.size && a.sizeDigits == b.sizeDigits && a.priceDigits == b.priceDigits;
+  }
+  static void startTrackingTopN(TopNTracker& tracker, const Side& side, size_t n) {
+    tracker.previousLevelList.clear();
+    tracker.previousFull = side.size() >= n;
+    if (tracker.previousFull) {
+      tracker.previousBoundaryPrice = side[side.size() - n].price;
+    }
+  }
+  const TopNTracker& getTopNTracker(bool isBid) const { return isBid ? this->bidTopNTracker : this->askTopNTracker; }
+  // Whether a price was within the best n levels when tracking was started, provided that a level existed there.
+  bool wasInTopN(bool isBid, int64_t price) const {
+    const TopNTracker& tracker = this->getTopNTracker(isBid);
+    return !tracker.previousFull || (isBid ? price >= tracker.previousBoundaryPrice : price <= tracker.previousBoundaryPrice);
+  }
+  static bool isTouched(const TopNTracker& tracker, int64_t price) {
+    for (const auto& level : tracker.previousLevelList) {
+      if (level.price == price) {
+        return true;
+      }
+    }
+    return false;
+  }
+  void touch(bool isBid, const Level& previousLevel) {
+    TopNTracker& tracker = isBid ? this->bidTopNTracker : this->askTopNTracker;
+    if (!isTouched(tracker, previousLevel.price)) {
+      tracker.previousLevelList.push_back(previousLevel);
+    }
+  }
+  void trackUpdate(bool isBid, const Side& side, Side::const_iterator it, int64_t price) {
+    const bool exists = it != side.end() && it->price == price;
+    const size_t depth = side.end() - it - (exists ? 1 : 0);
+    if (depth < this->topN || this->wasInTopN(isBid, price)) {
+      if (exists) {
+        this->touch(isBid, *it);
+      } else {
+        Level level;
+        level.price = price;
+        this->touch(isBid, level);
+      }
+    }
+  }
+  // Track the removal of the worst numErased levels of one side.
+  void trackErase(bool isBid, const Side& side, size_t numErased) {
+    for (size_t i = numErased; i > 0; --i) {
+      const size_t depth = side.size() - i;
+      if (depth >= this->topN && !this->wasInTopN(isBid, side[i - 1].price)) {
+        break;
+      }
+      this->touch(isBid, side[i - 1]);
+    }
+  }
+  // Call f(level, isRemoved) for each changed level among the best n levels of one side until it returns false. Returns false if it has been stopped. A
+  // level can only have changed if it has been touched, or if it has moved into or out of the best n levels because of other levels being touched.
+  template <class F>
+  bool visitTopNChange(bool isBid, F f) const {
+    const Side& side = this->getSide(isBid);
+    const TopNTracker& tracker = this->getTopNTracker(isBid);
+    for (const auto& previousLevel : tracker.previousLevelList) {
+      const bool previousIn = previousLevel.size != 0 && this->wasInTopN(isBid, previousLevel.price);
+      auto it = lowerBound(side, isBid, previousLevel.price);
+      const bool currentIn = it != side.end() && it->price == previousLevel.price && static_cast<size_t>(side.end() - it) <= this->topN;
+      if (currentIn) {
+        if ((!previousIn || !sameLevel(previousLevel, *it)) && !f(*it, false)) {
+          return false;
+        }
+      } else if (previousIn && !f(previousLevel, true)) {
+        return false;
+      }
+    }
+    size_t depth = 0;
+    for (auto it = side.rbegin(); it != side.rend(); ++it, ++depth) {
+      const bool currentIn = depth < this->topN;
+      const bool previousIn = this->wasInTopN(isBid, it->price);
+      if (!currentIn && !previousIn) {
+        break;
+      }
+      if (currentIn != previousIn && !isTouched(tracker, it->price) && !f(*it, !currentIn)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  static Side::const_iterator lowerBound(const Side& side, bool isBid, int64_t price) {
+    return isBid ? std::lower_bound(side.begin(), side.end(), price, [](const Level& level, int64_t value) { return level.price < value; })
+                 : std::lower_bound(side.begin(), side.end(), price, [](const Level& level, int64_t value) { return level.price > value; });
+  }
+  static Side::iterator lowerBound(Side& side, bool isBid, int64_t price) {
+    return isBid ? std::lower_bound(side.begin(), side.end(), price, [](const Level& level, int64_t value) { return level.price < value; })
+                 : std::lower_bound(side.begin(), side.end(), price, [](const Level& level, int64_t value) { return level.price > value; });
+  }
+  static void sortSide(Side& side, bool isBid) {
+    if (isBid) {
+      std::stable_sort(side.begin(), side.end(), [](const Level& a, const Level& b) { return a.price < b.price; });
+    } else {
+      std::stable_sort(side.begin(), side.end(), [](const Level& a, const Level& b) { return a.price > b.price; });
+    }
+    side.erase(std::unique(side.begin(), side.end(), [](const Level& a, const Level& b) { return a.price == b.price; }), side.end());
+    side.erase(std::remove_if(side.begin(), side.end(), [](const Level& level) { return level.size == 0; }), side.end());
+  }
+  void rescale(int newPriceScale) {
+    const int n = newPriceScale - this->priceScale;
+    for (auto& level : this->bids) {
+      level.price = scaleUp(level.price, n);
+    }
+    for (auto& level : this->asks) {
+      level.price = scaleUp(level.price, n);
+    }
+    for (TopNTracker* tracker : {&this->bidTopNTracker, &this->askTopNTracker}) {
+      for (auto& level : tracker->previousLevelList) {
+        level.price = scaleUp(level.price, n);
+      }
+      if (tracker->previousFull) {
+        tracker->previousBoundaryPrice = scaleUp(tracker->previousBoundaryPrice, n);
+      }
+    }
+    this->priceScale = newPriceScale;
+  }
+  void parseLevel(Level& level, std::string_view price, std::string_view size, bool keepTrailingZero) {
+    int64_t mantissa;
+    int digits;
+    parse(price.data(), price.size(), mantissa, digits, keepTrailingZero);
+    if (digits > this->priceScale) {
+      this->rescale(digits);
+    }
+    level.price = scaleUp(mantissa, this->priceScale - digits);
+    level.priceDigits = digits;
+    parse(size.data(), size.size(), mantissa, digits, true);
+    level.size = mantissa;
+    level.sizeDigits = digits;
+  }
+  void appendSide(std::string& output, const Side& side, size_t n) const {
+    output += "[";
+    size_t i = 0;
+    for (auto it = side.rbegin(); it != side.rend() && i < n; ++it, ++i) {
+      if (i > 0) {
+        output += ", ";
+      }
+      this->appendPrice(output, *it);
+      output += ":";
+      appendSize(output, *it);
+    }
+    output += "]";
+  }
+  int priceScale{};
+  Side bids;
+  Side asks;
+  size_t topN{};
+  TopNTracker bidTopNTracker;
+  TopNTracker askTopNTracker;
+  mutable std::vector<std::pair<Level, bool> > topNChangeBuffer;
+};
+} /* namespace ccapi */
+#endif  // INCLUDE_CCAPI_CPP_CCAPI_ORDER_BOOK_H_
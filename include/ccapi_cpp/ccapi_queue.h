@@ -1,19 +1,91 @@
 #ifndef INCLUDE_CCAPI_CPP_CCAPI_QUEUE_H_
 #define INCLUDE_CCAPI_CPP_CCAPI_QUEUE_H_
+#ifndef CCAPI_LOCK_FREE_QUEUE_DEFAULT_CAPACITY
+#define CCAPI_LOCK_FREE_QUEUE_DEFAULT_CAPACITY (1 << 16)
+#endif
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 #include <vector>
 
 #include "ccapi_cpp/ccapi_logger.h"
 namespace ccapi {
 /**
- * This class represents a generic FIFO queue.
+ * This class represents a generic FIFO queue. If macro CCAPI_USE_LOCK_FREE_QUEUE is defined, it is a bounded lock-free ring buffer which allows multiple
+ * producers and consumers. Its capacity is maxSize or CCAPI_LOCK_FREE_QUEUE_DEFAULT_CAPACITY if maxSize is 0, and popBack isn't available.
  */
 template <class T>
 class Queue {
  public:
+  enum class WaitStrategy {
+    BUSY_POLL,
+    YIELD,
+  };
   std::string EXCEPTION_QUEUE_FULL = "queue is full";
   std::string EXCEPTION_QUEUE_EMPTY = "queue is empty";
+#ifdef CCAPI_USE_LOCK_FREE_QUEUE
+  explicit Queue(const size_t maxSize = 0)
+      : maxSize(maxSize), capacity(maxSize > 0 ? maxSize : CCAPI_LOCK_FREE_QUEUE_DEFAULT_CAPACITY), cellList(new Cell[capacity]) {
+    for (size_t i = 0; i < this->capacity; ++i) {
+      this->cellList[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  void pushBack(const T& t) {
+    T copy(t);
+    this->pushBack(std::move(copy));
+  }
+  void pushBack(T&& t) {
+    size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = this->cellList[position % this->capacity];
+      auto difference = static_cast<std::ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - position);
+      if (difference == 0) {
+        if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          cell.data = std::move(t);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return;
+        }
+      } else if (difference < 0) {
+        throw std::runtime_error(EXCEPTION_QUEUE_FULL);
+      } else {
+        position = this->enqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  std::vector<T> purge() {
+    std::vector<T> p;
+    this->removeAll(p);
+    return p;
+  }
+  void removeAll(std::vector<T>& c) {
+    size_t position = this->dequeuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = this->cellList[position % this->capacity];
+      auto difference = static_cast<std::ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - (position + 1));
+      if (difference == 0) {
+        if (this->dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          c.emplace_back(std::move(cell.data));
+          cell.sequence.store(position + this->capacity, std::memory_order_release);
+          ++position;
+        }
+      } else if (difference < 0) {
+        return;
+      } else {
+        position = this->dequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  size_t size() const {
+    size_t dequeuePosition = this->dequeuePosition.load(std::memory_order_acquire);
+    size_t enqueuePosition = this->enqueuePosition.load(std::memory_order_acquire);
+    return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+  }
+  bool empty() const { return this->size() == 0; }
+#else
   explicit Queue(const size_t maxSize = 0) : maxSize(maxSize) {}
   void pushBack(const T& t) {
 #ifndef CCAPI_USE_SINGLE_THREAD
@@ -32,7 +104,7 @@ class Queue {
 #endif
     if (this->maxSize <= 0 || this->queue.size() < this->maxSize) {
       CCAPI_LOGGER_TRACE("this->queue.size() = " + size_tToString(this->queue.size()));
-      this->queue.push_back(t);
+      this->queue.push_back(std::move(t));
     } else {
       throw std::runtime_error(EXCEPTION_QUEUE_FULL);
     }
@@ -81,15 +153,40 @@ class Queue {
 #endif
     return this->queue.empty();
   }
+#endif
+  // Waits until the queue isn't empty or timeout has elapsed, then moves all elements to the end of c. Returns the number of elements moved.
+  size_t removeAll(std::vector<T>& c, WaitStrategy waitStrategy, std::chrono::nanoseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (this->empty() && std::chrono::steady_clock::now() < deadline) {
+      if (waitStrategy == WaitStrategy::YIELD) {
+        std::this_thread::yield();
+      }
+    }
+    size_t previousSize = c.size();
+    this->removeAll(c);
+    return c.size() - previousSize;
+  }
 #ifndef CCAPI_EXPOSE_INTERNAL
 
  private:
 #endif
+#ifdef CCAPI_USE_LOCK_FREE_QUEUE
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+  size_t maxSize{};
+  size_t capacity{};
+  std::unique_ptr<Cell[]> cellList;
+  alignas(64) std::atomic<size_t> enqueuePosition{};
+  alignas(64) std::atomic<size_t> dequeuePosition{};
+#else
   std::vector<T> queue;
 #ifndef CCAPI_USE_SINGLE_THREAD
   mutable std::mutex m;
 #endif
   size_t maxSize{};
+#endif
 };
 } /* namespace ccapi */
 #endif  // INCLUDE_CCAPI_CPP_CCAPI_QUEUE_H_
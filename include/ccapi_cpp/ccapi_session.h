@@ -4,6 +4,7 @@
 
 // start: enable exchanges for market data
 #ifdef CCAPI_ENABLE_SERVICE_MARKET_DATA
+#include "ccapi_cpp/service/ccapi_market_data_service.h"
 #ifdef CCAPI_ENABLE_EXCHANGE_COINBASE
 #include "ccapi_cpp/service/ccapi_market_data_service_coinbase.h"
 #endif
@@ -611,8 +612,15 @@ class Session {
       for (const auto& y : x.second) {
         auto exchange = y.first;
         CCAPI_LOGGER_INFO("enabled service: " + serviceName + ", exchange: " + exchange);
+        y.second->startHttpConnectionPoolWarmUp();
       }
     }
+#ifndef SWIG
+    if (this->sessionOptions.enableLatencyHistogram && this->sessionOptions.latencyHistogramEventIntervalMilliseconds > 0) {
+      this->latencyStatisticsTimerPtr = std::make_shared<steady_timer>(*this->serviceContextPtr->ioContextPtr);
+      boost::asio::post(*this->serviceContextPtr->ioContextPtr, [this]() { this->scheduleLatencyStatistics(); });
+    }
+#endif
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
   virtual void stop() {
@@ -626,9 +634,38 @@ class Session {
         y.second->stop();
       }
     }
+    if (this->latencyStatisticsTimerPtr) {
+      boost::asio::post(*this->serviceContextPtr->ioContextPtr, [this]() { this->latencyStatisticsTimerPtr->cancel(); });
+    }
     this->serviceContextPtr->stop();
     this->t.join();
   }
+#if defined(CCAPI_ENABLE_SERVICE_MARKET_DATA) && !defined(SWIG)
+  // Deliver market depth updates and trades of all exchanges to marketDataHandler as typed structs. They are still delivered as Events to the eventHandler (or
+  // the event queue in batching mode) unless skipEvents is true, in which case the corresponding market data Events aren't generated at all. Must be called
+  // before subscribing.
+  virtual void setMarketDataHandler(MarketDataHandler* marketDataHandler, bool skipEvents = false) {
+    auto it = this->serviceByServiceNameExchangeMap.find(CCAPI_MARKET_DATA);
+    if (it != this->serviceByServiceNameExchangeMap.end()) {
+      for (const auto& x : it->second) {
+        std::static_pointer_cast<MarketDataService>(x.second)->setMarketDataHandler(marketDataHandler, skipEvents);
+      }
+    }
+  }
+#endif
+#if defined(CCAPI_ENABLE_SERVICE_FIX) && !defined(SWIG)
+  // Deliver execution reports, order cancel rejects, rejects and business message rejects of all exchanges to fixHandler as typed structs. They are still
+  // delivered as Events to the eventHandler (or the event queue in batching mode) unless skipEvents is true, in which case the corresponding FIX Events aren't
+  // generated at all. Must be called before subscribing.
+  virtual void setFixHandler(FixHandler* fixHandler, bool skipEvents = false) {
+    auto it = this->serviceByServiceNameExchangeMap.find(CCAPI_FIX);
+    if (it != this->serviceByServiceNameExchangeMap.end()) {
+      for (const auto& x : it->second) {
+        x.second->setFixHandler(fixHandler, skipEvents);
+      }
+    }
+  }
+#endif
   virtual void subscribe(Subscription& subscription) {
     std::vector<Subscription> subscriptionList;
     subscriptionList.push_back(subscription);
@@ -766,7 +803,14 @@ class Session {
           CCAPI_LOGGER_ERROR(e.what());
         }
 #else
-        this->eventDispatcher->dispatch([that = this, event = std::move(event)] {
+        const auto& messageList = event.getMessageList();
+        const std::string& shardKey =
+            !messageList.empty() && !messageList.front().getCorrelationIdList().empty() ? messageList.front().getCorrelationIdList().front() : std::string();
+        auto timeDispatched = this->sessionOptions.enableLatencyHistogram ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        this->eventDispatcher->dispatch(shardKey, [that = this, event = std::move(event), timeDispatched] {
+          if (that->sessionOptions.enableLatencyHistogram) {
+            that->dispatchLatencyHistogram.record(timeDispatched, std::chrono::steady_clock::now());
+          }
           bool shouldContinue = true;
           try {
             shouldContinue = that->eventHandler->processEvent(event, that);
@@ -970,10 +1014,110 @@ class Session {
       }
     }
   }
+  // Requires sessionOptions.enableLatencyHistogram. Stage DISPATCH is recorded by the session itself, so serviceName and exchange are ignored for it.
+  // Returns nullptr if there is no such histogram.
+  const LatencyHistogram* getLatencyHistogram(const std::string& serviceName, const std::string& exchange, LatencyHistogram::Stage stage) const {
+    if (!this->sessionOptions.enableLatencyHistogram) {
+      return nullptr;
+    }
+    if (stage == LatencyHistogram::Stage::DISPATCH) {
+      return &this->dispatchLatencyHistogram;
+    }
+    auto it = this->serviceByServiceNameExchangeMap.find(serviceName);
+    if (it == this->serviceByServiceNameExchangeMap.end()) {
+      return nullptr;
+    }
+    auto it2 = it->second.find(exchange);
+    if (it2 == it->second.end()) {
+      return nullptr;
+    }
+    return it2->second->getLatencyHistogram(stage);
+  }
+  std::vector<Element> getLatencyStatisticsElementList() const {
+    std::vector<Element> elementList;
+    if (!this->sessionOptions.enableLatencyHistogram) {
+      return elementList;
+    }
+    for (const auto& x : this->serviceByServiceNameExchangeMap) {
+      for (const auto& y : x.second) {
+        for (int i = 0; i < LatencyHistogram::numStages; ++i) {
+          auto stage = static_cast<LatencyHistogram::Stage>(i);
+          if (stage != LatencyHistogram::Stage::DISPATCH) {
+            this->appendLatencyStatisticsElement(elementList, x.first, y.first, stage, y.second->getLatencyHistogram(stage));
+          }
+        }
+      }
+    }
+    this->appendLatencyStatisticsElement(elementList, "", "", LatencyHistogram::Stage::DISPATCH, &this->dispatchLatencyHistogram);
+    return elementList;
+  }
+  // For each service which has sent rest requests or warmed up http connections, how many requests reused an idle pooled connection (hits), how many
+  // needed a new one (misses) and how many connections were opened ahead of requests (see SessionOptions::httpConnectionPoolMinSize).
+  std::vector<Element> getHttpConnectionPoolStatisticsElementList() const {
+    std::vector<Element> elementList;
+    for (const auto& x : this->serviceByServiceNameExchangeMap) {
+      for (const auto& y : x.second) {
+        const auto& service = *y.second;
+        auto numHits = service.getHttpConnectionPoolNumHits();
+        auto numMisses = service.getHttpConnectionPoolNumMisses();
+        auto numWarmUps = service.getHttpConnectionPoolNumWarmUps();
+        if (numHits + numMisses + numWarmUps > 0) {
+          Element element;
+          element.insert(CCAPI_SERVICE_NAME, x.first);
+          element.insert(CCAPI_EXCHANGE, y.first);
+          element.insert(CCAPI_HTTP_CONNECTION_POOL_NUM_HITS, std::to_string(numHits));
+          element.insert(CCAPI_HTTP_CONNECTION_POOL_NUM_MISSES, std::to_string(numMisses));
+          element.insert(CCAPI_HTTP_CONNECTION_POOL_NUM_WARM_UPS, std::to_string(numWarmUps));
+          elementList.emplace_back(std::move(element));
+        }
+      }
+    }
+    return elementList;
+  }
 #endif
 #ifndef CCAPI_EXPOSE_INTERNAL
 
  protected:
+#endif
+#ifndef SWIG
+  void appendLatencyStatisticsElement(std::vector<Element>& elementList, const std::string& serviceName, const std::string& exchange,
+                                      LatencyHistogram::Stage stage, const LatencyHistogram* latencyHistogramPtr) const {
+    if (!latencyHistogramPtr || latencyHistogramPtr->getCount() == 0) {
+      return;
+    }
+    Element element;
+    element.reserve(9);
+    element.insert(CCAPI_LATENCY_SERVICE_NAME, serviceName);
+    element.insert(CCAPI_LATENCY_EXCHANGE, exchange);
+    element.insert(CCAPI_LATENCY_STAGE, LatencyHistogram::stageToString(stage));
+    element.insert(CCAPI_LATENCY_COUNT, std::to_string(latencyHistogramPtr->getCount()));
+    element.insert(CCAPI_LATENCY_P50_NANOSECONDS, std::to_string(latencyHistogramPtr->getValueAtPercentile(50)));
+    element.insert(CCAPI_LATENCY_P90_NANOSECONDS, std::to_string(latencyHistogramPtr->getValueAtPercentile(90)));
+    element.insert(CCAPI_LATENCY_P99_NANOSECONDS, std::to_string(latencyHistogramPtr->getValueAtPercentile(99)));
+    element.insert(CCAPI_LATENCY_P999_NANOSECONDS, std::to_string(latencyHistogramPtr->getValueAtPercentile(99.9)));
+    element.insert(CCAPI_LATENCY_MAX_NANOSECONDS, std::to_string(latencyHistogramPtr->getMax()));
+    elementList.emplace_back(std::move(element));
+  }
+  void scheduleLatencyStatistics() {
+    this->latencyStatisticsTimerPtr->expires_after(std::chrono::milliseconds(this->sessionOptions.latencyHistogramEventIntervalMilliseconds));
+    this->latencyStatisticsTimerPtr->async_wait([this](const boost::system::error_code& ec) {
+      if (ec) {
+        return;
+      }
+      auto elementList = this->getLatencyStatisticsElementList();
+      if (!elementList.empty()) {
+        Event event;
+        event.setType(Event::Type::SESSION_STATUS);
+        Message message;
+        message.setType(Message::Type::SESSION_LATENCY_STATISTICS);
+        message.setTimeReceived(UtilTime::now());
+        message.setElementList(elementList);
+        event.addMessage(message);
+        this->onEvent(event, nullptr);
+      }
+      this->scheduleLatencyStatistics();
+    });
+  }
 #endif
   SessionOptions sessionOptions;
   SessionConfigs sessionConfigs;
@@ -988,6 +1132,8 @@ class Session {
   Queue<Event> eventQueue;
   std::function<void(Event& event, Queue<Event>* eventQueue)> internalEventHandler;
   std::map<std::string, std::shared_ptr<steady_timer> > delayTimerByIdMap;
+  LatencyHistogram dispatchLatencyHistogram;
+  std::shared_ptr<steady_timer> latencyStatisticsTimerPtr;
 };
 } /* namespace ccapi */
 #endif  // INCLUDE_CCAPI_CPP_CCAPI_SESSION_H_
@@ -15,6 +15,7 @@ class SessionOptions CCAPI_FINAL {
     std::string output = "SessionOptions [enableCheckSequence = " + ccapi::toString(enableCheckSequence) +
                          ", enableCheckOrderBookChecksum = " + ccapi::toString(enableCheckOrderBookChecksum) +
                          ", enableCheckOrderBookCrossed = " + ccapi::toString(enableCheckOrderBookCrossed) +
+                         ", enableResyncOrderBook = " + ccapi::toString(enableResyncOrderBook) +
                          ", enableCheckPingPongWebsocketProtocolLevel = " + ccapi::toString(enableCheckPingPongWebsocketProtocolLevel) +
                          ", enableCheckPingPongWebsocketApplicationLevel = " + ccapi::toString(enableCheckPingPongWebsocketApplicationLevel) +
                          ", enableCheckHeartbeatFix = " + ccapi::toString(enableCheckHeartbeatFix) +
@@ -28,14 +29,31 @@ class SessionOptions CCAPI_FINAL {
                          ", httpMaxNumRedirect = " + ccapi::toString(httpMaxNumRedirect) +
                          ", httpRequestTimeoutMilliseconds = " + ccapi::toString(httpRequestTimeoutMilliseconds) +
                          ", httpConnectionPoolMaxSize = " + ccapi::toString(httpConnectionPoolMaxSize) +
+                         ", httpConnectionPoolMinSize = " + ccapi::toString(httpConnectionPoolMinSize) +
                          ", httpConnectionKeepAliveTimeoutSeconds = " + ccapi::toString(httpConnectionKeepAliveTimeoutSeconds) +
-                         ", enableOneHttpConnectionPerRequest = " + ccapi::toString(enableOneHttpConnectionPerRequest) + "]";
+                         ", enableOneHttpConnectionPerRequest = " + ccapi::toString(enableOneHttpConnectionPerRequest) +
+                         ", websocketJsonDocumentPoolSize = " + ccapi::toString(websocketJsonDocumentPoolSize) +
+                         ", enableLatencyHistogram = " + ccapi::toString(enableLatencyHistogram) +
+                         ", latencyHistogramEventIntervalMilliseconds = " + ccapi::toString(latencyHistogramEventIntervalMilliseconds) +
+                         ", enableTlsSessionResumption = " + ccapi::toString(enableTlsSessionResumption) +
+                         ", enableTcpNoDelay = " + ccapi::toString(enableTcpNoDelay) +
+                         ", tcpReceiveBufferSizeBytes = " + ccapi::toString(tcpReceiveBufferSizeBytes) +
+                         ", tcpSendBufferSizeBytes = " + ccapi::toString(tcpSendBufferSizeBytes) +
+                         ", tcpBusyPollMicroseconds = " + ccapi::toString(tcpBusyPollMicroseconds) +
+                         ", enableFixReadBatching = " + ccapi::toString(enableFixReadBatching) +
+                         ", fixJournalDirectory = " + fixJournalDirectory + ", fixJournalSizeBytes = " + ccapi::toString(fixJournalSizeBytes) +
+#ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
+#else
+                         ", websocketWriteQueueHighWaterMarkBytes = " + ccapi::toString(websocketWriteQueueHighWaterMarkBytes) +
+#endif
+                         "]";
     return output;
   }
   // long warnLateEventMaxMilliseconds{};                      // used to print a warning log message if en event arrives late
   bool enableCheckSequence{};                               // used to check sequence number discontinuity
   bool enableCheckOrderBookChecksum{};                      // used to check order book checksum
   bool enableCheckOrderBookCrossed{true};                   // used to check order book cross, usually this should be set to true
+  bool enableResyncOrderBook{true};                         // used to resync an incorrect order book from a fresh snapshot instead of reconnecting
   bool enableCheckPingPongWebsocketProtocolLevel{true};     // used to check ping-pong health for exchange connections on websocket protocol level
   bool enableCheckPingPongWebsocketApplicationLevel{true};  // used to check ping-pong health for exchange connections on websocket application level
   bool enableCheckHeartbeatFix{true};                       // used to check heartbeat health for exchange connections on FIX
@@ -50,12 +68,25 @@ class SessionOptions CCAPI_FINAL {
   int httpMaxNumRedirect{1};
   long httpRequestTimeoutMilliseconds{10000};
   int httpConnectionPoolMaxSize{1};  // used to set the maximal number of http connections to be kept in the pool (connections in the pool are idle)
+  int httpConnectionPoolMinSize{};   // if positive, at least this many idle http connections are kept open to each rest host ahead of requests
   long httpConnectionKeepAliveTimeoutSeconds{
       10};  // used to remove a http connection from the http connection pool if it has stayed idle for at least this amount of time
-  bool enableOneHttpConnectionPerRequest{};  // create a new http connection for each request
+  bool enableOneHttpConnectionPerRequest{};          // create a new http connection for each request
+  size_t websocketJsonDocumentPoolSize{1 << 16};     // size of the per-connection memory pool for parsing websocket messages, larger messages cause allocations
+  bool enableLatencyHistogram{};                     // used to record latency histograms of each message processing stage per exchange, see Session
+  long latencyHistogramEventIntervalMilliseconds{};  // if set to a positive integer, latency statistics are periodically emitted as a SESSION_STATUS event
+  bool enableTlsSessionResumption{true};             // reconnects to a host resume the most recent tls session negotiated with it instead of a full handshake
+  bool enableTcpNoDelay{true};                       // used to disable Nagle's algorithm (TCP_NODELAY) on exchange connections
+  int tcpReceiveBufferSizeBytes{};                   // if positive, used to set SO_RCVBUF on exchange connections
+  int tcpSendBufferSizeBytes{};                      // if positive, used to set SO_SNDBUF on exchange connections
+  int tcpBusyPollMicroseconds{};                     // if positive, used to set SO_BUSY_POLL on exchange connections (Linux only)
+  bool enableFixReadBatching{};                      // used to deliver all FIX application messages decoded from one socket read in a single Event
+  std::string fixJournalDirectory;       // if not empty, each FIX session is journaled to a file in this directory so that it can be resumed, see FixJournal
+  size_t fixJournalSizeBytes{1 << 26};  // size of a newly created FIX journal file
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
 #else
   long websocketConnectTimeoutMilliseconds{10000};
+  size_t websocketWriteQueueHighWaterMarkBytes{1 << 20};  // a SESSION_STATUS event is emitted once a connection's unsent messages exceed this many bytes
 #endif
 };
 } /* namespace ccapi */
@@ -4,15 +4,21 @@
 #define timegm _mkgmtime
 #endif
 #include <unistd.h>
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#endif
 
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <numeric>
 #include <random>
@@ -21,6 +27,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -246,6 +253,18 @@ class UtilString CCAPI_FINAL {
     }
     return str;
   }
+  // Same as normalizeDecimalString, but returns a view into original instead of a copy.
+  static std::string_view normalizeDecimalStringView(std::string_view original) {
+    if (original.find('.') != std::string_view::npos) {
+      while (!original.empty() && original.back() == '0') {
+        original.remove_suffix(1);
+      }
+      if (!original.empty() && original.back() == '.') {
+        original.remove_suffix(1);
+      }
+    }
+    return original;
+  }
   static std::string leftPadTo(const std::string& str, const size_t padToLength, const char paddingChar) {
     std::string copy = str;
     if (padToLength > copy.size()) {
@@ -276,35 +295,8 @@ class UtilTime CCAPI_FINAL {
     output += "Z";
     return output;
   }
-  static std::string convertTimePointToFIXTime(const TimePoint& tp) {
-    int year, month, day, hour, minute, second, millisecond;
-    timePointToParts(tp, year, month, day, hour, minute, second, millisecond);
-    std::string output;
-    output += std::to_string(year);
-    auto monthStr = std::to_string(month);
-    output += std::string(2 - monthStr.length(), '0');
-    output += monthStr;
-    auto dayStr = std::to_string(day);
-    output += std::string(2 - dayStr.length(), '0');
-    output += dayStr;
-    output += "-";
-    auto hourStr = std::to_string(hour);
-    output += std::string(2 - hourStr.length(), '0');
-    output += hourStr;
-    output += ":";
-    auto minuteStr = std::to_string(minute);
-    output += std::string(2 - minuteStr.length(), '0');
-    output += minuteStr;
-    output += ":";
-    auto secondStr = std::to_string(second);
-    output += std::string(2 - secondStr.length(), '0');
-    output += secondStr;
-    output += ".";
-    auto millisecondStr = std::to_string(millisecond);
-    output += std::string(3 - millisecondStr.length(), '0');
-    output += millisecondStr;
-    return output;
-  }
+  // Thread safe, see TimestampFormatter.
+  static std::string convertTimePointToFIXTime(const TimePoint& tp);
   template <typename T = std::chrono::milliseconds>
   static void timePointToParts(TimePoint tp, int& year, int& month, int& day, int& hour, int& minute, int& second, int& fractionalSecond) {
     auto epoch_sec = std::chrono::time_point_cast<std::chrono::seconds>(tp).time_since_epoch().count();
@@ -419,50 +411,9 @@ class UtilTime CCAPI_FINAL {
   static std::pair<long long, long long> divideNanoWhole(const std::string& nanoseconds) {
     return std::make_pair(std::stoll(nanoseconds.substr(0, nanoseconds.length() - 9)), std::stoll(nanoseconds.substr(nanoseconds.length() - 9)));
   }
+  // Thread safe, see TimestampFormatter.
   template <typename T = std::chrono::nanoseconds>
-  static std::string getISOTimestamp(const TimePoint& tp) {
-    int year, month, day, hour, minute, second, fractionalSecond;
-    timePointToParts<T>(tp, year, month, day, hour, minute, second, fractionalSecond);
-    std::string output;
-    output += std::to_string(year);
-    output += "-";
-    auto monthStr = std::to_string(month);
-    output += std::string(2 - monthStr.length(), '0');
-    output += monthStr;
-    output += "-";
-    auto dayStr = std::to_string(day);
-    output += std::string(2 - dayStr.length(), '0');
-    output += dayStr;
-    output += "T";
-    auto hourStr = std::to_string(hour);
-    output += std::string(2 - hourStr.length(), '0');
-    output += hourStr;
-    output += ":";
-    auto minuteStr = std::to_string(minute);
-    output += std::string(2 - minuteStr.length(), '0');
-    output += minuteStr;
-    output += ":";
-    auto secondStr = std::to_string(second);
-    output += std::string(2 - secondStr.length(), '0');
-    output += secondStr;
-    if (!std::is_same<T, std::chrono::seconds>::value) {
-      output += ".";
-      auto fractionalSecondStr = std::to_string(fractionalSecond);
-      int padToLength;
-      if (std::is_same<T, std::chrono::nanoseconds>::value) {
-        padToLength = 9;
-      } else if (std::is_same<T, std::chrono::microseconds>::value) {
-        padToLength = 6;
-      } else if (std::is_same<T, std::chrono::milliseconds>::value) {
-        padToLength = 3;
-      }
-      output += std::string(padToLength - fractionalSecondStr.length(), '0');
-      // UtilString::rtrimInPlace(fractionalSecondStr, '0');
-      output += fractionalSecondStr;
-    }
-    output += "Z";
-    return output;
-  }
+  static std::string getISOTimestamp(const TimePoint& tp);
   static int getUnixTimestamp(const TimePoint& tp) {
     auto then = tp.time_since_epoch();
     auto s = std::chrono::duration_cast<std::chrono::seconds>(then);
@@ -471,6 +422,126 @@ class UtilTime CCAPI_FINAL {
   static TimePoint makeTimePointFromMilliseconds(long long milliseconds) { return TimePoint(std::chrono::milliseconds(milliseconds)); }
   static TimePoint makeTimePointFromSeconds(long seconds) { return TimePoint(std::chrono::seconds(seconds)); }
 };
+/**
+ * Formats time points as ISO 8601 (e.g. 2020-09-25T15:55:28.093490622Z) or FIX UTCTimestamp (e.g. 20200925-15:55:28.093) strings into a caller-provided
+ * buffer. The part up to the second is cached, so that a time point within the same second as the previous one only has its fractional digits rewritten,
+ * without any calendar math. An instance isn't thread safe; UtilTime uses one per thread and format.
+ */
+class TimestampFormatter CCAPI_FINAL {
+ public:
+  enum class Format {
+    ISO,
+    FIX,
+  };
+  static constexpr size_t maxLength = 32;
+  explicit TimestampFormatter(Format outputFormat = Format::ISO, int numFractionalDigits = 9)
+      : outputFormat(outputFormat), numFractionalDigits(std::min(std::max(numFractionalDigits, 0), 9)) {
+    this->fractionDivisor = 1;
+    for (int i = this->numFractionalDigits; i < 9; ++i) {
+      this->fractionDivisor *= 10;
+    }
+  }
+  // Writes at most maxLength characters to output and returns the number of characters written. No terminating null character is written.
+  size_t format(const TimePoint& tp, char* output) {
+    int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    int64_t epochSecond = nanoseconds / 1000000000;
+    if (nanoseconds % 1000000000 < 0) {
+      --epochSecond;
+    }
+    if (epochSecond != this->cachedEpochSecond) {
+      this->updatePrefix(epochSecond);
+    }
+    std::memcpy(output, this->prefix, this->prefixLength);
+    size_t n = this->prefixLength;
+    if (this->numFractionalDigits > 0) {
+      output[n++] = '.';
+      int64_t fraction = (nanoseconds - epochSecond * 1000000000) / this->fractionDivisor;
+      for (int i = this->numFractionalDigits - 1; i >= 0; --i) {
+        output[n + i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+      }
+      n += this->numFractionalDigits;
+    }
+    if (this->outputFormat == Format::ISO) {
+      output[n++] = 'Z';
+    }
+    return n;
+  }
+  // Same as above, but assigns to output, which doesn't allocate once its capacity suffices.
+  void format(const TimePoint& tp, std::string& output) {
+    char buffer[maxLength];
+    output.assign(buffer, this->format(tp, buffer));
+  }
+  std::string format(const TimePoint& tp) {
+    char buffer[maxLength];
+    return std::string(buffer, this->format(tp, buffer));
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  static char* writeDigits(char* output, int value, int numDigits) {
+    for (int i = numDigits - 1; i >= 0; --i) {
+      output[i] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    return output + numDigits;
+  }
+  void updatePrefix(int64_t epochSecond) {
+    int64_t daysSinceEpoch = epochSecond / 86400;
+    int64_t secondOfDay = epochSecond % 86400;
+    if (secondOfDay < 0) {
+      secondOfDay += 86400;
+      --daysSinceEpoch;
+    }
+    // see http://howardhinnant.github.io/date_algorithms.html
+    int64_t z = daysSinceEpoch + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const int day = doy - (153 * mp + 2) / 5 + 1;
+    const int month = mp < 10 ? mp + 3 : mp - 9;
+    const int year = static_cast<int>(yoe + era * 400 + (month <= 2));
+    const bool isIso = this->outputFormat == Format::ISO;
+    char* p = writeDigits(this->prefix, year, 4);
+    if (isIso) {
+      *p++ = '-';
+    }
+    p = writeDigits(p, month, 2);
+    if (isIso) {
+      *p++ = '-';
+    }
+    p = writeDigits(p, day, 2);
+    *p++ = isIso ? 'T' : '-';
+    p = writeDigits(p, static_cast<int>(secondOfDay / 3600), 2);
+    *p++ = ':';
+    p = writeDigits(p, static_cast<int>(secondOfDay / 60 % 60), 2);
+    *p++ = ':';
+    p = writeDigits(p, static_cast<int>(secondOfDay % 60), 2);
+    this->prefixLength = p - this->prefix;
+    this->cachedEpochSecond = epochSecond;
+  }
+  Format outputFormat;
+  int numFractionalDigits;
+  int64_t fractionDivisor;
+  int64_t cachedEpochSecond{std::numeric_limits<int64_t>::min()};
+  char prefix[maxLength]{};
+  size_t prefixLength{};
+};
+inline std::string UtilTime::convertTimePointToFIXTime(const TimePoint& tp) {
+  thread_local TimestampFormatter timestampFormatter(TimestampFormatter::Format::FIX, 3);
+  return timestampFormatter.format(tp);
+}
+template <typename T>
+std::string UtilTime::getISOTimestamp(const TimePoint& tp) {
+  thread_local TimestampFormatter timestampFormatter(TimestampFormatter::Format::ISO, std::is_same<T, std::chrono::nanoseconds>::value    ? 9
+                                                                                      : std::is_same<T, std::chrono::microseconds>::value ? 6
+                                                                                      : std::is_same<T, std::chrono::milliseconds>::value ? 3
+                                                                                                                                          : 0);
+  return timestampFormatter.format(tp);
+}
 class UtilAlgorithm CCAPI_FINAL {
  public:
   enum class ShaVersion {
@@ -497,28 +568,30 @@ class UtilAlgorithm CCAPI_FINAL {
     unsigned int lengthOfHash = 0;
     EVP_DigestFinal_ex(context, hash, &lengthOfHash);
     EVP_MD_CTX_free(context);
-    std::stringstream ss;
+    std::string output;
     if (returnHex) {
-      for (unsigned int i = 0; i < lengthOfHash; ++i) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-      }
+      appendHex(output, hash, lengthOfHash);
     } else {
-      for (unsigned int i = 0; i < lengthOfHash; ++i) {
-        ss << (char)hash[i];
-      }
+      output.assign(reinterpret_cast<const char*>(hash), lengthOfHash);
     }
-    return ss.str();
+    return output;
   }
   static std::string stringToHex(const std::string& input) {
-    static const char hex_digits[] = "0123456789abcdef";
     std::string output;
-    output.reserve(input.length() * 2);
-    for (unsigned char c : input) {
-      output.push_back(hex_digits[c >> 4]);
-      output.push_back(hex_digits[c & 15]);
-    }
+    appendHex(output, reinterpret_cast<const unsigned char*>(input.data()), input.length());
     return output;
   }
+  // Appends the lower case hex representation of data to output.
+  static void appendHex(std::string& output, const unsigned char* data, size_t size) {
+    static const char hex_digits[] = "0123456789abcdef";
+    size_t position = output.size();
+    output.resize(position + size * 2);
+    char* out = &output[position];
+    for (size_t i = 0; i < size; ++i) {
+      *out++ = hex_digits[data[i] >> 4];
+      *out++ = hex_digits[data[i] & 15];
+    }
+  }
   static int hexValue(unsigned char hex_digit) {
     static const signed char hex_values[256] = {
         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
@@ -547,17 +620,23 @@ class UtilAlgorithm CCAPI_FINAL {
   }
   // https://stackoverflow.com/questions/342409/how-do-i-base64-encode-decode-in-c
   static std::string base64Encode(const std::string& input) {
+    std::string outStr;
+    appendBase64(outStr, reinterpret_cast<const unsigned char*>(input.c_str()), input.length());
+    return outStr;
+  }
+  // Appends the base64 representation of data to output.
+  static void appendBase64(std::string& output, const unsigned char* data, size_t size) {
     static const unsigned char base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    const unsigned char* src = reinterpret_cast<const unsigned char*>(input.c_str());
-    size_t len = input.length();
+    const unsigned char* src = data;
+    size_t len = size;
     unsigned char *out, *pos;
     const unsigned char *end, *in;
     size_t olen;
-    olen = 4 * ((len + 2) / 3);           /* 3-byte blocks to 4-byte */
-    if (olen < len) return std::string(); /* integer overflow */
-    std::string outStr;
-    outStr.resize(olen);
-    out = (unsigned char*)&outStr[0];
+    olen = 4 * ((len + 2) / 3); /* 3-byte blocks to 4-byte */
+    if (olen < len) return;     /* integer overflow */
+    size_t position = output.size();
+    output.resize(position + olen);
+    out = (unsigned char*)&output[position];
     end = src + len;
     in = src;
     pos = out;
@@ -579,7 +658,6 @@ class UtilAlgorithm CCAPI_FINAL {
       }
       *pos++ = '=';
     }
-    return outStr;
   }
   static std::string base64Decode(const std::string& in) {
     static const int B64index[256] = {0, 0, 0,  0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 0,
@@ -631,6 +709,14 @@ class UtilAlgorithm CCAPI_FINAL {
   static double exponentialBackoff(double initial, double multiplier, double base, double exponent) { return initial + multiplier * (pow(base, exponent) - 1); }
   template <typename InputIterator>
   static uint_fast32_t crc(InputIterator first, InputIterator last);
+  // Same checksum as crc (i.e. the one of zlib), continuing from crc32 of the preceding data if any. Uses carry-less multiplication if compiled with PCLMUL and
+  // SSE4.1 support (e.g. -march=native), otherwise processes 8 bytes at a time with lookup tables.
+  static uint32_t crc32(const char* data, size_t size, uint32_t crc32 = 0);
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+  // https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/fast-crc-computation-generic-polynomials-pclmulqdq-paper.pdf. size must be a
+  // multiple of 16 and at least 64. crc and the return value are inverted.
+  static uint32_t crc32Clmul(const unsigned char* p, size_t size, uint32_t crc);
+#endif
 };
 template <typename InputIterator>
 inline uint_fast32_t UtilAlgorithm::crc(InputIterator first, InputIterator last) {
@@ -656,6 +742,102 @@ inline uint_fast32_t UtilAlgorithm::crc(InputIterator first, InputIterator last)
          ~std::accumulate(first, last, ~uint_fast32_t{0} & uint_fast32_t{0xFFFFFFFFuL},
                           [](uint_fast32_t checksum, std::uint_fast8_t value) { return table[(checksum ^ value) & 0xFFu] ^ (checksum >> 8); });
 }
+inline uint32_t UtilAlgorithm::crc32(const char* data, size_t size, uint32_t crc32) {
+  static const auto tableList = []() {
+    std::array<std::array<uint32_t, 256>, 8> tableList{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t checksum = i;
+      for (int j = 0; j < 8; ++j) {
+        checksum = (checksum >> 1) ^ ((checksum & 0x1u) ? 0xEDB88320u : 0);
+      }
+      tableList[0][i] = checksum;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (int k = 1; k < 8; ++k) {
+        tableList[k][i] = (tableList[k - 1][i] >> 8) ^ tableList[0][tableList[k - 1][i] & 0xFFu];
+      }
+    }
+    return tableList;
+  }();
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+  uint32_t crc = ~crc32;
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+  if (size >= 64) {
+    size_t chunkSize = size & ~size_t{15};
+    crc = crc32Clmul(p, chunkSize, crc);
+    p += chunkSize;
+    size -= chunkSize;
+  }
+#endif
+  while (size >= 8) {
+    uint32_t one = crc ^ (uint32_t{p[0]} | uint32_t{p[1]} << 8 | uint32_t{p[2]} << 16 | uint32_t{p[3]} << 24);
+    uint32_t two = uint32_t{p[4]} | uint32_t{p[5]} << 8 | uint32_t{p[6]} << 16 | uint32_t{p[7]} << 24;
+    crc = tableList[7][one & 0xFFu] ^ tableList[6][(one >> 8) & 0xFFu] ^ tableList[5][(one >> 16) & 0xFFu] ^ tableList[4][one >> 24] ^
+          tableList[3][two & 0xFFu] ^ tableList[2][(two >> 8) & 0xFFu] ^ tableList[1][(two >> 16) & 0xFFu] ^ tableList[0][two >> 24];
+    p += 8;
+    size -= 8;
+  }
+  while (size > 0) {
+    crc = tableList[0][(crc ^ *p) & 0xFFu] ^ (crc >> 8);
+    ++p;
+    --size;
+  }
+  return ~crc;
+}
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+inline uint32_t UtilAlgorithm::crc32Clmul(const unsigned char* p, size_t size, uint32_t crc) {
+  // the bit-reflected folding constants and the polynomials for the Barrett reduction given at the end of the paper
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+  x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+  x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+  x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  p += 64;
+  size -= 64;
+  while (size >= 64) {
+    x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)));
+    p += 64;
+    size -= 64;
+  }
+  for (__m128i x : {x2, x3, x4}) {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x), x5);
+  }
+  while (size >= 16) {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))), x5);
+    p += 16;
+    size -= 16;
+  }
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, x3), k5k0, 0x00), x2);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, x3), poly, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, x3), poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif
 class UtilSystem CCAPI_FINAL {
  public:
   static bool getEnvAsBool(const std::string variableName, const bool defaultValue = false) {
@@ -7,7 +7,9 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 
 #include "boost/shared_ptr.hpp"
 #include "ccapi_cpp/ccapi_event.h"
@@ -385,6 +387,42 @@ class ExecutionManagementService : public Service {
   virtual void signReqeustForRestGenericPrivateRequest(http::request<http::string_body>& req, const Request& request, std::string& methodString,
                                                        std::string& headerString, std::string& path, std::string& queryString, std::string& body,
                                                        const TimePoint& now, const std::map<std::string, std::string>& credential) {}
+  // Computes the key schedule of the default credential's api secret once, so that signing with it takes neither a lock nor a lookup. Called by the
+  // exchange constructors after setupCredential. If apiSecretIsBase64Encoded, the key is the base64 decoded api secret.
+  void setupHmacKeyDefault(const Hmac::ShaVersion shaVersion, bool apiSecretIsBase64Encoded = false) {
+    this->setupHmacKeyDefault(shaVersion, this->apiSecretName, apiSecretIsBase64Encoded);
+  }
+  // For exchanges whose api secret is stored under another credential name than apiSecretName, e.g. Deribit's client secret.
+  void setupHmacKeyDefault(const Hmac::ShaVersion shaVersion, const std::string& apiSecretName, bool apiSecretIsBase64Encoded = false) {
+    auto it = this->credentialDefault.find(apiSecretName);
+    if (it == this->credentialDefault.end()) {
+      return;
+    }
+    this->hmacKeyDefaultApiSecret = it->second;
+    this->hmacKeyDefaultShaVersion = shaVersion;
+    this->hmacKeyDefaultApiSecretIsBase64Encoded = apiSecretIsBase64Encoded;
+    this->hmacKeyDefault = Hmac::Key(shaVersion, apiSecretIsBase64Encoded ? UtilAlgorithm::base64Decode(it->second) : it->second);
+    this->hmacKeyDefaultIsSetup = true;
+  }
+  // Returns the key schedule of apiSecret. If apiSecretIsBase64Encoded, the key is the base64 decoded api secret. Keys of secrets other than the
+  // default one are computed once and cached by their raw api secret behind a mutex, because requests can be converted on the caller's thread.
+  const Hmac::Key& getHmacKey(const Hmac::ShaVersion shaVersion, const std::string& apiSecret, bool apiSecretIsBase64Encoded = false) {
+    if (this->hmacKeyDefaultIsSetup && shaVersion == this->hmacKeyDefaultShaVersion &&
+        apiSecretIsBase64Encoded == this->hmacKeyDefaultApiSecretIsBase64Encoded && apiSecret == this->hmacKeyDefaultApiSecret) {
+      return this->hmacKeyDefault;
+    }
+#ifndef CCAPI_USE_SINGLE_THREAD
+    std::lock_guard<std::mutex> lock(this->hmacKeyMutex);
+#endif
+    auto key = std::make_tuple(shaVersion, apiSecretIsBase64Encoded, apiSecret);
+    auto it = this->hmacKeyByShaVersionApiSecretMap.find(key);
+    if (it == this->hmacKeyByShaVersionApiSecretMap.end()) {
+      it = this->hmacKeyByShaVersionApiSecretMap
+               .emplace(std::move(key), Hmac::Key(shaVersion, apiSecretIsBase64Encoded ? UtilAlgorithm::base64Decode(apiSecret) : apiSecret))
+               .first;
+    }
+    return it->second;
+  }
   std::string createOrderTarget;
   std::string cancelOrderTarget;
   std::string getOrderTarget;
@@ -401,6 +439,15 @@ class ExecutionManagementService : public Service {
       wsConnectionByCorrelationIdMap;  // TODO(cryptochassis): for consistency, to be renamed to wsConnectionPtrByCorrelationIdMap
 #endif
   std::map<std::string, int> wsRequestIdByConnectionIdMap;
+  bool hmacKeyDefaultIsSetup{};
+  Hmac::ShaVersion hmacKeyDefaultShaVersion{};
+  bool hmacKeyDefaultApiSecretIsBase64Encoded{};
+  std::string hmacKeyDefaultApiSecret;
+  Hmac::Key hmacKeyDefault;
+  std::map<std::tuple<Hmac::ShaVersion, bool, std::string>, Hmac::Key> hmacKeyByShaVersionApiSecretMap;
+#ifndef CCAPI_USE_SINGLE_THREAD
+  std::mutex hmacKeyMutex;
+#endif
 };
 } /* namespace ccapi */
 #endif
@@ -31,6 +31,7 @@ class ExecutionManagementServiceAscendex : public ExecutionManagementService {
     this->apiSecretName = CCAPI_ASCENDEX_API_SECRET;
     this->apiAccountGroupName = CCAPI_ASCENDEX_API_ACCOUNT_GROUP;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiAccountGroupName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/api/pro/v1/cash/order";
     this->cancelOrderTarget = "/api/pro/v1/cash/order";
     this->getOrderTarget = "/api/pro/v1/cash/order/status";
@@ -63,7 +64,8 @@ class ExecutionManagementServiceAscendex : public ExecutionManagementService {
     auto splitted = UtilString::split(path, '/');
     std::vector<std::string> subSplitted(splitted.begin() + 6, splitted.begin() + splitted.size());
     preSignedText += UtilString::join(subSplitted, "/");
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     req.set("x-auth-signature", signature);
     if (!body.empty()) {
       req.body() = body;
@@ -75,7 +77,8 @@ class ExecutionManagementServiceAscendex : public ExecutionManagementService {
     auto preSignedText = req.base().at("x-auth-timestamp").to_string();
     preSignedText += "+";
     preSignedText += apiPath;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     req.set("x-auth-signature", signature);
   }
   void appendParam(rj::Value& rjValue, rj::Document::AllocatorType& allocator, const std::map<std::string, std::string>& param,
@@ -397,7 +400,8 @@ class ExecutionManagementServiceAscendex : public ExecutionManagementService {
     document.AddMember("key", rj::Value(apiKey.c_str(), allocator).Move(), allocator);
     document.AddMember("t", rj::Value(t).Move(), allocator);
     std::string signData = std::to_string(t) + "+stream";
-    std::string sign = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, signData));
+    std::string sign;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(sign, signData);
     document.AddMember("sig", rj::Value(sign.c_str(), allocator).Move(), allocator);
     rj::StringBuffer stringBuffer;
     rj::Writer<rj::StringBuffer> writer(stringBuffer);
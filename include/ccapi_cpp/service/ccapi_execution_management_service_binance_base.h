@@ -288,9 +288,10 @@ class ExecutionManagementServiceBinanceBase : public ExecutionManagementService
       queryString += std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
     }
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, queryString, true);
+    const auto& hmacKey = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret);
+    size_t queryStringSize = queryString.size();
     queryString += "&signature=";
-    queryString += signature;
+    hmacKey.appendHex(queryString, std::string_view(queryString.data(), queryStringSize));
   }
   void signRequest(std::string& queryString, const std::map<std::string, std::string>& param, const TimePoint& now,
                    const std::map<std::string, std::string>& credential) {
@@ -303,9 +304,10 @@ class ExecutionManagementServiceBinanceBase : public ExecutionManagementService
       queryString.pop_back();
     }
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, queryString, true);
+    const auto& hmacKey = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret);
+    size_t queryStringSize = queryString.size();
     queryString += "&signature=";
-    queryString += signature;
+    hmacKey.appendHex(queryString, std::string_view(queryString.data(), queryStringSize));
   }
   void appendParam(std::string& queryString, const std::map<std::string, std::string>& param,
                    const std::map<std::string, std::string> standardizationMap = {}) {
@@ -30,6 +30,7 @@ class ExecutionManagementServiceBinanceCoinFutures : public ExecutionManagementS
     this->apiKeyName = CCAPI_BINANCE_COIN_FUTURES_API_KEY;
     this->apiSecretName = CCAPI_BINANCE_COIN_FUTURES_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = CCAPI_BINANCE_COIN_FUTURES_CREATE_ORDER_PATH;
     this->cancelOrderTarget = "/dapi/v1/order";
     this->getOrderTarget = "/dapi/v1/order";
@@ -30,6 +30,7 @@ class ExecutionManagementServiceBinanceUs : public ExecutionManagementServiceBin
     this->apiKeyName = CCAPI_BINANCE_US_API_KEY;
     this->apiSecretName = CCAPI_BINANCE_US_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = CCAPI_BINANCE_US_CREATE_ORDER_PATH;
     this->cancelOrderTarget = "/api/v3/order";
     this->getOrderTarget = "/api/v3/order";
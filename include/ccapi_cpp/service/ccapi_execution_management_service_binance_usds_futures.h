@@ -30,6 +30,7 @@ class ExecutionManagementServiceBinanceUsdsFutures : public ExecutionManagementS
     this->apiKeyName = CCAPI_BINANCE_USDS_FUTURES_API_KEY;
     this->apiSecretName = CCAPI_BINANCE_USDS_FUTURES_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = CCAPI_BINANCE_USDS_FUTURES_CREATE_ORDER_PATH;
     this->cancelOrderTarget = "/fapi/v1/order";
     this->getOrderTarget = "/fapi/v1/order";
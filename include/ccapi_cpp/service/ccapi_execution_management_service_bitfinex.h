@@ -30,6 +30,7 @@ class ExecutionManagementServiceBitfinex : public ExecutionManagementService {
     this->apiKeyName = CCAPI_BITFINEX_API_KEY;
     this->apiSecretName = CCAPI_BITFINEX_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA384);
     this->createOrderTarget = "/v2/auth/w/order/submit";
     this->cancelOrderTarget = "/v2/auth/w/order/cancel";
     this->getOrderTarget = "/v2/auth/r/orders/:Symbol/hist";
@@ -66,7 +67,7 @@ class ExecutionManagementServiceBitfinex : public ExecutionManagementService {
     preSignedText += path;
     preSignedText += req.base().at("bfx-nonce").to_string();
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA384, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA384, apiSecret).sign(preSignedText, true);
     req.set("bfx-signature", signature);
     req.target(path);
     req.body() = body;
@@ -338,7 +339,7 @@ class ExecutionManagementServiceBitfinex : public ExecutionManagementService {
     document.AddMember("authNonce", rj::Value(nonce).Move(), allocator);
     std::string authPayload = "AUTH" + std::to_string(nonce);
     document.AddMember("authPayload", rj::Value(authPayload.c_str(), allocator).Move(), allocator);
-    std::string authSig = Hmac::hmac(Hmac::ShaVersion::SHA384, apiSecret, authPayload, true);
+    std::string authSig = this->getHmacKey(Hmac::ShaVersion::SHA384, apiSecret).sign(authPayload, true);
     document.AddMember("authSig", rj::Value(authSig.c_str(), allocator).Move(), allocator);
     rj::Value filter(rj::kArrayType);
     const auto& fieldSet = subscription.getFieldSet();
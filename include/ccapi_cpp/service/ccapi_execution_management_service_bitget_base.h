@@ -35,7 +35,8 @@ class ExecutionManagementServiceBitgetBase : public ExecutionManagementService {
     }
     preSignedText += target;
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -47,7 +48,8 @@ class ExecutionManagementServiceBitgetBase : public ExecutionManagementService {
     preSignedText += std::string(req.method_string());
     preSignedText += req.target().to_string();
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     req.set("ACCESS-SIGN", signature);
     req.body() = body;
     req.prepare_payload();
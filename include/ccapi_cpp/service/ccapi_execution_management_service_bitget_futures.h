@@ -31,6 +31,7 @@ class ExecutionManagementServiceBitgetFutures : public ExecutionManagementServic
     this->apiSecretName = CCAPI_BITGET_FUTURES_API_SECRET;
     this->apiPassphraseName = CCAPI_BITGET_FUTURES_API_PASSPHRASE;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiPassphraseName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/api/mix/v1/order/placeOrder";
     this->cancelOrderTarget = "/api/mix/v1/order/cancel-order";
     this->getOrderTarget = "/api/mix/v1/order/detail";
@@ -297,7 +298,8 @@ class ExecutionManagementServiceBitgetFutures : public ExecutionManagementServic
     arg.AddMember("passphrase", rj::Value(apiPassphrase.c_str(), allocator).Move(), allocator);
     arg.AddMember("timestamp", rj::Value(ts.c_str(), allocator).Move(), allocator);
     std::string signData = ts + "GET" + "/user/verify";
-    std::string sign = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, signData));
+    std::string sign;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(sign, signData);
     arg.AddMember("sign", rj::Value(sign.c_str(), allocator).Move(), allocator);
     rj::Value args(rj::kArrayType);
     args.PushBack(arg, allocator);
@@ -31,6 +31,7 @@ class ExecutionManagementServiceBitmart : public ExecutionManagementService {
     this->apiSecretName = CCAPI_BITMART_API_SECRET;
     this->apiMemoName = CCAPI_BITMART_API_MEMO;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiMemoName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/spot/v2/submit_order";
     this->cancelOrderTarget = "/spot/v3/cancel_order";
     this->getOrderTarget = "/spot/v2/order_detail";
@@ -73,7 +74,7 @@ class ExecutionManagementServiceBitmart : public ExecutionManagementService {
       paramString = body;
     }
     preSignedText += paramString;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -86,7 +87,7 @@ class ExecutionManagementServiceBitmart : public ExecutionManagementService {
     preSignedText += mapGetWithDefault(credential, this->apiMemoName);
     preSignedText += "#";
     preSignedText += paramString;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set("X-BM-SIGN", signature);
   }
   void appendParam(Request::Operation operation, rj::Value& rjValue, rj::Document::AllocatorType& allocator, const std::map<std::string, std::string>& param,
@@ -288,7 +289,7 @@ class ExecutionManagementServiceBitmart : public ExecutionManagementService {
     auto timestamp = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
     std::string preSignedText = timestamp + "#" + mapGetWithDefault(credential, this->apiMemoName) + "#bitmart.WebSocket";
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     rj::Value args(rj::kArrayType);
     args.PushBack(rj::Value(apiKey.c_str(), allocator).Move(), allocator);
     args.PushBack(rj::Value(timestamp.c_str(), allocator).Move(), allocator);
@@ -30,6 +30,7 @@ class ExecutionManagementServiceBitmex : public ExecutionManagementService {
     this->apiKeyName = CCAPI_BITMEX_API_KEY;
     this->apiSecretName = CCAPI_BITMEX_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     std::string prefix = "/api/v1";
     this->createOrderTarget = prefix + "/order";
     this->cancelOrderTarget = prefix + "/order";
@@ -56,7 +57,7 @@ class ExecutionManagementServiceBitmex : public ExecutionManagementService {
     preSignedText += target;
     preSignedText += req.base().at("api-expires").to_string();
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -68,7 +69,7 @@ class ExecutionManagementServiceBitmex : public ExecutionManagementService {
     preSignedText += req.target().to_string();
     preSignedText += req.base().at("api-expires").to_string();
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set("api-signature", signature);
     req.body() = body;
     req.prepare_payload();
@@ -300,7 +301,7 @@ class ExecutionManagementServiceBitmex : public ExecutionManagementService {
     std::string preSignedText = "GET";
     preSignedText += "/realtime";
     preSignedText += std::to_string(expires);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     rj::Value args(rj::kArrayType);
     args.PushBack(rj::Value(apiKey.c_str(), allocator).Move(), allocator);
     args.PushBack(rj::Value(expires).Move(), allocator);
@@ -30,6 +30,7 @@ class ExecutionManagementServiceBitstamp : public ExecutionManagementService {
     this->apiKeyName = CCAPI_BITSTAMP_API_KEY;
     this->apiSecretName = CCAPI_BITSTAMP_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     std::string prefix = "/api/v2";
     this->createOrderTarget = prefix + "/{buy_or_sell}/{order_type}/{currency_pair}/";
     this->cancelOrderTarget = prefix + "/cancel_order/";
@@ -78,7 +79,7 @@ class ExecutionManagementServiceBitstamp : public ExecutionManagementService {
     preSignedText += req.base().at("X-Auth-Timestamp").to_string();
     preSignedText += req.base().at("X-Auth-Version").to_string();
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -100,7 +101,7 @@ class ExecutionManagementServiceBitstamp : public ExecutionManagementService {
     preSignedText += req.base().at("X-Auth-Timestamp").to_string();
     preSignedText += req.base().at("X-Auth-Version").to_string();
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set("X-Auth-Signature", signature);
     if (!body.empty()) {
       req.body() = body;
@@ -30,6 +30,7 @@ class ExecutionManagementServiceBybit : public ExecutionManagementServiceBybitBa
     this->apiKeyName = CCAPI_BYBIT_API_KEY;
     this->apiSecretName = CCAPI_BYBIT_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/spot/v3/private/order";
     this->cancelOrderTarget = "/spot/v3/private/cancel-order";
     this->getOrderTarget = "/spot/v3/private/order";
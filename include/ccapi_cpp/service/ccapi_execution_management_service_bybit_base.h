@@ -35,7 +35,7 @@ class ExecutionManagementServiceBybitBase : public ExecutionManagementService {
       aString = body;
     }
     preSignedText += aString;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set("X-BAPI-SIGN", signature);
   }
   void signRequest(http::request<http::string_body>& req, const std::string aString, const TimePoint& now,
@@ -46,7 +46,7 @@ class ExecutionManagementServiceBybitBase : public ExecutionManagementService {
     preSignedText += apiKey;
     preSignedText += req.base().at("X-BAPI-RECV-WINDOW").to_string();
     preSignedText += aString;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set("X-BAPI-SIGN", signature);
   }
   void appendParamToQueryString(std::string& queryString, const std::map<std::string, std::string>& param,
@@ -89,7 +89,7 @@ class ExecutionManagementServiceBybitBase : public ExecutionManagementService {
     std::string preSignedText = "GET";
     preSignedText += "/realtime";
     preSignedText += std::to_string(expires);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     rj::Value args(rj::kArrayType);
     args.PushBack(rj::Value(apiKey.c_str(), allocator).Move(), allocator);
     args.PushBack(rj::Value(expires).Move(), allocator);
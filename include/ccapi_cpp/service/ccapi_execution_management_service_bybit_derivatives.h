@@ -30,6 +30,7 @@ class ExecutionManagementServiceBybitDerivatives : public ExecutionManagementSer
     this->apiKeyName = CCAPI_BYBIT_DERIVATIVES_API_KEY;
     this->apiSecretName = CCAPI_BYBIT_DERIVATIVES_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/unified/v3/private/order/create";
     this->cancelOrderTarget = "/unified/v3/private/order/cancel";
     this->getOrderTarget = "/unified/v3/private/order/list";
@@ -31,6 +31,7 @@ class ExecutionManagementServiceCoinbase : public ExecutionManagementService {
     this->apiSecretName = CCAPI_COINBASE_API_SECRET;
     this->apiPassphraseName = CCAPI_COINBASE_API_PASSPHRASE;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiPassphraseName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256, true);
     this->createOrderTarget = "/orders";
     this->cancelOrderTarget = "/orders/<id>";
     this->getOrderTarget = "/orders/<id>";
@@ -56,7 +57,8 @@ class ExecutionManagementServiceCoinbase : public ExecutionManagementService {
     }
     preSignedText += target;
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, UtilAlgorithm::base64Decode(apiSecret), preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret, true).appendBase64(signature, preSignedText);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -68,7 +70,8 @@ class ExecutionManagementServiceCoinbase : public ExecutionManagementService {
     preSignedText += std::string(req.method_string());
     preSignedText += req.target().to_string();
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, UtilAlgorithm::base64Decode(apiSecret), preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret, true).appendBase64(signature, preSignedText);
     req.set("CB-ACCESS-SIGN", signature);
     req.body() = body;
     req.prepare_payload();
@@ -250,7 +253,8 @@ class ExecutionManagementServiceCoinbase : public ExecutionManagementService {
     auto preSignedText = timestamp;
     preSignedText += "GET";
     preSignedText += "/users/self/verify";
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, UtilAlgorithm::base64Decode(apiSecret), preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret, true).appendBase64(signature, preSignedText);
     std::vector<std::string> sendStringList;
     rj::Document document;
     document.SetObject();
@@ -30,6 +30,7 @@ class ExecutionManagementServiceCryptocom : public ExecutionManagementService {
     this->apiKeyName = CCAPI_CRYPTOCOM_API_KEY;
     this->apiSecretName = CCAPI_CRYPTOCOM_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->pathPrefix = "/v2/";
     this->createOrderMethod = "private/create-order";
     this->cancelOrderMethod = "private/cancel-order";
@@ -75,7 +76,7 @@ class ExecutionManagementServiceCryptocom : public ExecutionManagementService {
     preSignedText += apiKey;
     preSignedText += document["nonce"].GetString();
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     document.AddMember("sig", rj::Value(signature.c_str(), allocator).Move(), allocator);
     rj::StringBuffer stringBuffer;
     rj::Writer<rj::StringBuffer> writer(stringBuffer);
@@ -108,7 +109,7 @@ class ExecutionManagementServiceCryptocom : public ExecutionManagementService {
     preSignedText += paramsString;
     preSignedText += std::to_string(nonce);
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     document.AddMember("sig", rj::Value(signature.c_str(), allocator).Move(), allocator);
     rj::StringBuffer stringBuffer;
     rj::Writer<rj::StringBuffer> writer(stringBuffer);
@@ -30,6 +30,7 @@ class ExecutionManagementServiceDeribit : public ExecutionManagementService {
     this->clientIdName = CCAPI_DERIBIT_CLIENT_ID;
     this->clientSecretName = CCAPI_DERIBIT_CLIENT_SECRET;
     this->setupCredential({this->clientIdName, this->clientSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256, this->clientSecretName);
     this->restTarget = "/api/v2";
     this->createOrderBuyTarget = "/private/buy";
     this->createOrderSellTarget = "/private/sell";
@@ -126,7 +127,7 @@ class ExecutionManagementServiceDeribit : public ExecutionManagementService {
     stringToSign += "\n";
     stringToSign += requestData;
     auto clientSecret = mapGetWithDefault(credential, this->clientSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, clientSecret, stringToSign, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, clientSecret).sign(stringToSign, true);
     authorizationHeader += signature;
     authorizationHeader += ",nonce=";
     authorizationHeader += nonce;
@@ -152,7 +153,7 @@ class ExecutionManagementServiceDeribit : public ExecutionManagementService {
     stringToSign += "\n";
     stringToSign += requestData;
     auto clientSecret = mapGetWithDefault(credential, this->clientSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, clientSecret, stringToSign, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, clientSecret).sign(stringToSign, true);
     authorizationHeader += signature;
     authorizationHeader += ",nonce=";
     authorizationHeader += nonce;
@@ -341,7 +342,7 @@ class ExecutionManagementServiceDeribit : public ExecutionManagementService {
     std::string nonce = ts;
     std::string stringToSign = ts + "\n" + nonce + "\n";
     auto clientSecret = mapGetWithDefault(credential, this->clientSecretName);
-    std::string signature = Hmac::hmac(Hmac::ShaVersion::SHA256, clientSecret, stringToSign, true);
+    std::string signature = this->getHmacKey(Hmac::ShaVersion::SHA256, clientSecret).sign(stringToSign, true);
     this->appendParam(document, allocator, requestId, "public/auth",
                       {
                           {"grant_type", "client_signature"},
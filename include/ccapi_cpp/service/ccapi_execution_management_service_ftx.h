@@ -31,6 +31,7 @@ class ExecutionManagementServiceFtx : public ExecutionManagementServiceFtxBase {
     this->apiSecretName = CCAPI_FTX_API_SECRET;
     this->apiSubaccountName = CCAPI_FTX_API_SUBACCOUNT;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiSubaccountName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->getAccountPositionsTarget = "/api/positions";
     this->ftx = "FTX";
   }
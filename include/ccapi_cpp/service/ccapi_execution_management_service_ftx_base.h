@@ -39,7 +39,7 @@ class ExecutionManagementServiceFtxBase : public ExecutionManagementService {
     }
     preSignedText += target;
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -51,7 +51,7 @@ class ExecutionManagementServiceFtxBase : public ExecutionManagementService {
     preSignedText += std::string(req.method_string());
     preSignedText += req.target().to_string();
     preSignedText += body;
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set(this->ftx + "-SIGN", signature);
     req.body() = body;
     req.prepare_payload();
@@ -287,7 +287,7 @@ class ExecutionManagementServiceFtxBase : public ExecutionManagementService {
     std::string ts = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
     args.AddMember("key", rj::Value(apiKey.c_str(), allocatorArgs).Move(), allocatorArgs);
     std::string signData = ts + "websocket_login";
-    std::string sign = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, signData, true);
+    std::string sign = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(signData, true);
     args.AddMember("sign", rj::Value(sign.c_str(), allocatorArgs).Move(), allocatorArgs);
     rj::Value timeRj;
     timeRj.SetInt64(std::stoll(ts));
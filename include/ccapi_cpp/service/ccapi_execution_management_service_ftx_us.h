@@ -31,6 +31,7 @@ class ExecutionManagementServiceFtxUs : public ExecutionManagementServiceFtxBase
     this->apiSecretName = CCAPI_FTX_US_API_SECRET;
     this->apiSubaccountName = CCAPI_FTX_US_API_SUBACCOUNT;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiSubaccountName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->ftx = "FTXUS";
   }
   virtual ~ExecutionManagementServiceFtxUs() {}
@@ -30,6 +30,7 @@ class ExecutionManagementServiceGateio : public ExecutionManagementServiceGateio
     this->apiKeyName = CCAPI_GATEIO_API_KEY;
     this->apiSecretName = CCAPI_GATEIO_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA512);
     std::string prefix = "/api/v4";
     this->createOrderTarget = prefix + "/spot/orders";
     this->cancelOrderTarget = prefix + "/spot/orders/{order_id}";
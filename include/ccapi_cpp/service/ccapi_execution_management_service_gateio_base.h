@@ -42,7 +42,7 @@ class ExecutionManagementServiceGateioBase : public ExecutionManagementService {
     preSignedText += UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA512, body, true);
     preSignedText += "\n";
     preSignedText += req.base().at("TIMESTAMP").to_string();
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA512, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret).sign(preSignedText, true);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -60,7 +60,7 @@ class ExecutionManagementServiceGateioBase : public ExecutionManagementService {
     preSignedText += UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA512, body, true);
     preSignedText += "\n";
     preSignedText += req.base().at("TIMESTAMP").to_string();
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA512, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret).sign(preSignedText, true);
     req.set("SIGN", signature);
     req.target(queryString.empty() ? path : path + "?" + queryString);
     req.body() = body;
@@ -341,7 +341,7 @@ class ExecutionManagementServiceGateioBase : public ExecutionManagementService {
       auth.AddMember("method", rj::Value("api_key").Move(), allocator);
       auth.AddMember("KEY", rj::Value(apiKey.c_str(), allocator).Move(), allocator);
       std::string preSignedText = "channel=" + channel + "&event=subscribe&time=" + std::to_string(time);
-      auto signature = Hmac::hmac(Hmac::ShaVersion::SHA512, apiSecret, preSignedText, true);
+      auto signature = this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret).sign(preSignedText, true);
       auth.AddMember("SIGN", rj::Value(signature.c_str(), allocator).Move(), allocator);
       document.AddMember("auth", auth, allocator);
       rj::StringBuffer stringBuffer;
@@ -30,6 +30,7 @@ class ExecutionManagementServiceGateioPerpetualFutures : public ExecutionManagem
     this->apiKeyName = CCAPI_GATEIO_PERPETUAL_FUTURES_API_KEY;
     this->apiSecretName = CCAPI_GATEIO_PERPETUAL_FUTURES_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA512);
     std::string prefix = "/api/v4";
     this->createOrderTarget = prefix + "/futures/{settle}/orders";
     this->cancelOrderTarget = prefix + "/futures/{settle}/orders/{order_id}";
@@ -30,6 +30,7 @@ class ExecutionManagementServiceGemini : public ExecutionManagementService {
     this->apiKeyName = CCAPI_GEMINI_API_KEY;
     this->apiSecretName = CCAPI_GEMINI_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA384);
     this->createOrderTarget = "/v1/order/new";
     this->cancelOrderTarget = "/v1/order/cancel";
     this->getOrderTarget = "/v1/order/status";
@@ -49,7 +50,7 @@ class ExecutionManagementServiceGemini : public ExecutionManagementService {
     auto headerMap = ExecutionManagementService::convertHeaderStringToMap(headerString);
     auto base64Payload = mapGetWithDefault(headerMap, std::string("X-GEMINI-PAYLOAD"));
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA384, apiSecret, base64Payload, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA384, apiSecret).sign(base64Payload, true);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -69,7 +70,7 @@ class ExecutionManagementServiceGemini : public ExecutionManagementService {
     auto base64Payload = UtilAlgorithm::base64Encode(body);
     req.set("X-GEMINI-PAYLOAD", base64Payload);
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA384, apiSecret, base64Payload, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA384, apiSecret).sign(base64Payload, true);
     req.set("X-GEMINI-SIGNATURE", signature);
   }
   void appendParam(rj::Document& document, rj::Document::AllocatorType& allocator, const std::map<std::string, std::string>& param,
@@ -300,7 +301,7 @@ class ExecutionManagementServiceGemini : public ExecutionManagementService {
     auto base64Payload = UtilAlgorithm::base64Encode(payload);
     wsConnection.headers.insert({"X-GEMINI-PAYLOAD", base64Payload});
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA384, apiSecret, base64Payload, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA384, apiSecret).sign(base64Payload, true);
     wsConnection.headers.insert({"X-GEMINI-SIGNATURE", signature});
     this->connect(wsConnection);
   }
@@ -331,7 +332,7 @@ class ExecutionManagementServiceGemini : public ExecutionManagementService {
     auto base64Payload = UtilAlgorithm::base64Encode(payload);
     wsConnectionPtr->headers.insert({"X-GEMINI-PAYLOAD", base64Payload});
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA384, apiSecret, base64Payload, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA384, apiSecret).sign(base64Payload, true);
     wsConnectionPtr->headers.insert({"X-GEMINI-SIGNATURE", signature});
     this->connect(wsConnectionPtr);
   }
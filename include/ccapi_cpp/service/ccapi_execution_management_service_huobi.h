@@ -30,6 +30,7 @@ class ExecutionManagementServiceHuobi : public ExecutionManagementServiceHuobiBa
     this->apiKeyName = CCAPI_HUOBI_API_KEY;
     this->apiSecretName = CCAPI_HUOBI_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/v1/order/orders/place";
     this->cancelOrderTarget = "/v1/order/orders/{order-id}/submitcancel";
     this->cancelOrderByClientOrderIdTarget = "/v1/order/orders/submitCancelClientOrder";
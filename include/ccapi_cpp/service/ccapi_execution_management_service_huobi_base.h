@@ -35,7 +35,8 @@ class ExecutionManagementServiceHuobiBase : public ExecutionManagementService {
     }
     preSignedText += queryString;
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    signature.clear();
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
   }
   void signReqeustForRestGenericPrivateRequest(http::request<http::string_body>& req, const Request& request, std::string& methodString,
                                                std::string& headerString, std::string& path, std::string& queryString, std::string& body, const TimePoint& now,
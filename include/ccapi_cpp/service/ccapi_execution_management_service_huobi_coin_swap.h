@@ -30,6 +30,7 @@ class ExecutionManagementServiceHuobiCoinSwap : public ExecutionManagementServic
     this->apiKeyName = CCAPI_HUOBI_COIN_SWAP_API_KEY;
     this->apiSecretName = CCAPI_HUOBI_COIN_SWAP_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = CCAPI_HUOBI_COIN_SWAP_CREATE_ORDER_PATH;
     this->cancelOrderTarget = CCAPI_HUOBI_COIN_SWAP_CANCEL_ORDER_PATH;
     this->getOrderTarget = CCAPI_HUOBI_COIN_SWAP_GET_ORDER_PATH;
@@ -31,6 +31,7 @@ class ExecutionManagementServiceKraken : public ExecutionManagementService {
     this->apiKeyName = CCAPI_KRAKEN_API_KEY;
     this->apiSecretName = CCAPI_KRAKEN_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA512, true);
     std::string prefix = "/0/private";
     this->createOrderTarget = prefix + "/AddOrder";
     this->cancelOrderTarget = prefix + "/CancelOrder";
@@ -70,7 +71,8 @@ class ExecutionManagementServiceKraken : public ExecutionManagementService {
     std::string preSignedText = target;
     std::string noncePlusBodySha256 = UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA256, noncePlusBody);
     preSignedText += noncePlusBodySha256;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA512, UtilAlgorithm::base64Decode(apiSecret), preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret, true).appendBase64(signature, preSignedText);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -83,7 +85,8 @@ class ExecutionManagementServiceKraken : public ExecutionManagementService {
     std::string preSignedText = req.target().to_string();
     std::string noncePlusBodySha256 = UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA256, noncePlusBody);
     preSignedText += noncePlusBodySha256;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA512, UtilAlgorithm::base64Decode(apiSecret), preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret, true).appendBase64(signature, preSignedText);
     req.set("API-Sign", signature);
     req.body() = body;
     req.prepare_payload();
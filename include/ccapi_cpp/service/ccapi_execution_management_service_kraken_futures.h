@@ -31,6 +31,7 @@ class ExecutionManagementServiceKrakenFutures : public ExecutionManagementServic
     this->apiKeyName = CCAPI_KRAKEN_FUTURES_API_KEY;
     this->apiSecretName = CCAPI_KRAKEN_FUTURES_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA512, true);
     std::string prefix("/derivatives/api/v3");
     std::string prefix_2("/api/v3");
     this->createOrderTarget = prefix + "/sendorder";
@@ -61,7 +62,8 @@ class ExecutionManagementServiceKrakenFutures : public ExecutionManagementServic
     ;
     preSignedText += path;
     std::string preSignedTextSha256 = UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA256, preSignedText);
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA512, UtilAlgorithm::base64Decode(apiSecret), preSignedTextSha256));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret, true).appendBase64(signature, preSignedTextSha256);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -74,7 +76,8 @@ class ExecutionManagementServiceKrakenFutures : public ExecutionManagementServic
     preSignedText += nonce;
     preSignedText += path;
     std::string preSignedTextSha256 = UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA256, preSignedText);
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA512, UtilAlgorithm::base64Decode(apiSecret), preSignedTextSha256));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret, true).appendBase64(signature, preSignedTextSha256);
     req.set("Authent", signature);
   }
   std::string generateNonce(const TimePoint& now, int requestIndex) {
@@ -381,7 +384,8 @@ class ExecutionManagementServiceKrakenFutures : public ExecutionManagementServic
         auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
         std::string challengeToSign = document["message"].GetString();
         std::string challengeToSignSha256 = UtilAlgorithm::computeHash(UtilAlgorithm::ShaVersion::SHA256, challengeToSign);
-        auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA512, UtilAlgorithm::base64Decode(apiSecret), challengeToSignSha256));
+        std::string signature;
+        this->getHmacKey(Hmac::ShaVersion::SHA512, apiSecret, true).appendBase64(signature, challengeToSignSha256);
         std::vector<std::string> sendStringList;
         for (const auto& field : subscription.getFieldSet()) {
           {
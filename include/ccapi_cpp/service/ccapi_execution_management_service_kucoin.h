@@ -29,6 +29,7 @@ class ExecutionManagementServiceKucoin : public ExecutionManagementServiceKucoin
     this->apiSecretName = CCAPI_KUCOIN_API_SECRET;
     this->apiPassphraseName = CCAPI_KUCOIN_API_PASSPHRASE;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiPassphraseName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/api/v1/orders";
     this->cancelOrderTarget = "/api/v1/orders/<id>";
     this->getOrderTarget = "/api/v1/orders/<id>";
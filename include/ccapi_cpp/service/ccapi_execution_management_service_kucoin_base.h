@@ -133,7 +133,8 @@ class ExecutionManagementServiceKucoinBase : public ExecutionManagementService {
     }
     preSignedText += target;
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -144,7 +145,8 @@ class ExecutionManagementServiceKucoinBase : public ExecutionManagementService {
     auto preSignedText = req.base().at("KC-API-TIMESTAMP").to_string();
     preSignedText += CCAPI_KUCOIN_API_PARTNER_PLATFORM_ID;
     preSignedText += req.base().at("KC-API-KEY").to_string();
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, CCAPI_KUCOIN_API_PARTNER_PRIVATE_KEY, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, CCAPI_KUCOIN_API_PARTNER_PRIVATE_KEY).appendBase64(signature, preSignedText);
     req.set("KC-API-PARTNER-SIGN", signature);
   }
   void signRequest(http::request<http::string_body>& req, const std::string& body, const std::map<std::string, std::string>& credential) {
@@ -153,13 +155,14 @@ class ExecutionManagementServiceKucoinBase : public ExecutionManagementService {
     preSignedText += std::string(req.method_string());
     preSignedText += req.target().to_string();
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     req.set("KC-API-SIGN", signature);
     req.body() = body;
     req.prepare_payload();
   }
   void signApiPassphrase(http::request<http::string_body>& req, const std::string& apiPassphrase, const std::string& apiSecret) {
-    req.set("KC-API-PASSPHRASE", UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, apiPassphrase)));
+    req.set("KC-API-PASSPHRASE", UtilAlgorithm::base64Encode(this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(apiPassphrase)));
   }
   void appendParam(rj::Document& document, rj::Document::AllocatorType& allocator, const std::map<std::string, std::string>& param,
                    const std::map<std::string, std::string> standardizationMap = {
@@ -31,6 +31,7 @@ class ExecutionManagementServiceMexc : public ExecutionManagementService {
     this->apiKeyName = CCAPI_MEXC_API_KEY;
     this->apiSecretName = CCAPI_MEXC_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = CCAPI_MEXC_CREATE_ORDER_PATH;
     this->cancelOrderTarget = "/api/v3/order";
     this->getOrderTarget = "/api/v3/order";
@@ -63,7 +64,7 @@ class ExecutionManagementServiceMexc : public ExecutionManagementService {
       queryString += std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
     }
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, queryString, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(queryString, true);
     queryString += "&signature=";
     queryString += signature;
   }
@@ -78,7 +79,7 @@ class ExecutionManagementServiceMexc : public ExecutionManagementService {
       queryString.pop_back();
     }
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, queryString, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(queryString, true);
     queryString += "&signature=";
     queryString += signature;
   }
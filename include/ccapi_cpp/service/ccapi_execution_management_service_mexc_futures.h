@@ -30,6 +30,7 @@ class ExecutionManagementServiceMexcFutures : public ExecutionManagementService
     this->apiKeyName = CCAPI_MEXC_FUTURES_API_KEY;
     this->apiSecretName = CCAPI_MEXC_FUTURES_API_SECRET;
     this->setupCredential({this->apiKeyName, this->apiSecretName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/api/v1/private/order/submit";
     this->cancelOrderTarget = "/api/v1/private/order/cancel";
     this->cancelOrderWithExternalOidTarget = "/api/v1/private/order/cancel_with_external";
@@ -74,7 +75,8 @@ class ExecutionManagementServiceMexcFutures : public ExecutionManagementService
     }
     preSignedText += queryString;
     auto apiSecret = mapGetWithDefault(credential, this->apiSecretName);
-    signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    signature.clear();
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
   }
   void signReqeustForRestGenericPrivateRequest(http::request<http::string_body>& req, const Request& request, std::string& methodString,
                                                std::string& headerString, std::string& path, std::string& queryString, std::string& body, const TimePoint& now,
@@ -111,7 +113,7 @@ class ExecutionManagementServiceMexcFutures : public ExecutionManagementService
     preSignedText += paramString;
     CCAPI_LOGGER_TRACE("preSignedText = " + preSignedText);
     CCAPI_LOGGER_TRACE("apiSecret = " + apiSecret);
-    auto signature = Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText, true);
+    auto signature = this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).sign(preSignedText, true);
     req.set("Signature", signature);
   }
   void appendParam(Request::Operation operation, rj::Value& rjValue, rj::Document::AllocatorType& allocator, const std::map<std::string, std::string>& param,
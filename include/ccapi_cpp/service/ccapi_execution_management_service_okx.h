@@ -32,6 +32,7 @@ class ExecutionManagementServiceOkx : public ExecutionManagementService {
     this->apiPassphraseName = CCAPI_OKX_API_PASSPHRASE;
     this->apiXSimulatedTradingName = CCAPI_OKX_API_X_SIMULATED_TRADING;
     this->setupCredential({this->apiKeyName, this->apiSecretName, this->apiPassphraseName, this->apiXSimulatedTradingName});
+    this->setupHmacKeyDefault(Hmac::ShaVersion::SHA256);
     this->createOrderTarget = "/api/v5/trade/order";
     this->cancelOrderTarget = "/api/v5/trade/cancel-order";
     this->getOrderTarget = "/api/v5/trade/order";
@@ -62,7 +63,8 @@ class ExecutionManagementServiceOkx : public ExecutionManagementService {
     }
     preSignedText += target;
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     if (!headerString.empty()) {
       headerString += "\r\n";
     }
@@ -74,7 +76,8 @@ class ExecutionManagementServiceOkx : public ExecutionManagementService {
     preSignedText += std::string(req.method_string());
     preSignedText += req.target().to_string();
     preSignedText += body;
-    auto signature = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, preSignedText));
+    std::string signature;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(signature, preSignedText);
     req.set("OK-ACCESS-SIGN", signature);
     req.body() = body;
     req.prepare_payload();
@@ -358,7 +361,8 @@ class ExecutionManagementServiceOkx : public ExecutionManagementService {
     arg.AddMember("passphrase", rj::Value(apiPassphrase.c_str(), allocator).Move(), allocator);
     arg.AddMember("timestamp", rj::Value(ts.c_str(), allocator).Move(), allocator);
     std::string signData = ts + "GET" + "/users/self/verify";
-    std::string sign = UtilAlgorithm::base64Encode(Hmac::hmac(Hmac::ShaVersion::SHA256, apiSecret, signData));
+    std::string sign;
+    this->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret).appendBase64(sign, signData);
     arg.AddMember("sign", rj::Value(sign.c_str(), allocator).Move(), allocator);
     rj::Value args(rj::kArrayType);
     args.PushBack(arg, allocator);
@@ -7,6 +7,7 @@
 #ifndef CCAPI_FIX_WRITE_BUFFER_SIZE
 #define CCAPI_FIX_WRITE_BUFFER_SIZE 1 << 20
 #endif
+#include "ccapi_cpp/ccapi_fix_journal.h"
 #include "ccapi_cpp/service/ccapi_service.h"
 #include "hffix.hpp"
 namespace hff = hffix;
@@ -22,6 +23,12 @@ class FixService : public Service {
              ServiceContextPtr serviceContextPtr)
       : Service(eventHandler, sessionOptions, sessionConfigs, serviceContextPtr) {}
   virtual ~FixService() {}
+  // Deliver execution reports, order cancel rejects, rejects and business message rejects to fixHandler as well. If skipFixEvents is true, the corresponding
+  // Events aren't generated at all.
+  void setFixHandler(FixHandler* fixHandler, bool skipFixEvents) override {
+    this->fixHandler = fixHandler;
+    this->skipFixEvents = fixHandler && skipFixEvents;
+  }
 #ifndef CCAPI_EXPOSE_INTERNAL
 
  protected:
@@ -76,6 +83,12 @@ class FixService : public Service {
     this->fixConnectionPtrByIdMap.erase(connectionId);
     this->sequenceSentByConnectionIdMap.erase(connectionId);
     this->credentialByConnectionIdMap.erase(connectionId);
+    this->isLogonResponseReceivedByConnectionIdMap.erase(connectionId);
+    auto fixJournalIt = this->fixJournalByConnectionIdMap.find(connectionId);
+    if (fixJournalIt != this->fixJournalByConnectionIdMap.end()) {
+      fixJournalIt->second->flush();
+      this->fixJournalByConnectionIdMap.erase(fixJournalIt);
+    }
     auto urlBase = fixConnectionPtr->url;
     this->connectNumRetryOnFailByConnectionUrlMap.erase(urlBase);
   }
@@ -105,7 +118,7 @@ class FixService : public Service {
     });
     this->connectRetryOnFailTimerByConnectionIdMap[fixConnectionPtr->id] = timerPtr;
   }
-  std::shared_ptr<T> createStreamFix(net::io_context* iocPtr, net::ssl::context* ctxPtr, const std::string& host);
+  std::shared_ptr<T> createStreamFix(net::io_context* iocPtr, net::ssl::context* ctxPtr, const std::string& host, const std::string& port);
   void connect(Subscription& subscription) {
     std::string aHostFix = this->hostFix;
     std::string aPortFix = this->portFix;
@@ -119,7 +132,7 @@ class FixService : public Service {
     }
     std::shared_ptr<T> streamPtr(nullptr);
     try {
-      streamPtr = this->createStreamFix(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr, aHostFix);
+      streamPtr = this->createStreamFix(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr, aHostFix, aPortFix);
     } catch (const beast::error_code& ec) {
       CCAPI_LOGGER_TRACE("fail");
       this->onError(Event::Type::FIX_STATUS, Message::Type::FIX_FAILURE, ec, "create stream", {subscription.getCorrelationId()});
@@ -202,7 +215,14 @@ class FixService : public Service {
         logonOptionMap.insert({std::stoi(x.first), x.second});
       }
     }
+    if (!this->sessionOptions.fixJournalDirectory.empty()) {
+      this->openFixJournal(connectionId, credential);
+    }
     auto param = this->createLogonParam(connectionId, nowFixTimeStr, logonOptionMap);
+    if (this->resetFixJournalOnLogon(connectionId, param)) {
+      // the logon may sign its MsgSeqNum, which has just been reset
+      param = this->createLogonParam(connectionId, nowFixTimeStr, logonOptionMap);
+    }
     this->writeMessage(fixConnectionPtr, nowFixTimeStr, {param});
   }
   void startRead_3(std::shared_ptr<FixConnection<T>> fixConnectionPtr, void* data, size_t requestedNumBytesToRead) {
@@ -217,7 +237,9 @@ class FixService : public Service {
     CCAPI_LOGGER_FUNCTION_ENTER;
     CCAPI_LOGGER_TRACE("n = " + toString(n));
     auto now = UtilTime::now();
-    auto nowFixTimeStr = UtilTime::convertTimePointToFIXTime(now);
+    // only the sub-second digits are rewritten for reads within the same second, into a buffer which is reused
+    this->fixTimestampFormatter.format(now, this->fixTimeStr);
+    const std::string& nowFixTimeStr = this->fixTimeStr;
     if (ec) {
       CCAPI_LOGGER_TRACE("fail");
       Event event;
@@ -246,6 +268,9 @@ class FixService : public Service {
     CCAPI_LOGGER_TRACE("readMessageBufferReadLength = " + toString(readMessageBufferReadLength));
     hff::message_reader reader(readMessageBuffer.data(), readMessageBuffer.data() + readMessageBufferReadLength);
     std::vector<std::string> correlationIdList{fixConnectionPtr->subscription.getCorrelationId()};
+    std::vector<Message> fixMessageBatch;
+    auto fixJournalIt = this->fixJournalByConnectionIdMap.find(connectionId);
+    FixJournal* fixJournal = fixJournalIt == this->fixJournalByConnectionIdMap.end() ? nullptr : fixJournalIt->second.get();
     for (; reader.is_complete(); reader = reader.next_message_reader()) {
       Event event;
       bool shouldEmitEvent = true;
@@ -260,6 +285,9 @@ class FixService : public Service {
           auto messageType = it->value().as_string();
           CCAPI_LOGGER_DEBUG("received a " + messageType + " message");
           element.insert(it->tag(), messageType);
+          if (fixJournal) {
+            this->checkSequenceReceived(fixConnectionPtr, *fixJournal, reader, messageType, nowFixTimeStr);
+          }
           if (messageType == "0") {
             shouldEmitEvent = false;
             CCAPI_LOGGER_DEBUG("Heartbeat: " + toString(*fixConnectionPtr));
@@ -280,12 +308,26 @@ class FixService : public Service {
                                  }});
             }
           } else {
-            it = it + 5;
-            while (it->tag() != hffix::tag::CheckSum) {
-              element.insert(it->tag(), it->value().as_string());
-              ++it;
+            auto fieldIt = it + 5;
+            auto& isLogonResponseReceived = this->isLogonResponseReceivedByConnectionIdMap[connectionId];
+            bool isLogonResponse = !isLogonResponseReceived;
+            isLogonResponseReceived = true;
+            if (this->fixHandler && !isLogonResponse && messageType.size() == 1 &&
+                (messageType[0] == '8' || messageType[0] == '9' || messageType[0] == '3' || messageType[0] == 'j')) {
+              FixReport fixReport;
+              fixReport.correlationIdList = &correlationIdList;
+              fixReport.recvTs = now;
+              this->decodeFixReport(reader, fixReport);
+              this->fixHandler->onFixReport(fixReport);
+              shouldEmitEvent = !this->skipFixEvents;
+            }
+            if (shouldEmitEvent) {
+              while (fieldIt->tag() != hffix::tag::CheckSum) {
+                element.insert(fieldIt->tag(), fieldIt->value().as_string());
+                ++fieldIt;
+              }
             }
-            if (reader.find_with_hint(hff::tag::MsgSeqNum, it) && it->value().as_string() == "1") {
+            if (isLogonResponse) {
               if (messageType == "A") {
                 event.setType(Event::Type::AUTHORIZATION_STATUS);
                 message.setType(Message::Type::AUTHORIZATION_SUCCESS);
@@ -317,6 +359,8 @@ class FixService : public Service {
                                    {{
                                        {hff::tag::MsgType, "5"},
                                    }});
+              } else if (messageType == "2") {
+                this->onResendRequest(fixConnectionPtr, reader, nowFixTimeStr);
               }
             }
           }
@@ -336,10 +380,16 @@ class FixService : public Service {
       }
       if (shouldEmitEvent) {
         message.setElementList({element});
-        event.setMessageList({message});
-        this->eventHandler(event, nullptr);
+        if (this->sessionOptions.enableFixReadBatching && event.getType() == Event::Type::FIX) {
+          fixMessageBatch.push_back(std::move(message));
+        } else {
+          this->flushFixMessageBatch(fixMessageBatch);
+          event.setMessageList({message});
+          this->eventHandler(event, nullptr);
+        }
       }
     }
+    this->flushFixMessageBatch(fixMessageBatch);
     readMessageBufferReadLength = reader.buffer_end() - reader.buffer_begin();
     if (readMessageBufferReadLength >= this->readMessageChunkSize) {
       std::memmove(readMessageBuffer.data(), reader.buffer_begin(), readMessageBufferReadLength);
@@ -354,6 +404,104 @@ class FixService : public Service {
     this->onPongByMethod(PingPongMethod::FIX_PROTOCOL_LEVEL, fixConnectionPtr, now);
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
+  // Emits the FIX messages collected from one read as a single Event, see SessionOptions::enableFixReadBatching.
+  void flushFixMessageBatch(std::vector<Message>& fixMessageBatch) {
+    if (fixMessageBatch.empty()) {
+      return;
+    }
+    Event event;
+    event.setType(Event::Type::FIX);
+    event.setMessageList(fixMessageBatch);
+    fixMessageBatch.clear();
+    this->eventHandler(event, nullptr);
+  }
+  static std::string_view toStringView(const hff::field_value& value) { return std::string_view(value.begin(), value.end() - value.begin()); }
+  static int64_t toInt64(const hff::field_value& value) {
+    int64_t output = 0;
+    for (const char* c = value.begin(); c != value.end() && *c >= '0' && *c <= '9'; ++c) {
+      output = output * 10 + (*c - '0');
+    }
+    return output;
+  }
+  // Fills fixReport from the fields of an ExecutionReport, OrderCancelReject, Reject or BusinessMessageReject in a single pass without copying any value.
+  static void decodeFixReport(const hff::message_reader& reader, FixReport& fixReport) {
+    auto it = reader.message_type();
+    fixReport.msgType = *it->value().begin();
+    for (++it; it != reader.end() && it->tag() != hff::tag::CheckSum; ++it) {
+      const auto& value = it->value();
+      switch (it->tag()) {
+        case hff::tag::MsgSeqNum:
+          fixReport.msgSeqNum = toInt64(value);
+          break;
+        case hff::tag::SendingTime:
+          fixReport.sendingTime = toStringView(value);
+          break;
+        case hff::tag::ClOrdID:
+          fixReport.clOrdId = toStringView(value);
+          break;
+        case hff::tag::OrigClOrdID:
+          fixReport.origClOrdId = toStringView(value);
+          break;
+        case hff::tag::OrderID:
+          fixReport.orderId = toStringView(value);
+          break;
+        case hff::tag::ExecID:
+          fixReport.execId = toStringView(value);
+          break;
+        case hff::tag::ExecType:
+          fixReport.execType = *value.begin();
+          break;
+        case hff::tag::OrdStatus:
+          fixReport.ordStatus = *value.begin();
+          break;
+        case hff::tag::Symbol:
+          fixReport.symbol = toStringView(value);
+          break;
+        case hff::tag::Side:
+          fixReport.side = *value.begin();
+          break;
+        case hff::tag::Price:
+          fixReport.price = toStringView(value);
+          break;
+        case hff::tag::OrderQty:
+          fixReport.orderQty = toStringView(value);
+          break;
+        case hff::tag::LastPx:
+          fixReport.lastPx = toStringView(value);
+          break;
+        case hff::tag::LastQty:
+          fixReport.lastQty = toStringView(value);
+          break;
+        case hff::tag::LeavesQty:
+          fixReport.leavesQty = toStringView(value);
+          break;
+        case hff::tag::CumQty:
+          fixReport.cumQty = toStringView(value);
+          break;
+        case hff::tag::AvgPx:
+          fixReport.avgPx = toStringView(value);
+          break;
+        case hff::tag::TransactTime:
+          fixReport.transactTime = toStringView(value);
+          break;
+        case hff::tag::OrdRejReason:
+        case hff::tag::CxlRejReason:
+        case hff::tag::SessionRejectReason:
+        case hff::tag::BusinessRejectReason:
+          fixReport.rejectReason = toStringView(value);
+          break;
+        case hff::tag::RefSeqNum:
+          fixReport.refSeqNum = toInt64(value);
+          break;
+        case hff::tag::RefMsgType:
+          fixReport.refMsgType = toStringView(value);
+          break;
+        case hff::tag::Text:
+          fixReport.text = toStringView(value);
+          break;
+      }
+    }
+  }
   void startWrite_3(std::shared_ptr<FixConnection<T>> fixConnectionPtr, void* data, size_t numBytesToWrite) {
     T& stream = *fixConnectionPtr->streamPtr;
     CCAPI_LOGGER_TRACE("before async_write");
@@ -386,6 +534,7 @@ class FixService : public Service {
     auto& writeMessageBuffer = this->writeMessageBufferByConnectionIdMap[connectionId];
     auto& writeMessageBufferWrittenLength = this->writeMessageBufferWrittenLengthByConnectionIdMap[connectionId];
     size_t n = writeMessageBufferWrittenLength;
+    auto fixJournalIt = this->fixJournalByConnectionIdMap.find(connectionId);
     for (const auto& param : paramList) {
       auto commonParam = this->createCommonParam(connectionId, nowFixTimeStr);
       hff::message_writer messageWriter(writeMessageBuffer.data() + n, writeMessageBuffer.data() + writeMessageBuffer.size());
@@ -403,8 +552,20 @@ class FixService : public Service {
         }
       }
       messageWriter.push_back_trailer();
-      n += messageWriter.message_end() - messageWriter.message_begin();
+      size_t numBytes = messageWriter.message_end() - messageWriter.message_begin();
+      if (fixJournalIt != this->fixJournalByConnectionIdMap.end() &&
+          !fixJournalIt->second->append(this->sequenceSentByConnectionIdMap[connectionId], messageWriter.message_begin(), numBytes)) {
+        CCAPI_LOGGER_WARN("FIX journal is full, message is not journaled: " + toString(*fixConnectionPtr));
+      }
+      n += numBytes;
     }
+    this->startWriteMessageBuffer(fixConnectionPtr, n);
+  }
+  // Sends the write buffer up to n, which includes the messages appended to it since the last call.
+  void startWriteMessageBuffer(std::shared_ptr<FixConnection<T>> fixConnectionPtr, size_t n) {
+    auto& connectionId = fixConnectionPtr->id;
+    auto& writeMessageBuffer = this->writeMessageBufferByConnectionIdMap[connectionId];
+    auto& writeMessageBufferWrittenLength = this->writeMessageBufferWrittenLengthByConnectionIdMap[connectionId];
     CCAPI_LOGGER_DEBUG("about to send " + printableString(writeMessageBuffer.data(), n));
     CCAPI_LOGGER_TRACE("writeMessageBufferWrittenLength = " + toString(writeMessageBufferWrittenLength));
     if (writeMessageBufferWrittenLength == 0) {
@@ -414,6 +575,175 @@ class FixService : public Service {
     writeMessageBufferWrittenLength = n;
     CCAPI_LOGGER_TRACE("writeMessageBufferWrittenLength = " + toString(writeMessageBufferWrittenLength));
   }
+  // Opens the journal of the FIX session identified by the exchange, SenderCompID and TargetCompID, which stays open across reconnects, and resumes its
+  // outbound sequence numbers.
+  void openFixJournal(const std::string& connectionId, const std::map<std::string, std::string>& credential) {
+    std::string sessionName = this->exchangeName + "_" + mapGetWithDefault(credential, this->apiKeyName) + "_" + this->targetCompID;
+    std::replace_if(sessionName.begin(), sessionName.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '-'; }, '_');
+    std::string filePath = this->sessionOptions.fixJournalDirectory + "/" + sessionName + ".journal";
+    auto& fixJournalPtr = this->fixJournalByFilePathMap[filePath];
+    if (!fixJournalPtr) {
+      try {
+        fixJournalPtr = std::make_shared<FixJournal>(filePath, this->sessionOptions.fixJournalSizeBytes);
+      } catch (const std::exception& e) {
+        this->fixJournalByFilePathMap.erase(filePath);
+        this->onError(Event::Type::FIX_STATUS, Message::Type::GENERIC_ERROR, std::string("cannot open FIX journal: ") + e.what(), {connectionId});
+        return;
+      }
+    }
+    this->sequenceSentByConnectionIdMap[connectionId] = fixJournalPtr->getLastSequenceSent();
+    this->fixJournalByConnectionIdMap[connectionId] = fixJournalPtr;
+  }
+  // Resets the journal if logonParam, i.e. the logon as it is going to be sent, has ResetSeqNumFlag=Y. Returns true if the outbound sequence numbers had been
+  // resumed and now start over, in which case the logon has to be created again so that it carries MsgSeqNum 1.
+  bool resetFixJournalOnLogon(const std::string& connectionId, const std::vector<std::pair<int, std::string>>& logonParam) {
+    auto fixJournalIt = this->fixJournalByConnectionIdMap.find(connectionId);
+    if (fixJournalIt == this->fixJournalByConnectionIdMap.end() ||
+        std::find(logonParam.begin(), logonParam.end(), std::make_pair(int(hff::tag::ResetSeqNumFlag), std::string("Y"))) == logonParam.end()) {
+      return false;
+    }
+    fixJournalIt->second->reset();
+    auto& sequenceSent = this->sequenceSentByConnectionIdMap[connectionId];
+    bool isResumed = sequenceSent != 0;
+    sequenceSent = 0;
+    return isResumed;
+  }
+  // Asks for the inbound messages after the last one received to be resent if MsgSeqNum skips ahead, and applies SequenceReset. Messages with a lower MsgSeqNum
+  // (e.g. resent ones) are processed as usual but don't move the last MsgSeqNum received back.
+  void checkSequenceReceived(std::shared_ptr<FixConnection<T>> fixConnectionPtr, FixJournal& fixJournal, const hff::message_reader& reader,
+                             const std::string& messageType, const std::string& nowFixTimeStr) {
+    auto it = reader.message_type();
+    if (messageType == "4") {
+      if (reader.find_with_hint(hff::tag::NewSeqNo, it)) {
+        fixJournal.setLastSequenceReceived(std::max(fixJournal.getLastSequenceReceived(), toInt64(it->value()) - 1));
+      }
+      return;
+    }
+    if (!reader.find_with_hint(hff::tag::MsgSeqNum, it)) {
+      return;
+    }
+    int64_t msgSeqNum = toInt64(it->value());
+    int64_t expectedMsgSeqNum = fixJournal.getLastSequenceReceived() + 1;
+    if (messageType == "A" && msgSeqNum < expectedMsgSeqNum) {
+      CCAPI_LOGGER_WARN("MsgSeqNum was reset to " + toString(msgSeqNum) + " by the logon response: " + toString(*fixConnectionPtr));
+      expectedMsgSeqNum = msgSeqNum;
+    }
+    if (msgSeqNum > expectedMsgSeqNum) {
+      CCAPI_LOGGER_WARN("expected MsgSeqNum " + toString(expectedMsgSeqNum) + ", received " + toString(msgSeqNum) + ": " + toString(*fixConnectionPtr));
+      this->writeMessage(fixConnectionPtr, nowFixTimeStr,
+                         {{
+                             {hff::tag::MsgType, "2"},
+                             {hff::tag::BeginSeqNo, std::to_string(expectedMsgSeqNum)},
+                             {hff::tag::EndSeqNo, "0"},
+                         }});
+    }
+    if (msgSeqNum >= expectedMsgSeqNum) {
+      fixJournal.setLastSequenceReceived(msgSeqNum);
+    }
+  }
+  // Answers a ResendRequest as the FIX specification recommends: application messages which are still in the journal are resent with PossDupFlag, everything
+  // else (administrative messages, messages which weren't journaled) is skipped with a SequenceReset-GapFill. Every message is checked against the space left
+  // in the write buffer. Once the next one doesn't fit, the answer stops short of EndSeqNo, so that the counterparty sees the remaining gap and requests it
+  // again instead of losing those messages to a gap fill.
+  void onResendRequest(std::shared_ptr<FixConnection<T>> fixConnectionPtr, const hff::message_reader& reader, const std::string& nowFixTimeStr) {
+    auto& connectionId = fixConnectionPtr->id;
+    auto it = reader.message_type();
+    int64_t beginSeqNo = reader.find_with_hint(hff::tag::BeginSeqNo, it) ? toInt64(it->value()) : 0;
+    int64_t endSeqNo = reader.find_with_hint(hff::tag::EndSeqNo, it) ? toInt64(it->value()) : 0;
+    int64_t lastSequenceSent = this->sequenceSentByConnectionIdMap[connectionId];
+    if (endSeqNo == 0 || endSeqNo > lastSequenceSent) {
+      endSeqNo = lastSequenceSent;
+    }
+    CCAPI_LOGGER_INFO("resend " + toString(beginSeqNo) + " to " + toString(endSeqNo) + ": " + toString(*fixConnectionPtr));
+    if (beginSeqNo <= 0 || beginSeqNo > endSeqNo) {
+      return;
+    }
+    auto& writeMessageBuffer = this->writeMessageBufferByConnectionIdMap[connectionId];
+    size_t n = this->writeMessageBufferWrittenLengthByConnectionIdMap[connectionId];
+    int64_t gapFillBeginSeqNo = beginSeqNo;
+    int64_t answeredEndSeqNo = endSeqNo;
+    size_t gapFillNumBytesMax = this->getGapFillNumBytesMax(connectionId, nowFixTimeStr);
+    auto fixJournalIt = this->fixJournalByConnectionIdMap.find(connectionId);
+    if (fixJournalIt != this->fixJournalByConnectionIdMap.end()) {
+      fixJournalIt->second->forEachMessage(beginSeqNo, endSeqNo, [&](int64_t msgSeqNum, const char* message, size_t numBytes) {
+        if (msgSeqNum > answeredEndSeqNo) {
+          return;
+        }
+        hff::message_reader messageReader(message, message + numBytes);
+        auto messageTypeIt = messageReader.message_type();
+        const char* messageType = messageTypeIt->value().begin();
+        if (messageTypeIt->value().end() - messageType == 1 && std::strchr("012345A", *messageType)) {
+          return;
+        }
+        // the resent message gains PossDupFlag, OrigSendingTime and a new SendingTime, and may be preceded and followed by a gap fill
+        if (n + numBytes + nowFixTimeStr.size() + 32 + 2 * gapFillNumBytesMax > writeMessageBuffer.size()) {
+          answeredEndSeqNo = msgSeqNum - 1;
+          return;
+        }
+        if (msgSeqNum > gapFillBeginSeqNo) {
+          n += this->writeGapFill(connectionId, writeMessageBuffer.data() + n, writeMessageBuffer.data() + writeMessageBuffer.size(), gapFillBeginSeqNo,
+                                  msgSeqNum, nowFixTimeStr);
+        }
+        hff::message_writer messageWriter(writeMessageBuffer.data() + n, writeMessageBuffer.data() + writeMessageBuffer.size());
+        messageWriter.push_back_header(this->protocolVersion.c_str());
+        messageWriter.push_back_string(messageTypeIt->tag(), messageTypeIt->value().begin(), messageTypeIt->value().end());
+        for (++messageTypeIt; messageTypeIt != messageReader.end() && messageTypeIt->tag() != hff::tag::CheckSum; ++messageTypeIt) {
+          auto tag = messageTypeIt->tag();
+          if (tag == hff::tag::SendingTime) {
+            messageWriter.push_back_string(hff::tag::SendingTime, nowFixTimeStr);
+            messageWriter.push_back_string(hff::tag::PossDupFlag, "Y");
+            messageWriter.push_back_string(hff::tag::OrigSendingTime, messageTypeIt->value().begin(), messageTypeIt->value().end());
+          } else if (tag != hff::tag::PossDupFlag && tag != hff::tag::OrigSendingTime) {
+            messageWriter.push_back_string(tag, messageTypeIt->value().begin(), messageTypeIt->value().end());
+          }
+        }
+        messageWriter.push_back_trailer();
+        n += messageWriter.message_end() - messageWriter.message_begin();
+        gapFillBeginSeqNo = msgSeqNum + 1;
+      });
+    }
+    if (gapFillBeginSeqNo <= answeredEndSeqNo) {
+      size_t numBytes = this->writeGapFill(connectionId, writeMessageBuffer.data() + n, writeMessageBuffer.data() + writeMessageBuffer.size(),
+                                           gapFillBeginSeqNo, answeredEndSeqNo + 1, nowFixTimeStr);
+      if (numBytes == 0) {
+        answeredEndSeqNo = gapFillBeginSeqNo - 1;
+      }
+      n += numBytes;
+    }
+    if (answeredEndSeqNo < endSeqNo) {
+      CCAPI_LOGGER_WARN("write buffer is full, resend stops at " + toString(answeredEndSeqNo) + ": " + toString(*fixConnectionPtr));
+    }
+    this->startWriteMessageBuffer(fixConnectionPtr, n);
+  }
+  // An upper bound of the length of a SequenceReset-GapFill written by writeGapFill.
+  size_t getGapFillNumBytesMax(const std::string& connectionId, const std::string& nowFixTimeStr) {
+    // BeginString, BodyLength, MsgType, PossDupFlag, OrigSendingTime, GapFillFlag, NewSeqNo and CheckSum
+    size_t output = this->protocolVersion.size() + nowFixTimeStr.size() + 96;
+    // the gap fill's MsgSeqNum is at most as long as the next one
+    for (const auto& x : this->createCommonParam(connectionId, nowFixTimeStr, this->sequenceSentByConnectionIdMap[connectionId] + 1)) {
+      output += x.second.size() + 16;
+    }
+    return output;
+  }
+  // Writes a SequenceReset-GapFill with MsgSeqNum beginSeqNo and NewSeqNo newSeqNo into [begin, end) and returns its length, or 0 if it might not fit. Unlike
+  // writeMessage it doesn't consume an outbound sequence number.
+  size_t writeGapFill(const std::string& connectionId, char* begin, char* end, int64_t beginSeqNo, int64_t newSeqNo, const std::string& nowFixTimeStr) {
+    if (static_cast<size_t>(end - begin) < this->getGapFillNumBytesMax(connectionId, nowFixTimeStr)) {
+      return 0;
+    }
+    hff::message_writer messageWriter(begin, end);
+    messageWriter.push_back_header(this->protocolVersion.c_str());
+    messageWriter.push_back_string(hff::tag::MsgType, "4");
+    for (const auto& x : this->createCommonParam(connectionId, nowFixTimeStr, beginSeqNo)) {
+      messageWriter.push_back_string(x.first, x.second);
+    }
+    messageWriter.push_back_string(hff::tag::PossDupFlag, "Y");
+    messageWriter.push_back_string(hff::tag::OrigSendingTime, nowFixTimeStr);
+    messageWriter.push_back_string(hff::tag::GapFillFlag, "Y");
+    messageWriter.push_back_string(hff::tag::NewSeqNo, std::to_string(newSeqNo));
+    messageWriter.push_back_trailer();
+    return messageWriter.message_end() - messageWriter.message_begin();
+  }
   void onPongByMethod(PingPongMethod method, std::shared_ptr<FixConnection<T>> fixConnectionPtr, const TimePoint& timeReceived) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     this->lastPongTpByMethodByConnectionIdMap[fixConnectionPtr->id][method] = timeReceived;
@@ -526,7 +856,13 @@ class FixService : public Service {
     }
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
-  virtual std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr) { return {}; }
+  // Consumes the next outbound sequence number.
+  std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr) {
+    return this->createCommonParam(connectionId, nowFixTimeStr, ++this->sequenceSentByConnectionIdMap[connectionId]);
+  }
+  virtual std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr, int64_t msgSeqNum) {
+    return {};
+  }
   virtual std::vector<std::pair<int, std::string>> createLogonParam(const std::string& connectionId, const std::string& nowFixTimeStr,
                                                                     const std::map<int, std::string> logonOptionMap = {}) {
     return {};
@@ -539,6 +875,11 @@ class FixService : public Service {
   std::map<std::string, std::shared_ptr<FixConnection<T>>> fixConnectionPtrByIdMap;
   std::map<std::string, int> sequenceSentByConnectionIdMap;
   std::map<std::string, std::map<std::string, std::string>> credentialByConnectionIdMap;
+  std::map<std::string, bool> isLogonResponseReceivedByConnectionIdMap;
+  TimestampFormatter fixTimestampFormatter{TimestampFormatter::Format::FIX, 3};
+  std::string fixTimeStr;
+  std::map<std::string, std::shared_ptr<FixJournal>> fixJournalByConnectionIdMap;
+  std::map<std::string, std::shared_ptr<FixJournal>> fixJournalByFilePathMap;
   std::string apiKeyName;
   std::string apiSecretName;
   std::string baseUrlFix;
@@ -556,11 +897,14 @@ class FixService : public Service {
   std::string protocolVersion;
   std::string senderCompID;
   std::string targetCompID;
+  FixHandler* fixHandler{nullptr};
+  bool skipFixEvents{};
 };
 template <>
 inline std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> FixService<beast::ssl_stream<beast::tcp_stream>>::createStreamFix(net::io_context* iocPtr,
                                                                                                                                net::ssl::context* ctxPtr,
-                                                                                                                               const std::string& host) {
+                                                                                                                               const std::string& host,
+                                                                                                                               const std::string& port) {
   std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> streamPtr(new beast::ssl_stream<beast::tcp_stream>(*iocPtr, *ctxPtr));
   // Set SNI Hostname (many hosts need this to handshake successfully)
   if (!SSL_set_tlsext_host_name(streamPtr->native_handle(), host.c_str())) {
@@ -568,11 +912,12 @@ inline std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> FixService<beast::s
     CCAPI_LOGGER_DEBUG("error SSL_set_tlsext_host_name: " + ec.message());
     throw ec;
   }
+  this->prepareTlsSessionResumption(streamPtr->native_handle(), host, port);
   return streamPtr;
 }
 template <>
 inline std::shared_ptr<beast::tcp_stream> FixService<beast::tcp_stream>::createStreamFix(net::io_context* iocPtr, net::ssl::context* ctxPtr,
-                                                                                         const std::string& host) {
+                                                                                         const std::string& host, const std::string& port) {
   std::shared_ptr<beast::tcp_stream> streamPtr(new beast::tcp_stream(*iocPtr));
   return streamPtr;
 }
@@ -589,6 +934,7 @@ inline void FixService<beast::ssl_stream<beast::tcp_stream>>::onConnect_3(std::s
   CCAPI_LOGGER_TRACE("fixConnectionPtr = " + toString(*fixConnectionPtr));
   CCAPI_LOGGER_TRACE("connected");
   beast::ssl_stream<beast::tcp_stream>& stream = *fixConnectionPtr->streamPtr;
+  this->setSocketOptions(beast::get_lowest_layer(stream).socket());
   CCAPI_LOGGER_TRACE("before async_handshake");
   stream.async_handshake(ssl::stream_base::client, beast::bind_front_handler(&FixService::onHandshake_3, shared_from_base<FixService>(), fixConnectionPtr));
   CCAPI_LOGGER_TRACE("after async_handshake");
@@ -606,6 +952,7 @@ inline void FixService<beast::tcp_stream>::onConnect_3(std::shared_ptr<FixConnec
   CCAPI_LOGGER_TRACE("fixConnectionPtr = " + toString(*fixConnectionPtr));
   CCAPI_LOGGER_TRACE("connected");
   beast::tcp_stream& stream = *fixConnectionPtr->streamPtr;
+  this->setSocketOptions(stream.socket());
   this->start(fixConnectionPtr, now);
 }
 } /* namespace ccapi */
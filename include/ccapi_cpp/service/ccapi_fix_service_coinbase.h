@@ -30,11 +30,11 @@ class FixServiceCoinbase : public FixService<beast::ssl_stream<beast::tcp_stream
 
  protected:
 #endif
-  virtual std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr) {
+  virtual std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr, int64_t msgSeqNum) {
     return {
         {hff::tag::SenderCompID, mapGetWithDefault(this->credentialByConnectionIdMap[connectionId], this->apiKeyName)},
         {hff::tag::TargetCompID, this->targetCompID},
-        {hff::tag::MsgSeqNum, std::to_string(++this->sequenceSentByConnectionIdMap[connectionId])},
+        {hff::tag::MsgSeqNum, std::to_string(msgSeqNum)},
         {hff::tag::SendingTime, nowFixTimeStr},
     };
   }
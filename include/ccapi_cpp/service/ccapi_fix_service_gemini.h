@@ -26,11 +26,11 @@ class FixServiceGemini : public FixService<beast::tcp_stream> {
 
  protected:
 #endif
-  virtual std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr) {
+  virtual std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr, int64_t msgSeqNum) {
     return {
         {hff::tag::SenderCompID, CCAPI_GEMINI_API_SENDER_COMP_ID},
         {hff::tag::TargetCompID, CCAPI_GEMINI_API_TARGET_COMP_ID},
-        {hff::tag::MsgSeqNum, std::to_string(++this->sequenceSentByConnectionIdMap[connectionId])},
+        {hff::tag::MsgSeqNum, std::to_string(msgSeqNum)},
         {hff::tag::SendingTime, nowFixTimeStr},
     };
   }
@@ -1,13 +1,17 @@
 #ifndef INCLUDE_CCAPI_CPP_SERVICE_CCAPI_MARKET_DATA_SERVICE_H_
 #define INCLUDE_CCAPI_CPP_SERVICE_CCAPI_MARKET_DATA_SERVICE_H_
 #ifdef CCAPI_ENABLE_SERVICE_MARKET_DATA
+#include <deque>
 #include <functional>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ccapi_cpp/ccapi_hmac.h"
 #include "ccapi_cpp/ccapi_logger.h"
+#include "ccapi_cpp/ccapi_market_data_handler.h"
+#include "ccapi_cpp/ccapi_order_book.h"
 #include "ccapi_cpp/ccapi_util_private.h"
 #include "ccapi_cpp/service/ccapi_service.h"
 namespace ccapi {
@@ -16,6 +20,29 @@ namespace ccapi {
  */
 class MarketDataService : public Service {
  public:
+  // The state of a subscription that is needed on the message path. It is resolved once per exchange subscription id and afterwards referenced by an integer
+  // handle. The pointers refer to elements of the ...ByConnectionIdChannelIdSymbolIdMap containers which are only erased together with the connection.
+  struct SubscriptionState {
+    size_t handle{};
+    std::string connectionId;
+    std::string channelId;
+    std::string symbolId;
+    const std::string* field{};
+    const std::map<std::string, std::string>* optionMap{};
+    const std::vector<std::string>* correlationIdList{};
+    bool* processedInitialSnapshot{};
+    bool* l2UpdateIsReplace{};
+    const int* marketDepthSubscribedToExchange{};
+    OrderBook orderBook;
+    OrderBook previousConflateOrderBook;
+    bool processedInitialTrade{};
+    size_t orderBookResyncGeneration{};  // incremented on each resync of the order book, so that snapshots fetched before it are discarded
+    TimePoint previousConflateTime{std::chrono::seconds{0}};
+    std::string open;
+    Decimal high;
+    Decimal low;
+    std::string close;
+  };
   MarketDataService(std::function<void(Event&, Queue<Event>*)> eventHandler, SessionOptions sessionOptions, SessionConfigs sessionConfigs,
                     ServiceContext* serviceContextPtr)
       : Service(eventHandler, sessionOptions, sessionConfigs, serviceContextPtr) {
@@ -47,6 +74,12 @@ class MarketDataService : public Service {
       }
     }
   }
+  // Deliver market data to marketDataHandler as well. If skipMarketDataEvents is true, the market depth, trade and agg trade Events aren't generated at all.
+  // Must be called before subscribing.
+  void setMarketDataHandler(MarketDataHandler* marketDataHandler, bool skipMarketDataEvents) {
+    this->marketDataHandler = marketDataHandler;
+    this->skipMarketDataEvents = marketDataHandler && skipMarketDataEvents;
+  }
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
   // subscriptions are grouped and each group creates a unique websocket connection
   void subscribe(std::vector<Subscription>& subscriptionList) override {
@@ -223,38 +256,34 @@ class MarketDataService : public Service {
         }
 
         std::string& exchangeSubscriptionId = marketDataMessage.exchangeSubscriptionId;
-        CCAPI_LOGGER_TRACE("this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap = " +
-                           toString(this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap));
-        std::string& channelId =
-            this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId).at(CCAPI_CHANNEL_ID);
-        std::string& symbolId =
-            this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId).at(CCAPI_SYMBOL_ID);
-        auto& field = this->fieldByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
-        CCAPI_LOGGER_TRACE("this->optionMapByConnectionIdChannelIdSymbolIdMap = " + toString(this->optionMapByConnectionIdChannelIdSymbolIdMap));
+        CCAPI_LOGGER_TRACE("exchangeSubscriptionId = " + exchangeSubscriptionId);
+        SubscriptionState& subscriptionState = this->getSubscriptionState(wsConnection, exchangeSubscriptionId);
+        const std::string& channelId = subscriptionState.channelId;
+        const std::string& symbolId = subscriptionState.symbolId;
+        const std::string& field = *subscriptionState.field;
+        const std::map<std::string, std::string>& optionMap = *subscriptionState.optionMap;
+        const std::vector<std::string>& correlationIdList = *subscriptionState.correlationIdList;
         CCAPI_LOGGER_TRACE("wsConnection = " + toString(wsConnection));
         CCAPI_LOGGER_TRACE("channelId = " + toString(channelId));
         CCAPI_LOGGER_TRACE("symbolId = " + toString(symbolId));
-        auto& optionMap = this->optionMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
         CCAPI_LOGGER_TRACE("optionMap = " + toString(optionMap));
-        auto& correlationIdList = this->correlationIdListByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
         CCAPI_LOGGER_TRACE("correlationIdList = " + toString(correlationIdList));
-        if (marketDataMessage.data.find(MarketDataMessage::DataType::BID) != marketDataMessage.data.end() ||
-            marketDataMessage.data.find(MarketDataMessage::DataType::ASK) != marketDataMessage.data.end()) {
-          std::map<Decimal, std::string>& snapshotBid = this->snapshotBidByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-          std::map<Decimal, std::string>& snapshotAsk = this->snapshotAskByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-          if (this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] &&
-              marketDataMessage.recapType == MarketDataMessage::RecapType::NONE) {
-            this->processOrderBookUpdate(wsConnection, channelId, symbolId, event, marketDataMessage.tp, timeReceived, marketDataMessage.data, field, optionMap,
-                                         correlationIdList, snapshotBid, snapshotAsk);
+        if (marketDataMessage.hasDataType(MarketDataMessage::DataType::BID) || marketDataMessage.hasDataType(MarketDataMessage::DataType::ASK)) {
+          OrderBook& orderBook = subscriptionState.orderBook;
+          if (*subscriptionState.processedInitialSnapshot && marketDataMessage.recapType == MarketDataMessage::RecapType::NONE) {
+            this->dispatchOrderBookUpdate(wsConnection, subscriptionState, event, timeReceived, marketDataMessage);
             if (this->sessionOptions.enableCheckOrderBookChecksum &&
                 this->orderBookChecksumByConnectionIdSymbolIdMap.find(wsConnection.id) != this->orderBookChecksumByConnectionIdSymbolIdMap.end() &&
                 this->orderBookChecksumByConnectionIdSymbolIdMap.at(wsConnection.id).find(symbolId) !=
                     this->orderBookChecksumByConnectionIdSymbolIdMap.at(wsConnection.id).end()) {
               bool shouldProcessRemainingMessage = true;
               std::string receivedOrderBookChecksumStr = this->orderBookChecksumByConnectionIdSymbolIdMap[wsConnection.id][symbolId];
-              if (!this->checkOrderBookChecksum(snapshotBid, snapshotAsk, receivedOrderBookChecksumStr, shouldProcessRemainingMessage)) {
-                CCAPI_LOGGER_ERROR("snapshotBid = " + toString(snapshotBid));
-                CCAPI_LOGGER_ERROR("snapshotAsk = " + toString(snapshotAsk));
+              if (!this->checkOrderBookChecksum(orderBook, receivedOrderBookChecksumStr, shouldProcessRemainingMessage)) {
+                CCAPI_LOGGER_ERROR("orderBook = " + toString(orderBook));
+                if (this->canResyncOrderBook()) {
+                  this->resyncOrderBook(wsConnection, exchangeSubscriptionId, "order book incorrect checksum found");
+                  continue;
+                }
                 this->onIncorrectStatesFound(wsConnection, hdl, textMessage, timeReceived, exchangeSubscriptionId, "order book incorrect checksum found");
               }
               if (!shouldProcessRemainingMessage) {
@@ -263,9 +292,12 @@ class MarketDataService : public Service {
             }
             if (this->sessionOptions.enableCheckOrderBookCrossed) {
               bool shouldProcessRemainingMessage = true;
-              if (!this->checkOrderBookCrossed(snapshotBid, snapshotAsk, shouldProcessRemainingMessage)) {
-                CCAPI_LOGGER_ERROR("lastNToString(snapshotBid, 1) = " + lastNToString(snapshotBid, 1));
-                CCAPI_LOGGER_ERROR("firstNToString(snapshotAsk, 1) = " + firstNToString(snapshotAsk, 1));
+              if (!this->checkOrderBookCrossed(orderBook, shouldProcessRemainingMessage)) {
+                CCAPI_LOGGER_ERROR("orderBook.topNToString(1) = " + orderBook.topNToString(1));
+                if (this->canResyncOrderBook()) {
+                  this->resyncOrderBook(wsConnection, exchangeSubscriptionId, "order book crossed market found");
+                  continue;
+                }
                 this->onIncorrectStatesFound(wsConnection, hdl, textMessage, timeReceived, exchangeSubscriptionId, "order book crossed market found");
               }
               if (!shouldProcessRemainingMessage) {
@@ -273,17 +305,19 @@ class MarketDataService : public Service {
               }
             }
           } else if (marketDataMessage.recapType == MarketDataMessage::RecapType::SOLICITED) {
-            this->processOrderBookInitial(wsConnection, channelId, symbolId, event, marketDataMessage.tp, timeReceived, marketDataMessage.data, field,
-                                          optionMap, correlationIdList, snapshotBid, snapshotAsk);
+            this->dispatchOrderBookInitial(wsConnection, subscriptionState, event, timeReceived, marketDataMessage);
           }
-          CCAPI_LOGGER_TRACE("snapshotBid.size() = " + toString(snapshotBid.size()));
-          CCAPI_LOGGER_TRACE("snapshotAsk.size() = " + toString(snapshotAsk.size()));
+          CCAPI_LOGGER_TRACE("orderBook.getBids().size() = " + toString(orderBook.getBids().size()));
+          CCAPI_LOGGER_TRACE("orderBook.getAsks().size() = " + toString(orderBook.getAsks().size()));
         }
-        if (marketDataMessage.data.find(MarketDataMessage::DataType::TRADE) != marketDataMessage.data.end() ||
-            marketDataMessage.data.find(MarketDataMessage::DataType::AGG_TRADE) != marketDataMessage.data.end()) {
+        if (this->marketDataHandler &&
+            (marketDataMessage.type != MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH || *subscriptionState.processedInitialSnapshot)) {
+          this->invokeMarketDataHandler(subscriptionState, marketDataMessage, timeReceived);
+        }
+        if (!this->skipMarketDataEvents &&
+            (marketDataMessage.hasDataType(MarketDataMessage::DataType::TRADE) || marketDataMessage.hasDataType(MarketDataMessage::DataType::AGG_TRADE))) {
           bool isSolicited = marketDataMessage.recapType == MarketDataMessage::RecapType::SOLICITED;
-          this->processTrade(wsConnection, channelId, symbolId, event, marketDataMessage.tp, timeReceived, marketDataMessage.data, field, optionMap,
-                             correlationIdList, isSolicited);
+          this->processTrade(wsConnection, subscriptionState, event, marketDataMessage.tp, timeReceived, marketDataMessage, isSolicited);
         }
       } else {
         CCAPI_LOGGER_WARN("websocket event type is unknown for " + toString(marketDataMessage));
@@ -297,6 +331,7 @@ class MarketDataService : public Service {
     if (this->correlationIdByConnectionIdMap.find(wsConnection.id) == this->correlationIdByConnectionIdMap.end()) {
       Event event;
       std::vector<MarketDataMessage> marketDataMessageList;
+      this->marketDataRecordList.clear();
       this->processTextMessage(wsConnection, hdl, textMessage, timeReceived, event, marketDataMessageList);
       if (!marketDataMessageList.empty()) {
         this->processMarketDataMessageList(wsConnection, hdl, textMessage, timeReceived, event, marketDataMessageList);
@@ -366,14 +401,9 @@ class MarketDataService : public Service {
     this->subscriptionListByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->correlationIdListByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.erase(wsConnection.id);
-    this->snapshotBidByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->snapshotAskByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
+    this->releaseSubscriptionStates(wsConnection);
     this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->processedInitialTradeByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->l2UpdateIsReplaceByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     if (this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.find(wsConnection.id) != this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.end()) {
       for (const auto& x : this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id)) {
         for (const auto& y : x.second) {
@@ -382,10 +412,6 @@ class MarketDataService : public Service {
       }
       this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     }
-    this->openByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->highByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->lowByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->closeByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->orderBookChecksumByConnectionIdSymbolIdMap.erase(wsConnection.id);
     this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.erase(wsConnection.id);
     if (this->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap.find(wsConnection.id) !=
@@ -481,44 +507,34 @@ class MarketDataService : public Service {
         // }
 
         std::string& exchangeSubscriptionId = marketDataMessage.exchangeSubscriptionId;
-        CCAPI_LOGGER_TRACE("this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap = " +
-                           toString(this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap));
-        CCAPI_LOGGER_TRACE("this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id) = " +
-                           toString(this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id)));
         CCAPI_LOGGER_TRACE("exchangeSubscriptionId = " + exchangeSubscriptionId);
-        std::string& channelId =
-            this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId).at(CCAPI_CHANNEL_ID);
+        SubscriptionState& subscriptionState = this->getSubscriptionState(wsConnection, exchangeSubscriptionId);
+        const std::string& channelId = subscriptionState.channelId;
+        const std::string& symbolId = subscriptionState.symbolId;
+        const std::string& field = *subscriptionState.field;
+        const std::map<std::string, std::string>& optionMap = *subscriptionState.optionMap;
+        const std::vector<std::string>& correlationIdList = *subscriptionState.correlationIdList;
+        CCAPI_LOGGER_TRACE("wsConnection = " + toString(wsConnection));
         CCAPI_LOGGER_TRACE("channelId = " + toString(channelId));
-        std::string& symbolId =
-            this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId).at(CCAPI_SYMBOL_ID);
         CCAPI_LOGGER_TRACE("symbolId = " + toString(symbolId));
-        CCAPI_LOGGER_TRACE("this->fieldByConnectionIdChannelIdSymbolIdMap = " + toString(this->fieldByConnectionIdChannelIdSymbolIdMap));
-        CCAPI_LOGGER_TRACE("this->fieldByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id) = " +
-                           toString(this->fieldByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id)));
-        auto& field = this->fieldByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
-        CCAPI_LOGGER_TRACE("this->optionMapByConnectionIdChannelIdSymbolIdMap = " + toString(this->optionMapByConnectionIdChannelIdSymbolIdMap));
-        CCAPI_LOGGER_TRACE("wsConnection = " + toString(wsConnection));
-        auto& optionMap = this->optionMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
         CCAPI_LOGGER_TRACE("optionMap = " + toString(optionMap));
-        auto& correlationIdList = this->correlationIdListByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
         CCAPI_LOGGER_TRACE("correlationIdList = " + toString(correlationIdList));
-        if (marketDataMessage.data.find(MarketDataMessage::DataType::BID) != marketDataMessage.data.end() ||
-            marketDataMessage.data.find(MarketDataMessage::DataType::ASK) != marketDataMessage.data.end()) {
-          std::map<Decimal, std::string>& snapshotBid = this->snapshotBidByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-          std::map<Decimal, std::string>& snapshotAsk = this->snapshotAskByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-          if (this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] &&
-              marketDataMessage.recapType == MarketDataMessage::RecapType::NONE) {
-            this->processOrderBookUpdate(wsConnection, channelId, symbolId, event, marketDataMessage.tp, timeReceived, marketDataMessage.data, field, optionMap,
-                                         correlationIdList, snapshotBid, snapshotAsk);
+        if (marketDataMessage.hasDataType(MarketDataMessage::DataType::BID) || marketDataMessage.hasDataType(MarketDataMessage::DataType::ASK)) {
+          OrderBook& orderBook = subscriptionState.orderBook;
+          if (*subscriptionState.processedInitialSnapshot && marketDataMessage.recapType == MarketDataMessage::RecapType::NONE) {
+            this->dispatchOrderBookUpdate(wsConnection, subscriptionState, event, timeReceived, marketDataMessage);
             if (this->sessionOptions.enableCheckOrderBookChecksum &&
                 this->orderBookChecksumByConnectionIdSymbolIdMap.find(wsConnection.id) != this->orderBookChecksumByConnectionIdSymbolIdMap.end() &&
                 this->orderBookChecksumByConnectionIdSymbolIdMap.at(wsConnection.id).find(symbolId) !=
                     this->orderBookChecksumByConnectionIdSymbolIdMap.at(wsConnection.id).end()) {
               bool shouldProcessRemainingMessage = true;
               std::string receivedOrderBookChecksumStr = this->orderBookChecksumByConnectionIdSymbolIdMap[wsConnection.id][symbolId];
-              if (!this->checkOrderBookChecksum(snapshotBid, snapshotAsk, receivedOrderBookChecksumStr, shouldProcessRemainingMessage)) {
-                CCAPI_LOGGER_ERROR("snapshotBid = " + toString(snapshotBid));
-                CCAPI_LOGGER_ERROR("snapshotAsk = " + toString(snapshotAsk));
+              if (!this->checkOrderBookChecksum(orderBook, receivedOrderBookChecksumStr, shouldProcessRemainingMessage)) {
+                CCAPI_LOGGER_ERROR("orderBook = " + toString(orderBook));
+                if (this->canResyncOrderBook()) {
+                  this->resyncOrderBook(wsConnection, exchangeSubscriptionId, "order book incorrect checksum found");
+                  continue;
+                }
                 this->onIncorrectStatesFound(wsConnectionPtr, textMessage, timeReceived, exchangeSubscriptionId, "order book incorrect checksum found");
               }
               if (!shouldProcessRemainingMessage) {
@@ -527,9 +543,12 @@ class MarketDataService : public Service {
             }
             if (this->sessionOptions.enableCheckOrderBookCrossed) {
               bool shouldProcessRemainingMessage = true;
-              if (!this->checkOrderBookCrossed(snapshotBid, snapshotAsk, shouldProcessRemainingMessage)) {
-                CCAPI_LOGGER_ERROR("lastNToString(snapshotBid, 1) = " + lastNToString(snapshotBid, 1));
-                CCAPI_LOGGER_ERROR("firstNToString(snapshotAsk, 1) = " + firstNToString(snapshotAsk, 1));
+              if (!this->checkOrderBookCrossed(orderBook, shouldProcessRemainingMessage)) {
+                CCAPI_LOGGER_ERROR("orderBook.topNToString(1) = " + orderBook.topNToString(1));
+                if (this->canResyncOrderBook()) {
+                  this->resyncOrderBook(wsConnection, exchangeSubscriptionId, "order book crossed market found");
+                  continue;
+                }
                 this->onIncorrectStatesFound(wsConnectionPtr, textMessage, timeReceived, exchangeSubscriptionId, "order book crossed market found");
               }
               if (!shouldProcessRemainingMessage) {
@@ -537,17 +556,19 @@ class MarketDataService : public Service {
               }
             }
           } else if (marketDataMessage.recapType == MarketDataMessage::RecapType::SOLICITED) {
-            this->processOrderBookInitial(wsConnection, channelId, symbolId, event, marketDataMessage.tp, timeReceived, marketDataMessage.data, field,
-                                          optionMap, correlationIdList, snapshotBid, snapshotAsk);
+            this->dispatchOrderBookInitial(wsConnection, subscriptionState, event, timeReceived, marketDataMessage);
           }
-          CCAPI_LOGGER_TRACE("snapshotBid.size() = " + toString(snapshotBid.size()));
-          CCAPI_LOGGER_TRACE("snapshotAsk.size() = " + toString(snapshotAsk.size()));
+          CCAPI_LOGGER_TRACE("orderBook.getBids().size() = " + toString(orderBook.getBids().size()));
+          CCAPI_LOGGER_TRACE("orderBook.getAsks().size() = " + toString(orderBook.getAsks().size()));
+        }
+        if (this->marketDataHandler &&
+            (marketDataMessage.type != MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH || *subscriptionState.processedInitialSnapshot)) {
+          this->invokeMarketDataHandler(subscriptionState, marketDataMessage, timeReceived);
         }
-        if (marketDataMessage.data.find(MarketDataMessage::DataType::TRADE) != marketDataMessage.data.end() ||
-            marketDataMessage.data.find(MarketDataMessage::DataType::AGG_TRADE) != marketDataMessage.data.end()) {
+        if (!this->skipMarketDataEvents &&
+            (marketDataMessage.hasDataType(MarketDataMessage::DataType::TRADE) || marketDataMessage.hasDataType(MarketDataMessage::DataType::AGG_TRADE))) {
           bool isSolicited = marketDataMessage.recapType == MarketDataMessage::RecapType::SOLICITED;
-          this->processTrade(wsConnection, channelId, symbolId, event, marketDataMessage.tp, timeReceived, marketDataMessage.data, field, optionMap,
-                             correlationIdList, isSolicited);
+          this->processTrade(wsConnection, subscriptionState, event, marketDataMessage.tp, timeReceived, marketDataMessage, isSolicited);
         }
         if (marketDataMessage.data.find(MarketDataMessage::DataType::CANDLESTICK) != marketDataMessage.data.end()) {
           bool isSolicited = marketDataMessage.recapType == MarketDataMessage::RecapType::SOLICITED;
@@ -565,12 +586,23 @@ class MarketDataService : public Service {
     if (this->correlationIdByConnectionIdMap.find(wsConnectionPtr->id) == this->correlationIdByConnectionIdMap.end()) {
       Event event;
       std::vector<MarketDataMessage> marketDataMessageList;
+      this->marketDataRecordList.clear();
+      auto start = this->latencyHistogramList ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
       this->processTextMessage(wsConnectionPtr, textMessage, timeReceived, event, marketDataMessageList);
+      if (this->latencyHistogramList) {
+        start = this->recordLatency(LatencyHistogram::Stage::PROCESS_TEXT_MESSAGE, start);
+      }
       if (!marketDataMessageList.empty()) {
         this->processMarketDataMessageList(wsConnectionPtr, textMessage, timeReceived, event, marketDataMessageList);
+        if (this->latencyHistogramList) {
+          start = this->recordLatency(LatencyHistogram::Stage::PROCESS_MARKET_DATA_MESSAGE_LIST, start);
+        }
       }
       if (!event.getMessageList().empty()) {
         this->eventHandler(event, nullptr);
+        if (this->latencyHistogramList) {
+          this->recordLatency(LatencyHistogram::Stage::EVENT_HANDLER, start);
+        }
       }
     } else {
       Event event;
@@ -646,14 +678,9 @@ class MarketDataService : public Service {
     this->subscriptionListByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->correlationIdListByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.erase(wsConnection.id);
-    this->snapshotBidByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->snapshotAskByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
+    this->releaseSubscriptionStates(wsConnection);
     this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->processedInitialTradeByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->l2UpdateIsReplaceByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     if (this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.find(wsConnection.id) != this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.end()) {
       for (const auto& x : this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id)) {
         for (const auto& y : x.second) {
@@ -662,10 +689,6 @@ class MarketDataService : public Service {
       }
       this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     }
-    this->openByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->highByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->lowByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
-    this->closeByConnectionIdChannelIdSymbolIdMap.erase(wsConnection.id);
     this->orderBookChecksumByConnectionIdSymbolIdMap.erase(wsConnection.id);
     this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.erase(wsConnection.id);
     if (this->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap.find(wsConnection.id) !=
@@ -736,261 +759,184 @@ class MarketDataService : public Service {
     }
   }
 #endif
-  void updateOrderBook(std::map<Decimal, std::string>& snapshot, const Decimal& price, const std::string& size, bool sizeMayHaveTrailingZero = false) {
-    auto it = snapshot.find(price);
-    if (it == snapshot.end()) {
-      if ((!sizeMayHaveTrailingZero && size != "0") ||
-          (sizeMayHaveTrailingZero && ((size.find('.') != std::string::npos && UtilString::rtrim(UtilString::rtrim(size, "0"), ".") != "0") ||
-                                       (size.find('.') == std::string::npos && size != "0")))) {
-        snapshot.emplace(std::move(price), std::move(size));
-      }
-    } else {
-      if ((!sizeMayHaveTrailingZero && size != "0") ||
-          (sizeMayHaveTrailingZero && ((size.find('.') != std::string::npos && UtilString::rtrim(UtilString::rtrim(size, "0"), ".") != "0") ||
-                                       (size.find('.') == std::string::npos && size != "0")))) {
-        it->second = std::move(size);
+  void updateOrderBook(OrderBook& orderBook, bool isBid, std::string_view price, std::string_view size, bool keepTrailingZero = false) {
+    orderBook.update(isBid, price, size, keepTrailingZero);
+  }
+  // Append a typed record whose price and size refer to (normalized) string values of the rapidjson document being processed. See
+  // MarketDataMessage::setRecords.
+  MarketDataMessage::Record& appendMarketDataRecord(MarketDataMessage::DataType dataType, const rj::Value& price, const rj::Value& size) {
+    MarketDataMessage::Record& record = this->marketDataRecordList.emplace_back();
+    record.dataType = dataType;
+    record.price = UtilString::normalizeDecimalStringView(std::string_view(price.GetString(), price.GetStringLength()));
+    record.size = UtilString::normalizeDecimalStringView(std::string_view(size.GetString(), size.GetStringLength()));
+    return record;
+  }
+  void insertOrderBookUnsorted(OrderBook& orderBook, const MarketDataMessage::TypeForData& input, bool keepTrailingZero) {
+    for (const auto& x : input) {
+      const auto& type = x.first;
+      const auto& detail = x.second;
+      if (type == MarketDataMessage::DataType::BID || type == MarketDataMessage::DataType::ASK) {
+        bool isBid = type == MarketDataMessage::DataType::BID;
+        for (const auto& y : detail) {
+          orderBook.insertUnsorted(isBid, y.at(MarketDataMessage::DataFieldType::PRICE), y.at(MarketDataMessage::DataFieldType::SIZE), keepTrailingZero);
+        }
       } else {
-        snapshot.erase(price);
+        CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(type));
       }
     }
   }
-  void updateElementListWithInitialMarketDepth(const std::string& field, const std::map<std::string, std::string>& optionMap,
-                                               const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotAsk,
+  void updateElementListWithMarketDepthLevel(bool isBid, const OrderBook& orderBook, const OrderBook::Level& level, bool isRemoved,
+                                             std::vector<Element>& elementList) {
+    Element element;
+    element.reserve(2);
+    element.insert(isBid ? CCAPI_BEST_BID_N_PRICE : CCAPI_BEST_ASK_N_PRICE, orderBook.priceToString(level));
+    element.insert(isBid ? CCAPI_BEST_BID_N_SIZE : CCAPI_BEST_ASK_N_SIZE, isRemoved ? std::string("0") : OrderBook::sizeToString(level));
+    elementList.emplace_back(std::move(element));
+  }
+  void updateElementListWithOrderBookTopN(const OrderBook& orderBook, int maxMarketDepth, std::vector<Element>& elementList) {
+    const auto& bids = orderBook.getBids();
+    int bidIndex = 0;
+    for (auto iter = bids.rbegin(); iter != bids.rend() && bidIndex < maxMarketDepth; ++iter) {
+      this->updateElementListWithMarketDepthLevel(true, orderBook, *iter, false, elementList);
+      ++bidIndex;
+    }
+    if (bids.empty()) {
+      Element element;
+      element.insert(CCAPI_BEST_BID_N_PRICE, CCAPI_BEST_BID_N_PRICE_EMPTY);
+      element.insert(CCAPI_BEST_BID_N_SIZE, CCAPI_BEST_BID_N_SIZE_EMPTY);
+      elementList.emplace_back(std::move(element));
+    }
+    const auto& asks = orderBook.getAsks();
+    int askIndex = 0;
+    for (auto iter = asks.rbegin(); iter != asks.rend() && askIndex < maxMarketDepth; ++iter) {
+      this->updateElementListWithMarketDepthLevel(false, orderBook, *iter, false, elementList);
+      ++askIndex;
+    }
+    if (asks.empty()) {
+      Element element;
+      element.insert(CCAPI_BEST_ASK_N_PRICE, CCAPI_BEST_ASK_N_PRICE_EMPTY);
+      element.insert(CCAPI_BEST_ASK_N_SIZE, CCAPI_BEST_ASK_N_SIZE_EMPTY);
+      elementList.emplace_back(std::move(element));
+    }
+  }
+  void updateElementListWithInitialMarketDepth(const std::string& field, const std::map<std::string, std::string>& optionMap, const OrderBook& orderBook,
                                                std::vector<Element>& elementList) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     if (field == CCAPI_MARKET_DEPTH) {
       int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
-      int bidIndex = 0;
-      for (auto iter = snapshotBid.rbegin(); iter != snapshotBid.rend(); iter++) {
-        if (bidIndex < maxMarketDepth) {
-          Element element;
-          element.insert(CCAPI_BEST_BID_N_PRICE, iter->first.toString());
-          element.insert(CCAPI_BEST_BID_N_SIZE, iter->second);
-          elementList.emplace_back(std::move(element));
-        }
-        ++bidIndex;
-      }
-      if (snapshotBid.empty()) {
-        Element element;
-        element.insert(CCAPI_BEST_BID_N_PRICE, CCAPI_BEST_BID_N_PRICE_EMPTY);
-        element.insert(CCAPI_BEST_BID_N_SIZE, CCAPI_BEST_BID_N_SIZE_EMPTY);
-        elementList.emplace_back(std::move(element));
-      }
-      int askIndex = 0;
-      for (auto iter = snapshotAsk.begin(); iter != snapshotAsk.end(); iter++) {
-        if (askIndex < maxMarketDepth) {
-          Element element;
-          element.insert(CCAPI_BEST_ASK_N_PRICE, iter->first.toString());
-          element.insert(CCAPI_BEST_ASK_N_SIZE, iter->second);
-          elementList.emplace_back(std::move(element));
-        }
-        ++askIndex;
-      }
-      if (snapshotAsk.empty()) {
-        Element element;
-        element.insert(CCAPI_BEST_ASK_N_PRICE, CCAPI_BEST_ASK_N_PRICE_EMPTY);
-        element.insert(CCAPI_BEST_ASK_N_SIZE, CCAPI_BEST_ASK_N_SIZE_EMPTY);
-        elementList.emplace_back(std::move(element));
-      }
+      this->updateElementListWithOrderBookTopN(orderBook, maxMarketDepth, elementList);
     }
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
-  void updateElementListWithOrderBookSnapshot(const std::string& field, int maxMarketDepth, const std::map<Decimal, std::string>& snapshotBid,
-                                              const std::map<Decimal, std::string>& snapshotAsk, std::vector<Element>& elementList) {
+  void updateElementListWithOrderBookSnapshot(const std::string& field, int maxMarketDepth, const OrderBook& orderBook, std::vector<Element>& elementList) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     if (field == CCAPI_MARKET_DEPTH) {
-      int bidIndex = 0;
-      for (auto iter = snapshotBid.rbegin(); iter != snapshotBid.rend(); iter++) {
-        if (bidIndex < maxMarketDepth) {
-          Element element;
-          element.insert(CCAPI_BEST_BID_N_PRICE, iter->first.toString());
-          element.insert(CCAPI_BEST_BID_N_SIZE, iter->second);
-          elementList.emplace_back(std::move(element));
-        }
-        ++bidIndex;
-      }
-      if (snapshotBid.empty()) {
-        Element element;
-        element.insert(CCAPI_BEST_BID_N_PRICE, CCAPI_BEST_BID_N_PRICE_EMPTY);
-        element.insert(CCAPI_BEST_BID_N_SIZE, CCAPI_BEST_BID_N_SIZE_EMPTY);
-        elementList.emplace_back(std::move(element));
-      }
-      int askIndex = 0;
-      for (auto iter = snapshotAsk.begin(); iter != snapshotAsk.end(); iter++) {
-        if (askIndex < maxMarketDepth) {
-          Element element;
-          element.insert(CCAPI_BEST_ASK_N_PRICE, iter->first.toString());
-          element.insert(CCAPI_BEST_ASK_N_SIZE, iter->second);
-          elementList.emplace_back(std::move(element));
-        }
-        ++askIndex;
-      }
-      if (snapshotAsk.empty()) {
-        Element element;
-        element.insert(CCAPI_BEST_ASK_N_PRICE, CCAPI_BEST_ASK_N_PRICE_EMPTY);
-        element.insert(CCAPI_BEST_ASK_N_SIZE, CCAPI_BEST_ASK_N_SIZE_EMPTY);
-        elementList.emplace_back(std::move(element));
-      }
+      this->updateElementListWithOrderBookTopN(orderBook, maxMarketDepth, elementList);
     }
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
-  std::map<Decimal, std::string> calculateMarketDepthUpdate(bool isBid, const std::map<Decimal, std::string>& c1, const std::map<Decimal, std::string>& c2,
-                                                            int maxMarketDepth) {
-    if (c1.empty()) {
-      std::map<Decimal, std::string> output;
-      for (const auto& x : c2) {
-        output.insert(std::make_pair(x.first, "0"));
-      }
-      return output;
-    } else if (c2.empty()) {
-      return c1;
-    }
-    if (isBid) {
-      auto it1 = c1.rbegin();
-      int i1 = 0;
-      auto it2 = c2.rbegin();
-      int i2 = 0;
-      std::map<Decimal, std::string> output;
-      while (i1 < maxMarketDepth && i2 < maxMarketDepth && it1 != c1.rend() && it2 != c2.rend()) {
-        if (it1->first > it2->first) {
-          output.insert(std::make_pair(it1->first, it1->second));
-          ++it1;
-          ++i1;
-        } else if (it1->first < it2->first) {
-          output.insert(std::make_pair(it2->first, "0"));
-          ++it2;
-          ++i2;
-        } else {
-          if (it1->second != it2->second) {
-            output.insert(std::make_pair(it1->first, it1->second));
-          }
-          ++it1;
-          ++i1;
-          ++it2;
-          ++i2;
-        }
+  // Append to elementList the levels of one side which differ between the best maxMarketDepth levels of c1 (current) and c2 (previous). Removed levels are
+  // reported with size "0". Elements are appended in ascending price order.
+  void calculateMarketDepthUpdate(bool isBid, const OrderBook& c1, const OrderBook& c2, int maxMarketDepth, std::vector<Element>& elementList) {
+    const auto& s1 = c1.getSide(isBid);
+    const auto& s2 = c2.getSide(isBid);
+    const size_t begin = elementList.size();
+    auto it1 = s1.rbegin();
+    int i1 = 0;
+    auto it2 = s2.rbegin();
+    int i2 = 0;
+    while (i1 < maxMarketDepth && i2 < maxMarketDepth && it1 != s1.rend() && it2 != s2.rend()) {
+      int comparison = c1.comparePrice(*it1, c2, *it2);
+      if (!isBid) {
+        comparison = -comparison;
       }
-      while (i1 < maxMarketDepth && it1 != c1.rend()) {
-        output.insert(std::make_pair(it1->first, it1->second));
+      if (comparison > 0) {
+        this->updateElementListWithMarketDepthLevel(isBid, c1, *it1, false, elementList);
         ++it1;
         ++i1;
-      }
-      while (i2 < maxMarketDepth && it2 != c2.rend()) {
-        output.insert(std::make_pair(it2->first, "0"));
+      } else if (comparison < 0) {
+        this->updateElementListWithMarketDepthLevel(isBid, c2, *it2, true, elementList);
         ++it2;
         ++i2;
-      }
-      return output;
-    } else {
-      auto it1 = c1.begin();
-      int i1 = 0;
-      auto it2 = c2.begin();
-      int i2 = 0;
-      std::map<Decimal, std::string> output;
-      while (i1 < maxMarketDepth && i2 < maxMarketDepth && it1 != c1.end() && it2 != c2.end()) {
-        if (it1->first < it2->first) {
-          output.insert(std::make_pair(it1->first, it1->second));
-          ++it1;
-          ++i1;
-        } else if (it1->first > it2->first) {
-          output.insert(std::make_pair(it2->first, "0"));
-          ++it2;
-          ++i2;
-        } else {
-          if (it1->second != it2->second) {
-            output.insert(std::make_pair(it1->first, it1->second));
-          }
-          ++it1;
-          ++i1;
-          ++it2;
-          ++i2;
+      } else {
+        if (it1->size != it2->size || it1->sizeDigits != it2->sizeDigits) {
+          this->updateElementListWithMarketDepthLevel(isBid, c1, *it1, false, elementList);
         }
-      }
-      while (i1 < maxMarketDepth && it1 != c1.end()) {
-        output.insert(std::make_pair(it1->first, it1->second));
         ++it1;
         ++i1;
-      }
-      while (i2 < maxMarketDepth && it2 != c2.end()) {
-        output.insert(std::make_pair(it2->first, "0"));
         ++it2;
         ++i2;
       }
-      return output;
+    }
+    while (i1 < maxMarketDepth && it1 != s1.rend()) {
+      this->updateElementListWithMarketDepthLevel(isBid, c1, *it1, false, elementList);
+      ++it1;
+      ++i1;
+    }
+    while (i2 < maxMarketDepth && it2 != s2.rend()) {
+      this->updateElementListWithMarketDepthLevel(isBid, c2, *it2, true, elementList);
+      ++it2;
+      ++i2;
+    }
+    if (isBid) {
+      std::reverse(elementList.begin() + begin, elementList.end());
     }
   }
-  void updateElementListWithUpdateMarketDepth(const std::string& field, const std::map<std::string, std::string>& optionMap,
-                                              const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotBidPrevious,
-                                              const std::map<Decimal, std::string>& snapshotAsk, const std::map<Decimal, std::string>& snapshotAskPrevious,
+  void updateElementListWithUpdateMarketDepth(const std::string& field, const std::map<std::string, std::string>& optionMap, const OrderBook& orderBook,
+                                              const OrderBook& orderBookPrevious, std::vector<Element>& elementList, bool alwaysUpdate) {
+    CCAPI_LOGGER_FUNCTION_ENTER;
+    if (field == CCAPI_MARKET_DEPTH) {
+      int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
+      CCAPI_LOGGER_TRACE("bidTopNSame = " + toString(orderBook.topNSame(true, orderBookPrevious, maxMarketDepth)));
+      CCAPI_LOGGER_TRACE("askTopNSame = " + toString(orderBook.topNSame(false, orderBookPrevious, maxMarketDepth)));
+      if (optionMap.at(CCAPI_MARKET_DEPTH_RETURN_UPDATE) == CCAPI_MARKET_DEPTH_RETURN_UPDATE_ENABLE) {
+        this->calculateMarketDepthUpdate(true, orderBook, orderBookPrevious, maxMarketDepth, elementList);
+        this->calculateMarketDepthUpdate(false, orderBook, orderBookPrevious, maxMarketDepth, elementList);
+      } else if (alwaysUpdate || !orderBook.topNSame(true, orderBookPrevious, maxMarketDepth) ||
+                 !orderBook.topNSame(false, orderBookPrevious, maxMarketDepth)) {
+        this->updateElementListWithOrderBookTopN(orderBook, maxMarketDepth, elementList);
+      }
+    }
+    CCAPI_LOGGER_FUNCTION_EXIT;
+  }
+  // Same as above, but compare orderBook with its state when 'OrderBook::startTrackingTopN' was called instead of with a copy of it.
+  void updateElementListWithUpdateMarketDepth(const std::string& field, const std::map<std::string, std::string>& optionMap, const OrderBook& orderBook,
                                               std::vector<Element>& elementList, bool alwaysUpdate) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     if (field == CCAPI_MARKET_DEPTH) {
       int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
       if (optionMap.at(CCAPI_MARKET_DEPTH_RETURN_UPDATE) == CCAPI_MARKET_DEPTH_RETURN_UPDATE_ENABLE) {
-        CCAPI_LOGGER_TRACE("lastNSame = " + toString(lastNSame(snapshotBid, snapshotBidPrevious, maxMarketDepth)));
-        CCAPI_LOGGER_TRACE("firstNSame = " + toString(firstNSame(snapshotAsk, snapshotAskPrevious, maxMarketDepth)));
-        std::map<Decimal, std::string> snapshotBidUpdate = this->calculateMarketDepthUpdate(true, snapshotBid, snapshotBidPrevious, maxMarketDepth);
-        for (auto& x : snapshotBidUpdate) {
-          Element element;
-          std::string k1(CCAPI_BEST_BID_N_PRICE);
-          std::string v1 = x.first.toString();
-          element.emplace(k1, v1);
-          std::string k2(CCAPI_BEST_BID_N_SIZE);
-          element.emplace(k2, x.second);
-          elementList.emplace_back(std::move(element));
+        for (bool isBid : {true, false}) {
+          orderBook.forEachTopNChange(isBid, [this, isBid, &orderBook, &elementList](const OrderBook::Level& level, bool isRemoved) {
+            this->updateElementListWithMarketDepthLevel(isBid, orderBook, level, isRemoved, elementList);
+          });
         }
-        std::map<Decimal, std::string> snapshotAskUpdate = this->calculateMarketDepthUpdate(false, snapshotAsk, snapshotAskPrevious, maxMarketDepth);
-        for (auto& x : snapshotAskUpdate) {
+      } else if (alwaysUpdate || orderBook.topNChanged(true) || orderBook.topNChanged(false)) {
+        this->updateElementListWithOrderBookTopN(orderBook, maxMarketDepth, elementList);
+      }
+    }
+    CCAPI_LOGGER_FUNCTION_EXIT;
+  }
+  void updateElementListWithTrade(const std::string& field, MarketDataMessage& marketDataMessage, std::vector<Element>& elementList) {
+    if (field == CCAPI_TRADE || field == CCAPI_AGG_TRADE) {
+      for (size_t i = marketDataMessage.recordBegin; i < marketDataMessage.recordEnd; ++i) {
+        const MarketDataMessage::Record& record = (*marketDataMessage.recordList)[i];
+        if (record.dataType == MarketDataMessage::DataType::TRADE || record.dataType == MarketDataMessage::DataType::AGG_TRADE) {
           Element element;
-          std::string k1(CCAPI_BEST_ASK_N_PRICE);
-          std::string v1 = x.first.toString();
-          element.emplace(k1, v1);
-          std::string k2(CCAPI_BEST_ASK_N_SIZE);
-          element.emplace(k2, x.second);
-          elementList.emplace_back(std::move(element));
-        }
-      } else {
-        CCAPI_LOGGER_TRACE("lastNSame = " + toString(lastNSame(snapshotBid, snapshotBidPrevious, maxMarketDepth)));
-        CCAPI_LOGGER_TRACE("firstNSame = " + toString(firstNSame(snapshotAsk, snapshotAskPrevious, maxMarketDepth)));
-        if (alwaysUpdate || !lastNSame(snapshotBid, snapshotBidPrevious, maxMarketDepth) || !firstNSame(snapshotAsk, snapshotAskPrevious, maxMarketDepth)) {
-          int bidIndex = 0;
-          for (auto iter = snapshotBid.rbegin(); iter != snapshotBid.rend(); ++iter) {
-            if (bidIndex >= maxMarketDepth) {
-              break;
-            }
-            Element element;
-            element.insert(CCAPI_BEST_BID_N_PRICE, iter->first.toString());
-            element.insert(CCAPI_BEST_BID_N_SIZE, iter->second);
-            elementList.emplace_back(std::move(element));
-            ++bidIndex;
-          }
-          if (snapshotBid.empty()) {
-            Element element;
-            element.insert(CCAPI_BEST_BID_N_PRICE, CCAPI_BEST_BID_N_PRICE_EMPTY);
-            element.insert(CCAPI_BEST_BID_N_SIZE, CCAPI_BEST_BID_N_SIZE_EMPTY);
-            elementList.emplace_back(std::move(element));
-          }
-          int askIndex = 0;
-          for (auto iter = snapshotAsk.begin(); iter != snapshotAsk.end(); ++iter) {
-            if (askIndex >= maxMarketDepth) {
-              break;
-            }
-            Element element;
-            element.insert(CCAPI_BEST_ASK_N_PRICE, iter->first.toString());
-            element.insert(CCAPI_BEST_ASK_N_SIZE, iter->second);
-            elementList.emplace_back(std::move(element));
-            ++askIndex;
-          }
-          if (snapshotAsk.empty()) {
-            Element element;
-            element.insert(CCAPI_BEST_ASK_N_PRICE, CCAPI_BEST_ASK_N_PRICE_EMPTY);
-            element.insert(CCAPI_BEST_ASK_N_SIZE, CCAPI_BEST_ASK_N_SIZE_EMPTY);
-            elementList.emplace_back(std::move(element));
+          element.reserve(4);
+          element.insert(CCAPI_LAST_PRICE, std::string(record.price));
+          element.insert(CCAPI_LAST_SIZE, std::string(record.size));
+          if (!record.tradeId.empty()) {
+            element.insert(record.dataType == MarketDataMessage::DataType::TRADE ? CCAPI_TRADE_ID : CCAPI_AGG_TRADE_ID, std::string(record.tradeId));
           }
+          element.insert(CCAPI_IS_BUYER_MAKER, record.isBuyerMaker ? "1" : "0");
+          elementList.emplace_back(std::move(element));
+        } else {
+          CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(record.dataType));
         }
       }
     }
-    CCAPI_LOGGER_FUNCTION_EXIT;
+    this->updateElementListWithTrade(field, marketDataMessage.data, elementList);
   }
   void updateElementListWithTrade(const std::string& field, MarketDataMessage::TypeForData& input, std::vector<Element>& elementList) {
     if (field == CCAPI_TRADE || field == CCAPI_AGG_TRADE) {
@@ -1079,68 +1025,208 @@ class MarketDataService : public Service {
       }
     }
   }
-  void updateElementListWithCalculatedCandlestick(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId,
-                                                  const std::string& field, std::vector<Element>& elementList) {
+  SubscriptionState& getSubscriptionState(const WsConnection& wsConnection, const std::string& exchangeSubscriptionId) {
+    auto& handleByExchangeSubscriptionIdMap = this->subscriptionStateHandleByConnectionIdExchangeSubscriptionIdMap[wsConnection.id];
+    auto it = handleByExchangeSubscriptionIdMap.find(exchangeSubscriptionId);
+    if (it != handleByExchangeSubscriptionIdMap.end()) {
+      return this->subscriptionStateList[it->second];
+    }
+    const auto& channelIdSymbolId = this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId);
+    size_t handle = this->getSubscriptionStateHandle(wsConnection, channelIdSymbolId.at(CCAPI_CHANNEL_ID), channelIdSymbolId.at(CCAPI_SYMBOL_ID));
+    handleByExchangeSubscriptionIdMap.emplace(exchangeSubscriptionId, handle);
+    return this->subscriptionStateList[handle];
+  }
+  size_t getSubscriptionStateHandle(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId) {
+    auto& handleBySymbolIdMap = this->subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId];
+    auto it = handleBySymbolIdMap.find(symbolId);
+    if (it != handleBySymbolIdMap.end()) {
+      return it->second;
+    }
+    size_t handle;
+    if (this->freeSubscriptionStateHandleList.empty()) {
+      handle = this->subscriptionStateList.size();
+      this->subscriptionStateList.emplace_back();
+    } else {
+      handle = this->freeSubscriptionStateHandleList.back();
+      this->freeSubscriptionStateHandleList.pop_back();
+    }
+    SubscriptionState& subscriptionState = this->subscriptionStateList[handle];
+    subscriptionState.handle = handle;
+    subscriptionState.connectionId = wsConnection.id;
+    subscriptionState.channelId = channelId;
+    subscriptionState.symbolId = symbolId;
+    subscriptionState.field = &this->fieldByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
+    subscriptionState.optionMap = &this->optionMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
+    subscriptionState.correlationIdList = &this->correlationIdListByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
+    subscriptionState.processedInitialSnapshot = &this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
+    subscriptionState.l2UpdateIsReplace = &this->l2UpdateIsReplaceByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
+    handleBySymbolIdMap.emplace(symbolId, handle);
+    return handle;
+  }
+  SubscriptionState* findSubscriptionState(const std::string& connectionId, const std::string& channelId, const std::string& symbolId) {
+    auto it1 = this->subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap.find(connectionId);
+    if (it1 == this->subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap.end()) {
+      return nullptr;
+    }
+    auto it2 = it1->second.find(channelId);
+    if (it2 == it1->second.end()) {
+      return nullptr;
+    }
+    auto it3 = it2->second.find(symbolId);
+    if (it3 == it2->second.end()) {
+      return nullptr;
+    }
+    return &this->subscriptionStateList[it3->second];
+  }
+  void releaseSubscriptionStates(const WsConnection& wsConnection) {
+    auto it = this->subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap.find(wsConnection.id);
+    if (it != this->subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap.end()) {
+      for (const auto& x : it->second) {
+        for (const auto& y : x.second) {
+          this->subscriptionStateList[y.second] = SubscriptionState();
+          this->freeSubscriptionStateHandleList.push_back(y.second);
+        }
+      }
+      this->subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap.erase(it);
+    }
+    this->subscriptionStateHandleByConnectionIdExchangeSubscriptionIdMap.erase(wsConnection.id);
+  }
+  void updateElementListWithCalculatedCandlestick(SubscriptionState& subscriptionState, std::vector<Element>& elementList) {
+    const std::string& field = *subscriptionState.field;
     if (field == CCAPI_TRADE || field == CCAPI_AGG_TRADE) {
       Element element;
-      if (this->openByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId].empty()) {
+      if (subscriptionState.open.empty()) {
         element.insert(CCAPI_OPEN_PRICE, CCAPI_CANDLESTICK_EMPTY);
         element.insert(CCAPI_HIGH_PRICE, CCAPI_CANDLESTICK_EMPTY);
         element.insert(CCAPI_LOW_PRICE, CCAPI_CANDLESTICK_EMPTY);
         element.insert(CCAPI_CLOSE_PRICE, CCAPI_CANDLESTICK_EMPTY);
       } else {
-        element.insert(CCAPI_OPEN_PRICE, this->openByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]);
-        element.insert(CCAPI_HIGH_PRICE, this->highByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId].toString());
-        element.insert(CCAPI_LOW_PRICE, this->lowByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId].toString());
-        element.insert(CCAPI_CLOSE_PRICE, this->closeByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]);
+        element.insert(CCAPI_OPEN_PRICE, subscriptionState.open);
+        element.insert(CCAPI_HIGH_PRICE, subscriptionState.high.toString());
+        element.insert(CCAPI_LOW_PRICE, subscriptionState.low.toString());
+        element.insert(CCAPI_CLOSE_PRICE, subscriptionState.close);
       }
       elementList.emplace_back(std::move(element));
-      this->openByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = "";
-      this->highByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = Decimal();
-      this->lowByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = Decimal();
-      this->closeByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = "";
+      subscriptionState.open.clear();
+      subscriptionState.high = Decimal();
+      subscriptionState.low = Decimal();
+      subscriptionState.close.clear();
     }
   }
-  void copySnapshot(bool isBid, const std::map<Decimal, std::string>& original, std::map<Decimal, std::string>& copy, const int maxMarketDepth) {
-    size_t nToCopy = std::min(original.size(), static_cast<size_t>(maxMarketDepth));
-    if (isBid) {
-      std::copy_n(original.rbegin(), nToCopy, std::inserter(copy, copy.end()));
-    } else {
-      std::copy_n(original.begin(), nToCopy, std::inserter(copy, copy.end()));
-    }
+  // Rebuild the order book of a subscription from a snapshot without generating any Element.
+  void applyOrderBookInitial(SubscriptionState& subscriptionState, const MarketDataMessage& marketDataMessage) {
+    OrderBook& orderBook = subscriptionState.orderBook;
+    orderBook.clear();
+    bool keepTrailingZero = this->sessionOptions.enableCheckOrderBookChecksum;
+    marketDataMessage.forEachRecord([&orderBook, keepTrailingZero](const MarketDataMessage::Record& record) {
+      if (record.dataType == MarketDataMessage::DataType::BID || record.dataType == MarketDataMessage::DataType::ASK) {
+        orderBook.insertUnsorted(record.dataType == MarketDataMessage::DataType::BID, record.price, record.size, keepTrailingZero);
+      } else {
+        CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(record.dataType));
+      }
+    });
+    orderBook.sort();
+    *subscriptionState.processedInitialSnapshot = true;
   }
-  void processOrderBookInitial(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, Event& event, const TimePoint& tp,
-                               const TimePoint& timeReceived, MarketDataMessage::TypeForData& input, const std::string& field,
-                               const std::map<std::string, std::string>& optionMap, const std::vector<std::string>& correlationIdList,
-                               std::map<Decimal, std::string>& snapshotBid, std::map<Decimal, std::string>& snapshotAsk) {
-    snapshotBid.clear();
-    snapshotAsk.clear();
-    int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
-    for (auto& x : input) {
-      auto& type = x.first;
-      auto& detail = x.second;
-      if (type == MarketDataMessage::DataType::BID) {
-        for (auto& y : detail) {
-          auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-          auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-          Decimal decimalPrice(price, this->sessionOptions.enableCheckOrderBookChecksum);
-          snapshotBid.emplace(std::move(decimalPrice), std::move(size));
+  // Apply an incremental update to the order book of a subscription without generating any Element.
+  void applyOrderBookUpdate(const WsConnection& wsConnection, SubscriptionState& subscriptionState, const MarketDataMessage& marketDataMessage) {
+    OrderBook& orderBook = subscriptionState.orderBook;
+    if (*subscriptionState.l2UpdateIsReplace) {
+      for (bool isBid : {true, false}) {
+        if (marketDataMessage.hasDataType(isBid ? MarketDataMessage::DataType::BID : MarketDataMessage::DataType::ASK)) {
+          CCAPI_LOGGER_TRACE("l2Update is replace");
+          orderBook.clear(isBid);
         }
-        CCAPI_LOGGER_TRACE("lastNToString(snapshotBid, " + toString(maxMarketDepth) + ") = " + lastNToString(snapshotBid, maxMarketDepth));
-      } else if (type == MarketDataMessage::DataType::ASK) {
-        for (auto& y : detail) {
-          auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-          auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-          Decimal decimalPrice(price, this->sessionOptions.enableCheckOrderBookChecksum);
-          snapshotAsk.emplace(std::move(decimalPrice), std::move(size));
-        }
-        CCAPI_LOGGER_TRACE("firstNToString(snapshotAsk, " + toString(maxMarketDepth) + ") = " + firstNToString(snapshotAsk, maxMarketDepth));
+      }
+    }
+    bool keepTrailingZero = this->sessionOptions.enableCheckOrderBookChecksum;
+    marketDataMessage.forEachRecord([this, &orderBook, keepTrailingZero](const MarketDataMessage::Record& record) {
+      if (record.dataType == MarketDataMessage::DataType::BID || record.dataType == MarketDataMessage::DataType::ASK) {
+        this->updateOrderBook(orderBook, record.dataType == MarketDataMessage::DataType::BID, record.price, record.size, keepTrailingZero);
       } else {
-        CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(type));
+        CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(record.dataType));
       }
+    });
+    if (this->shouldAlignSnapshot) {
+      if (!subscriptionState.marketDepthSubscribedToExchange) {
+        subscriptionState.marketDepthSubscribedToExchange = &this->marketDepthSubscribedToExchangeByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id)
+                                                                 .at(subscriptionState.channelId)
+                                                                 .at(subscriptionState.symbolId);
+      }
+      this->alignSnapshot(orderBook, *subscriptionState.marketDepthSubscribedToExchange);
+    }
+  }
+  // Rebuild the order book of a subscription from a snapshot and, unless skipMarketDataEvents is set, add the resulting market depth message to event.
+  void dispatchOrderBookInitial(const WsConnection& wsConnection, SubscriptionState& subscriptionState, Event& event, const TimePoint& timeReceived,
+                                const MarketDataMessage& marketDataMessage) {
+    if (this->skipMarketDataEvents) {
+      this->applyOrderBookInitial(subscriptionState, marketDataMessage);
+    } else {
+      this->processOrderBookInitial(wsConnection, subscriptionState, event, marketDataMessage.tp, timeReceived, marketDataMessage);
     }
+  }
+  // Apply an incremental update to the order book of a subscription and, unless skipMarketDataEvents is set, add the resulting market depth message to event.
+  void dispatchOrderBookUpdate(const WsConnection& wsConnection, SubscriptionState& subscriptionState, Event& event, const TimePoint& timeReceived,
+                               const MarketDataMessage& marketDataMessage) {
+    if (this->skipMarketDataEvents) {
+      this->applyOrderBookUpdate(wsConnection, subscriptionState, marketDataMessage);
+    } else {
+      this->processOrderBookUpdate(wsConnection, subscriptionState, event, marketDataMessage.tp, timeReceived, marketDataMessage);
+    }
+  }
+  // Deliver the levels and trades of a market data message to the typed market data handler, parsing prices and sizes without allocating.
+  void invokeMarketDataHandler(const SubscriptionState& subscriptionState, const MarketDataMessage& marketDataMessage, const TimePoint& timeReceived) {
+    size_t numBookUpdates = 0;
+    marketDataMessage.forEachRecord([&numBookUpdates](const MarketDataMessage::Record& record) {
+      if (record.dataType == MarketDataMessage::DataType::BID || record.dataType == MarketDataMessage::DataType::ASK) {
+        ++numBookUpdates;
+      }
+    });
+    BookUpdate bookUpdate;
+    bookUpdate.instrumentHandle = subscriptionState.handle;
+    bookUpdate.correlationIdList = subscriptionState.correlationIdList;
+    bookUpdate.isSnapshot = marketDataMessage.recapType == MarketDataMessage::RecapType::SOLICITED || *subscriptionState.l2UpdateIsReplace;
+    bookUpdate.exchangeTs = marketDataMessage.tp;
+    bookUpdate.recvTs = timeReceived;
+    Trade trade;
+    trade.instrumentHandle = subscriptionState.handle;
+    trade.correlationIdList = subscriptionState.correlationIdList;
+    trade.exchangeTs = marketDataMessage.tp;
+    trade.recvTs = timeReceived;
+    size_t bookUpdateIndex = 0;
+    marketDataMessage.forEachRecord([this, numBookUpdates, &bookUpdate, &trade, &bookUpdateIndex](const MarketDataMessage::Record& record) {
+      int digits;
+      if (record.dataType == MarketDataMessage::DataType::BID || record.dataType == MarketDataMessage::DataType::ASK) {
+        bookUpdate.isBid = record.dataType == MarketDataMessage::DataType::BID;
+        OrderBook::parse(record.price.data(), record.price.size(), bookUpdate.priceTicks, digits, false);
+        bookUpdate.priceScale = digits;
+        OrderBook::parse(record.size.data(), record.size.size(), bookUpdate.sizeLots, digits, false);
+        bookUpdate.sizeScale = digits;
+        bookUpdate.isLastInMessage = ++bookUpdateIndex == numBookUpdates;
+        this->marketDataHandler->onBookUpdate(bookUpdate);
+      } else if (record.dataType == MarketDataMessage::DataType::TRADE || record.dataType == MarketDataMessage::DataType::AGG_TRADE) {
+        trade.isAggregated = record.dataType == MarketDataMessage::DataType::AGG_TRADE;
+        OrderBook::parse(record.price.data(), record.price.size(), trade.priceTicks, digits, false);
+        trade.priceScale = digits;
+        OrderBook::parse(record.size.data(), record.size.size(), trade.sizeLots, digits, false);
+        trade.sizeScale = digits;
+        trade.isBuyerMaker = record.isBuyerMaker;
+        trade.tradeId = record.tradeId;
+        this->marketDataHandler->onTrade(trade);
+      }
+    });
+  }
+  void processOrderBookInitial(const WsConnection& wsConnection, SubscriptionState& subscriptionState, Event& event, const TimePoint& tp,
+                               const TimePoint& timeReceived, const MarketDataMessage& marketDataMessage) {
+    const std::string& field = *subscriptionState.field;
+    const std::map<std::string, std::string>& optionMap = *subscriptionState.optionMap;
+    const std::vector<std::string>& correlationIdList = *subscriptionState.correlationIdList;
+    OrderBook& orderBook = subscriptionState.orderBook;
+    int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
+    this->applyOrderBookInitial(subscriptionState, marketDataMessage);
+    CCAPI_LOGGER_TRACE("orderBook.topNToString(" + toString(maxMarketDepth) + ") = " + orderBook.topNToString(maxMarketDepth));
     std::vector<Element> elementList;
-    this->updateElementListWithInitialMarketDepth(field, optionMap, snapshotBid, snapshotAsk, elementList);
+    this->updateElementListWithInitialMarketDepth(field, optionMap, orderBook, elementList);
     if (!elementList.empty()) {
       Message message;
       message.setTimeReceived(timeReceived);
@@ -1153,127 +1239,68 @@ class MarketDataService : public Service {
       event.addMessages(newMessageList);
       CCAPI_LOGGER_TRACE("event.getMessageList() = " + toString(event.getMessageList()));
     }
-    this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = true;
     bool shouldConflate = optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS) != CCAPI_CONFLATE_INTERVAL_MILLISECONDS_DEFAULT;
     if (shouldConflate) {
-      this->copySnapshot(true, snapshotBid, this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId],
-                         maxMarketDepth);
-      this->copySnapshot(false, snapshotAsk, this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId],
-                         maxMarketDepth);
-      CCAPI_LOGGER_TRACE(
-          "this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at("
-          "symbolId) = " +
-          toString(this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId)));
-      CCAPI_LOGGER_TRACE(
-          "this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at("
-          "symbolId) = " +
-          toString(this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId)));
+      orderBook.copyTopN(subscriptionState.previousConflateOrderBook, maxMarketDepth);
+      CCAPI_LOGGER_TRACE("subscriptionState.previousConflateOrderBook = " + toString(subscriptionState.previousConflateOrderBook));
       TimePoint previousConflateTp = UtilTime::makeTimePointFromMilliseconds(
           std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count() / std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)) *
           std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)));
-      this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = previousConflateTp;
+      subscriptionState.previousConflateTime = previousConflateTp;
       if (optionMap.at(CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS) != CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS_DEFAULT) {
         auto interval = std::chrono::milliseconds(std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)));
         auto gracePeriod = std::chrono::milliseconds(std::stoi(optionMap.at(CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS)));
         CCAPI_LOGGER_TRACE("about to set conflate timer");
-        this->setConflateTimer(previousConflateTp, interval, gracePeriod, wsConnection, channelId, symbolId, field, optionMap, correlationIdList);
+        this->setConflateTimer(previousConflateTp, interval, gracePeriod, wsConnection, subscriptionState);
       }
     }
   }
-  void processOrderBookUpdate(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, Event& event, const TimePoint& tp,
-                              const TimePoint& timeReceived, MarketDataMessage::TypeForData& input, const std::string& field,
-                              const std::map<std::string, std::string>& optionMap, const std::vector<std::string>& correlationIdList,
-                              std::map<Decimal, std::string>& snapshotBid, std::map<Decimal, std::string>& snapshotAsk) {
-    CCAPI_LOGGER_TRACE("input = " + MarketDataMessage::dataToString(input));
-    if (this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]) {
+  void processOrderBookUpdate(const WsConnection& wsConnection, SubscriptionState& subscriptionState, Event& event, const TimePoint& tp,
+                              const TimePoint& timeReceived, const MarketDataMessage& marketDataMessage) {
+    CCAPI_LOGGER_TRACE("marketDataMessage = " + toString(marketDataMessage));
+    if (*subscriptionState.processedInitialSnapshot) {
+      const std::string& field = *subscriptionState.field;
+      const std::map<std::string, std::string>& optionMap = *subscriptionState.optionMap;
+      const std::vector<std::string>& correlationIdList = *subscriptionState.correlationIdList;
+      OrderBook& orderBook = subscriptionState.orderBook;
       std::vector<Message> messageList;
       CCAPI_LOGGER_TRACE("optionMap = " + toString(optionMap));
       int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
-      std::map<Decimal, std::string> snapshotBidPrevious;
-      this->copySnapshot(true, snapshotBid, snapshotBidPrevious, maxMarketDepth);
-      std::map<Decimal, std::string> snapshotAskPrevious;
-      this->copySnapshot(false, snapshotAsk, snapshotAskPrevious, maxMarketDepth);
-      CCAPI_LOGGER_TRACE("before updating orderbook");
-      CCAPI_LOGGER_TRACE("lastNToString(snapshotBid, " + toString(maxMarketDepth) + ") = " + lastNToString(snapshotBid, maxMarketDepth));
-      CCAPI_LOGGER_TRACE("firstNToString(snapshotAsk, " + toString(maxMarketDepth) + ") = " + firstNToString(snapshotAsk, maxMarketDepth));
-      if (this->l2UpdateIsReplaceByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]) {
-        CCAPI_LOGGER_TRACE("l2Update is replace");
-        if (input.find(MarketDataMessage::DataType::BID) != input.end()) {
-          snapshotBid.clear();
-        }
-        if (input.find(MarketDataMessage::DataType::ASK) != input.end()) {
-          snapshotAsk.clear();
-        }
-      }
-      for (auto& x : input) {
-        auto& type = x.first;
-        auto& detail = x.second;
-        if (type == MarketDataMessage::DataType::BID) {
-          for (auto& y : detail) {
-            auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-            auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-            Decimal decimalPrice(price, this->sessionOptions.enableCheckOrderBookChecksum);
-            this->updateOrderBook(snapshotBid, decimalPrice, size, this->sessionOptions.enableCheckOrderBookChecksum);
-          }
-        } else if (type == MarketDataMessage::DataType::ASK) {
-          for (auto& y : detail) {
-            auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-            auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-            Decimal decimalPrice(price, this->sessionOptions.enableCheckOrderBookChecksum);
-            this->updateOrderBook(snapshotAsk, decimalPrice, size, this->sessionOptions.enableCheckOrderBookChecksum);
-          }
-        } else {
-          CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(type));
-        }
-      }
-      CCAPI_LOGGER_TRACE("this->marketDepthSubscribedToExchangeByConnectionIdChannelIdSymbolIdMap = " +
-                         toString(this->marketDepthSubscribedToExchangeByConnectionIdChannelIdSymbolIdMap));
-      if (this->shouldAlignSnapshot) {
-        int marketDepthSubscribedToExchange =
-            this->marketDepthSubscribedToExchangeByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
-        this->alignSnapshot(snapshotBid, snapshotAsk, marketDepthSubscribedToExchange);
+      bool shouldConflate = optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS) != CCAPI_CONFLATE_INTERVAL_MILLISECONDS_DEFAULT;
+      CCAPI_LOGGER_TRACE("shouldConflate = " + toString(shouldConflate));
+      OrderBook orderBookPrevious;
+      if (shouldConflate) {
+        orderBook.copyTopN(orderBookPrevious, maxMarketDepth);
+      } else {
+        orderBook.startTrackingTopN(maxMarketDepth);
       }
+      CCAPI_LOGGER_TRACE("before updating orderbook");
+      CCAPI_LOGGER_TRACE("orderBook.topNToString(" + toString(maxMarketDepth) + ") = " + orderBook.topNToString(maxMarketDepth));
+      this->applyOrderBookUpdate(wsConnection, subscriptionState, marketDataMessage);
       CCAPI_LOGGER_TRACE("after updating orderbook");
-      CCAPI_LOGGER_TRACE("lastNToString(snapshotBid, " + toString(maxMarketDepth) + ") = " + lastNToString(snapshotBid, maxMarketDepth));
-      CCAPI_LOGGER_TRACE("firstNToString(snapshotAsk, " + toString(maxMarketDepth) + ") = " + firstNToString(snapshotAsk, maxMarketDepth));
-      CCAPI_LOGGER_TRACE("lastNToString(snapshotBidPrevious, " + toString(maxMarketDepth) + ") = " + lastNToString(snapshotBidPrevious, maxMarketDepth));
-      CCAPI_LOGGER_TRACE("firstNToString(snapshotAskPrevious, " + toString(maxMarketDepth) + ") = " + firstNToString(snapshotAskPrevious, maxMarketDepth));
+      CCAPI_LOGGER_TRACE("orderBook.topNToString(" + toString(maxMarketDepth) + ") = " + orderBook.topNToString(maxMarketDepth));
+      CCAPI_LOGGER_TRACE("orderBookPrevious = " + toString(orderBookPrevious));
       CCAPI_LOGGER_TRACE("field = " + toString(field));
       CCAPI_LOGGER_TRACE("maxMarketDepth = " + toString(maxMarketDepth));
       CCAPI_LOGGER_TRACE("optionMap = " + toString(optionMap));
-      bool shouldConflate = optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS) != CCAPI_CONFLATE_INTERVAL_MILLISECONDS_DEFAULT;
-      CCAPI_LOGGER_TRACE("shouldConflate = " + toString(shouldConflate));
       TimePoint conflateTp =
           shouldConflate ? UtilTime::makeTimePointFromMilliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count() /
                                                                    std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)) *
                                                                    std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)))
                          : tp;
       CCAPI_LOGGER_TRACE("conflateTp = " + toString(conflateTp));
-      bool intervalChanged =
-          shouldConflate && conflateTp > this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
+      bool intervalChanged = shouldConflate && conflateTp > subscriptionState.previousConflateTime;
       CCAPI_LOGGER_TRACE("intervalChanged = " + toString(intervalChanged));
       if (!shouldConflate || intervalChanged) {
         std::vector<Element> elementList;
         if (shouldConflate && intervalChanged) {
-          const std::map<Decimal, std::string>& snapshotBidPreviousPrevious =
-              this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
-          const std::map<Decimal, std::string>& snapshotAskPreviousPrevious =
-              this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
-          this->updateElementListWithUpdateMarketDepth(field, optionMap, snapshotBidPrevious, snapshotBidPreviousPrevious, snapshotAskPrevious,
-                                                       snapshotAskPreviousPrevious, elementList, false);
-          this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) = snapshotBidPrevious;
-          this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) = snapshotAskPrevious;
-          CCAPI_LOGGER_TRACE(
-              "this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at("
-              "symbolId) = " +
-              toString(this->previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId)));
-          CCAPI_LOGGER_TRACE(
-              "this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at("
-              "symbolId) = " +
-              toString(this->previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId)));
+          OrderBook& orderBookPreviousPrevious = subscriptionState.previousConflateOrderBook;
+          this->updateElementListWithUpdateMarketDepth(field, optionMap, orderBookPrevious, orderBookPreviousPrevious, elementList, false);
+          orderBookPreviousPrevious = std::move(orderBookPrevious);
+          CCAPI_LOGGER_TRACE("subscriptionState.previousConflateOrderBook = " + toString(subscriptionState.previousConflateOrderBook));
         } else {
-          this->updateElementListWithUpdateMarketDepth(field, optionMap, snapshotBid, snapshotBidPrevious, snapshotAsk, snapshotAskPrevious, elementList,
-                                                       false);
+          this->updateElementListWithUpdateMarketDepth(field, optionMap, orderBook, elementList, false);
+          orderBook.stopTrackingTopN();
         }
         CCAPI_LOGGER_TRACE("elementList = " + toString(elementList));
         if (!elementList.empty()) {
@@ -1281,9 +1308,10 @@ class MarketDataService : public Service {
           message.setTimeReceived(timeReceived);
           message.setType(Message::Type::MARKET_DATA_EVENTS_MARKET_DEPTH);
           message.setRecapType(Message::RecapType::NONE);
-          TimePoint time = shouldConflate ? this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) +
-                                                std::chrono::milliseconds(std::stoll(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)))
-                                          : conflateTp;
+          TimePoint time = conflateTp;
+          if (shouldConflate) {
+            time = subscriptionState.previousConflateTime + std::chrono::milliseconds(std::stoll(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)));
+          }
           message.setTime(time);
           message.setElementList(elementList);
           message.setCorrelationIdList(correlationIdList);
@@ -1293,15 +1321,17 @@ class MarketDataService : public Service {
           event.addMessages(messageList);
         }
         if (shouldConflate) {
-          this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) = conflateTp;
+          subscriptionState.previousConflateTime = conflateTp;
         }
       }
     }
   }
-  void processTrade(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, Event& event, const TimePoint& tp,
-                    const TimePoint& timeReceived, MarketDataMessage::TypeForData& input, const std::string& field,
-                    const std::map<std::string, std::string>& optionMap, const std::vector<std::string>& correlationIdList, bool isSolicited) {
-    CCAPI_LOGGER_TRACE("input = " + MarketDataMessage::dataToString(input));
+  void processTrade(const WsConnection& wsConnection, SubscriptionState& subscriptionState, Event& event, const TimePoint& tp, const TimePoint& timeReceived,
+                    MarketDataMessage& marketDataMessage, bool isSolicited) {
+    const std::string& field = *subscriptionState.field;
+    const std::map<std::string, std::string>& optionMap = *subscriptionState.optionMap;
+    const std::vector<std::string>& correlationIdList = *subscriptionState.correlationIdList;
+    CCAPI_LOGGER_TRACE("marketDataMessage = " + toString(marketDataMessage));
     CCAPI_LOGGER_TRACE("optionMap = " + toString(optionMap));
     bool shouldConflate = optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS) != CCAPI_CONFLATE_INTERVAL_MILLISECONDS_DEFAULT;
     CCAPI_LOGGER_TRACE("shouldConflate = " + toString(shouldConflate));
@@ -1311,29 +1341,28 @@ class MarketDataService : public Service {
                                                                          std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)))
                                : tp;
     CCAPI_LOGGER_TRACE("conflateTp = " + toString(conflateTp));
-    if (!this->processedInitialTradeByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]) {
+    if (!subscriptionState.processedInitialTrade) {
       if (shouldConflate) {
         TimePoint previousConflateTp = conflateTp;
-        this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = previousConflateTp;
+        subscriptionState.previousConflateTime = previousConflateTp;
         if (optionMap.at(CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS) != CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS_DEFAULT) {
           auto interval = std::chrono::milliseconds(std::stoi(optionMap.at(CCAPI_CONFLATE_INTERVAL_MILLISECONDS)));
           auto gracePeriod = std::chrono::milliseconds(std::stoi(optionMap.at(CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS)));
           CCAPI_LOGGER_TRACE("about to set conflate timer");
-          this->setConflateTimer(previousConflateTp, interval, gracePeriod, wsConnection, channelId, symbolId, field, optionMap, correlationIdList);
+          this->setConflateTimer(previousConflateTp, interval, gracePeriod, wsConnection, subscriptionState);
         }
       }
-      this->processedInitialTradeByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = true;
+      subscriptionState.processedInitialTrade = true;
     }
-    bool intervalChanged =
-        shouldConflate && conflateTp > this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
+    bool intervalChanged = shouldConflate && conflateTp > subscriptionState.previousConflateTime;
     CCAPI_LOGGER_TRACE("intervalChanged = " + toString(intervalChanged));
     if (!shouldConflate || intervalChanged) {
       std::vector<Message> messageList;
       std::vector<Element> elementList;
       if (shouldConflate && intervalChanged) {
-        this->updateElementListWithCalculatedCandlestick(wsConnection, channelId, symbolId, field, elementList);
+        this->updateElementListWithCalculatedCandlestick(subscriptionState, elementList);
       } else {
-        this->updateElementListWithTrade(field, input, elementList);
+        this->updateElementListWithTrade(field, marketDataMessage, elementList);
       }
       CCAPI_LOGGER_TRACE("elementList = " + toString(elementList));
       if (!elementList.empty()) {
@@ -1341,8 +1370,7 @@ class MarketDataService : public Service {
         message.setTimeReceived(timeReceived);
         message.setType(field == CCAPI_TRADE ? Message::Type::MARKET_DATA_EVENTS_TRADE : Message::Type::MARKET_DATA_EVENTS_AGG_TRADE);
         message.setRecapType(isSolicited ? Message::RecapType::SOLICITED : Message::RecapType::NONE);
-        TimePoint time =
-            shouldConflate ? this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) : conflateTp;
+        TimePoint time = shouldConflate ? subscriptionState.previousConflateTime : conflateTp;
         message.setTime(time);
         message.setElementList(elementList);
         message.setCorrelationIdList(correlationIdList);
@@ -1352,11 +1380,11 @@ class MarketDataService : public Service {
         event.addMessages(messageList);
       }
       if (shouldConflate) {
-        this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) = conflateTp;
-        this->updateCalculatedCandlestick(wsConnection, channelId, symbolId, field, input);
+        subscriptionState.previousConflateTime = conflateTp;
+        this->updateCalculatedCandlestick(subscriptionState, marketDataMessage);
       }
     } else {
-      this->updateCalculatedCandlestick(wsConnection, channelId, symbolId, field, input);
+      this->updateCalculatedCandlestick(subscriptionState, marketDataMessage);
     }
   }
   void processExchangeProvidedCandlestick(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, Event& event,
@@ -1398,58 +1426,46 @@ class MarketDataService : public Service {
       event.addMessages(messageList);
     }
   }
-  void updateCalculatedCandlestick(const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, const std::string& field,
-                                   const MarketDataMessage::TypeForData& input) {
+  void updateCalculatedCandlestick(SubscriptionState& subscriptionState, const MarketDataMessage& marketDataMessage) {
+    const std::string& field = *subscriptionState.field;
     if (field == CCAPI_TRADE || field == CCAPI_AGG_TRADE) {
-      for (const auto& x : input) {
-        auto type = x.first;
-        auto detail = x.second;
-        if (type == MarketDataMessage::DataType::TRADE || type == MarketDataMessage::DataType::AGG_TRADE) {
-          for (const auto& y : detail) {
-            auto price = y.at(MarketDataMessage::DataFieldType::PRICE);
-            if (this->openByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId].empty()) {
-              this->openByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = price;
-              this->highByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = Decimal(price);
-              this->lowByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = Decimal(price);
-            } else {
-              Decimal decimalPrice(price);
-              if (decimalPrice > this->highByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]) {
-                this->highByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = decimalPrice;
-              }
-              if (decimalPrice < this->lowByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]) {
-                this->lowByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = decimalPrice;
-              }
+      marketDataMessage.forEachRecord([&subscriptionState](const MarketDataMessage::Record& record) {
+        if (record.dataType == MarketDataMessage::DataType::TRADE || record.dataType == MarketDataMessage::DataType::AGG_TRADE) {
+          Decimal decimalPrice(record.price);
+          if (subscriptionState.open.empty()) {
+            subscriptionState.open.assign(record.price.data(), record.price.size());
+            subscriptionState.high = decimalPrice;
+            subscriptionState.low = decimalPrice;
+          } else {
+            if (decimalPrice > subscriptionState.high) {
+              subscriptionState.high = decimalPrice;
+            }
+            if (decimalPrice < subscriptionState.low) {
+              subscriptionState.low = decimalPrice;
             }
-            this->closeByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = price;
           }
+          subscriptionState.close.assign(record.price.data(), record.price.size());
         } else {
-          CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(type));
+          CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(record.dataType));
         }
-      }
+      });
     }
   }
-  virtual void alignSnapshot(std::map<Decimal, std::string>& snapshotBid, std::map<Decimal, std::string>& snapshotAsk, int marketDepthSubscribedToExchange) {
-    CCAPI_LOGGER_TRACE("snapshotBid.size() = " + toString(snapshotBid.size()));
-    if (snapshotBid.size() > marketDepthSubscribedToExchange) {
-      keepLastN(snapshotBid, marketDepthSubscribedToExchange);
-    }
-    CCAPI_LOGGER_TRACE("snapshotBid.size() = " + toString(snapshotBid.size()));
-    CCAPI_LOGGER_TRACE("snapshotAsk.size() = " + toString(snapshotAsk.size()));
-    if (snapshotAsk.size() > marketDepthSubscribedToExchange) {
-      keepFirstN(snapshotAsk, marketDepthSubscribedToExchange);
-    }
-    CCAPI_LOGGER_TRACE("snapshotAsk.size() = " + toString(snapshotAsk.size()));
+  virtual void alignSnapshot(OrderBook& orderBook, int marketDepthSubscribedToExchange) {
+    CCAPI_LOGGER_TRACE("orderBook.getBids().size() = " + toString(orderBook.getBids().size()));
+    CCAPI_LOGGER_TRACE("orderBook.getAsks().size() = " + toString(orderBook.getAsks().size()));
+    orderBook.keepTopN(marketDepthSubscribedToExchange);
+    CCAPI_LOGGER_TRACE("orderBook.getBids().size() = " + toString(orderBook.getBids().size()));
+    CCAPI_LOGGER_TRACE("orderBook.getAsks().size() = " + toString(orderBook.getAsks().size()));
   }
-  virtual bool checkOrderBookChecksum(const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotAsk,
-                                      const std::string& receivedOrderBookChecksumStr, bool& shouldProcessRemainingMessage) {
+  virtual bool checkOrderBookChecksum(const OrderBook& orderBook, const std::string& receivedOrderBookChecksumStr, bool& shouldProcessRemainingMessage) {
     if (this->sessionOptions.enableCheckOrderBookChecksum) {
-      std::string calculatedOrderBookChecksumStr = this->calculateOrderBookChecksum(snapshotBid, snapshotAsk);
+      std::string calculatedOrderBookChecksumStr = this->calculateOrderBookChecksum(orderBook);
       if (!calculatedOrderBookChecksumStr.empty() && calculatedOrderBookChecksumStr != receivedOrderBookChecksumStr) {
         shouldProcessRemainingMessage = false;
         CCAPI_LOGGER_ERROR("calculatedOrderBookChecksumStr = " + calculatedOrderBookChecksumStr);
         CCAPI_LOGGER_ERROR("receivedOrderBookChecksumStr = " + receivedOrderBookChecksumStr);
-        CCAPI_LOGGER_ERROR("snapshotBid = " + toString(snapshotBid));
-        CCAPI_LOGGER_ERROR("snapshotAsk = " + toString(snapshotAsk));
+        CCAPI_LOGGER_ERROR("orderBook = " + toString(orderBook));
         return false;
       } else {
         CCAPI_LOGGER_DEBUG("calculatedOrderBookChecksumStr = " + calculatedOrderBookChecksumStr);
@@ -1458,20 +1474,13 @@ class MarketDataService : public Service {
     }
     return true;
   }
-  virtual bool checkOrderBookCrossed(const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotAsk,
-                                     bool& shouldProcessRemainingMessage) {
+  virtual bool checkOrderBookCrossed(const OrderBook& orderBook, bool& shouldProcessRemainingMessage) {
     if (this->sessionOptions.enableCheckOrderBookCrossed) {
-      auto i1 = snapshotBid.rbegin();
-      auto i2 = snapshotAsk.begin();
-      if (i1 != snapshotBid.rend() && i2 != snapshotAsk.end()) {
-        auto& bid = i1->first;
-        auto& ask = i2->first;
-        if (bid >= ask) {
-          CCAPI_LOGGER_ERROR("bid = " + toString(bid));
-          CCAPI_LOGGER_ERROR("ask = " + toString(ask));
-          shouldProcessRemainingMessage = false;
-          return false;
-        }
+      if (orderBook.isCrossed()) {
+        CCAPI_LOGGER_ERROR("bid = " + orderBook.priceToString(orderBook.getBids().back()));
+        CCAPI_LOGGER_ERROR("ask = " + orderBook.priceToString(orderBook.getAsks().back()));
+        shouldProcessRemainingMessage = false;
+        return false;
       }
     }
     return true;
@@ -1495,10 +1504,11 @@ class MarketDataService : public Service {
     }
   }
   void setConflateTimer(const TimePoint& previousConflateTp, const std::chrono::milliseconds& interval, const std::chrono::milliseconds& gracePeriod,
-                        const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, const std::string& field,
-                        const std::map<std::string, std::string>& optionMap, const std::vector<std::string>& correlationIdList) {
+                        const WsConnection& wsConnection, const SubscriptionState& subscriptionState) {
     CCAPI_LOGGER_FUNCTION_ENTER;
     if (wsConnection.status == WsConnection::Status::OPEN) {
+      const std::string& channelId = subscriptionState.channelId;
+      const std::string& symbolId = subscriptionState.symbolId;
       if (this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.find(wsConnection.id) != this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap.end() &&
           this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id].find(channelId) !=
               this->conflateTimerMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id].end() &&
@@ -1516,7 +1526,7 @@ class MarketDataService : public Service {
       if (waitMilliseconds > 0) {
         TimerPtr timerPtr(new boost::asio::steady_timer(*this->serviceContextPtr->ioContextPtr, std::chrono::milliseconds(waitMilliseconds)));
         timerPtr->async_wait(
-            [wsConnection, channelId, symbolId, field, optionMap, correlationIdList, previousConflateTp, interval, gracePeriod, this](ErrorCode const& ec) {
+            [wsConnection, channelId, symbolId, previousConflateTp, interval, gracePeriod, this](ErrorCode const& ec) {
               if (this->wsConnectionByIdMap.find(wsConnection.id) != this->wsConnectionByIdMap.end()) {
                 if (ec) {
                   CCAPI_LOGGER_ERROR("wsConnection = " + toString(wsConnection) + ", conflate timer error: " + ec.message());
@@ -1529,21 +1539,26 @@ class MarketDataService : public Service {
                       this->wsConnectionByIdMap.at(wsConnection.id)->status == WsConnection::Status::OPEN
 #endif
                   ) {
+                    SubscriptionState* subscriptionStatePtr = this->findSubscriptionState(wsConnection.id, channelId, symbolId);
+                    if (!subscriptionStatePtr) {
+                      return;
+                    }
+                    SubscriptionState& subscriptionState = *subscriptionStatePtr;
+                    const std::string& field = *subscriptionState.field;
+                    const std::vector<std::string>& correlationIdList = *subscriptionState.correlationIdList;
                     auto conflateTp = previousConflateTp + interval;
-                    if (conflateTp > this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId)) {
+                    if (conflateTp > subscriptionState.previousConflateTime) {
                       Event event;
                       event.setType(Event::Type::SUBSCRIPTION_DATA);
                       std::vector<Element> elementList;
                       if (field == CCAPI_MARKET_DEPTH) {
-                        std::map<Decimal, std::string>& snapshotBid = this->snapshotBidByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-                        std::map<Decimal, std::string>& snapshotAsk = this->snapshotAskByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-                        this->updateElementListWithUpdateMarketDepth(field, optionMap, snapshotBid, std::map<Decimal, std::string>(), snapshotAsk,
-                                                                     std::map<Decimal, std::string>(), elementList, true);
+                        this->updateElementListWithUpdateMarketDepth(field, *subscriptionState.optionMap, subscriptionState.orderBook, OrderBook(), elementList,
+                                                                     true);
                       } else if (field == CCAPI_TRADE || field == CCAPI_AGG_TRADE) {
-                        this->updateElementListWithCalculatedCandlestick(wsConnection, channelId, symbolId, field, elementList);
+                        this->updateElementListWithCalculatedCandlestick(subscriptionState, elementList);
                       }
                       CCAPI_LOGGER_TRACE("elementList = " + toString(elementList));
-                      this->previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId) = conflateTp;
+                      subscriptionState.previousConflateTime = conflateTp;
                       std::vector<Message> messageList;
                       if (!elementList.empty()) {
                         Message message;
@@ -1565,7 +1580,7 @@ class MarketDataService : public Service {
                       conflateTp += interval;
                     }
                     CCAPI_LOGGER_TRACE("about to set conflate timer");
-                    this->setConflateTimer(conflateTp, interval, gracePeriod, wsConnection, channelId, symbolId, field, optionMap, correlationIdList);
+                    this->setConflateTimer(conflateTp, interval, gracePeriod, wsConnection, subscriptionState);
                   }
                 }
               }
@@ -1667,31 +1682,11 @@ class MarketDataService : public Service {
                                 const std::vector<std::string>& correlationIdList, Message::Type messageType, int maxMarketDepth) {
     std::vector<Message> messageList;
     std::vector<Element> elementList;
-    std::map<Decimal, std::string> snapshotBid, snapshotAsk;
-    for (auto& x : input) {
-      auto& type = x.first;
-      auto& detail = x.second;
-      if (type == MarketDataMessage::DataType::BID) {
-        for (auto& y : detail) {
-          auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-          auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-          Decimal decimalPrice(price, this->sessionOptions.enableCheckOrderBookChecksum);
-          snapshotBid.emplace(std::move(decimalPrice), std::move(size));
-        }
-        CCAPI_LOGGER_TRACE("lastNToString(snapshotBid, " + toString(maxMarketDepth) + ") = " + lastNToString(snapshotBid, maxMarketDepth));
-      } else if (type == MarketDataMessage::DataType::ASK) {
-        for (auto& y : detail) {
-          auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-          auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-          Decimal decimalPrice(price, this->sessionOptions.enableCheckOrderBookChecksum);
-          snapshotAsk.emplace(std::move(decimalPrice), std::move(size));
-        }
-        CCAPI_LOGGER_TRACE("firstNToString(snapshotAsk, " + toString(maxMarketDepth) + ") = " + firstNToString(snapshotAsk, maxMarketDepth));
-      } else {
-        CCAPI_LOGGER_WARN("extra type " + MarketDataMessage::dataTypeToString(type));
-      }
-    }
-    this->updateElementListWithOrderBookSnapshot(CCAPI_MARKET_DEPTH, maxMarketDepth, snapshotBid, snapshotAsk, elementList);
+    OrderBook orderBook;
+    this->insertOrderBookUnsorted(orderBook, input, this->sessionOptions.enableCheckOrderBookChecksum);
+    orderBook.sort();
+    CCAPI_LOGGER_TRACE("orderBook.topNToString(" + toString(maxMarketDepth) + ") = " + orderBook.topNToString(maxMarketDepth));
+    this->updateElementListWithOrderBookSnapshot(CCAPI_MARKET_DEPTH, maxMarketDepth, orderBook, elementList);
     CCAPI_LOGGER_TRACE("elementList = " + toString(elementList));
     Message message;
     message.setTimeReceived(timeReceived);
@@ -1724,41 +1719,106 @@ class MarketDataService : public Service {
       req.prepare_payload();
     }
   }
+  // firstVersionId is the version id of the first change in the message, or -1 if the exchange's version ids aren't consecutive. If enableCheckSequence is set
+  // and a gap is found, the order book is resynced.
   void processOrderBookWithVersionId(int64_t versionId, const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId,
                                      const std::string& exchangeSubscriptionId, const std::map<std::string, std::string>& optionMap,
-                                     std::vector<MarketDataMessage>& marketDataMessageList, const MarketDataMessage& marketDataMessage) {
+                                     std::vector<MarketDataMessage>& marketDataMessageList, const MarketDataMessage& marketDataMessage,
+                                     int64_t firstVersionId = -1) {
     if (this->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId]) {
-      if (versionId > this->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId)) {
-        marketDataMessageList.emplace_back(std::move(marketDataMessage));
-        this->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = versionId;
+      int64_t previousVersionId = this->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap.at(wsConnection.id).at(exchangeSubscriptionId);
+      if (!this->sessionOptions.enableCheckSequence || firstVersionId < 0 || firstVersionId <= previousVersionId + 1) {
+        if (versionId > previousVersionId) {
+          marketDataMessageList.push_back(marketDataMessage);
+          this->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = versionId;
+        }
+        return;
       }
-    } else {
-      if (this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnection.id][exchangeSubscriptionId].empty()) {
-        int delayMilliseconds = std::stoi(optionMap.at(CCAPI_FETCH_MARKET_DEPTH_INITIAL_SNAPSHOT_DELAY_MILLISECONDS));
-        if (delayMilliseconds > 0) {
-          TimerPtr timerPtr(new boost::asio::steady_timer(*this->serviceContextPtr->ioContextPtr, std::chrono::milliseconds(delayMilliseconds)));
-          timerPtr->async_wait([wsConnection, exchangeSubscriptionId, delayMilliseconds, that = this](ErrorCode const& ec) {
-            auto now = UtilTime::now();
-            if (ec) {
-              that->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::GENERIC_ERROR, ec, "timer");
-            } else {
-              that->buildOrderBookInitial(wsConnection, exchangeSubscriptionId, delayMilliseconds);
-            }
-          });
-          this->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = timerPtr;
-        } else {
-          this->buildOrderBookInitial(wsConnection, exchangeSubscriptionId, delayMilliseconds);
+      this->resyncOrderBook(
+          wsConnection, exchangeSubscriptionId,
+          "sequence gap found: previousVersionId = " + std::to_string(previousVersionId) + ", firstVersionId = " + std::to_string(firstVersionId));
+    }
+    if (this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnection.id][exchangeSubscriptionId].empty()) {
+      int delayMilliseconds = std::stoi(optionMap.at(CCAPI_FETCH_MARKET_DEPTH_INITIAL_SNAPSHOT_DELAY_MILLISECONDS));
+      if (delayMilliseconds > 0) {
+        size_t generation = this->getSubscriptionState(wsConnection, exchangeSubscriptionId).orderBookResyncGeneration;
+        TimerPtr timerPtr(new boost::asio::steady_timer(*this->serviceContextPtr->ioContextPtr, std::chrono::milliseconds(delayMilliseconds)));
+        timerPtr->async_wait([wsConnection, exchangeSubscriptionId, delayMilliseconds, generation, that = this](ErrorCode const& ec) {
+          if (!that->findSubscriptionStateToBuildOrderBookInitial(wsConnection, exchangeSubscriptionId, generation)) {
+            return;
+          }
+          if (ec) {
+            that->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::GENERIC_ERROR, ec, "timer");
+          } else {
+            that->buildOrderBookInitial(wsConnection, exchangeSubscriptionId, delayMilliseconds);
+          }
+        });
+        this->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = timerPtr;
+      } else {
+        this->buildOrderBookInitial(wsConnection, exchangeSubscriptionId, delayMilliseconds);
+      }
+    }
+    this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnection.id][exchangeSubscriptionId][versionId] =
+        marketDataMessage.data;
+  }
+  bool canResyncOrderBook() const { return this->sessionOptions.enableResyncOrderBook && this->shouldFetchMarketDepthInitialSnapshot; }
+  // Instead of closing the connection, which would drop every other subscription multiplexed on it, discard the order book of a single subscription. The
+  // updates received from now on are buffered by processOrderBookWithVersionId until a fresh snapshot has been fetched, then replayed on top of it.
+  void resyncOrderBook(const WsConnection& wsConnection, const std::string& exchangeSubscriptionId, const std::string& reason) {
+    SubscriptionState& subscriptionState = this->getSubscriptionState(wsConnection, exchangeSubscriptionId);
+    std::string errorMessage = "order book resync: connection = " + toString(wsConnection) + ", exchangeSubscriptionId = " + exchangeSubscriptionId +
+                               ", reason = " + reason;
+    CCAPI_LOGGER_WARN(errorMessage);
+    *subscriptionState.processedInitialSnapshot = false;
+    subscriptionState.orderBook.clear();
+    ++subscriptionState.orderBookResyncGeneration;
+    {
+      auto it = this->orderBookChecksumByConnectionIdSymbolIdMap.find(wsConnection.id);
+      if (it != this->orderBookChecksumByConnectionIdSymbolIdMap.end()) {
+        it->second.erase(subscriptionState.symbolId);
+      }
+    }
+    {
+      auto it = this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.find(wsConnection.id);
+      if (it != this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.end()) {
+        it->second.erase(exchangeSubscriptionId);
+      }
+    }
+    {
+      auto it = this->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap.find(wsConnection.id);
+      if (it != this->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap.end()) {
+        auto it2 = it->second.find(exchangeSubscriptionId);
+        if (it2 != it->second.end()) {
+          it2->second->cancel();
+          it->second.erase(it2);
         }
       }
-      this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnection.id][exchangeSubscriptionId][versionId] =
-          marketDataMessage.data;
     }
+    this->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::INCORRECT_STATE_FOUND, errorMessage, *subscriptionState.correlationIdList);
   }
-  void buildOrderBookInitialOnFail(const WsConnection& wsConnection, const std::string& exchangeSubscriptionId, long delayMilliseconds) {
+  // Returns the state of a subscription whose initial order book snapshot is being fetched, or nullptr if the subscription has gone or its order book has been
+  // resynced since generation, i.e. if the fetch is stale and must not touch the order book.
+  SubscriptionState* findSubscriptionStateToBuildOrderBookInitial(const WsConnection& wsConnection, const std::string& exchangeSubscriptionId,
+                                                                  size_t generation) {
+    auto it = this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.find(wsConnection.id);
+    if (it == this->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap.end()) {
+      return nullptr;
+    }
+    auto it2 = it->second.find(exchangeSubscriptionId);
+    if (it2 == it->second.end()) {
+      return nullptr;
+    }
+    SubscriptionState* subscriptionState = this->findSubscriptionState(wsConnection.id, it2->second.at(CCAPI_CHANNEL_ID), it2->second.at(CCAPI_SYMBOL_ID));
+    return subscriptionState && subscriptionState->orderBookResyncGeneration == generation ? subscriptionState : nullptr;
+  }
+  void buildOrderBookInitialOnFail(const WsConnection& wsConnection, const std::string& exchangeSubscriptionId, long delayMilliseconds, size_t generation) {
     auto thisDelayMilliseconds = delayMilliseconds * 2;
     if (thisDelayMilliseconds > 0) {
       TimerPtr timerPtr(new boost::asio::steady_timer(*this->serviceContextPtr->ioContextPtr, std::chrono::milliseconds(thisDelayMilliseconds)));
-      timerPtr->async_wait([wsConnection, exchangeSubscriptionId, thisDelayMilliseconds, that = this](ErrorCode const& ec) {
+      timerPtr->async_wait([wsConnection, exchangeSubscriptionId, thisDelayMilliseconds, generation, that = this](ErrorCode const& ec) {
+        if (!that->findSubscriptionStateToBuildOrderBookInitial(wsConnection, exchangeSubscriptionId, generation)) {
+          return;
+        }
         if (ec) {
           that->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::GENERIC_ERROR, ec, "timer");
         } else {
@@ -1779,162 +1839,78 @@ class MarketDataService : public Service {
       credential = this->credentialDefault;
     }
     this->createFetchOrderBookInitialReq(req, symbolId, now, credential);
+    // A resync while this request is in flight starts a new fetch, so the response of this one is discarded.
+    size_t generation = this->getSubscriptionState(wsConnection, exchangeSubscriptionId).orderBookResyncGeneration;
     this->sendRequest(
         req,
-        [wsConnection, exchangeSubscriptionId, delayMilliseconds, that = shared_from_base<MarketDataService>()](const beast::error_code& ec) {
-          that->buildOrderBookInitialOnFail(wsConnection, exchangeSubscriptionId, delayMilliseconds);
-        },
-        [wsConnection, exchangeSubscriptionId, delayMilliseconds, that = shared_from_base<MarketDataService>()](const http::response<http::string_body>& res) {
-          auto timeReceived = UtilTime::now();
-          int statusCode = res.result_int();
-          std::string body = res.body();
-          if (statusCode / 100 == 2 && !that->doesHttpBodyContainError(body)) {
-            try {
-              rj::Document document;
-              document.Parse<rj::kParseNumbersAsStringsFlag>(body.c_str());
-              int64_t versionId;
-              that->extractOrderBookInitialVersionId(versionId, document);
-              if (versionId >=
-                  that->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnection.id][exchangeSubscriptionId].begin()->first) {
-                const auto& channelId =
-                    that->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId][CCAPI_CHANNEL_ID];
-                const auto& symbolId = that->channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId][CCAPI_SYMBOL_ID];
-                const auto& optionMap = that->optionMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-                that->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = versionId;
-                const auto& correlationIdList = that->correlationIdListByConnectionIdChannelIdSymbolIdMap.at(wsConnection.id).at(channelId).at(symbolId);
-                std::map<Decimal, std::string>& snapshotBid = that->snapshotBidByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-                std::map<Decimal, std::string>& snapshotAsk = that->snapshotAskByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId];
-                snapshotBid.clear();
-                snapshotAsk.clear();
-                MarketDataMessage::TypeForData input;
-                that->extractOrderBookInitialData(input, document);
-                for (const auto& x : input) {
-                  const auto& type = x.first;
-                  const auto& detail = x.second;
-                  if (type == MarketDataMessage::DataType::BID) {
-                    for (const auto& y : detail) {
-                      const auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-                      const auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-                      Decimal decimalPrice(price, that->sessionOptions.enableCheckOrderBookChecksum);
-                      snapshotBid.emplace(std::move(decimalPrice), std::move(size));
-                    }
-                  } else if (type == MarketDataMessage::DataType::ASK) {
-                    for (const auto& y : detail) {
-                      const auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-                      const auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-                      Decimal decimalPrice(price, that->sessionOptions.enableCheckOrderBookChecksum);
-                      snapshotAsk.emplace(std::move(decimalPrice), std::move(size));
-                    }
-                  }
-                }
-                if (that->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.at(wsConnection.id).find(exchangeSubscriptionId) !=
-                    that->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.at(wsConnection.id).end()) {
-                  auto it = that->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.at(wsConnection.id)
-                                .at(exchangeSubscriptionId)
-                                .upper_bound(versionId);
-                  while (
-                      it !=
-                      that->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.at(wsConnection.id).at(exchangeSubscriptionId).end()) {
-                    const auto& input = it->second;
-                    for (const auto& x : input) {
-                      const auto& type = x.first;
-                      const auto& detail = x.second;
-                      if (type == MarketDataMessage::DataType::BID) {
-                        for (const auto& y : detail) {
-                          const auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-                          const auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-                          Decimal decimalPrice(price, that->sessionOptions.enableCheckOrderBookChecksum);
-                          that->updateOrderBook(snapshotBid, decimalPrice, size, that->sessionOptions.enableCheckOrderBookChecksum);
-                        }
-                      } else if (type == MarketDataMessage::DataType::ASK) {
-                        for (const auto& y : detail) {
-                          const auto& price = y.at(MarketDataMessage::DataFieldType::PRICE);
-                          const auto& size = y.at(MarketDataMessage::DataFieldType::SIZE);
-                          Decimal decimalPrice(price, that->sessionOptions.enableCheckOrderBookChecksum);
-                          that->updateOrderBook(snapshotAsk, decimalPrice, size, that->sessionOptions.enableCheckOrderBookChecksum);
-                        }
-                      }
-                    }
-                    that->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = it->first;
-                    it++;
-                  }
-                  that->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.at(wsConnection.id).erase(exchangeSubscriptionId);
-                }
-                Event event;
-                event.setType(Event::Type::SUBSCRIPTION_DATA);
-                std::vector<Element> elementList;
-                int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
-                int bidIndex = 0;
-                for (auto iter = snapshotBid.rbegin(); iter != snapshotBid.rend(); iter++) {
-                  if (bidIndex < maxMarketDepth) {
-                    Element element;
-                    element.insert(CCAPI_BEST_BID_N_PRICE, iter->first.toString());
-                    element.insert(CCAPI_BEST_BID_N_SIZE, iter->second);
-                    elementList.emplace_back(std::move(element));
-                  }
-                  ++bidIndex;
-                }
-                if (snapshotBid.empty()) {
-                  Element element;
-                  element.insert(CCAPI_BEST_BID_N_PRICE, CCAPI_BEST_BID_N_PRICE_EMPTY);
-                  element.insert(CCAPI_BEST_BID_N_SIZE, CCAPI_BEST_BID_N_SIZE_EMPTY);
-                  elementList.emplace_back(std::move(element));
-                }
-                int askIndex = 0;
-                for (auto iter = snapshotAsk.begin(); iter != snapshotAsk.end(); iter++) {
-                  if (askIndex < maxMarketDepth) {
-                    Element element;
-                    element.insert(CCAPI_BEST_ASK_N_PRICE, iter->first.toString());
-                    element.insert(CCAPI_BEST_ASK_N_SIZE, iter->second);
-                    elementList.emplace_back(std::move(element));
-                  }
-                  ++askIndex;
-                }
-                if (snapshotAsk.empty()) {
-                  Element element;
-                  element.insert(CCAPI_BEST_ASK_N_PRICE, CCAPI_BEST_ASK_N_PRICE_EMPTY);
-                  element.insert(CCAPI_BEST_ASK_N_SIZE, CCAPI_BEST_ASK_N_SIZE_EMPTY);
-                  elementList.emplace_back(std::move(element));
-                }
-                std::vector<Message> messageList;
-                Message message;
-                message.setTimeReceived(timeReceived);
-                message.setType(Message::Type::MARKET_DATA_EVENTS_MARKET_DEPTH);
-                message.setRecapType(Message::RecapType::SOLICITED);
-                message.setTime(timeReceived);
-                message.setElementList(elementList);
-                message.setCorrelationIdList(correlationIdList);
-                messageList.emplace_back(std::move(message));
-                event.addMessages(messageList);
-                that->eventHandler(event, nullptr);
-                that->processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = true;
-              } else {
-                that->buildOrderBookInitialOnFail(wsConnection, exchangeSubscriptionId, delayMilliseconds);
-                // if (delayMilliseconds > 0) {
-                //   that->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] =
-                //       that->serviceContextPtr->tlsClientPtr->set_timer(
-                //           delayMilliseconds, [wsConnection, exchangeSubscriptionId, delayMilliseconds, that](ErrorCode const& ec) {
-                //             if (ec) {
-                //               that->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::GENERIC_ERROR, ec, "timer");
-                //             } else {
-                //               that->buildOrderBookInitial(wsConnection, exchangeSubscriptionId, delayMilliseconds);
-                //             }
-                //           });
-                // } else {
-                //   that->buildOrderBookInitial(wsConnection, exchangeSubscriptionId, delayMilliseconds);
-                // }
-              }
-              return;
-            } catch (const std::runtime_error& e) {
-              CCAPI_LOGGER_ERROR(std::string("e.what() = ") + e.what());
-            }
+        [wsConnection, exchangeSubscriptionId, delayMilliseconds, generation, that = shared_from_base<MarketDataService>()](const beast::error_code& ec) {
+          if (that->findSubscriptionStateToBuildOrderBookInitial(wsConnection, exchangeSubscriptionId, generation)) {
+            that->buildOrderBookInitialOnFail(wsConnection, exchangeSubscriptionId, delayMilliseconds, generation);
           }
-          that->buildOrderBookInitialOnFail(wsConnection, exchangeSubscriptionId, delayMilliseconds);
-          // WsConnection thisWsConnection = wsConnection;
-          // that->onFail_(thisWsConnection);
+        },
+        [wsConnection, exchangeSubscriptionId, delayMilliseconds, generation,
+         that = shared_from_base<MarketDataService>()](const http::response<http::string_body>& res) {
+          that->processOrderBookInitialResponse(wsConnection, exchangeSubscriptionId, delayMilliseconds, generation, res);
         },
         this->sessionOptions.httpRequestTimeoutMilliseconds);
   }
+  // Rebuild the order book from a fetched snapshot and replay the updates buffered since on top of it. They are dispatched like a snapshot and updates received
+  // on the websocket, i.e. as market depth Events and to the typed market data handler.
+  void processOrderBookInitialResponse(const WsConnection& wsConnection, const std::string& exchangeSubscriptionId, long delayMilliseconds, size_t generation,
+                                       const http::response<http::string_body>& res) {
+    auto timeReceived = UtilTime::now();
+    SubscriptionState* subscriptionStatePtr = this->findSubscriptionStateToBuildOrderBookInitial(wsConnection, exchangeSubscriptionId, generation);
+    if (!subscriptionStatePtr) {
+      CCAPI_LOGGER_DEBUG("discard stale order book snapshot: exchangeSubscriptionId = " + exchangeSubscriptionId);
+      return;
+    }
+    SubscriptionState& subscriptionState = *subscriptionStatePtr;
+    int statusCode = res.result_int();
+    const std::string& body = res.body();
+    if (statusCode / 100 == 2 && !this->doesHttpBodyContainError(body)) {
+      try {
+        rj::Document document;
+        document.Parse<rj::kParseNumbersAsStringsFlag>(body.c_str());
+        int64_t versionId;
+        this->extractOrderBookInitialVersionId(versionId, document);
+        auto& buffer = this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnection.id][exchangeSubscriptionId];
+        if (buffer.empty() || versionId >= buffer.begin()->first) {
+          this->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = versionId;
+          MarketDataMessage marketDataMessage;
+          marketDataMessage.type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+          marketDataMessage.recapType = MarketDataMessage::RecapType::SOLICITED;
+          marketDataMessage.tp = timeReceived;
+          marketDataMessage.exchangeSubscriptionId = exchangeSubscriptionId;
+          this->extractOrderBookInitialData(marketDataMessage.data, document);
+          Event event;
+          event.setType(Event::Type::SUBSCRIPTION_DATA);
+          this->dispatchOrderBookInitial(wsConnection, subscriptionState, event, timeReceived, marketDataMessage);
+          if (this->marketDataHandler) {
+            this->invokeMarketDataHandler(subscriptionState, marketDataMessage, timeReceived);
+          }
+          marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
+          for (auto it = buffer.upper_bound(versionId); it != buffer.end(); ++it) {
+            marketDataMessage.data = std::move(it->second);
+            this->dispatchOrderBookUpdate(wsConnection, subscriptionState, event, timeReceived, marketDataMessage);
+            if (this->marketDataHandler) {
+              this->invokeMarketDataHandler(subscriptionState, marketDataMessage, timeReceived);
+            }
+            this->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = it->first;
+          }
+          this->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap.at(wsConnection.id).erase(exchangeSubscriptionId);
+          if (!event.getMessageList().empty()) {
+            this->eventHandler(event, nullptr);
+          }
+        } else {
+          this->buildOrderBookInitialOnFail(wsConnection, exchangeSubscriptionId, delayMilliseconds, generation);
+        }
+        return;
+      } catch (const std::runtime_error& e) {
+        CCAPI_LOGGER_ERROR(std::string("e.what() = ") + e.what());
+      }
+    }
+    this->buildOrderBookInitialOnFail(wsConnection, exchangeSubscriptionId, delayMilliseconds, generation);
+  }
   std::string convertCandlestickIntervalSecondsToInterval(int intervalSeconds, const std::string& secondStr, const std::string& minuteStr,
                                                           const std::string& hourStr, const std::string& dayStr, const std::string& weekStr) {
     std::string interval;
@@ -1964,8 +1940,33 @@ class MarketDataService : public Service {
   virtual void processTextMessage(std::shared_ptr<WsConnection> wsConnectionPtr, boost::beast::string_view textMessageView, const TimePoint& timeReceived,
                                   Event& event, std::vector<MarketDataMessage>& marketDataMessageList) {}
 #endif
-  virtual std::string calculateOrderBookChecksum(const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotAsk) {
-    return {};
+  virtual std::string calculateOrderBookChecksum(const OrderBook& orderBook) { return {}; }
+  // The crc32 of the best maxLevels bid and ask levels, interleaved and formatted as "bidPrice:bidSize:askPrice:askSize:...", which is how most exchanges
+  // define their order book checksum. If isAskSizeNegative is true, the ask sizes are prefixed with '-'.
+  uint32_t calculateOrderBookCrc32(const OrderBook& orderBook, int maxLevels, bool isAskSizeNegative = false) {
+    const auto& bids = orderBook.getBids();
+    const auto& asks = orderBook.getAsks();
+    auto i1 = bids.rbegin();
+    auto i2 = asks.rbegin();
+    std::string& buffer = this->orderBookChecksumBuffer;
+    buffer.clear();
+    for (int i = 0; i < maxLevels && (i1 != bids.rend() || i2 != asks.rend()); ++i) {
+      if (i1 != bids.rend()) {
+        orderBook.appendPrice(buffer, *i1);
+        buffer += ':';
+        OrderBook::appendSize(buffer, *i1);
+        buffer += ':';
+        ++i1;
+      }
+      if (i2 != asks.rend()) {
+        orderBook.appendPrice(buffer, *i2);
+        buffer += isAskSizeNegative ? ":-" : ":";
+        OrderBook::appendSize(buffer, *i2);
+        buffer += ':';
+        ++i2;
+      }
+    }
+    return UtilAlgorithm::crc32(buffer.data(), buffer.empty() ? 0 : buffer.size() - 1);
   }
   virtual std::vector<std::string> createSendStringList(const WsConnection& wsConnection) { return {}; }
   virtual void prepareSubscriptionDetail(std::string& channelId, std::string& symbolId, const std::string& field, const WsConnection& wsConnection,
@@ -1980,25 +1981,25 @@ class MarketDataService : public Service {
   std::map<std::string, std::map<std::string, std::map<std::string, std::vector<Subscription>>>> subscriptionListByConnectionIdChannelIdSymbolIdMap;
   std::map<std::string, std::map<std::string, std::map<std::string, std::vector<std::string>>>> correlationIdListByConnectionIdChannelIdSymbolIdMap;
   std::map<std::string, std::map<std::string, std::map<std::string, std::string>>> channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, std::map<Decimal, std::string>>>> snapshotBidByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, std::map<Decimal, std::string>>>> snapshotAskByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, std::map<Decimal, std::string>>>>
-      previousConflateSnapshotBidByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, std::map<Decimal, std::string>>>>
-      previousConflateSnapshotAskByConnectionIdChannelIdSymbolIdMap;
   std::map<std::string, std::map<std::string, std::map<std::string, bool>>> processedInitialSnapshotByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, bool>>> processedInitialTradeByConnectionIdChannelIdSymbolIdMap;
   std::map<std::string, std::map<std::string, std::map<std::string, bool>>> l2UpdateIsReplaceByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, TimePoint>>> previousConflateTimeMapByConnectionIdChannelIdSymbolIdMap;
   std::map<std::string, std::map<std::string, std::map<std::string, TimerPtr>>> conflateTimerMapByConnectionIdChannelIdSymbolIdMap;
   std::map<std::string, std::map<std::string, std::string>> orderBookChecksumByConnectionIdSymbolIdMap;
   bool shouldAlignSnapshot{};
+  // whether the initial order book snapshot is fetched over REST and reconciled with the buffered updates by version id, which also allows resyncing it
+  bool shouldFetchMarketDepthInitialSnapshot{};
   std::map<std::string, std::map<std::string, Subscription::Status>> subscriptionStatusByInstrumentGroupInstrumentMap;
   std::map<std::string, std::string> instrumentGroupByWsConnectionIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, std::string>>> openByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, Decimal>>> highByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, Decimal>>> lowByConnectionIdChannelIdSymbolIdMap;
-  std::map<std::string, std::map<std::string, std::map<std::string, std::string>>> closeByConnectionIdChannelIdSymbolIdMap;
+  std::deque<SubscriptionState> subscriptionStateList;
+  std::vector<size_t> freeSubscriptionStateHandleList;
+  std::unordered_map<std::string, std::unordered_map<std::string, size_t>> subscriptionStateHandleByConnectionIdExchangeSubscriptionIdMap;
+  std::map<std::string, std::map<std::string, std::map<std::string, size_t>>> subscriptionStateHandleByConnectionIdChannelIdSymbolIdMap;
+  MarketDataHandler* marketDataHandler{nullptr};
+  bool skipMarketDataEvents{};
+  // reused by calculateOrderBookCrc32 so that no allocation is needed once it has grown to the size of a checksum string
+  std::string orderBookChecksumBuffer;
+  // typed records of the text message being processed, which processTextMessage implementations may append to instead of filling MarketDataMessage::data
+  MarketDataMessage::RecordList marketDataRecordList;
   std::string getRecentTradesTarget;
   std::string getHistoricalTradesTarget;
   std::string getRecentCandlesticksTarget;
@@ -119,10 +119,9 @@ class MarketDataServiceBinanceBase : public MarketDataService {
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
 #else
     WsConnection& wsConnection = *wsConnectionPtr;
-    std::string textMessage(textMessageView);
+    boost::beast::string_view textMessage(textMessageView);
 #endif
-    rj::Document document;
-    document.Parse<rj::kParseNumbersAsStringsFlag>(textMessage.c_str());
+    rj::Document& document = this->parseJsonDocument<rj::kParseNumbersAsStringsFlag>(wsConnection.id, textMessage);
     if (document.IsObject() && document.HasMember("result") && document["result"].IsNull()) {
       event.setType(Event::Type::SUBSCRIPTION_STATUS);
       std::vector<Message> messageList;
@@ -153,7 +152,7 @@ class MarketDataServiceBinanceBase : public MarketDataService {
       message.setCorrelationIdList(correlationIdList);
       message.setType(Message::Type::SUBSCRIPTION_STARTED);
       Element element;
-      element.insert(CCAPI_INFO_MESSAGE, textMessage);
+      element.insert(CCAPI_INFO_MESSAGE, std::string(textMessage));
       message.setElementList({element});
       messageList.emplace_back(std::move(message));
       event.setMessageList(messageList);
@@ -171,18 +170,10 @@ class MarketDataServiceBinanceBase : public MarketDataService {
                                           : MarketDataMessage::RecapType::SOLICITED;
         marketDataMessage.tp = this->isDerivatives ? TimePoint(std::chrono::milliseconds(std::stoll(data["T"].GetString()))) : timeReceived;
         marketDataMessage.exchangeSubscriptionId = exchangeSubscriptionId;
-        {
-          MarketDataMessage::TypeForDataPoint dataPoint;
-          dataPoint.insert({MarketDataMessage::DataFieldType::PRICE, UtilString::normalizeDecimalString(data["b"].GetString())});
-          dataPoint.insert({MarketDataMessage::DataFieldType::SIZE, UtilString::normalizeDecimalString(data["B"].GetString())});
-          marketDataMessage.data[MarketDataMessage::DataType::BID].emplace_back(std::move(dataPoint));
-        }
-        {
-          MarketDataMessage::TypeForDataPoint dataPoint;
-          dataPoint.insert({MarketDataMessage::DataFieldType::PRICE, UtilString::normalizeDecimalString(data["a"].GetString())});
-          dataPoint.insert({MarketDataMessage::DataFieldType::SIZE, UtilString::normalizeDecimalString(data["A"].GetString())});
-          marketDataMessage.data[MarketDataMessage::DataType::ASK].emplace_back(std::move(dataPoint));
-        }
+        size_t recordBegin = this->marketDataRecordList.size();
+        this->appendMarketDataRecord(MarketDataMessage::DataType::BID, data["b"], data["B"]);
+        this->appendMarketDataRecord(MarketDataMessage::DataType::ASK, data["a"], data["A"]);
+        marketDataMessage.setRecords(this->marketDataRecordList, recordBegin);
         marketDataMessageList.emplace_back(std::move(marketDataMessage));
       } else if (channelId.rfind(CCAPI_WEBSOCKET_BINANCE_BASE_CHANNEL_PARTIAL_BOOK_DEPTH, 0) == 0) {
         marketDataMessage.type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
@@ -191,6 +182,7 @@ class MarketDataServiceBinanceBase : public MarketDataService {
                                           : MarketDataMessage::RecapType::SOLICITED;
         marketDataMessage.tp = this->isDerivatives ? TimePoint(std::chrono::milliseconds(std::stoll(data["T"].GetString()))) : timeReceived;
         marketDataMessage.exchangeSubscriptionId = exchangeSubscriptionId;
+        size_t recordBegin = this->marketDataRecordList.size();
         const char* bidsName = this->isDerivatives ? "b" : "bids";
         int bidIndex = 0;
         int maxMarketDepth = std::stoi(optionMap.at(CCAPI_MARKET_DEPTH_MAX));
@@ -198,10 +190,7 @@ class MarketDataServiceBinanceBase : public MarketDataService {
           if (bidIndex >= maxMarketDepth) {
             break;
           }
-          MarketDataMessage::TypeForDataPoint dataPoint;
-          dataPoint.insert({MarketDataMessage::DataFieldType::PRICE, UtilString::normalizeDecimalString(x[0].GetString())});
-          dataPoint.insert({MarketDataMessage::DataFieldType::SIZE, UtilString::normalizeDecimalString(x[1].GetString())});
-          marketDataMessage.data[MarketDataMessage::DataType::BID].emplace_back(std::move(dataPoint));
+          this->appendMarketDataRecord(MarketDataMessage::DataType::BID, x[0], x[1]);
           ++bidIndex;
         }
         const char* asksName = this->isDerivatives ? "a" : "asks";
@@ -210,12 +199,10 @@ class MarketDataServiceBinanceBase : public MarketDataService {
           if (askIndex >= maxMarketDepth) {
             break;
           }
-          MarketDataMessage::TypeForDataPoint dataPoint;
-          dataPoint.insert({MarketDataMessage::DataFieldType::PRICE, UtilString::normalizeDecimalString(x[0].GetString())});
-          dataPoint.insert({MarketDataMessage::DataFieldType::SIZE, UtilString::normalizeDecimalString(x[1].GetString())});
-          marketDataMessage.data[MarketDataMessage::DataType::ASK].emplace_back(std::move(dataPoint));
+          this->appendMarketDataRecord(MarketDataMessage::DataType::ASK, x[0], x[1]);
           ++askIndex;
         }
+        marketDataMessage.setRecords(this->marketDataRecordList, recordBegin);
         marketDataMessageList.emplace_back(std::move(marketDataMessage));
       } else if (channelId == CCAPI_WEBSOCKET_BINANCE_BASE_CHANNEL_TRADE) {
         MarketDataMessage marketDataMessage;
@@ -223,12 +210,11 @@ class MarketDataServiceBinanceBase : public MarketDataService {
         marketDataMessage.exchangeSubscriptionId = exchangeSubscriptionId;
         marketDataMessage.tp = UtilTime::makeTimePointFromMilliseconds(std::stoll(data["T"].GetString()));
         marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
-        MarketDataMessage::TypeForDataPoint dataPoint;
-        dataPoint.insert({MarketDataMessage::DataFieldType::PRICE, UtilString::normalizeDecimalString(std::string(data["p"].GetString()))});
-        dataPoint.insert({MarketDataMessage::DataFieldType::SIZE, UtilString::normalizeDecimalString(std::string(data["q"].GetString()))});
-        dataPoint.insert({MarketDataMessage::DataFieldType::TRADE_ID, std::string(data["t"].GetString())});
-        dataPoint.insert({MarketDataMessage::DataFieldType::IS_BUYER_MAKER, data["m"].GetBool() ? "1" : "0"});
-        marketDataMessage.data[MarketDataMessage::DataType::TRADE].emplace_back(std::move(dataPoint));
+        size_t recordBegin = this->marketDataRecordList.size();
+        auto& record = this->appendMarketDataRecord(MarketDataMessage::DataType::TRADE, data["p"], data["q"]);
+        record.tradeId = std::string_view(data["t"].GetString(), data["t"].GetStringLength());
+        record.isBuyerMaker = data["m"].GetBool();
+        marketDataMessage.setRecords(this->marketDataRecordList, recordBegin);
         marketDataMessageList.emplace_back(std::move(marketDataMessage));
       } else if (channelId == CCAPI_WEBSOCKET_BINANCE_BASE_CHANNEL_AGG_TRADE) {
         auto time = UtilTime::makeTimePointFromMilliseconds(std::stoll(data["T"].GetString()));
@@ -237,12 +223,11 @@ class MarketDataServiceBinanceBase : public MarketDataService {
         marketDataMessage.exchangeSubscriptionId = exchangeSubscriptionId;
         marketDataMessage.tp = time;
         marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
-        MarketDataMessage::TypeForDataPoint dataPoint;
-        dataPoint.insert({MarketDataMessage::DataFieldType::PRICE, UtilString::normalizeDecimalString(std::string(data["p"].GetString()))});
-        dataPoint.insert({MarketDataMessage::DataFieldType::SIZE, UtilString::normalizeDecimalString(std::string(data["q"].GetString()))});
-        dataPoint.insert({MarketDataMessage::DataFieldType::AGG_TRADE_ID, data["a"].GetString()});
-        dataPoint.insert({MarketDataMessage::DataFieldType::IS_BUYER_MAKER, data["m"].GetBool() ? "1" : "0"});
-        marketDataMessage.data[MarketDataMessage::DataType::AGG_TRADE].emplace_back(std::move(dataPoint));
+        size_t recordBegin = this->marketDataRecordList.size();
+        auto& record = this->appendMarketDataRecord(MarketDataMessage::DataType::AGG_TRADE, data["p"], data["q"]);
+        record.tradeId = std::string_view(data["a"].GetString(), data["a"].GetStringLength());
+        record.isBuyerMaker = data["m"].GetBool();
+        marketDataMessage.setRecords(this->marketDataRecordList, recordBegin);
         marketDataMessageList.emplace_back(std::move(marketDataMessage));
       } else if (channelId.find(CCAPI_WEBSOCKET_BINANCE_BASE_CHANNEL_KLINE) != std::string::npos) {
         MarketDataMessage marketDataMessage;
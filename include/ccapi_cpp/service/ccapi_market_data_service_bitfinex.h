@@ -188,9 +188,8 @@ class MarketDataServiceBitfinex : public MarketDataService {
   void processTextMessage(std::shared_ptr<WsConnection> wsConnectionPtr, boost::beast::string_view textMessageView, const TimePoint& timeReceived, Event& event,
                           std::vector<MarketDataMessage>& marketDataMessageList) override {
     WsConnection& wsConnection = *wsConnectionPtr;
-    std::string textMessage(textMessageView);
-    rj::Document document;
-    document.Parse<rj::kParseNumbersAsStringsFlag>(textMessage.c_str());
+    boost::beast::string_view textMessage(textMessageView);
+    rj::Document& document = this->parseJsonDocument<rj::kParseNumbersAsStringsFlag>(wsConnection.id, textMessage);
     if (document.IsArray() && document.Size() >= 1) {
       auto exchangeSubscriptionId = std::string(document[0].GetString());
       if (document.Size() >= 2 && document[1].IsString() && std::string(document[1].GetString()) == "hb") {
@@ -499,35 +498,14 @@ class MarketDataServiceBitfinex : public MarketDataService {
         message.setCorrelationIdList(correlationIdList);
         message.setType(eventStr == "subscribed" ? Message::Type::SUBSCRIPTION_STARTED : Message::Type::SUBSCRIPTION_FAILURE);
         Element element;
-        element.insert(eventStr == "subscribed" ? CCAPI_INFO_MESSAGE : CCAPI_ERROR_MESSAGE, textMessage);
+        element.insert(eventStr == "subscribed" ? CCAPI_INFO_MESSAGE : CCAPI_ERROR_MESSAGE, std::string(textMessage));
         message.setElementList({element});
         messageList.emplace_back(std::move(message));
         event.setMessageList(messageList);
       }
     }
   }
-  std::string calculateOrderBookChecksum(const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotAsk) override {
-    auto i = 0;
-    auto i1 = snapshotBid.rbegin();
-    auto i2 = snapshotAsk.begin();
-    std::vector<std::string> csData;
-    while (i < 25 && (i1 != snapshotBid.rend() || i2 != snapshotAsk.end())) {
-      if (i1 != snapshotBid.rend()) {
-        csData.push_back(i1->first.toString());
-        csData.push_back(i1->second);
-        ++i1;
-      }
-      if (i2 != snapshotAsk.end()) {
-        csData.push_back(i2->first.toString());
-        csData.push_back("-" + i2->second);
-        ++i2;
-      }
-      ++i;
-    }
-    std::string csStr = UtilString::join(csData, ":");
-    uint_fast32_t csCalc = UtilAlgorithm::crc(csStr.begin(), csStr.end());
-    return intToHex(csCalc);
-  }
+  std::string calculateOrderBookChecksum(const OrderBook& orderBook) override { return intToHex(this->calculateOrderBookCrc32(orderBook, 25, true)); }
   void convertRequestForRest(http::request<http::string_body>& req, const Request& request, const TimePoint& now, const std::string& symbolId,
                              const std::map<std::string, std::string>& credential) override {
     switch (request.getOperation()) {
@@ -86,28 +86,7 @@ class MarketDataServiceBitgetBase : public MarketDataService {
     sendStringList.push_back(sendString);
     return sendStringList;
   }
-  std::string calculateOrderBookChecksum(const std::map<Decimal, std::string>& snapshotBid, const std::map<Decimal, std::string>& snapshotAsk) override {
-    auto i = 0;
-    auto i1 = snapshotBid.rbegin();
-    auto i2 = snapshotAsk.begin();
-    std::vector<std::string> csData;
-    while (i < 25 && (i1 != snapshotBid.rend() || i2 != snapshotAsk.end())) {
-      if (i1 != snapshotBid.rend()) {
-        csData.push_back(toString(i1->first));
-        csData.push_back(i1->second);
-        ++i1;
-      }
-      if (i2 != snapshotAsk.end()) {
-        csData.push_back(toString(i2->first));
-        csData.push_back(i2->second);
-        ++i2;
-      }
-      ++i;
-    }
-    std::string csStr = UtilString::join(csData, ":");
-    uint_fast32_t csCalc = UtilAlgorithm::crc(csStr.begin(), csStr.end());
-    return intToHex(csCalc);
-  }
+  std::string calculateOrderBookChecksum(const OrderBook& orderBook) override { return intToHex(this->calculateOrderBookCrc32(orderBook, 25)); }
   void processTextMessage(
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
       WsConnection& wsConnection, wspp::connection_hdl hdl, const std::string& textMessage
@@ -119,11 +98,10 @@ class MarketDataServiceBitgetBase : public MarketDataService {
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
 #else
     WsConnection& wsConnection = *wsConnectionPtr;
-    std::string textMessage(textMessageView);
+    boost::beast::string_view textMessage(textMessageView);
 #endif
     if (textMessage != "pong") {
-      rj::Document document;
-      document.Parse<rj::kParseNumbersAsStringsFlag>(textMessage.c_str());
+      rj::Document& document = this->parseJsonDocument<rj::kParseNumbersAsStringsFlag>(wsConnection.id, textMessage);
       auto it = document.FindMember("event");
       std::string eventStr = it != document.MemberEnd() ? it->value.GetString() : "";
       // if (eventStr == "login") {
@@ -154,7 +132,7 @@ class MarketDataServiceBitgetBase : public MarketDataService {
           message.setCorrelationIdList(correlationIdList);
           message.setType(Message::Type::SUBSCRIPTION_STARTED);
           Element element;
-          element.insert(CCAPI_INFO_MESSAGE, textMessage);
+          element.insert(CCAPI_INFO_MESSAGE, std::string(textMessage));
           message.setElementList({element});
           messageList.emplace_back(std::move(message));
           event.setMessageList(messageList);
@@ -165,7 +143,7 @@ class MarketDataServiceBitgetBase : public MarketDataService {
           message.setTimeReceived(timeReceived);
           message.setType(Message::Type::SUBSCRIPTION_FAILURE);
           Element element;
-          element.insert(CCAPI_ERROR_MESSAGE, textMessage);
+          element.insert(CCAPI_ERROR_MESSAGE, std::string(textMessage));
           message.setElementList({element});
           messageList.emplace_back(std::move(message));
           event.setMessageList(messageList);
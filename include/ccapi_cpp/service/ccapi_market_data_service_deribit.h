@@ -184,10 +184,9 @@ class MarketDataServiceDeribit : public MarketDataService {
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
 #else
     WsConnection& wsConnection = *wsConnectionPtr;
-    std::string textMessage(textMessageView);
+    boost::beast::string_view textMessage(textMessageView);
 #endif
-    rj::Document document;
-    document.Parse<rj::kParseNumbersAsStringsFlag>(textMessage.c_str());
+    rj::Document& document = this->parseJsonDocument<rj::kParseNumbersAsStringsFlag>(wsConnection.id, textMessage);
     auto it = document.FindMember("result");
     if (it == document.MemberEnd()) {
       std::string method = document["method"].GetString();
@@ -327,7 +326,7 @@ class MarketDataServiceDeribit : public MarketDataService {
             message.setTimeReceived(timeReceived);
             message.setType(Message::Type::SUBSCRIPTION_FAILURE);
             Element element;
-            element.insert(CCAPI_ERROR_MESSAGE, textMessage);
+            element.insert(CCAPI_ERROR_MESSAGE, std::string(textMessage));
             message.setElementList({element});
             messageList.emplace_back(std::move(message));
             event.setMessageList(messageList);
@@ -359,7 +358,7 @@ class MarketDataServiceDeribit : public MarketDataService {
             message.setCorrelationIdList(correlationIdList);
             message.setType(Message::Type::SUBSCRIPTION_STARTED);
             Element element;
-            element.insert(CCAPI_INFO_MESSAGE, textMessage);
+            element.insert(CCAPI_INFO_MESSAGE, std::string(textMessage));
             message.setElementList({element});
             messageList.emplace_back(std::move(message));
             event.setMessageList(messageList);
@@ -8,7 +8,9 @@ class MarketDataServiceKucoinBase : public MarketDataService {
  public:
   MarketDataServiceKucoinBase(std::function<void(Event&, Queue<Event>*)> eventHandler, SessionOptions sessionOptions, SessionConfigs sessionConfigs,
                               ServiceContext* serviceContextPtr)
-      : MarketDataService(eventHandler, sessionOptions, sessionConfigs, serviceContextPtr) {}
+      : MarketDataService(eventHandler, sessionOptions, sessionConfigs, serviceContextPtr) {
+    this->shouldFetchMarketDepthInitialSnapshot = true;
+  }
   virtual ~MarketDataServiceKucoinBase() {}
 #ifndef CCAPI_EXPOSE_INTERNAL
 
@@ -283,10 +285,9 @@ class MarketDataServiceKucoinBase : public MarketDataService {
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
 #else
     WsConnection& wsConnection = *wsConnectionPtr;
-    std::string textMessage(textMessageView);
+    boost::beast::string_view textMessage(textMessageView);
 #endif
-    rj::Document document;
-    document.Parse<rj::kParseNumbersAsStringsFlag>(textMessage.c_str());
+    rj::Document& document = this->parseJsonDocument<rj::kParseNumbersAsStringsFlag>(wsConnection.id, textMessage);
     if (document.IsObject()) {
       auto it = document.FindMember("type");
       if (it != document.MemberEnd()) {
@@ -326,8 +327,9 @@ class MarketDataServiceKucoinBase : public MarketDataService {
               }
             }
             int64_t versionId = std::stoll(data["sequenceEnd"].GetString());
+            int64_t firstVersionId = std::stoll(data["sequenceStart"].GetString());
             this->processOrderBookWithVersionId(versionId, wsConnection, channelId, symbolId, exchangeSubscriptionId, optionMap, marketDataMessageList,
-                                                marketDataMessage);
+                                                marketDataMessage, firstVersionId);
           } else if (subject == this->tickerSubject) {
             MarketDataMessage marketDataMessage;
             std::string exchangeSubscriptionId = document["topic"].GetString();
@@ -477,7 +479,7 @@ class MarketDataServiceKucoinBase : public MarketDataService {
           message.setCorrelationIdList(correlationIdList);
           message.setType(Message::Type::SUBSCRIPTION_STARTED);
           Element element;
-          element.insert(CCAPI_INFO_MESSAGE, textMessage);
+          element.insert(CCAPI_INFO_MESSAGE, std::string(textMessage));
           message.setElementList({element});
           messageList.emplace_back(std::move(message));
           event.setMessageList(messageList);
@@ -488,7 +490,7 @@ class MarketDataServiceKucoinBase : public MarketDataService {
           message.setTimeReceived(timeReceived);
           message.setType(Message::Type::SUBSCRIPTION_FAILURE);
           Element element;
-          element.insert(CCAPI_ERROR_MESSAGE, textMessage);
+          element.insert(CCAPI_ERROR_MESSAGE, std::string(textMessage));
           message.setElementList({element});
           messageList.emplace_back(std::move(message));
           event.setMessageList(messageList);
@@ -13,9 +13,11 @@
 #ifndef RAPIDJSON_PARSE_ERROR_NORETURN
 #define RAPIDJSON_PARSE_ERROR_NORETURN(parseErrorCode, offset) throw std::runtime_error(#parseErrorCode)
 #endif
+// Deprecated and without effect: websocket writes are queued without a fixed size buffer, see SessionOptions::websocketWriteQueueHighWaterMarkBytes.
 #ifndef CCAPI_WEBSOCKET_WRITE_BUFFER_SIZE
 #define CCAPI_WEBSOCKET_WRITE_BUFFER_SIZE 1 << 20
 #endif
+#include <deque>
 #include <regex>
 
 #include "boost/asio/strand.hpp"
@@ -56,8 +58,10 @@
 #endif
 
 #include "ccapi_cpp/ccapi_fix_connection.h"
+#include "ccapi_cpp/ccapi_fix_handler.h"
 #include "ccapi_cpp/ccapi_http_connection.h"
 #include "ccapi_cpp/ccapi_http_retry.h"
+#include "ccapi_cpp/ccapi_latency_histogram.h"
 #include "ccapi_cpp/ccapi_queue.h"
 #include "ccapi_cpp/ccapi_request.h"
 #include "ccapi_cpp/ccapi_session_configs.h"
@@ -93,6 +97,38 @@ class Service : public std::enable_shared_from_this<Service> {
     WEBSOCKET_APPLICATION_LEVEL,
     FIX_PROTOCOL_LEVEL,
   };
+  // Memory backing the rapidjson document of the websocket message which is being processed on a connection. The allocator keeps its buffer across messages
+  // so that parsing a message that fits into it doesn't allocate.
+  struct JsonDocumentPool {
+    explicit JsonDocumentPool(size_t size) : buffer(new char[size]), allocator(buffer.get(), size), document(&allocator, 1024, &stackAllocator) {}
+    std::unique_ptr<char[]> buffer;
+    rj::MemoryPoolAllocator<> allocator;
+    rj::CrtAllocator stackAllocator;
+    rj::Document document;
+  };
+  // The messages waiting to be written to a websocket connection, of which only the front one is being written. The payloads are reference counted so that the
+  // same payload can be queued for several connections without copying and stays alive until its write has completed.
+  struct WriteMessageQueue {
+    std::deque<std::shared_ptr<const std::string>> payloadList;
+    size_t numBytes{};
+    size_t peakSize{};
+    size_t peakNumBytes{};
+    bool isAboveHighWaterMark{};
+  };
+  // The idle http connections to one host, ordered by their last use so that the most recently used one, i.e. the least likely to have been closed by the
+  // server, is at the back. Every warm-up holds numWarmingUpPtr and decrements it once when it finishes, so a pool which is purged meanwhile doesn't
+  // inherit the count.
+  struct HttpConnectionPool {
+    std::string host;
+    std::string port;
+    std::deque<std::shared_ptr<HttpConnection>> httpConnectionList;
+    std::shared_ptr<size_t> numWarmingUpPtr{std::make_shared<size_t>()};
+  };
+  // Attached to a tls connection so that the new session callback of the shared ssl context knows which service and host:port the session belongs to.
+  struct TlsSessionExData {
+    std::weak_ptr<Service> servicePtr;
+    std::string hostPort;
+  };
   static std::string pingPongMethodToString(PingPongMethod pingPongMethod) {
     std::string output;
     switch (pingPongMethod) {
@@ -115,10 +151,18 @@ class Service : public std::enable_shared_from_this<Service> {
       : eventHandler(eventHandler),
         sessionOptions(sessionOptions),
         sessionConfigs(sessionConfigs),
-        serviceContextPtr(serviceContextPtr),
-        resolver(*serviceContextPtr->ioContextPtr),
-        resolverWs(*serviceContextPtr->ioContextPtr) {
+        serviceContextPtr(serviceContextPtr->nextServiceContextPtr()),
+        resolver(*this->serviceContextPtr->ioContextPtr),
+        resolverWs(*this->serviceContextPtr->ioContextPtr) {
     this->enableCheckPingPongWebsocketProtocolLevel = this->sessionOptions.enableCheckPingPongWebsocketProtocolLevel;
+    if (this->sessionOptions.enableLatencyHistogram) {
+      this->latencyHistogramList.reset(new LatencyHistogram[LatencyHistogram::numStages]);
+    }
+    if (this->sessionOptions.enableTlsSessionResumption) {
+      SSL_CTX* sslCtx = this->serviceContextPtr->sslContextPtr->native_handle();
+      SSL_CTX_set_session_cache_mode(sslCtx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+      SSL_CTX_sess_set_new_cb(sslCtx, &Service::onNewTlsSession);
+    }
     this->enableCheckPingPongWebsocketApplicationLevel = this->sessionOptions.enableCheckPingPongWebsocketApplicationLevel;
     // this->pingIntervalMillisecondsByMethodMap[PingPongMethod::WEBSOCKET_PROTOCOL_LEVEL] = sessionOptions.pingWebsocketProtocolLevelIntervalMilliseconds;
     // this->pongTimeoutMillisecondsByMethodMap[PingPongMethod::WEBSOCKET_PROTOCOL_LEVEL] = sessionOptions.pongWebsocketProtocolLevelTimeoutMilliseconds;
@@ -141,10 +185,34 @@ class Service : public std::enable_shared_from_this<Service> {
     for (const auto& x : this->connectRetryOnFailTimerByConnectionIdMap) {
       x.second->cancel();
     }
+    if (this->httpConnectionPoolTimerPtr) {
+      this->httpConnectionPoolTimerPtr->cancel();
+    }
   }
   void purgeHttpConnectionPool() { this->httpConnectionPool.clear(); }
   void purgeHttpConnectionPool(const std::string& localIpAddress) { this->httpConnectionPool.erase(localIpAddress); }
+  // Returns nullptr if SessionOptions::enableLatencyHistogram is false.
+  const LatencyHistogram* getLatencyHistogram(LatencyHistogram::Stage stage) const {
+    return this->latencyHistogramList ? &this->latencyHistogramList[static_cast<int>(stage)] : nullptr;
+  }
   void purgeHttpConnectionPool(const std::string& localIpAddress, const std::string& baseUrl) { this->httpConnectionPool[localIpAddress].erase(baseUrl); }
+  // Keeps SessionOptions::httpConnectionPoolMinSize idle http connections open to the rest host, replacing them before they have stayed idle for
+  // SessionOptions::httpConnectionKeepAliveTimeoutSeconds. Pools of other local ip addresses and base urls are kept warm as well once they have been used.
+  void startHttpConnectionPoolWarmUp() {
+    if (this->sessionOptions.httpConnectionPoolMinSize <= 0 || this->sessionOptions.enableOneHttpConnectionPerRequest || this->hostRest.empty()) {
+      return;
+    }
+    boost::asio::post(*this->serviceContextPtr->ioContextPtr, [that = shared_from_this()]() {
+      auto& httpConnectionPool = that->httpConnectionPool[""][""];
+      httpConnectionPool.host = that->hostRest;
+      httpConnectionPool.port = that->portRest;
+      that->httpConnectionPoolTimerPtr = std::make_shared<net::steady_timer>(*that->serviceContextPtr->ioContextPtr);
+      that->maintainHttpConnectionPool();
+    });
+  }
+  size_t getHttpConnectionPoolNumHits() const { return this->httpConnectionPoolNumHits.load(std::memory_order_relaxed); }
+  size_t getHttpConnectionPoolNumMisses() const { return this->httpConnectionPoolNumMisses.load(std::memory_order_relaxed); }
+  size_t getHttpConnectionPoolNumWarmUps() const { return this->httpConnectionPoolNumWarmUps.load(std::memory_order_relaxed); }
   void forceCloseWebsocketConnections() {
     for (const auto& x : this->wsConnectionByIdMap) {
       ErrorCode ec;
@@ -160,6 +228,9 @@ class Service : public std::enable_shared_from_this<Service> {
       x.second->cancel();
     }
     sendRequestDelayTimerByCorrelationIdMap.clear();
+    if (this->httpConnectionPoolTimerPtr) {
+      this->httpConnectionPoolTimerPtr->cancel();
+    }
     this->shouldContinue = false;
     for (const auto& x : this->wsConnectionByIdMap) {
       ErrorCode ec;
@@ -245,6 +316,7 @@ class Service : public std::enable_shared_from_this<Service> {
   virtual void sendRequestByWebsocket(Request& request, const TimePoint& now) {}
   virtual void sendRequestByFix(Request& request, const TimePoint& now) {}
   virtual void subscribeByFix(Subscription& subscription) {}
+  virtual void setFixHandler(FixHandler* fixHandler, bool skipFixEvents) {}
   void onError(const Event::Type eventType, const Message::Type messageType, const std::string& errorMessage,
                const std::vector<std::string> correlationIdList = {}, Queue<Event>* eventQueuePtr = nullptr) {
     CCAPI_LOGGER_ERROR("errorMessage = " + errorMessage);
@@ -291,6 +363,12 @@ class Service : public std::enable_shared_from_this<Service> {
 
  protected:
 #endif
+  // Record the time elapsed since start into the histogram of the given stage, which must be enabled. Returns the current time.
+  std::chrono::steady_clock::time_point recordLatency(LatencyHistogram::Stage stage, std::chrono::steady_clock::time_point start) {
+    auto now = std::chrono::steady_clock::now();
+    this->latencyHistogramList[static_cast<int>(stage)].record(start, now);
+    return now;
+  }
   // static std::string printableString(const char* s, size_t n) {
   //   std::string output(s, n);
   //   std::replace(output.begin(), output.end(), '\x01', '^');
@@ -349,7 +427,7 @@ class Service : public std::enable_shared_from_this<Service> {
     std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> streamPtr(nullptr);
     try {
       streamPtr = this->createStream<beast::ssl_stream<beast::tcp_stream>>(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr,
-                                                                           this->hostRest);
+                                                                           this->hostRest, this->portRest);
     } catch (const beast::error_code& ec) {
       CCAPI_LOGGER_TRACE("fail");
       errorHandler(ec);
@@ -375,7 +453,8 @@ class Service : public std::enable_shared_from_this<Service> {
 #endif
     std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> streamPtr(nullptr);
     try {
-      streamPtr = this->createStream<beast::ssl_stream<beast::tcp_stream>>(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr, host);
+      streamPtr =
+          this->createStream<beast::ssl_stream<beast::tcp_stream>>(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr, host, port);
     } catch (const beast::error_code& ec) {
       CCAPI_LOGGER_TRACE("fail");
       errorHandler(ec);
@@ -423,9 +502,7 @@ class Service : public std::enable_shared_from_this<Service> {
     }
     CCAPI_LOGGER_TRACE("connected");
     beast::ssl_stream<beast::tcp_stream>& stream = *httpConnectionPtr->streamPtr;
-    // #ifdef CCAPI_DISABLE_NAGLE_ALGORITHM
-    beast::get_lowest_layer(stream).socket().set_option(tcp::no_delay(true));
-    // #endif
+    this->setSocketOptions(beast::get_lowest_layer(stream).socket());
     CCAPI_LOGGER_TRACE("before ssl async_handshake");
     stream.async_handshake(ssl::stream_base::client,
                            beast::bind_front_handler(&Service::onSslHandshake, shared_from_this(), httpConnectionPtr, req, errorHandler, responseHandler));
@@ -495,7 +572,7 @@ class Service : public std::enable_shared_from_this<Service> {
     responseHandler(*resPtr);
   }
   template <class T>
-  std::shared_ptr<T> createStream(net::io_context* iocPtr, net::ssl::context* ctxPtr, const std::string& host) {
+  std::shared_ptr<T> createStream(net::io_context* iocPtr, net::ssl::context* ctxPtr, const std::string& host, const std::string& port) {
     std::shared_ptr<T> streamPtr(new T(*iocPtr, *ctxPtr));
     // Set SNI Hostname (many hosts need this to handshake successfully)
     if (!SSL_set_tlsext_host_name(streamPtr->native_handle(), host.c_str())) {
@@ -503,8 +580,94 @@ class Service : public std::enable_shared_from_this<Service> {
       CCAPI_LOGGER_DEBUG("error SSL_set_tlsext_host_name: " + ec.message());
       throw ec;
     }
+    this->prepareTlsSessionResumption(streamPtr->native_handle(), host, port);
     return streamPtr;
   }
+  // Registers a tls connection to host:port so that the session tickets it receives are cached, and lets it resume the most recent session cached for
+  // host:port.
+  void prepareTlsSessionResumption(SSL* ssl, const std::string& host, const std::string& port) {
+    if (!this->sessionOptions.enableTlsSessionResumption) {
+      return;
+    }
+    std::string hostPort = host + ":" + port;
+    auto index = Service::getTlsSessionExDataIndex();
+    delete static_cast<TlsSessionExData*>(SSL_get_ex_data(ssl, index));
+    SSL_set_ex_data(ssl, index, new TlsSessionExData{this->weak_from_this(), hostPort});
+    std::shared_ptr<SSL_SESSION> tlsSessionPtr;
+    {
+#ifndef CCAPI_USE_SINGLE_THREAD
+      std::lock_guard<std::mutex> lock(this->tlsSessionMutex);
+#endif
+      auto it = this->tlsSessionByHostPortMap.find(hostPort);
+      if (it != this->tlsSessionByHostPortMap.end()) {
+        tlsSessionPtr = it->second;
+      }
+    }
+    if (tlsSessionPtr && SSL_SESSION_is_resumable(tlsSessionPtr.get())) {
+      if (SSL_set_session(ssl, tlsSessionPtr.get())) {
+        CCAPI_LOGGER_TRACE("resume tls session for " + hostPort);
+      } else {
+        CCAPI_LOGGER_WARN("error SSL_set_session for " + hostPort);
+      }
+    }
+  }
+  // The ex data index of TlsSessionExData. OpenSSL frees it together with the connection.
+  static int getTlsSessionExDataIndex() {
+    static const int index = SSL_get_ex_new_index(
+        0, nullptr, nullptr, nullptr,
+        [](void* parent, void* ptr, CRYPTO_EX_DATA* ad, int index, long argl, void* argp) { delete static_cast<TlsSessionExData*>(ptr); });
+    return index;
+  }
+  // Installed as the new session callback of the shared ssl context. With TLS 1.3 session tickets arrive after the handshake, so they can't simply be read
+  // off the connection once it is established. A copy is cached because OpenSSL marks a connection's own session as not resumable when the connection is
+  // dropped without a tls shutdown, which is how exchange-side disconnects usually look.
+  // The connection only holds a weak reference, so a session which arrives after its service has been destroyed is dropped.
+  static int onNewTlsSession(SSL* ssl, SSL_SESSION* session) {
+    auto tlsSessionExDataPtr = static_cast<TlsSessionExData*>(SSL_get_ex_data(ssl, Service::getTlsSessionExDataIndex()));
+    if (!tlsSessionExDataPtr) {
+      return 0;
+    }
+    auto servicePtr = tlsSessionExDataPtr->servicePtr.lock();
+    if (!servicePtr) {
+      return 0;
+    }
+    SSL_SESSION* sessionCopy = SSL_SESSION_dup(session);
+    if (!sessionCopy) {
+      return 0;
+    }
+#ifndef CCAPI_USE_SINGLE_THREAD
+    std::lock_guard<std::mutex> lock(servicePtr->tlsSessionMutex);
+#endif
+    servicePtr->tlsSessionByHostPortMap[tlsSessionExDataPtr->hostPort] = std::shared_ptr<SSL_SESSION>(sessionCopy, SSL_SESSION_free);
+    return 0;
+  }
+  void setSocketOptions(tcp::socket& socket) {
+    beast::error_code ec;
+    socket.set_option(tcp::no_delay(this->sessionOptions.enableTcpNoDelay), ec);
+    if (ec) {
+      CCAPI_LOGGER_WARN("error set TCP_NODELAY: " + ec.message());
+    }
+    if (this->sessionOptions.tcpReceiveBufferSizeBytes > 0) {
+      socket.set_option(net::socket_base::receive_buffer_size(this->sessionOptions.tcpReceiveBufferSizeBytes), ec);
+      if (ec) {
+        CCAPI_LOGGER_WARN("error set SO_RCVBUF: " + ec.message());
+      }
+    }
+    if (this->sessionOptions.tcpSendBufferSizeBytes > 0) {
+      socket.set_option(net::socket_base::send_buffer_size(this->sessionOptions.tcpSendBufferSizeBytes), ec);
+      if (ec) {
+        CCAPI_LOGGER_WARN("error set SO_SNDBUF: " + ec.message());
+      }
+    }
+#ifdef SO_BUSY_POLL
+    if (this->sessionOptions.tcpBusyPollMicroseconds > 0) {
+      socket.set_option(net::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>(this->sessionOptions.tcpBusyPollMicroseconds), ec);
+      if (ec) {
+        CCAPI_LOGGER_WARN("error set SO_BUSY_POLL: " + ec.message());
+      }
+    }
+#endif
+  }
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
 #else
   std::shared_ptr<beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>> createWsStream(net::io_context* iocPtr, net::ssl::context* ctxPtr) {
@@ -640,9 +803,7 @@ class Service : public std::enable_shared_from_this<Service> {
     timerPtr->cancel();
     CCAPI_LOGGER_TRACE("connected");
     beast::ssl_stream<beast::tcp_stream>& stream = *httpConnectionPtr->streamPtr;
-    // #ifdef CCAPI_DISABLE_NAGLE_ALGORITHM
-    beast::get_lowest_layer(stream).socket().set_option(tcp::no_delay(true));
-    // #endif
+    this->setSocketOptions(beast::get_lowest_layer(stream).socket());
     CCAPI_LOGGER_TRACE("before ssl async_handshake");
     stream.async_handshake(ssl::stream_base::client,
                            beast::bind_front_handler(&Service::onSslHandshake_2, shared_from_this(), httpConnectionPtr, request, req, retry, eventQueuePtr));
@@ -678,7 +839,7 @@ class Service : public std::enable_shared_from_this<Service> {
     if (ec) {
       CCAPI_LOGGER_TRACE("fail");
       this->onError(Event::Type::REQUEST_STATUS, Message::Type::REQUEST_FAILURE, ec, "write", {request.getCorrelationId()}, eventQueuePtr);
-      this->httpConnectionPool[request.getLocalIpAddress()][request.getBaseUrl()].clear();
+      this->httpConnectionPool[request.getLocalIpAddress()][request.getBaseUrl()].httpConnectionList.clear();
       auto now = UtilTime::now();
       auto req = this->convertRequest(request, now);
       retry.numRetry += 1;
@@ -705,7 +866,7 @@ class Service : public std::enable_shared_from_this<Service> {
     if (ec) {
       CCAPI_LOGGER_TRACE("fail");
       this->onError(Event::Type::REQUEST_STATUS, Message::Type::REQUEST_FAILURE, ec, "read", {request.getCorrelationId()}, eventQueuePtr);
-      this->httpConnectionPool[request.getLocalIpAddress()][request.getBaseUrl()].clear();
+      this->httpConnectionPool[request.getLocalIpAddress()][request.getBaseUrl()].httpConnectionList.clear();
       auto now = UtilTime::now();
       auto req = this->convertRequest(request, now);
       retry.numRetry += 1;
@@ -716,12 +877,7 @@ class Service : public std::enable_shared_from_this<Service> {
       httpConnectionPtr->lastReceiveDataTp = now;
       const auto& localIpAddress = request.getLocalIpAddress();
       const auto& requestBaseUrl = request.getBaseUrl();
-      if (this->sessionOptions.httpConnectionPoolMaxSize > 0 &&
-          this->httpConnectionPool[localIpAddress][requestBaseUrl].size() >= this->sessionOptions.httpConnectionPoolMaxSize) {
-        CCAPI_LOGGER_TRACE("httpConnectionPool is full for localIpAddress = " + localIpAddress + ", requestBaseUrl = " + toString(requestBaseUrl));
-        this->httpConnectionPool[localIpAddress][requestBaseUrl].pop_front();
-      }
-      this->httpConnectionPool[localIpAddress][requestBaseUrl].push_back(httpConnectionPtr);
+      this->pushHttpConnectionToPool(this->httpConnectionPool[localIpAddress][requestBaseUrl], httpConnectionPtr);
       CCAPI_LOGGER_TRACE("pushed back httpConnectionPtr " + toString(*httpConnectionPtr) + " to httpConnectionPool for localIpAddress = " + localIpAddress +
                          ", requestBaseUrl = " + toString(requestBaseUrl));
     }
@@ -796,6 +952,134 @@ class Service : public std::enable_shared_from_this<Service> {
     }
   }
   virtual bool doesHttpBodyContainError(const std::string& body) { return false; }
+  void pushHttpConnectionToPool(HttpConnectionPool& httpConnectionPool, std::shared_ptr<HttpConnection> httpConnectionPtr) {
+    auto maxSize = std::max(this->sessionOptions.httpConnectionPoolMaxSize, this->sessionOptions.httpConnectionPoolMinSize);
+    if (this->sessionOptions.httpConnectionPoolMaxSize > 0 && httpConnectionPool.httpConnectionList.size() >= maxSize) {
+      CCAPI_LOGGER_TRACE("httpConnectionPool is full for host = " + httpConnectionPool.host);
+      httpConnectionPool.httpConnectionList.pop_front();
+    }
+    httpConnectionPool.httpConnectionList.push_back(std::move(httpConnectionPtr));
+  }
+  // Retires the idle connections which would exceed the keep-alive timeout before the next run and opens new ones so that every pool has at least
+  // SessionOptions::httpConnectionPoolMinSize connections.
+  void maintainHttpConnectionPool() {
+    auto keepAliveTimeoutSeconds = std::max(this->sessionOptions.httpConnectionKeepAliveTimeoutSeconds, 1L);
+    auto interval = std::chrono::seconds(std::max(keepAliveTimeoutSeconds / 4, 1L));
+    auto then = UtilTime::now() + interval;
+    for (auto& x : this->httpConnectionPool) {
+      for (auto& y : x.second) {
+        auto& httpConnectionList = y.second.httpConnectionList;
+        while (!httpConnectionList.empty() &&
+               std::chrono::duration_cast<std::chrono::seconds>(then - httpConnectionList.front()->lastReceiveDataTp).count() >= keepAliveTimeoutSeconds) {
+          httpConnectionList.pop_front();
+        }
+        this->warmUpHttpConnectionPool(x.first, y.first);
+      }
+    }
+    this->httpConnectionPoolTimerPtr->expires_after(interval);
+    this->httpConnectionPoolTimerPtr->async_wait([that = shared_from_this()](const ErrorCode& ec) {
+      if (!ec && that->shouldContinue.load()) {
+        that->maintainHttpConnectionPool();
+      }
+    });
+  }
+  void warmUpHttpConnectionPool(const std::string& localIpAddress, const std::string& baseUrl) {
+    auto& httpConnectionPool = this->httpConnectionPool[localIpAddress][baseUrl];
+    auto minSize = static_cast<size_t>(this->sessionOptions.httpConnectionPoolMinSize);
+    while (httpConnectionPool.httpConnectionList.size() + *httpConnectionPool.numWarmingUpPtr < minSize) {
+      std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> streamPtr(nullptr);
+      try {
+        streamPtr = this->createStream<beast::ssl_stream<beast::tcp_stream>>(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr,
+                                                                             httpConnectionPool.host, httpConnectionPool.port);
+      } catch (const beast::error_code& ec) {
+        CCAPI_LOGGER_WARN("warm up http connection to " + httpConnectionPool.host + " failed: create stream: " + ec.message());
+        return;
+      }
+      if (!localIpAddress.empty()) {
+        ErrorCode ec;
+        auto& socket = beast::get_lowest_layer(*streamPtr).socket();
+        socket.open(net::ip::tcp::v4(), ec);
+        if (!ec) {
+          socket.bind(tcp::endpoint(net::ip::address::from_string(localIpAddress), 0), ec);
+        }
+        if (ec) {
+          CCAPI_LOGGER_WARN("warm up http connection to " + httpConnectionPool.host + " failed: socket bind: " + ec.message());
+          return;
+        }
+      }
+      std::shared_ptr<HttpConnection> httpConnectionPtr(new HttpConnection(httpConnectionPool.host, httpConnectionPool.port, streamPtr));
+      auto numWarmingUpPtr = httpConnectionPool.numWarmingUpPtr;
+      ++*numWarmingUpPtr;
+      std::shared_ptr<tcp::resolver> newResolverPtr(new tcp::resolver(*this->serviceContextPtr->ioContextPtr));
+      newResolverPtr->async_resolve(httpConnectionPool.host, httpConnectionPool.port,
+                                    [that = shared_from_this(), httpConnectionPtr, newResolverPtr, localIpAddress, baseUrl, numWarmingUpPtr](
+                                        const ErrorCode& ec, tcp::resolver::results_type tcpNewResolverResults) {
+                                      if (ec) {
+                                        that->onWarmUpHttpConnectionFail(httpConnectionPtr, numWarmingUpPtr, ec, "DNS resolve");
+                                        return;
+                                      }
+                                      that->connectWarmUpHttpConnection(httpConnectionPtr, localIpAddress, baseUrl, numWarmingUpPtr, tcpNewResolverResults, 0);
+                                    });
+    }
+  }
+  void connectWarmUpHttpConnection(std::shared_ptr<HttpConnection> httpConnectionPtr, const std::string& localIpAddress, const std::string& baseUrl,
+                                   std::shared_ptr<size_t> numWarmingUpPtr, tcp::resolver::results_type tcpNewResolverResults,
+                                   size_t tcpNewResolverResultsIndex) {
+    auto it = tcpNewResolverResults.begin();
+    std::advance(it, tcpNewResolverResultsIndex);
+    if (it == tcpNewResolverResults.end()) {
+      this->onWarmUpHttpConnectionFail(httpConnectionPtr, numWarmingUpPtr, net::error::make_error_code(net::error::misc_errors::not_found), "connect");
+      return;
+    }
+    auto& stream = beast::get_lowest_layer(*httpConnectionPtr->streamPtr);
+    if (this->sessionOptions.httpRequestTimeoutMilliseconds > 0) {
+      stream.expires_after(std::chrono::milliseconds(this->sessionOptions.httpRequestTimeoutMilliseconds));
+    }
+    // connect the socket itself so that the bound local ip address isn't lost
+    stream.async_connect(*it, [that = shared_from_this(), httpConnectionPtr, localIpAddress, baseUrl, numWarmingUpPtr, tcpNewResolverResults,
+                               tcpNewResolverResultsIndex](const ErrorCode& ec) {
+      if (ec) {
+        if (ec == beast::error::timeout) {
+          that->onWarmUpHttpConnectionFail(httpConnectionPtr, numWarmingUpPtr, ec, "connect");
+        } else {
+          that->connectWarmUpHttpConnection(httpConnectionPtr, localIpAddress, baseUrl, numWarmingUpPtr, tcpNewResolverResults,
+                                            tcpNewResolverResultsIndex + 1);
+        }
+        return;
+      }
+      that->setSocketOptions(beast::get_lowest_layer(*httpConnectionPtr->streamPtr).socket());
+      httpConnectionPtr->streamPtr->async_handshake(ssl::stream_base::client, [that, httpConnectionPtr, localIpAddress, baseUrl,
+                                                                               numWarmingUpPtr](const ErrorCode& ec) {
+        if (ec) {
+          that->onWarmUpHttpConnectionFail(httpConnectionPtr, numWarmingUpPtr, ec, "ssl handshake");
+          return;
+        }
+        beast::get_lowest_layer(*httpConnectionPtr->streamPtr).expires_never();
+        httpConnectionPtr->lastReceiveDataTp = UtilTime::now();
+        --*numWarmingUpPtr;
+        auto httpConnectionPool = that->findHttpConnectionPool(localIpAddress, baseUrl);
+        if (httpConnectionPool && httpConnectionPool->numWarmingUpPtr == numWarmingUpPtr) {
+          that->pushHttpConnectionToPool(*httpConnectionPool, httpConnectionPtr);
+          that->httpConnectionPoolNumWarmUps.fetch_add(1, std::memory_order_relaxed);
+          CCAPI_LOGGER_TRACE("warmed up httpConnectionPtr " + toString(*httpConnectionPtr));
+        }
+      });
+    });
+  }
+  void onWarmUpHttpConnectionFail(std::shared_ptr<HttpConnection> httpConnectionPtr, std::shared_ptr<size_t> numWarmingUpPtr, const ErrorCode& ec,
+                                  const std::string& what) {
+    CCAPI_LOGGER_WARN("warm up httpConnectionPtr " + toString(*httpConnectionPtr) + " failed: " + what + ": " + ec.message());
+    --*numWarmingUpPtr;
+  }
+  // Returns nullptr if the pool has been purged meanwhile.
+  HttpConnectionPool* findHttpConnectionPool(const std::string& localIpAddress, const std::string& baseUrl) {
+    auto it = this->httpConnectionPool.find(localIpAddress);
+    if (it == this->httpConnectionPool.end()) {
+      return nullptr;
+    }
+    auto it2 = it->second.find(baseUrl);
+    return it2 == it->second.end() ? nullptr : &it2->second;
+  }
   void tryRequest(const Request& request, http::request<http::string_body>& req, const HttpRetry& retry, Queue<Event>* eventQueuePtr) {
     CCAPI_LOGGER_FUNCTION_ENTER;
 #if defined(CCAPI_ENABLE_LOG_DEBUG) || defined(CCAPI_ENABLE_LOG_TRACE)
@@ -808,19 +1092,25 @@ class Service : public std::enable_shared_from_this<Service> {
       try {
         const auto& localIpAddress = request.getLocalIpAddress();
         const auto& requestBaseUrl = request.getBaseUrl();
-        if (this->sessionOptions.enableOneHttpConnectionPerRequest || this->httpConnectionPool[localIpAddress][requestBaseUrl].empty() ||
-            std::chrono::duration_cast<std::chrono::seconds>(request.getTimeSent() -
-                                                             this->httpConnectionPool[localIpAddress][requestBaseUrl].back()->lastReceiveDataTp)
-                    .count() >= this->sessionOptions.httpConnectionKeepAliveTimeoutSeconds) {
-          this->httpConnectionPool[localIpAddress][requestBaseUrl].clear();
-          std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> streamPtr(nullptr);
-          try {
-            streamPtr = this->createStream<beast::ssl_stream<beast::tcp_stream>>(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr,
-                                                                                 this->hostRest);
-          } catch (const beast::error_code& ec) {
-            CCAPI_LOGGER_TRACE("fail");
-            this->onError(Event::Type::REQUEST_STATUS, Message::Type::REQUEST_FAILURE, ec, "create stream", {request.getCorrelationId()}, eventQueuePtr);
-            return;
+        auto& httpConnectionPool = this->httpConnectionPool[localIpAddress][requestBaseUrl];
+        auto& httpConnectionList = httpConnectionPool.httpConnectionList;
+        if (!httpConnectionList.empty() &&
+            std::chrono::duration_cast<std::chrono::seconds>(request.getTimeSent() - httpConnectionList.back()->lastReceiveDataTp).count() >=
+                this->sessionOptions.httpConnectionKeepAliveTimeoutSeconds) {
+          httpConnectionList.clear();
+        }
+        if (httpConnectionPool.host.empty()) {
+          if (requestBaseUrl.empty()) {
+            httpConnectionPool.host = this->hostRest;
+            httpConnectionPool.port = this->portRest;
+          } else {
+            httpConnectionPool.host = request.getHost();
+            httpConnectionPool.port = request.getPort();
+          }
+        }
+        if (this->sessionOptions.enableOneHttpConnectionPerRequest || httpConnectionList.empty()) {
+          if (!this->sessionOptions.enableOneHttpConnectionPerRequest) {
+            this->httpConnectionPoolNumMisses.fetch_add(1, std::memory_order_relaxed);
           }
           std::string host, port;
           if (requestBaseUrl.empty()) {
@@ -830,17 +1120,30 @@ class Service : public std::enable_shared_from_this<Service> {
             host = request.getHost();
             port = request.getPort();
           }
+          std::shared_ptr<beast::ssl_stream<beast::tcp_stream>> streamPtr(nullptr);
+          try {
+            streamPtr = this->createStream<beast::ssl_stream<beast::tcp_stream>>(this->serviceContextPtr->ioContextPtr, this->serviceContextPtr->sslContextPtr,
+                                                                                 host, port);
+          } catch (const beast::error_code& ec) {
+            CCAPI_LOGGER_TRACE("fail");
+            this->onError(Event::Type::REQUEST_STATUS, Message::Type::REQUEST_FAILURE, ec, "create stream", {request.getCorrelationId()}, eventQueuePtr);
+            return;
+          }
           std::shared_ptr<HttpConnection> httpConnectionPtr(new HttpConnection(host, port, streamPtr));
           CCAPI_LOGGER_WARN("about to perform request with new httpConnectionPtr " + toString(*httpConnectionPtr) + " for localIpAddress = " + localIpAddress +
                             ", requestBaseUrl = " + toString(requestBaseUrl));
           this->performRequestWithNewHttpConnection(httpConnectionPtr, request, req, retry, eventQueuePtr);
         } else {
-          std::shared_ptr<HttpConnection> httpConnectionPtr = this->httpConnectionPool[localIpAddress][requestBaseUrl].back();
-          this->httpConnectionPool[localIpAddress][requestBaseUrl].pop_back();
+          this->httpConnectionPoolNumHits.fetch_add(1, std::memory_order_relaxed);
+          std::shared_ptr<HttpConnection> httpConnectionPtr = httpConnectionList.back();
+          httpConnectionList.pop_back();
           CCAPI_LOGGER_TRACE("about to perform request with existing httpConnectionPtr " + toString(*httpConnectionPtr) +
                              " for localIpAddress = " + localIpAddress + ", requestBaseUrl = " + toString(requestBaseUrl));
           this->startWrite_2(httpConnectionPtr, request, req, retry, eventQueuePtr);
         }
+        if (this->httpConnectionPoolTimerPtr) {
+          this->warmUpHttpConnectionPool(localIpAddress, requestBaseUrl);
+        }
       } catch (const std::exception& e) {
         CCAPI_LOGGER_ERROR(std::string("e.what() = ") + e.what());
         this->onError(Event::Type::REQUEST_STATUS, Message::Type::REQUEST_FAILURE, e, {request.getCorrelationId()}, eventQueuePtr);
@@ -1049,6 +1352,7 @@ class Service : public std::enable_shared_from_this<Service> {
   virtual void clearStates(WsConnection& wsConnection) {
     CCAPI_LOGGER_INFO("clear states for wsConnection " + toString(wsConnection));
     this->shouldProcessRemainingMessageOnClosingByConnectionIdMap.erase(wsConnection.id);
+    this->jsonDocumentPoolByConnectionIdMap.erase(wsConnection.id);
     this->lastPongTpByMethodByConnectionIdMap.erase(wsConnection.id);
     this->extraPropertyByConnectionIdMap.erase(wsConnection.id);
     if (this->pingTimerByMethodByConnectionIdMap.find(wsConnection.id) != this->pingTimerByMethodByConnectionIdMap.end()) {
@@ -1316,6 +1620,7 @@ class Service : public std::enable_shared_from_this<Service> {
       this->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::SUBSCRIPTION_FAILURE, ec, "set SNI Hostname", wsConnectionPtr->correlationIdList);
       return;
     }
+    this->prepareTlsSessionResumption(stream.next_layer().native_handle(), wsConnectionPtr->host, wsConnectionPtr->port);
     CCAPI_LOGGER_TRACE("before async_connect");
     beast::get_lowest_layer(stream).async_connect(tcpResolverResults, beast::bind_front_handler(&Service::onConnectWs, shared_from_this(), wsConnectionPtr));
     CCAPI_LOGGER_TRACE("after async_connect");
@@ -1333,7 +1638,7 @@ class Service : public std::enable_shared_from_this<Service> {
         this->hostHttpHeaderValueIgnorePort ? wsConnectionPtr->host : wsConnectionPtr->host + ':' + std::to_string(ep.port());
     CCAPI_LOGGER_TRACE("wsConnectionPtr->hostHttpHeaderValue = " + wsConnectionPtr->hostHttpHeaderValue);
     beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>& stream = *wsConnectionPtr->streamPtr;
-    beast::get_lowest_layer(stream).socket().set_option(tcp::no_delay(true));
+    this->setSocketOptions(beast::get_lowest_layer(stream).socket());
     CCAPI_LOGGER_TRACE("before ssl async_handshake");
     stream.next_layer().async_handshake(ssl::stream_base::client, beast::bind_front_handler(&Service::onSslHandshakeWs, shared_from_this(), wsConnectionPtr));
     CCAPI_LOGGER_TRACE("after ssl async_handshake");
@@ -1419,7 +1724,13 @@ class Service : public std::enable_shared_from_this<Service> {
     }
     auto& connectionId = wsConnectionPtr->id;
     auto& readMessageBuffer = this->readMessageBufferByConnectionIdMap[connectionId];
-    this->onMessage(wsConnectionPtr, (const char*)readMessageBuffer.data().data(), readMessageBuffer.size());
+    if (this->latencyHistogramList) {
+      auto start = std::chrono::steady_clock::now();
+      this->onMessage(wsConnectionPtr, (const char*)readMessageBuffer.data().data(), readMessageBuffer.size());
+      this->recordLatency(LatencyHistogram::Stage::ON_MESSAGE, start);
+    } else {
+      this->onMessage(wsConnectionPtr, (const char*)readMessageBuffer.data().data(), readMessageBuffer.size());
+    }
     readMessageBuffer.consume(readMessageBuffer.size());
     this->startReadWs(wsConnectionPtr);
     this->onPongByMethod(PingPongMethod::WEBSOCKET_PROTOCOL_LEVEL, wsConnectionPtr, now, false);
@@ -1457,54 +1768,94 @@ class Service : public std::enable_shared_from_this<Service> {
     }
   }
   void writeMessage(std::shared_ptr<WsConnection> wsConnectionPtr, const char* data, size_t dataSize) {
+    this->writeMessage(wsConnectionPtr, std::make_shared<const std::string>(data, dataSize));
+  }
+  void writeMessage(std::shared_ptr<WsConnection> wsConnectionPtr, std::shared_ptr<const std::string> payloadPtr) {
     if (wsConnectionPtr->status != WsConnection::Status::OPEN) {
       CCAPI_LOGGER_WARN("should write no more messages");
       return;
     }
     auto& connectionId = wsConnectionPtr->id;
-    auto& writeMessageBuffer = this->writeMessageBufferByConnectionIdMap[connectionId];
-    auto& writeMessageBufferWrittenLength = this->writeMessageBufferWrittenLengthByConnectionIdMap[connectionId];
-    auto& writeMessageBufferBoundary = this->writeMessageBufferBoundaryByConnectionIdMap[connectionId];
-    size_t n = writeMessageBufferWrittenLength;
-    memcpy(writeMessageBuffer.data() + n, data, dataSize);
-    writeMessageBufferBoundary.push_back(dataSize);
-    n += dataSize;
+    auto& writeMessageQueue = this->writeMessageQueueByConnectionIdMap[connectionId];
     CCAPI_LOGGER_TRACE("connectionId = " + connectionId);
-    CCAPI_LOGGER_DEBUG("about to send " + std::string(data, dataSize));
-    CCAPI_LOGGER_TRACE("writeMessageBufferWrittenLength = " + toString(writeMessageBufferWrittenLength));
-    if (writeMessageBufferWrittenLength == 0) {
+    CCAPI_LOGGER_DEBUG("about to send " + *payloadPtr);
+    writeMessageQueue.numBytes += payloadPtr->size();
+    writeMessageQueue.payloadList.push_back(std::move(payloadPtr));
+    writeMessageQueue.peakSize = std::max(writeMessageQueue.peakSize, writeMessageQueue.payloadList.size());
+    writeMessageQueue.peakNumBytes = std::max(writeMessageQueue.peakNumBytes, writeMessageQueue.numBytes);
+    CCAPI_LOGGER_TRACE("writeMessageQueue.payloadList.size() = " + toString(writeMessageQueue.payloadList.size()));
+    CCAPI_LOGGER_TRACE("writeMessageQueue.numBytes = " + toString(writeMessageQueue.numBytes));
+    if (!writeMessageQueue.isAboveHighWaterMark && writeMessageQueue.numBytes > this->sessionOptions.websocketWriteQueueHighWaterMarkBytes) {
+      writeMessageQueue.isAboveHighWaterMark = true;
+      this->onWriteMessageQueueHighWaterMark(*wsConnectionPtr, writeMessageQueue);
+    }
+    if (writeMessageQueue.payloadList.size() == 1) {
       CCAPI_LOGGER_TRACE("about to start write");
-      this->startWriteWs(wsConnectionPtr, writeMessageBuffer.data(), writeMessageBufferBoundary.front());
+      this->startWriteWs(wsConnectionPtr, writeMessageQueue.payloadList.front());
     }
-    writeMessageBufferWrittenLength = n;
-    CCAPI_LOGGER_TRACE("writeMessageBufferWrittenLength = " + toString(writeMessageBufferWrittenLength));
-    CCAPI_LOGGER_TRACE("writeMessageBufferBoundary = " + toString(writeMessageBufferBoundary));
   }
-  void startWriteWs(std::shared_ptr<WsConnection> wsConnectionPtr, const char* data, size_t numBytesToWrite) {
+  void startWriteWs(std::shared_ptr<WsConnection> wsConnectionPtr, std::shared_ptr<const std::string> payloadPtr) {
     auto& stream = *wsConnectionPtr->streamPtr;
     CCAPI_LOGGER_TRACE("before async_write");
-    CCAPI_LOGGER_TRACE("numBytesToWrite = " + toString(numBytesToWrite));
+    CCAPI_LOGGER_TRACE("numBytesToWrite = " + toString(payloadPtr->size()));
     stream.binary(false);
-    stream.async_write(net::buffer(data, numBytesToWrite), beast::bind_front_handler(&Service::onWriteWs, shared_from_this(), wsConnectionPtr));
+    stream.async_write(net::buffer(*payloadPtr), [that = shared_from_this(), wsConnectionPtr, payloadPtr](const ErrorCode& ec, std::size_t n) {
+      that->onWriteWs(wsConnectionPtr, ec, n);
+    });
     CCAPI_LOGGER_TRACE("after async_write");
   }
   void onWriteWs(std::shared_ptr<WsConnection> wsConnectionPtr, const ErrorCode& ec, std::size_t n) {
     CCAPI_LOGGER_FUNCTION_ENTER;
-    auto& connectionId = wsConnectionPtr->id;
-    auto& writeMessageBuffer = this->writeMessageBufferByConnectionIdMap[connectionId];
-    auto& writeMessageBufferWrittenLength = this->writeMessageBufferWrittenLengthByConnectionIdMap[connectionId];
-    auto& writeMessageBufferBoundary = this->writeMessageBufferBoundaryByConnectionIdMap[connectionId];
-    writeMessageBufferWrittenLength -= writeMessageBufferBoundary.front();
-    writeMessageBufferBoundary.erase(writeMessageBufferBoundary.begin());
-    CCAPI_LOGGER_TRACE("writeMessageBufferWrittenLength = " + toString(writeMessageBufferWrittenLength));
-    CCAPI_LOGGER_TRACE("writeMessageBufferBoundary = " + toString(writeMessageBufferBoundary));
-    if (writeMessageBufferWrittenLength > 0) {
-      std::memmove(writeMessageBuffer.data(), writeMessageBuffer.data() + n, writeMessageBufferWrittenLength);
+    if (ec) {
+      CCAPI_LOGGER_TRACE("fail");
+      this->writeMessageQueueByConnectionIdMap.erase(wsConnectionPtr->id);
+      // Writes which are aborted because the connection is being closed aren't failures of the connection.
+      if (wsConnectionPtr->status == WsConnection::Status::OPEN) {
+        this->onError(Event::Type::SUBSCRIPTION_STATUS, Message::Type::GENERIC_ERROR, ec, "write", wsConnectionPtr->correlationIdList);
+        this->onFail(wsConnectionPtr);
+      }
+      return;
+    }
+    auto it = this->writeMessageQueueByConnectionIdMap.find(wsConnectionPtr->id);
+    if (it == this->writeMessageQueueByConnectionIdMap.end() || it->second.payloadList.empty()) {
+      return;
+    }
+    auto& writeMessageQueue = it->second;
+    writeMessageQueue.numBytes -= writeMessageQueue.payloadList.front()->size();
+    writeMessageQueue.payloadList.pop_front();
+    if (writeMessageQueue.numBytes <= this->sessionOptions.websocketWriteQueueHighWaterMarkBytes / 2) {
+      writeMessageQueue.isAboveHighWaterMark = false;
+    }
+    CCAPI_LOGGER_TRACE("writeMessageQueue.payloadList.size() = " + toString(writeMessageQueue.payloadList.size()));
+    CCAPI_LOGGER_TRACE("writeMessageQueue.numBytes = " + toString(writeMessageQueue.numBytes));
+    if (!writeMessageQueue.payloadList.empty()) {
       CCAPI_LOGGER_TRACE("about to start write");
-      this->startWriteWs(wsConnectionPtr, writeMessageBuffer.data(), writeMessageBufferBoundary.front());
+      this->startWriteWs(wsConnectionPtr, writeMessageQueue.payloadList.front());
     }
     CCAPI_LOGGER_FUNCTION_EXIT;
   }
+  // Signals backpressure: the application should stop sending on the connection until its queue has drained to half of the high-water mark, after which the
+  // event is delivered again the next time the mark is exceeded.
+  void onWriteMessageQueueHighWaterMark(const WsConnection& wsConnection, const WriteMessageQueue& writeMessageQueue) {
+    CCAPI_LOGGER_WARN("write queue of connection " + toString(wsConnection) + " has exceeded the high-water mark: numBytes = " +
+                      toString(writeMessageQueue.numBytes));
+    Event event;
+    event.setType(Event::Type::SESSION_STATUS);
+    Message message;
+    message.setType(Message::Type::WEBSOCKET_WRITE_QUEUE_HIGH_WATER_MARK);
+    message.setTimeReceived(UtilTime::now());
+    message.setCorrelationIdList(wsConnection.correlationIdList);
+    Element element;
+    element.insert(CCAPI_CONNECTION_ID, wsConnection.id);
+    element.insert(CCAPI_CONNECTION_URL, wsConnection.getUrl());
+    element.insert(CCAPI_WRITE_QUEUE_SIZE, std::to_string(writeMessageQueue.payloadList.size()));
+    element.insert(CCAPI_WRITE_QUEUE_NUM_BYTES, std::to_string(writeMessageQueue.numBytes));
+    element.insert(CCAPI_WRITE_QUEUE_PEAK_SIZE, std::to_string(writeMessageQueue.peakSize));
+    element.insert(CCAPI_WRITE_QUEUE_PEAK_NUM_BYTES, std::to_string(writeMessageQueue.peakNumBytes));
+    message.setElementList({element});
+    event.setMessageList({message});
+    this->eventHandler(event, nullptr);
+  }
   virtual void onFail_(std::shared_ptr<WsConnection> wsConnectionPtr) {
     WsConnection& wsConnection = *wsConnectionPtr;
     wsConnection.status = WsConnection::Status::FAILED;
@@ -1561,6 +1912,7 @@ class Service : public std::enable_shared_from_this<Service> {
     WsConnection& wsConnection = *wsConnectionPtr;
     CCAPI_LOGGER_INFO("clear states for wsConnection " + toString(wsConnection));
     this->shouldProcessRemainingMessageOnClosingByConnectionIdMap.erase(wsConnection.id);
+    this->jsonDocumentPoolByConnectionIdMap.erase(wsConnection.id);
     this->lastPongTpByMethodByConnectionIdMap.erase(wsConnection.id);
     this->extraPropertyByConnectionIdMap.erase(wsConnection.id);
     if (this->pingTimerByMethodByConnectionIdMap.find(wsConnection.id) != this->pingTimerByMethodByConnectionIdMap.end()) {
@@ -1582,8 +1934,7 @@ class Service : public std::enable_shared_from_this<Service> {
       this->connectRetryOnFailTimerByConnectionIdMap.erase(wsConnection.id);
     }
     this->readMessageBufferByConnectionIdMap.erase(wsConnection.id);
-    this->writeMessageBufferByConnectionIdMap.erase(wsConnection.id);
-    this->writeMessageBufferWrittenLengthByConnectionIdMap.erase(wsConnection.id);
+    this->writeMessageQueueByConnectionIdMap.erase(wsConnection.id);
   }
   virtual void onClose(std::shared_ptr<WsConnection> wsConnectionPtr, ErrorCode ec) {
     CCAPI_LOGGER_FUNCTION_ENTER;
@@ -1651,10 +2002,14 @@ class Service : public std::enable_shared_from_this<Service> {
         std::string decompressed;
         boost::beast::string_view payload(data, dataSize);
         try {
+          auto start = this->latencyHistogramList ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
           ErrorCode ec = this->inflater.decompress(reinterpret_cast<const uint8_t*>(&payload[0]), payload.size(), decompressed);
           if (ec) {
             CCAPI_LOGGER_FATAL(ec.message());
           }
+          if (this->latencyHistogramList) {
+            this->recordLatency(LatencyHistogram::Stage::DECOMPRESS, start);
+          }
           CCAPI_LOGGER_DEBUG("decompressed = " + decompressed);
           this->onTextMessage(wsConnectionPtr, decompressed, now);
         } catch (const std::exception& e) {
@@ -1704,6 +2059,9 @@ class Service : public std::enable_shared_from_this<Service> {
   void send(std::shared_ptr<WsConnection> wsConnectionPtr, boost::beast::string_view payload, ErrorCode& ec) {
     this->writeMessage(wsConnectionPtr, payload.data(), payload.length());
   }
+  void send(std::shared_ptr<WsConnection> wsConnectionPtr, std::shared_ptr<const std::string> payloadPtr, ErrorCode& ec) {
+    this->writeMessage(wsConnectionPtr, std::move(payloadPtr));
+  }
   void ping(std::shared_ptr<WsConnection> wsConnectionPtr, boost::beast::string_view payload, ErrorCode& ec) {
     if (!this->wsConnectionPendingPingingByConnectionIdMap[wsConnectionPtr->id]) {
       auto& stream = *wsConnectionPtr->streamPtr;
@@ -1802,6 +2160,22 @@ class Service : public std::enable_shared_from_this<Service> {
   }
   virtual void onTextMessage(std::shared_ptr<WsConnection> wsConnectionPtr, boost::beast::string_view textMessage, const TimePoint& timeReceived) {}
 #endif
+  // Parses a websocket text message where it is without copying it. The returned document belongs to the connection and stays valid only until the next message
+  // of the same connection is parsed.
+  template <unsigned parseFlags>
+  rj::Document& parseJsonDocument(const std::string& connectionId, boost::beast::string_view textMessage) {
+    auto it = this->jsonDocumentPoolByConnectionIdMap.find(connectionId);
+    if (it == this->jsonDocumentPoolByConnectionIdMap.end()) {
+      it = this->jsonDocumentPoolByConnectionIdMap
+               .emplace(connectionId, std::unique_ptr<JsonDocumentPool>(new JsonDocumentPool(this->sessionOptions.websocketJsonDocumentPoolSize)))
+               .first;
+    }
+    JsonDocumentPool& jsonDocumentPool = *it->second;
+    jsonDocumentPool.document.SetNull();
+    jsonDocumentPool.allocator.Clear();
+    jsonDocumentPool.document.Parse<parseFlags>(textMessage.data(), textMessage.size());
+    return jsonDocumentPool.document;
+  }
   bool hostHttpHeaderValueIgnorePort{};
   std::string apiKeyName;
   std::string apiSecretName;
@@ -1813,12 +2187,21 @@ class Service : public std::enable_shared_from_this<Service> {
   SessionConfigs sessionConfigs;
   ServiceContextPtr serviceContextPtr;
   tcp::resolver resolver, resolverWs;
+  std::unique_ptr<LatencyHistogram[]> latencyHistogramList;
   std::string hostRest;
   std::string portRest;
   std::string hostWs;
   std::string portWs;
   // tcp::resolver::results_type tcpResolverResultsRest, tcpResolverResultsWs;
-  std::map<std::string, std::map<std::string, std::deque<std::shared_ptr<HttpConnection>>>> httpConnectionPool;
+  std::map<std::string, std::map<std::string, HttpConnectionPool>> httpConnectionPool;
+  std::map<std::string, std::shared_ptr<SSL_SESSION>> tlsSessionByHostPortMap;
+#ifndef CCAPI_USE_SINGLE_THREAD
+  std::mutex tlsSessionMutex;
+#endif
+  TimerPtr httpConnectionPoolTimerPtr;
+  std::atomic<size_t> httpConnectionPoolNumHits{};
+  std::atomic<size_t> httpConnectionPoolNumMisses{};
+  std::atomic<size_t> httpConnectionPoolNumWarmUps{};
   std::map<std::string, std::string> credentialDefault;
   std::map<std::string, TimerPtr> sendRequestDelayTimerByCorrelationIdMap;
 #ifdef CCAPI_LEGACY_USE_WEBSOCKETPP
@@ -1826,11 +2209,10 @@ class Service : public std::enable_shared_from_this<Service> {
 #else
   std::map<std::string, std::shared_ptr<WsConnection>> wsConnectionByIdMap;  // TODO(cryptochassis): for consistency, to be renamed to wsConnectionPtrByIdMap
   std::map<std::string, beast::flat_buffer> readMessageBufferByConnectionIdMap;
-  std::map<std::string, std::array<char, CCAPI_WEBSOCKET_WRITE_BUFFER_SIZE>> writeMessageBufferByConnectionIdMap;
-  std::map<std::string, size_t> writeMessageBufferWrittenLengthByConnectionIdMap;
-  std::map<std::string, std::vector<size_t>> writeMessageBufferBoundaryByConnectionIdMap;
+  std::map<std::string, WriteMessageQueue> writeMessageQueueByConnectionIdMap;
 #endif
   std::map<std::string, bool> wsConnectionPendingPingingByConnectionIdMap;
+  std::map<std::string, std::unique_ptr<JsonDocumentPool>> jsonDocumentPoolByConnectionIdMap;
   std::map<std::string, bool> shouldProcessRemainingMessageOnClosingByConnectionIdMap;
   std::map<std::string, int> connectNumRetryOnFailByConnectionUrlMap;
   std::map<std::string, TimerPtr> connectRetryOnFailTimerByConnectionIdMap;
@@ -62,6 +62,8 @@ class ServiceContext CCAPI_FINAL {
     this->tlsClientPtr->stop();
     this->tlsClientPtr->stop_perpetual();
   }
+  // The websocketpp client runs on a single io_service, so every service uses this context.
+  ServiceContext* nextServiceContextPtr() { return this; }
   IoContextPtr ioContextPtr{new IoContext()};
   TlsClientPtr tlsClientPtr{new TlsClient()};
   SslContextPtr sslContextPtr{new SslContext(SslContext::tls_client)};
@@ -69,6 +71,14 @@ class ServiceContext CCAPI_FINAL {
 
 } /* namespace ccapi */
 #else
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "ccapi_cpp/ccapi_logger.h"
 namespace ccapi {
 /**
@@ -110,26 +120,82 @@ class ServiceContext CCAPI_FINAL {
     this->sslContextPtr = sslContextPtr;
     this->sslContextPtr->set_verify_mode(boost::asio::ssl::verify_none);
   }
+  // Creates a pool of numIoContexts io_contexts, each of which is run by its own thread. Every service is pinned to one io_context of the pool (assigned
+  // round-robin), so all of a service's connections, timers and states are handled by a single thread. If cpuAffinityList isn't empty, the thread running
+  // the i-th io_context is pinned to cpu cpuAffinityList[i % cpuAffinityList.size()].
+  ServiceContext(size_t numIoContexts, const std::vector<int>& cpuAffinityList = {}) : ServiceContext() {
+    this->cpuAffinityList = cpuAffinityList;
+    for (size_t i = 1; i < numIoContexts; ++i) {
+      std::unique_ptr<ServiceContext> pinnedServiceContextPtr(new ServiceContext(new boost::asio::io_context(), this->sslContextPtr));
+      pinnedServiceContextPtr->ownSslContext = false;
+      this->pinnedServiceContextPtrList.push_back(std::move(pinnedServiceContextPtr));
+    }
+  }
 #endif
   ServiceContext(const ServiceContext&) = delete;
   ServiceContext& operator=(const ServiceContext&) = delete;
   virtual ~ServiceContext() {
+    this->pinnedServiceContextPtrList.clear();
     delete this->executorWorkGuardPtr;
     delete this->ioContextPtr;
-    delete this->sslContextPtr;
+    if (this->ownSslContext) {
+      delete this->sslContextPtr;
+    }
   }
   void start() {
+    std::vector<std::thread> threadList;
+    for (size_t i = 0; i < this->pinnedServiceContextPtrList.size(); ++i) {
+      ServiceContext* pinnedServiceContextPtr = this->pinnedServiceContextPtrList.at(i).get();
+      int cpu = this->cpuAffinityList.empty() ? -1 : this->cpuAffinityList.at((i + 1) % this->cpuAffinityList.size());
+      threadList.emplace_back([pinnedServiceContextPtr, cpu]() {
+        if (cpu >= 0) {
+          setCurrentThreadCpuAffinity(cpu);
+        }
+        pinnedServiceContextPtr->start();
+      });
+    }
+    if (!this->cpuAffinityList.empty()) {
+      setCurrentThreadCpuAffinity(this->cpuAffinityList.front());
+    }
     CCAPI_LOGGER_INFO("about to start client asio io_context run loop");
     this->ioContextPtr->run();
     CCAPI_LOGGER_INFO("just exited client asio io_context run loop");
+    for (auto& thread : threadList) {
+      thread.join();
+    }
   }
   void stop() {
+    for (const auto& pinnedServiceContextPtr : this->pinnedServiceContextPtrList) {
+      pinnedServiceContextPtr->stop();
+    }
     this->executorWorkGuardPtr->reset();
     this->ioContextPtr->stop();
   }
+  // Returns the context that the next constructed service should be pinned to.
+  ServiceContext* nextServiceContextPtr() {
+    size_t index = this->nextServiceIndex++ % (this->pinnedServiceContextPtrList.size() + 1);
+    return index == 0 ? this : this->pinnedServiceContextPtrList.at(index - 1).get();
+  }
+  static void setCurrentThreadCpuAffinity(int cpu) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (error) {
+      CCAPI_LOGGER_WARN("failed to set cpu affinity to " + std::to_string(cpu) + ", error = " + std::to_string(error));
+    }
+#else
+    CCAPI_LOGGER_WARN("cpu affinity isn't supported on this platform");
+#endif
+  }
   IoContextPtr ioContextPtr{nullptr};
   ExecutorWorkGuardPtr executorWorkGuardPtr{nullptr};
   SslContextPtr sslContextPtr{nullptr};
+  bool ownSslContext{true};
+  std::vector<std::unique_ptr<ServiceContext> > pinnedServiceContextPtrList;
+  std::vector<int> cpuAffinityList;
+  size_t nextServiceIndex{};
   // IoContextPtr ioContextPtr{new IoContext()};
   // ExecutorWorkGuardPtr executorWorkGuardPtr{new ExecutorWorkGuard(ioContextPtr->get_executor())};
   // SslContextPtr sslContextPtr{new SslContext(SslContext::tls_client)};
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+
+#include "ccapi_cpp/ccapi_session.h"
+#include "mock_exchange.h"
+namespace ccapi {
+Logger* Logger::logger = nullptr;  // This line is needed.
+// Records the end-to-end latency of every trade received from the mock exchange and signals when a given number of trades or an order response has arrived.
+// sendTimeList is the mock exchange's send times of the current feed, taken once per run.
+class MyEventHandler : public EventHandler {
+ public:
+  explicit MyEventHandler(std::shared_ptr<const std::atomic<long long>[]> sendTimeList = nullptr) : sendTimeList(std::move(sendTimeList)) {}
+  bool processEvent(const Event& event, Session* session) override {
+    auto now = MockExchange::now();
+    std::lock_guard<std::mutex> lock(this->m);
+    if (event.getType() == Event::Type::SUBSCRIPTION_DATA) {
+      for (const auto& message : event.getMessageList()) {
+        if (message.getType() != Message::Type::MARKET_DATA_EVENTS_TRADE || message.getRecapType() != Message::RecapType::NONE) {
+          continue;
+        }
+        for (const auto& element : message.getElementList()) {
+          long long sendTime = this->sendTimeList[std::stoll(element.getValue(CCAPI_TRADE_ID))].load(std::memory_order_acquire);
+          this->latencyList.push_back(now - sendTime);
+          this->lastReceiveTime = now;
+        }
+      }
+    } else if (event.getType() == Event::Type::RESPONSE) {
+      this->numResponses += 1;
+    }
+    this->cv.notify_all();
+    return true;
+  }
+  bool waitFor(std::function<bool()> predicate, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(this->m);
+    return this->cv.wait_for(lock, timeout, predicate);
+  }
+  std::shared_ptr<const std::atomic<long long>[]> sendTimeList;
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<long long> latencyList;
+  long long lastReceiveTime{};
+  int numResponses{};
+};
+std::string percentilesToString(std::vector<long long> latencyList) {
+  if (latencyList.empty()) {
+    return "";
+  }
+  std::sort(latencyList.begin(), latencyList.end());
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  for (double percentile : {0.5, 0.9, 0.99, 0.999}) {
+    oss << std::setw(12) << latencyList[static_cast<size_t>(percentile * (latencyList.size() - 1))] / 1000.0;
+  }
+  oss << std::setw(12) << latencyList.back() / 1000.0;
+  return oss.str();
+}
+SessionConfigs createSessionConfigs(unsigned short port) {
+  SessionConfigs sessionConfigs;
+  auto urlWebsocketBase = sessionConfigs.getUrlWebsocketBase();
+  auto urlRestBase = sessionConfigs.getUrlRestBase();
+  for (const auto& dialect : MockExchange::createDialectList()) {
+    urlWebsocketBase[dialect.exchange] = "wss://127.0.0.1:" + std::to_string(port);
+    urlRestBase[dialect.exchange] = "https://127.0.0.1:" + std::to_string(port);
+  }
+  sessionConfigs.setUrlWebsocketBase(urlWebsocketBase);
+  sessionConfigs.setUrlRestBase(urlRestBase);
+  return sessionConfigs;
+}
+} /* namespace ccapi */
+using ::ccapi::createSessionConfigs;
+using ::ccapi::MockExchange;
+using ::ccapi::MyEventHandler;
+using ::ccapi::percentilesToString;
+using ::ccapi::Request;
+using ::ccapi::Session;
+using ::ccapi::SessionConfigs;
+using ::ccapi::SessionOptions;
+using ::ccapi::Subscription;
+using ::ccapi::UtilString;
+using ::ccapi::UtilSystem;
+int main(int argc, char** argv) {
+  const std::string exchangeFilter = UtilSystem::getEnvAsString("EXCHANGE");
+  const double durationSeconds = UtilSystem::getEnvAsDouble("DURATION_SECONDS", 2);
+  const int numRequests = UtilSystem::getEnvAsInt("NUM_REQUESTS", 1000);
+  std::vector<double> messagesPerSecondList;
+  for (const auto& x : UtilString::split(UtilSystem::getEnvAsString("MESSAGES_PER_SECOND_LIST", "10000,50000,100000,200000,500000"), ",")) {
+    messagesPerSecondList.push_back(std::stod(x));
+  }
+  MockExchange mockExchange;
+  mockExchange.start();
+  SessionConfigs sessionConfigs = createSessionConfigs(mockExchange.getPort());
+  std::cout << "Market data latency is measured from the mock exchange writing a trade to the event handler receiving it, in microseconds" << std::endl;
+  std::cout << std::left << std::setw(12) << "exchange" << std::right << std::setw(14) << "target msg/s" << std::setw(14) << "actual msg/s"
+            << std::setw(12) << "received" << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "p99.9"
+            << std::setw(12) << "max" << std::endl;
+  for (const auto& dialect : MockExchange::createDialectList()) {
+    if (!exchangeFilter.empty() && exchangeFilter != dialect.exchange) {
+      continue;
+    }
+    double maxSustainableMessagesPerSecond = 0;
+    for (double messagesPerSecond : messagesPerSecondList) {
+      auto numMessages = static_cast<long long>(messagesPerSecond * durationSeconds);
+      mockExchange.setFeed({dialect, messagesPerSecond, numMessages});
+      MyEventHandler eventHandler(mockExchange.getSendTimeList());
+      Session session(SessionOptions(), sessionConfigs, &eventHandler);
+      Subscription subscription(dialect.exchange, dialect.instrument, CCAPI_TRADE);
+      long long subscribeTime = MockExchange::now();
+      session.subscribe(subscription);
+      bool isComplete = eventHandler.waitFor([&eventHandler, numMessages]() { return static_cast<long long>(eventHandler.latencyList.size()) >= numMessages; },
+                                             std::chrono::milliseconds(static_cast<long>(durationSeconds * 2000) + 10000));
+      session.stop();
+      std::lock_guard<std::mutex> lock(eventHandler.m);
+      long long firstSendTime = numMessages > 0 ? eventHandler.sendTimeList[0].load(std::memory_order_acquire) : 0;
+      double actualMessagesPerSecond = eventHandler.latencyList.size() > 1 && firstSendTime > 0
+                                           ? eventHandler.latencyList.size() * 1e9 / (eventHandler.lastReceiveTime - std::max(firstSendTime, subscribeTime))
+                                           : 0;
+      if (isComplete && actualMessagesPerSecond >= 0.95 * messagesPerSecond) {
+        maxSustainableMessagesPerSecond = messagesPerSecond;
+      }
+      std::cout << std::left << std::setw(12) << dialect.exchange << std::right << std::fixed << std::setprecision(0) << std::setw(14) << messagesPerSecond
+                << std::setw(14) << actualMessagesPerSecond << std::setw(12) << eventHandler.latencyList.size()
+                << percentilesToString(eventHandler.latencyList) << std::endl;
+    }
+    std::cout << "Max sustainable message rate for " + dialect.exchange + " is " + std::to_string(static_cast<long long>(maxSustainableMessagesPerSecond)) +
+                     " messages per second"
+              << std::endl;
+  }
+  if (numRequests > 0 && (exchangeFilter.empty() || exchangeFilter == CCAPI_EXCHANGE_NAME_BINANCE)) {
+    MyEventHandler eventHandler;
+    Session session(SessionOptions(), sessionConfigs, &eventHandler);
+    std::vector<long long> latencyList;
+    for (int i = 0; i < numRequests + 1; ++i) {
+      Request request(Request::Operation::CREATE_ORDER, CCAPI_EXCHANGE_NAME_BINANCE, "BTCUSDT", "",
+                      {{CCAPI_BINANCE_API_KEY, "mock"}, {CCAPI_BINANCE_API_SECRET, "mock"}});
+      request.appendParam({
+          {CCAPI_EM_ORDER_SIDE, CCAPI_EM_ORDER_SIDE_BUY},
+          {CCAPI_EM_ORDER_QUANTITY, "0.001"},
+          {CCAPI_EM_ORDER_LIMIT_PRICE, "20000"},
+      });
+      long long start = MockExchange::now();
+      session.sendRequest(request);
+      if (!eventHandler.waitFor([&eventHandler, i]() { return eventHandler.numResponses > i; }, std::chrono::seconds(10))) {
+        std::cerr << "Timed out waiting for an order response" << std::endl;
+        break;
+      }
+      // skip the first one because it needs to create a tcp connection for the first time
+      if (i > 0) {
+        latencyList.push_back(MockExchange::now() - start);
+      }
+    }
+    session.stop();
+    std::cout << "Order round trip latency is measured from sending a create order request to the event handler receiving its response, in microseconds"
+              << std::endl;
+    std::cout << std::left << std::setw(12) << "exchange" << std::right << std::setw(12) << "requests" << std::setw(12) << "p50" << std::setw(12) << "p90"
+              << std::setw(12) << "p99" << std::setw(12) << "p99.9" << std::setw(12) << "max" << std::endl;
+    std::cout << std::left << std::setw(12) << CCAPI_EXCHANGE_NAME_BINANCE << std::right << std::setw(12) << latencyList.size()
+              << percentilesToString(latencyList) << std::endl;
+  }
+  mockExchange.stop();
+  std::cout << "Bye" << std::endl;
+  return EXIT_SUCCESS;
+}
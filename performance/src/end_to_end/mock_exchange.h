@@ -0,0 +1,264 @@
+#ifndef PERFORMANCE_SRC_END_TO_END_MOCK_EXCHANGE_H_
+#define PERFORMANCE_SRC_END_TO_END_MOCK_EXCHANGE_H_
+#include <openssl/x509.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio/ssl.hpp"
+#include "boost/beast/core.hpp"
+#include "boost/beast/http.hpp"
+#include "boost/beast/ssl.hpp"
+#include "boost/beast/websocket.hpp"
+#include "boost/beast/websocket/ssl.hpp"
+namespace ccapi {
+/**
+ * A mock exchange on localhost which speaks TLS websocket and HTTP on a single port. A websocket client gets its subscription acknowledged and is then sent a
+ * feed of trades at a configurable rate in the dialect of one of the supported exchanges. The send time of each trade is recorded by trade id so that a
+ * client in the same process can compute end-to-end latencies. HTTP requests for creating an order are answered with a new order in the binance dialect, all
+ * other HTTP requests with an empty json object.
+ */
+class MockExchange {
+ public:
+  struct Dialect {
+    std::string exchange;
+    std::string instrument;
+    std::function<std::string(const std::string& subscribeMessage)> createSubscribeAck;
+    std::function<std::string(long long tradeId, bool isBuy)> createTrade;
+  };
+  struct Feed {
+    Dialect dialect;
+    double messagesPerSecond{};
+    long long numMessages{};
+  };
+  MockExchange() : sslContext(boost::asio::ssl::context::tls_server), acceptor(ioContext) {
+    EVP_PKEY* pkey = nullptr;
+    EVP_PKEY_CTX* pkeyCtx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_keygen_init(pkeyCtx);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pkeyCtx, NID_X9_62_prime256v1);
+    EVP_PKEY_keygen(pkeyCtx, &pkey);
+    EVP_PKEY_CTX_free(pkeyCtx);
+    X509* x509 = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+    X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+    X509_gmtime_adj(X509_getm_notAfter(x509), 86400);
+    X509_set_pubkey(x509, pkey);
+    X509_NAME_add_entry_by_txt(X509_get_subject_name(x509), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(x509, X509_get_subject_name(x509));
+    X509_sign(x509, pkey, EVP_sha256());
+    SSL_CTX_use_certificate(this->sslContext.native_handle(), x509);
+    SSL_CTX_use_PrivateKey(this->sslContext.native_handle(), pkey);
+    X509_free(x509);
+    EVP_PKEY_free(pkey);
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address("127.0.0.1"), 0);
+    this->acceptor.open(endpoint.protocol());
+    this->acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    this->acceptor.bind(endpoint);
+    this->acceptor.listen();
+  }
+  ~MockExchange() { this->stop(); }
+  unsigned short getPort() const { return this->acceptor.local_endpoint().port(); }
+  // The feed is sent to every websocket client that subscribes after this call. sendTimeList is reset to numMessages entries.
+  void setFeed(const Feed& feed) {
+    std::lock_guard<std::mutex> lock(this->feedMutex);
+    this->feed = feed;
+    this->sendTimeList.reset(new std::atomic<long long>[feed.numMessages]);
+    for (long long i = 0; i < feed.numMessages; ++i) {
+      this->sendTimeList[i].store(0, std::memory_order_relaxed);
+    }
+  }
+  // Steady clock nanoseconds at which each trade of the current feed was written, indexed by trade id, or 0 if it hasn't been written. Take it once after
+  // setFeed rather than per trade so that reading send times doesn't contend with the writer.
+  std::shared_ptr<const std::atomic<long long>[]> getSendTimeList() const {
+    std::lock_guard<std::mutex> lock(this->feedMutex);
+    return this->sendTimeList;
+  }
+  void start() {
+    this->acceptThread = std::thread([this]() {
+      while (!this->stopped.load()) {
+        boost::asio::ip::tcp::socket socket(this->ioContext);
+        boost::beast::error_code ec;
+        this->acceptor.accept(socket, ec);
+        if (ec || this->stopped.load()) {
+          break;
+        }
+        std::lock_guard<std::mutex> lock(this->connectionThreadListMutex);
+        this->connectionThreadList.emplace_back(&MockExchange::serve, this, std::move(socket));
+      }
+    });
+  }
+  void stop() {
+    if (this->stopped.exchange(true)) {
+      return;
+    }
+    boost::asio::ip::tcp::socket socket(this->ioContext);
+    boost::beast::error_code ec;
+    socket.connect(this->acceptor.local_endpoint(), ec);
+    if (this->acceptThread.joinable()) {
+      this->acceptThread.join();
+    }
+    std::vector<std::thread> connectionThreadList;
+    {
+      // Connection threads block in synchronous reads on keep-alive and websocket connections, so shut their sockets down to let them return.
+      std::lock_guard<std::mutex> lock(this->connectionThreadListMutex);
+      for (auto socketPtr : this->connectionSocketPtrSet) {
+        socketPtr->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+      }
+      connectionThreadList.swap(this->connectionThreadList);
+    }
+    for (auto& connectionThread : connectionThreadList) {
+      connectionThread.join();
+    }
+  }
+  static long long now() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+  static std::vector<Dialect> createDialectList() {
+    std::vector<Dialect> dialectList;
+    dialectList.push_back({CCAPI_EXCHANGE_NAME_BINANCE, "BTCUSDT",
+                           [](const std::string& subscribeMessage) {
+                             std::smatch match;
+                             std::regex_search(subscribeMessage, match, std::regex("\"id\":(\\d+)"));
+                             return "{\"result\":null,\"id\":" + (match.empty() ? std::string("0") : match[1].str()) + "}";
+                           },
+                           [](long long tradeId, bool isBuy) {
+                             return "{\"stream\":\"btcusdt@trade\",\"data\":{\"e\":\"trade\",\"E\":1672531200000,\"s\":\"BTCUSDT\",\"t\":" +
+                                    std::to_string(tradeId) + ",\"p\":\"30000.01\",\"q\":\"0.01000000\",\"b\":1,\"a\":2,\"T\":1672531200000,\"m\":" +
+                                    (isBuy ? "false" : "true") + ",\"M\":true}}";
+                           }});
+    dialectList.push_back({CCAPI_EXCHANGE_NAME_OKX, "BTC-USDT",
+                           [](const std::string&) { return std::string("{\"event\":\"subscribe\",\"arg\":{\"channel\":\"trades\",\"instId\":\"BTC-USDT\"}}"); },
+                           [](long long tradeId, bool isBuy) {
+                             return "{\"arg\":{\"channel\":\"trades\",\"instId\":\"BTC-USDT\"},\"data\":[{\"instId\":\"BTC-USDT\",\"tradeId\":\"" +
+                                    std::to_string(tradeId) + "\",\"px\":\"30000.01\",\"sz\":\"0.01\",\"side\":\"" + (isBuy ? "buy" : "sell") +
+                                    "\",\"ts\":\"1672531200000\",\"count\":\"1\"}]}";
+                           }});
+    dialectList.push_back({CCAPI_EXCHANGE_NAME_COINBASE, "BTC-USD",
+                           [](const std::string&) {
+                             return std::string("{\"type\":\"subscriptions\",\"channels\":[{\"name\":\"matches\",\"product_ids\":[\"BTC-USD\"]}]}");
+                           },
+                           [](long long tradeId, bool isBuy) {
+                             return "{\"type\":\"match\",\"trade_id\":" + std::to_string(tradeId) + ",\"maker_order_id\":\"a\",\"taker_order_id\":\"b\"," +
+                                    "\"side\":\"" + (isBuy ? "sell" : "buy") +
+                                    "\",\"size\":\"0.01\",\"price\":\"30000.01\",\"product_id\":\"BTC-USD\",\"sequence\":" + std::to_string(tradeId) +
+                                    ",\"time\":\"2023-01-01T00:00:00.123456Z\"}";
+                           }});
+    return dialectList;
+  }
+#ifndef CCAPI_EXPOSE_INTERNAL
+
+ private:
+#endif
+  void serve(boost::asio::ip::tcp::socket socket) {
+    boost::beast::error_code ec;
+    socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+    // The websocket stream owns the connection from the start so that its socket stays at the same address for stop() to shut it down.
+    boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream> > ws(boost::beast::tcp_stream(std::move(socket)), this->sslContext);
+    auto socketPtr = &boost::beast::get_lowest_layer(ws).socket();
+    {
+      std::lock_guard<std::mutex> lock(this->connectionThreadListMutex);
+      if (this->stopped.load()) {
+        return;
+      }
+      this->connectionSocketPtrSet.insert(socketPtr);
+    }
+    this->serveConnection(ws);
+    std::lock_guard<std::mutex> lock(this->connectionThreadListMutex);
+    this->connectionSocketPtrSet.erase(socketPtr);
+  }
+  void serveConnection(boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream> >& ws) {
+    namespace http = boost::beast::http;
+    boost::beast::error_code ec;
+    auto& stream = ws.next_layer();
+    stream.handshake(boost::asio::ssl::stream_base::server, ec);
+    if (ec) {
+      return;
+    }
+    boost::beast::flat_buffer buffer;
+    long long orderId = 0;
+    while (!this->stopped.load()) {
+      http::request<http::string_body> req;
+      http::read(stream, buffer, req, ec);
+      if (ec) {
+        return;
+      }
+      if (boost::beast::websocket::is_upgrade(req)) {
+        ws.accept(req, ec);
+        if (!ec) {
+          this->serveWebsocket(ws);
+        }
+        return;
+      }
+      http::response<http::string_body> res{http::status::ok, req.version()};
+      res.set(http::field::content_type, "application/json");
+      res.keep_alive(req.keep_alive());
+      if (req.method() == http::verb::post && req.target().find("/order") != boost::beast::string_view::npos) {
+        ++orderId;
+        res.body() = "{\"symbol\":\"BTCUSDT\",\"orderId\":" + std::to_string(orderId) + ",\"clientOrderId\":\"mock" + std::to_string(orderId) +
+                     "\",\"transactTime\":1672531200000,\"price\":\"20000.00\",\"origQty\":\"0.001\",\"executedQty\":\"0\",\"cummulativeQuoteQty\":\"0\","
+                     "\"status\":\"NEW\",\"timeInForce\":\"GTC\",\"type\":\"LIMIT\",\"side\":\"BUY\",\"updateTime\":1672531200000}";
+      } else {
+        res.body() = "{}";
+      }
+      res.prepare_payload();
+      http::write(stream, res, ec);
+      if (ec || !res.keep_alive()) {
+        return;
+      }
+    }
+  }
+  void serveWebsocket(boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream> >& ws) {
+    boost::beast::error_code ec;
+    boost::beast::flat_buffer buffer;
+    ws.read(buffer, ec);
+    if (ec) {
+      return;
+    }
+    Feed feed;
+    std::shared_ptr<std::atomic<long long>[]> sendTimeList;
+    {
+      std::lock_guard<std::mutex> lock(this->feedMutex);
+      feed = this->feed;
+      sendTimeList = this->sendTimeList;
+    }
+    ws.text(true);
+    ws.write(boost::asio::buffer(feed.dialect.createSubscribeAck(boost::beast::buffers_to_string(buffer.data()))), ec);
+    buffer.consume(buffer.size());
+    auto begin = std::chrono::steady_clock::now();
+    for (long long i = 0; i < feed.numMessages && !ec && !this->stopped.load(); ++i) {
+      std::string payload = feed.dialect.createTrade(i, i % 2 == 0);
+      auto due = begin + std::chrono::nanoseconds(static_cast<long long>(i * 1e9 / feed.messagesPerSecond));
+      if (due - std::chrono::steady_clock::now() > std::chrono::microseconds(200)) {
+        std::this_thread::sleep_until(due - std::chrono::microseconds(100));
+      }
+      while (std::chrono::steady_clock::now() < due) {
+      }
+      sendTimeList[i].store(MockExchange::now(), std::memory_order_release);
+      ws.write(boost::asio::buffer(payload), ec);
+    }
+    // Keep reading so that pings are answered until the client closes the connection.
+    while (!ec && !this->stopped.load()) {
+      ws.read(buffer, ec);
+      buffer.consume(buffer.size());
+    }
+  }
+  boost::asio::io_context ioContext;
+  boost::asio::ssl::context sslContext;
+  boost::asio::ip::tcp::acceptor acceptor;
+  std::atomic<bool> stopped{};
+  std::thread acceptThread;
+  std::vector<std::thread> connectionThreadList;
+  std::set<boost::asio::ip::tcp::socket*> connectionSocketPtrSet;
+  std::mutex connectionThreadListMutex;
+  Feed feed;
+  std::shared_ptr<std::atomic<long long>[]> sendTimeList;
+  mutable std::mutex feedMutex;
+};
+} /* namespace ccapi */
+#endif  // PERFORMANCE_SRC_END_TO_END_MOCK_EXCHANGE_H_
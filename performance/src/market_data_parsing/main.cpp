@@ -0,0 +1,233 @@
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+#include "ccapi_cpp/service/ccapi_market_data_service_binance.h"
+#include "ccapi_cpp/service/ccapi_market_data_service_coinbase.h"
+#include "ccapi_cpp/service/ccapi_market_data_service_okx.h"
+namespace {
+std::atomic<size_t> numAllocations{};
+}
+void* operator new(std::size_t size) {
+  numAllocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+namespace ccapi {
+Logger* Logger::logger = nullptr;  // This line is needed.
+// Generates synthetic websocket payloads around a fixed mid price. Bids always stay below and asks always stay above the mid price so that the order book
+// never crosses and its number of levels stays bounded.
+class PayloadGenerator {
+ public:
+  static constexpr int midPriceTicks = 3000000;
+  static constexpr int numLevels = 50;
+  std::string price(int ticks) {
+    std::string output = std::to_string(ticks / 100) + ".";
+    int cents = ticks % 100;
+    if (cents < 10) {
+      output += '0';
+    }
+    return output + std::to_string(cents);
+  }
+  std::string bidPrice() { return this->price(midPriceTicks - std::uniform_int_distribution<int>(1, numLevels)(this->generator)); }
+  std::string askPrice() { return this->price(midPriceTicks + std::uniform_int_distribution<int>(1, numLevels)(this->generator)); }
+  std::string size(bool allowZero) {
+    int thousandths = std::uniform_int_distribution<int>(0, 4999)(this->generator);
+    if (allowZero && thousandths < 1000) {
+      return "0";
+    }
+    return std::to_string(thousandths / 1000) + "." + std::to_string(100 + thousandths % 1000).substr(1) + "45";
+  }
+  bool coin() { return std::uniform_int_distribution<int>(0, 1)(this->generator) == 1; }
+  std::string levelList(bool isBid, int n, const std::string& suffix) {
+    std::string output = "[";
+    for (int i = 1; i <= n; ++i) {
+      if (i > 1) {
+        output += ",";
+      }
+      output += "[\"" + this->price(midPriceTicks + (isBid ? -i : i)) + "\",\"" + this->size(false) + "\"" + suffix + "]";
+    }
+    return output + "]";
+  }
+  std::mt19937 generator{1};
+};
+struct Scenario {
+  std::string exchange;
+  std::string instrument;
+  std::string field;
+  std::string options;
+  std::vector<std::string> initialPayloadList;  // processed once before measuring, e.g. an order book snapshot
+  std::vector<std::string> payloadList;         // replayed in a loop while measuring
+};
+Scenario createScenario(const std::string& exchange, const std::string& instrument, const std::string& field, const std::string& options,
+                        std::function<std::string(PayloadGenerator&, int)> initialPayloadGenerator,
+                        std::function<std::string(PayloadGenerator&, int)> payloadGenerator) {
+  static const int numDistinctPayloads = 1000;
+  PayloadGenerator payloadGenerator_;
+  Scenario scenario{exchange, instrument, field, options};
+  if (initialPayloadGenerator) {
+    scenario.initialPayloadList.push_back(initialPayloadGenerator(payloadGenerator_, 0));
+  }
+  for (int i = 0; i < numDistinctPayloads; ++i) {
+    scenario.payloadList.push_back(payloadGenerator(payloadGenerator_, i));
+  }
+  return scenario;
+}
+std::vector<Scenario> createScenarioList() {
+  const long long startTimeMilliseconds = 1672531200000;
+  std::vector<Scenario> scenarioList;
+  scenarioList.push_back(createScenario(CCAPI_EXCHANGE_NAME_BINANCE, "BTCUSDT", CCAPI_MARKET_DEPTH, "MARKET_DEPTH_MAX=10", nullptr,
+                                        [](PayloadGenerator& g, int i) {
+                                          return "{\"stream\":\"btcusdt@depth10@100ms\",\"data\":{\"lastUpdateId\":" + std::to_string(i) +
+                                                 ",\"bids\":" + g.levelList(true, 10, "") + ",\"asks\":" + g.levelList(false, 10, "") + "}}";
+                                        }));
+  scenarioList.push_back(createScenario(CCAPI_EXCHANGE_NAME_BINANCE, "BTCUSDT", CCAPI_TRADE, "", nullptr, [startTimeMilliseconds](PayloadGenerator& g, int i) {
+    std::string time = std::to_string(startTimeMilliseconds + i);
+    return "{\"stream\":\"btcusdt@trade\",\"data\":{\"e\":\"trade\",\"E\":" + time + ",\"s\":\"BTCUSDT\",\"t\":" + std::to_string(i) + ",\"p\":\"" +
+           (g.coin() ? g.bidPrice() : g.askPrice()) + "\",\"q\":\"" + g.size(false) + "\",\"b\":1,\"a\":2,\"T\":" + time +
+           ",\"m\":" + (g.coin() ? "true" : "false") + ",\"M\":true}}";
+  }));
+  scenarioList.push_back(
+      createScenario(CCAPI_EXCHANGE_NAME_BINANCE, "BTCUSDT", CCAPI_CANDLESTICK, "CANDLESTICK_INTERVAL_SECONDS=60", nullptr,
+                     [startTimeMilliseconds](PayloadGenerator& g, int i) {
+                       std::string time = std::to_string(startTimeMilliseconds + i * 60000);
+                       return "{\"stream\":\"btcusdt@kline_1m\",\"data\":{\"e\":\"kline\",\"E\":" + time + ",\"s\":\"BTCUSDT\",\"k\":{\"t\":" + time +
+                              ",\"T\":" + time + ",\"s\":\"BTCUSDT\",\"i\":\"1m\",\"f\":1,\"L\":2,\"o\":\"" + g.bidPrice() + "\",\"c\":\"" + g.askPrice() +
+                              "\",\"h\":\"" + g.askPrice() + "\",\"l\":\"" + g.bidPrice() + "\",\"v\":\"" + g.size(false) + "\",\"n\":2,\"x\":false,\"q\":\"" +
+                              g.size(false) + "\",\"V\":\"0\",\"Q\":\"0\",\"B\":\"0\"}}}";
+                     }));
+  scenarioList.push_back(createScenario(
+      CCAPI_EXCHANGE_NAME_OKX, "BTC-USDT", CCAPI_MARKET_DEPTH, "MARKET_DEPTH_MAX=10",
+      [startTimeMilliseconds](PayloadGenerator& g, int i) {
+        return "{\"arg\":{\"channel\":\"books50-l2-tbt\",\"instId\":\"BTC-USDT\"},\"action\":\"snapshot\",\"data\":[{\"asks\":" +
+               g.levelList(false, PayloadGenerator::numLevels, ",\"0\",\"1\"") + ",\"bids\":" + g.levelList(true, PayloadGenerator::numLevels, ",\"0\",\"1\"") +
+               ",\"ts\":\"" + std::to_string(startTimeMilliseconds) + "\",\"checksum\":0}]}";
+      },
+      [startTimeMilliseconds](PayloadGenerator& g, int i) {
+        return "{\"arg\":{\"channel\":\"books50-l2-tbt\",\"instId\":\"BTC-USDT\"},\"action\":\"update\",\"data\":[{\"asks\":[[\"" + g.askPrice() + "\",\"" +
+               g.size(true) + "\",\"0\",\"1\"]],\"bids\":[[\"" + g.bidPrice() + "\",\"" + g.size(true) + "\",\"0\",\"1\"],[\"" + g.bidPrice() + "\",\"" +
+               g.size(true) + "\",\"0\",\"1\"]],\"ts\":\"" + std::to_string(startTimeMilliseconds + i) + "\",\"checksum\":0}]}";
+      }));
+  scenarioList.push_back(createScenario(CCAPI_EXCHANGE_NAME_OKX, "BTC-USDT", CCAPI_TRADE, "", nullptr, [startTimeMilliseconds](PayloadGenerator& g, int i) {
+    return "{\"arg\":{\"channel\":\"trades\",\"instId\":\"BTC-USDT\"},\"data\":[{\"instId\":\"BTC-USDT\",\"tradeId\":\"" + std::to_string(i) + "\",\"px\":\"" +
+           (g.coin() ? g.bidPrice() : g.askPrice()) + "\",\"sz\":\"" + g.size(false) + "\",\"side\":\"" + (g.coin() ? "buy" : "sell") + "\",\"ts\":\"" +
+           std::to_string(startTimeMilliseconds + i) + "\",\"count\":\"1\"}]}";
+  }));
+  scenarioList.push_back(createScenario(CCAPI_EXCHANGE_NAME_OKX, "BTC-USDT", CCAPI_CANDLESTICK, "CANDLESTICK_INTERVAL_SECONDS=60", nullptr,
+                                        [startTimeMilliseconds](PayloadGenerator& g, int i) {
+                                          return "{\"arg\":{\"channel\":\"candle1m\",\"instId\":\"BTC-USDT\"},\"data\":[[\"" +
+                                                 std::to_string(startTimeMilliseconds + i * 60000) + "\",\"" + g.bidPrice() + "\",\"" + g.askPrice() +
+                                                 "\",\"" + g.bidPrice() + "\",\"" + g.askPrice() + "\",\"" + g.size(false) + "\",\"" + g.size(false) +
+                                                 "\",\"" + g.size(false) + "\",\"0\"]]}";
+                                        }));
+  scenarioList.push_back(createScenario(
+      CCAPI_EXCHANGE_NAME_COINBASE, "BTC-USD", CCAPI_MARKET_DEPTH, "MARKET_DEPTH_MAX=10",
+      [](PayloadGenerator& g, int i) {
+        return "{\"type\":\"snapshot\",\"product_id\":\"BTC-USD\",\"bids\":" + g.levelList(true, PayloadGenerator::numLevels, "") +
+               ",\"asks\":" + g.levelList(false, PayloadGenerator::numLevels, "") + "}";
+      },
+      [](PayloadGenerator& g, int i) {
+        bool isBid = g.coin();
+        return std::string("{\"type\":\"l2update\",\"product_id\":\"BTC-USD\",\"changes\":[[\"") + (isBid ? "buy" : "sell") + "\",\"" +
+               (isBid ? g.bidPrice() : g.askPrice()) + "\",\"" + g.size(true) + "\"]],\"time\":\"2023-01-01T00:00:00.123456Z\"}";
+      }));
+  scenarioList.push_back(createScenario(CCAPI_EXCHANGE_NAME_COINBASE, "BTC-USD", CCAPI_TRADE, "", nullptr, [](PayloadGenerator& g, int i) {
+    return "{\"type\":\"match\",\"trade_id\":" + std::to_string(i) + ",\"maker_order_id\":\"a\",\"taker_order_id\":\"b\",\"side\":\"" +
+           (g.coin() ? "buy" : "sell") + "\",\"size\":\"" + g.size(false) + "\",\"price\":\"" + (g.coin() ? g.bidPrice() : g.askPrice()) +
+           "\",\"product_id\":\"BTC-USD\",\"sequence\":" + std::to_string(i) + ",\"time\":\"2023-01-01T00:00:00.123456Z\"}";
+  }));
+  return scenarioList;
+}
+std::shared_ptr<MarketDataService> createService(const std::string& exchange, ServiceContext* serviceContextPtr) {
+  auto eventHandler = [](Event&, Queue<Event>*) {};
+  if (exchange == CCAPI_EXCHANGE_NAME_BINANCE) {
+    return std::make_shared<MarketDataServiceBinance>(eventHandler, SessionOptions(), SessionConfigs(), serviceContextPtr);
+  } else if (exchange == CCAPI_EXCHANGE_NAME_OKX) {
+    return std::make_shared<MarketDataServiceOkx>(eventHandler, SessionOptions(), SessionConfigs(), serviceContextPtr);
+  } else {
+    return std::make_shared<MarketDataServiceCoinbase>(eventHandler, SessionOptions(), SessionConfigs(), serviceContextPtr);
+  }
+}
+// Mirrors MarketDataService::onTextMessage without invoking the event handler. If parseOnly is true, only the exchange specific parsing into
+// MarketDataMessage is done.
+void processPayload(MarketDataService& service, std::shared_ptr<WsConnection> wsConnectionPtr, const std::string& payload, const TimePoint& timeReceived,
+                    bool parseOnly) {
+  Event event;
+  std::vector<MarketDataMessage> marketDataMessageList;
+  service.marketDataRecordList.clear();
+  service.processTextMessage(wsConnectionPtr, payload, timeReceived, event, marketDataMessageList);
+  if (!parseOnly && !marketDataMessageList.empty()) {
+    service.processMarketDataMessageList(wsConnectionPtr, payload, timeReceived, event, marketDataMessageList);
+  }
+}
+struct Measurement {
+  double nanosecondsPerMessage{};
+  double allocationsPerMessage{};
+};
+Measurement measure(MarketDataService& service, std::shared_ptr<WsConnection> wsConnectionPtr, const std::vector<std::string>& payloadList, int numMessages,
+                    bool parseOnly) {
+  auto timeReceived = UtilTime::now();
+  size_t allocationsBegin = numAllocations.load(std::memory_order_relaxed);
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < numMessages; ++i) {
+    processPayload(service, wsConnectionPtr, payloadList[i % payloadList.size()], timeReceived, parseOnly);
+  }
+  auto end = std::chrono::steady_clock::now();
+  size_t allocationsEnd = numAllocations.load(std::memory_order_relaxed);
+  Measurement measurement;
+  measurement.nanosecondsPerMessage = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / numMessages;
+  measurement.allocationsPerMessage = static_cast<double>(allocationsEnd - allocationsBegin) / numMessages;
+  return measurement;
+}
+} /* namespace ccapi */
+using ::ccapi::createScenarioList;
+using ::ccapi::createService;
+using ::ccapi::measure;
+using ::ccapi::processPayload;
+using ::ccapi::ServiceContext;
+using ::ccapi::Subscription;
+using ::ccapi::UtilSystem;
+using ::ccapi::UtilTime;
+using ::ccapi::WsConnection;
+int main(int argc, char** argv) {
+  const int numMessages = UtilSystem::getEnvAsInt("NUM_MESSAGES", 200000);
+  const std::string exchangeFilter = UtilSystem::getEnvAsString("EXCHANGE");
+  const std::string fieldFilter = UtilSystem::getEnvAsString("FIELD");
+  std::cout << "Number of messages per benchmark is " + std::to_string(numMessages) << std::endl;
+  std::cout << std::left << std::setw(12) << "exchange" << std::setw(16) << "field" << std::right << std::setw(18) << "parse ns/msg" << std::setw(18)
+            << "total ns/msg" << std::setw(18) << "total msgs/sec" << std::setw(18) << "total allocs/msg" << std::endl;
+  ServiceContext serviceContext;
+  for (const auto& scenario : createScenarioList()) {
+    if ((!exchangeFilter.empty() && exchangeFilter != scenario.exchange) || (!fieldFilter.empty() && fieldFilter != scenario.field)) {
+      continue;
+    }
+    auto servicePtr = createService(scenario.exchange, &serviceContext);
+    auto wsConnectionPtr = std::make_shared<WsConnection>();
+    wsConnectionPtr->id = "benchmark";
+    Subscription subscription(scenario.exchange, scenario.instrument, scenario.field, scenario.options);
+    servicePtr->prepareSubscription(*wsConnectionPtr, subscription);
+    servicePtr->createSendStringList(*wsConnectionPtr);
+    auto timeReceived = UtilTime::now();
+    for (const auto& payload : scenario.initialPayloadList) {
+      processPayload(*servicePtr, wsConnectionPtr, payload, timeReceived, false);
+    }
+    for (const auto& payload : scenario.payloadList) {
+      processPayload(*servicePtr, wsConnectionPtr, payload, timeReceived, false);
+    }
+    auto parseMeasurement = measure(*servicePtr, wsConnectionPtr, scenario.payloadList, numMessages, true);
+    auto totalMeasurement = measure(*servicePtr, wsConnectionPtr, scenario.payloadList, numMessages, false);
+    std::cout << std::left << std::setw(12) << scenario.exchange << std::setw(16) << scenario.field << std::right << std::fixed << std::setprecision(1)
+              << std::setw(18) << parseMeasurement.nanosecondsPerMessage << std::setw(18) << totalMeasurement.nanosecondsPerMessage << std::setw(18)
+              << std::setprecision(0) << 1e9 / totalMeasurement.nanosecondsPerMessage << std::setw(18) << std::setprecision(1)
+              << totalMeasurement.allocationsPerMessage << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
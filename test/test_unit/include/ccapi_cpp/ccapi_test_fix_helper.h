@@ -0,0 +1,51 @@
+#ifndef TEST_TEST_UNIT_INCLUDE_CCAPI_CPP_CCAPI_TEST_FIX_HELPER_H_
+#define TEST_TEST_UNIT_INCLUDE_CCAPI_CPP_CCAPI_TEST_FIX_HELPER_H_
+#include "ccapi_cpp/service/ccapi_fix_service.h"
+namespace ccapi {
+class FixServiceGeneric final : public FixService<beast::tcp_stream> {
+ public:
+  FixServiceGeneric(std::function<void(Event&, Queue<Event>*)> eventHandler, SessionOptions sessionOptions, SessionConfigs sessionConfigs,
+                    ServiceContext* serviceContextPtr)
+      : FixService(eventHandler, sessionOptions, sessionConfigs, serviceContextPtr) {
+    this->exchangeName = "generic";
+    this->protocolVersion = "FIX.4.4";
+    this->senderCompID = "sender";
+    this->targetCompID = "target";
+  }
+  std::vector<std::pair<int, std::string>> createCommonParam(const std::string& connectionId, const std::string& nowFixTimeStr, int64_t msgSeqNum) override {
+    return {
+        {hff::tag::SenderCompID, this->senderCompID},
+        {hff::tag::TargetCompID, this->targetCompID},
+        {hff::tag::MsgSeqNum, std::to_string(msgSeqNum)},
+        {hff::tag::SendingTime, nowFixTimeStr},
+    };
+  }
+  std::vector<std::pair<int, std::string>> createLogonParam(const std::string& connectionId, const std::string& nowFixTimeStr,
+                                                            const std::map<int, std::string> logonOptionMap = {}) override {
+    std::vector<std::pair<int, std::string>> param;
+    param.push_back({hff::tag::MsgType, "A"});
+    if (this->resetSeqNumOnLogon) {
+      param.push_back({hff::tag::ResetSeqNumFlag, "Y"});
+    }
+    param.push_back({hff::tag::EncryptMethod, "0"});
+    for (const auto& x : logonOptionMap) {
+      param.push_back({x.first, x.second});
+    }
+    return param;
+  }
+  // like exchanges which reset the sequence numbers on every logon without being asked to
+  bool resetSeqNumOnLogon{};
+};
+// Returns body framed as a FIX 4.4 message, i.e. with BeginString, BodyLength and CheckSum. Fields in body are separated by '|'.
+inline std::string createFixMessage(std::string body) {
+  std::replace(body.begin(), body.end(), '|', '\x01');
+  std::string output = "8=FIX.4.4\x01" "9=" + std::to_string(body.size()) + "\x01" + body;
+  unsigned checkSum = 0;
+  for (char c : output) {
+    checkSum += static_cast<unsigned char>(c);
+  }
+  std::string checkSumStr = std::to_string(checkSum % 256);
+  return output + "10=" + std::string(3 - checkSumStr.size(), '0') + checkSumStr + "\x01";
+}
+} /* namespace ccapi */
+#endif  // TEST_TEST_UNIT_INCLUDE_CCAPI_CPP_CCAPI_TEST_FIX_HELPER_H_
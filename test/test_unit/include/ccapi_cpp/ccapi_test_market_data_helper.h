@@ -7,6 +7,7 @@ class MarketDataServiceGeneric final : public MarketDataService {
   MarketDataServiceGeneric(std::function<void(Event&, Queue<Event>*)> wsEventHandler, SessionOptions sessionOptions, SessionConfigs sessionConfigs,
                            ServiceContext* serviceContextPtr)
       : MarketDataService(wsEventHandler, sessionOptions, sessionConfigs, serviceContextPtr) {}
+  using MarketDataService::calculateMarketDepthUpdate;
   using MarketDataService::updateOrderBook;
 };
 } /* namespace ccapi */
@@ -0,0 +1,138 @@
+#include "app/backtest_parameter_sweep.h"
+
+#include <cstdio>
+
+#include "gtest/gtest.h"
+namespace ccapi {
+class BacktestParameterSweepTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    this->directory = ::testing::TempDir() + "ccapi_backtest_parameter_sweep_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    auto splitted = UtilString::split(UtilSystem::getEnvAsString("HISTORICAL_MARKET_DATA_EVENT_PROCESSOR_TEST"), ",");
+    this->historicalMarketDataDirectory = splitted.at(5);
+  }
+  void TearDown() override {
+    for (const auto& filePath : this->filePathList) {
+      std::remove(filePath.c_str());
+    }
+  }
+  // Configures a backtest of 4 hours of the gemini ETH-USD test data.
+  void configureEventHandler(EventHandlerBase& eventHandler) {
+    eventHandler.exchange = "gemini";
+    eventHandler.instrumentRest = "ethusd";
+    eventHandler.instrumentWebsocket = "ethusd";
+    eventHandler.inventoryBasePortionTarget = 0.5;
+    eventHandler.halfSpreadMinimum = 0.0005;
+    eventHandler.halfSpreadMaximum = 0.01;
+    eventHandler.orderQuantityProportion = 0.1;
+    eventHandler.originalOrderRefreshIntervalSeconds = 15;
+    eventHandler.orderRefreshIntervalSeconds = 15;
+    eventHandler.accountBalanceRefreshWaitSeconds = 1;
+    eventHandler.killSwitchMaximumDrawdown = 0.1;
+    eventHandler.clockStepMilliseconds = 1000;
+    eventHandler.enableMarketMaking = true;
+    eventHandler.privateDataDirectory = this->directory.substr(0, this->directory.rfind('/'));
+    eventHandler.privateDataFilePrefix = this->directory.substr(this->directory.rfind('/') + 1);
+    eventHandler.privateDataOnlySaveFinalSummary = true;
+    eventHandler.tradingMode = EventHandlerBase::TradingMode::BACKTEST;
+    eventHandler.makerFee = 0.001;
+    eventHandler.makerBuyerFeeAsset = "USD";
+    eventHandler.makerSellerFeeAsset = "USD";
+    eventHandler.takerFee = 0.001;
+    eventHandler.takerBuyerFeeAsset = "USD";
+    eventHandler.takerSellerFeeAsset = "USD";
+    eventHandler.quoteBalance = 10000;
+    eventHandler.marketImpfactFactor = 0.5;
+    eventHandler.historicalMarketDataStartDateTp = UtilTime::parse("2021-07-01");
+    eventHandler.historicalMarketDataEndDateTp = UtilTime::parse("2021-07-03");
+    eventHandler.historicalMarketDataDirectory = this->historicalMarketDataDirectory;
+    eventHandler.startTimeTp = eventHandler.historicalMarketDataStartDateTp + std::chrono::hours(22);
+    eventHandler.totalDurationSeconds = 4 * 3600;
+  }
+  // Initializes a backtest with its GET_INSTRUMENT response like app/src/spot_market_making/main.cpp does.
+  void initEventHandler(EventHandlerBase& eventHandler, const std::string& privateDataFileSuffix, bool replayHistoricalMarketData) {
+    eventHandler.privateDataFileSuffix = privateDataFileSuffix;
+    eventHandler.promisePtr = std::make_shared<std::promise<void>>();
+    eventHandler.replayHistoricalMarketData = replayHistoricalMarketData;
+    Event event;
+    event.setType(Event::Type::RESPONSE);
+    Message message;
+    message.setType(Message::Type::GET_INSTRUMENT);
+    message.setTime(eventHandler.startTimeTp);
+    message.setTimeReceived(eventHandler.startTimeTp);
+    message.setCorrelationIdList({"GET_INSTRUMENT"});
+    Element element;
+    element.insert(CCAPI_BASE_ASSET, "eth");
+    element.insert(CCAPI_QUOTE_ASSET, "usd");
+    element.insert(CCAPI_ORDER_PRICE_INCREMENT, "0.01");
+    element.insert(CCAPI_ORDER_QUANTITY_INCREMENT, "0.000001");
+    message.setElementList({element});
+    event.addMessage(message);
+    eventHandler.processEvent(event, nullptr);
+    this->filePathList.push_back(eventHandler.privateDataDirectory + "/" + eventHandler.privateDataFilePrefix +
+                                 "gemini__eth-usd__2021-07-01__2021-07-03__summary" + privateDataFileSuffix + ".csv");
+  }
+  std::string readFile(const std::string& filePath) {
+    std::ifstream ifs(filePath);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+  std::string directory, historicalMarketDataDirectory;
+  std::vector<std::string> filePathList;
+};
+
+TEST_F(BacktestParameterSweepTest, readParameterFile) {
+  std::string filePath = this->directory + ".csv";
+  this->filePathList.push_back(filePath);
+  std::ofstream(filePath) << "SPREAD_PROPORTION_MINIMUM,ORDER_QUANTITY_PROPORTION\r\n0.001,0.1\r\n\r\n0.002,0.2\n";
+  auto parameterList = BacktestParameterSweep::readParameterFile(filePath);
+  ASSERT_EQ(parameterList.size(), 2);
+  EXPECT_EQ(parameterList.at(0).at("SPREAD_PROPORTION_MINIMUM"), "0.001");
+  EXPECT_EQ(parameterList.at(0).at("ORDER_QUANTITY_PROPORTION"), "0.1");
+  EXPECT_EQ(parameterList.at(1).at("SPREAD_PROPORTION_MINIMUM"), "0.002");
+  EXPECT_EQ(parameterList.at(1).at("ORDER_QUANTITY_PROPORTION"), "0.2");
+  std::ofstream(filePath) << "SPREAD_PROPORTION_MINIMUM,ORDER_QUANTITY_PROPORTION\n0.001\n";
+  EXPECT_THROW(BacktestParameterSweep::readParameterFile(filePath), std::runtime_error);
+}
+
+TEST_F(BacktestParameterSweepTest, setParameter) {
+  EventHandlerBase eventHandler;
+  BacktestParameterSweep::setParameter(eventHandler, "SPREAD_PROPORTION_MINIMUM", "0.002");
+  BacktestParameterSweep::setParameter(eventHandler, "ORDER_QUANTITY_PROPORTION", "0.3");
+  BacktestParameterSweep::setParameter(eventHandler, "INVENTORY_BASE_QUOTE_RATIO_TARGET", "3");
+  BacktestParameterSweep::setParameter(eventHandler, "ADVERSE_SELECTION_GUARD_TRIGGER_ROC_NUM_OBSERVATIONS", "25");
+  BacktestParameterSweep::setParameter(eventHandler, "ENABLE_ADVERSE_SELECTION_GUARD", "TRUE");
+  BacktestParameterSweep::setParameter(eventHandler, "ADVERSE_SELECTION_GUARD_ACTION_TYPE", "make");
+  EXPECT_DOUBLE_EQ(eventHandler.halfSpreadMinimum, 0.001);
+  EXPECT_DOUBLE_EQ(eventHandler.orderQuantityProportion, 0.3);
+  EXPECT_DOUBLE_EQ(eventHandler.inventoryBasePortionTarget, 0.75);
+  EXPECT_EQ(eventHandler.adverseSelectionGuardTriggerRocNumObservations, 25);
+  EXPECT_TRUE(eventHandler.enableAdverseSelectionGuard);
+  EXPECT_EQ(eventHandler.adverseSelectionGuardActionType, EventHandlerBase::AdverseSelectionGuardActionType::MAKE);
+  EXPECT_THROW(BacktestParameterSweep::setParameter(eventHandler, "EXCHANGE", "gemini"), std::invalid_argument);
+}
+
+TEST_F(BacktestParameterSweepTest, runMatchesSeparateBacktests) {
+  std::vector<std::pair<std::string, std::string> > parameterList{{"0.001", "0.1"}, {"0.004", "0.3"}};
+  std::vector<std::unique_ptr<EventHandlerBase> > sweepEventHandlerList;
+  std::vector<EventHandlerBase*> sweepEventHandlerPtrList;
+  for (size_t i = 0; i < parameterList.size(); ++i) {
+    EventHandlerBase eventHandler;
+    this->configureEventHandler(eventHandler);
+    BacktestParameterSweep::setParameter(eventHandler, "SPREAD_PROPORTION_MINIMUM", parameterList.at(i).first);
+    BacktestParameterSweep::setParameter(eventHandler, "ORDER_QUANTITY_PROPORTION", parameterList.at(i).second);
+    sweepEventHandlerList.push_back(EventHandlerBase::clone(eventHandler));
+    this->initEventHandler(eventHandler, "__separate_" + std::to_string(i), true);
+    this->initEventHandler(*sweepEventHandlerList.back(), "__sweep_" + std::to_string(i), false);
+    sweepEventHandlerPtrList.push_back(sweepEventHandlerList.back().get());
+  }
+  BacktestParameterSweep backtestParameterSweep(sweepEventHandlerPtrList, 2, 1000);
+  backtestParameterSweep.run();
+  ASSERT_EQ(this->filePathList.size(), 4);
+  for (size_t i = 0; i < 4; i += 2) {
+    auto separateSummary = this->readFile(this->filePathList.at(i));
+    EXPECT_FALSE(separateSummary.empty());
+    EXPECT_EQ(this->readFile(this->filePathList.at(i + 1)), separateSummary);
+  }
+  EXPECT_NE(this->readFile(this->filePathList.at(0)), this->readFile(this->filePathList.at(2)));
+}
+} /* namespace ccapi */
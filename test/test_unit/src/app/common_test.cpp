@@ -16,4 +16,14 @@ TEST(AppUtilTest, roundInputRoundUp_2) { EXPECT_EQ(AppUtil::roundInput(0.0974990
 
 TEST(AppUtilTest, roundInputRoundDown_2) { EXPECT_EQ(AppUtil::roundInput(0.097499008778091811322, "0.00000001", false), "0.09749900"); }
 
+TEST(AppUtilTest, generateRandomDoubleHonorsBoundsOfEachCall) {
+  for (const auto& bounds : std::vector<std::pair<double, double> >{{0, 1}, {10, 11}, {-5, -4}}) {
+    for (int i = 0; i < 100; ++i) {
+      double x = AppUtil::generateRandomDouble(bounds.first, bounds.second);
+      EXPECT_GE(x, bounds.first);
+      EXPECT_LT(x, bounds.second);
+    }
+  }
+}
+
 } /* namespace ccapi */
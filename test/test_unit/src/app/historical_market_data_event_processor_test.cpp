@@ -1,5 +1,8 @@
 #include "app/historical_market_data_event_processor.h"
 
+#include <cstdio>
+
+#include "ccapi_cpp/ccapi_decimal.h"
 #include "gtest/gtest.h"
 namespace ccapi {
 class HistoricalMarketDataEventProcessorTest : public ::testing::Test {
@@ -168,4 +171,151 @@ TEST_F(HistoricalMarketDataEventProcessorTest, processEvent) {
     }
   }
 }
+
+TEST_F(HistoricalMarketDataEventProcessorTest, processEventBinaryMatchesCsv) {
+  auto processor = this->historicalMarketDataEventProcessor;
+  processor->exchange = "gemini";
+  processor->baseAsset = "eth";
+  processor->quoteAsset = "usd";
+  processor->historicalMarketDataStartDateTp = UtilTime::parse("2021-07-01");
+  processor->historicalMarketDataEndDateTp = UtilTime::parse("2021-07-03");
+  processor->startTimeTp = processor->historicalMarketDataStartDateTp + std::chrono::hours(22);
+  processor->totalDurationSeconds = 4 * 3600;
+  std::string csvDirectory = processor->historicalMarketDataDirectory;
+  std::string binaryDirectory = ::testing::TempDir();
+  std::vector<std::string> binaryFilePathList;
+  for (const auto& date : {"2021-07-01", "2021-07-02"}) {
+    for (const auto& type : {"market-depth", "trade"}) {
+      std::string fileName = std::string("gemini__eth-usd__") + date + "__" + type;
+      binaryFilePathList.push_back(binaryDirectory + "/" + fileName + ".bin");
+      HistoricalMarketDataBinaryFile::convertCsv(csvDirectory + "/" + fileName + ".csv", binaryFilePathList.back());
+    }
+  }
+  processor->processEvent();
+  std::vector<Event> expectedEventList = std::move(this->eventList);
+  this->eventList.clear();
+  processor->historicalMarketDataDirectory = binaryDirectory;
+  processor->historicalMarketDataFileFormat = "binary";
+  processor->processEvent();
+  for (const auto& binaryFilePath : binaryFilePathList) {
+    std::remove(binaryFilePath.c_str());
+  }
+  ASSERT_GT(expectedEventList.size(), 4 * 3600);
+  ASSERT_EQ(this->eventList.size(), expectedEventList.size());
+  for (size_t i = 0; i < expectedEventList.size(); ++i) {
+    const auto& message = this->eventList.at(i).getMessageList().at(0);
+    const auto& expectedMessage = expectedEventList.at(i).getMessageList().at(0);
+    EXPECT_EQ(message.getType(), expectedMessage.getType());
+    EXPECT_EQ(message.getTime(), expectedMessage.getTime());
+    EXPECT_EQ(message.getCorrelationIdList(), expectedMessage.getCorrelationIdList());
+    const auto& elementList = message.getElementList();
+    const auto& expectedElementList = expectedMessage.getElementList();
+    ASSERT_EQ(elementList.size(), expectedElementList.size());
+    for (size_t j = 0; j < expectedElementList.size(); ++j) {
+      const auto& nameValueMap = elementList.at(j).getNameValueMap();
+      const auto& expectedNameValueMap = expectedElementList.at(j).getNameValueMap();
+      ASSERT_EQ(nameValueMap.size(), expectedNameValueMap.size());
+      for (auto it1 = nameValueMap.cbegin(), it2 = expectedNameValueMap.cbegin(); it2 != expectedNameValueMap.cend(); ++it1, ++it2) {
+        EXPECT_EQ(it1->first, it2->first);
+        EXPECT_EQ(Decimal(it1->second).toString(), Decimal(it2->second).toString());
+      }
+    }
+  }
+}
+
+class HistoricalMarketDataBinaryFileTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    std::string base =
+        ::testing::TempDir() + "ccapi_historical_market_data_binary_file_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    this->csvFilePath = base + ".csv";
+    this->binaryFilePath = base + ".bin";
+  }
+  void TearDown() override {
+    std::remove(this->csvFilePath.c_str());
+    std::remove(this->binaryFilePath.c_str());
+  }
+  void writeCsv(const std::string& content) { std::ofstream(this->csvFilePath) << content; }
+  std::string csvFilePath, binaryFilePath;
+};
+
+TEST_F(HistoricalMarketDataBinaryFileTest, convertCsvMarketDepth) {
+  this->writeCsv(
+      "time_seconds,bid_price_bid_size,ask_price_ask_size\n"
+      "1625097600,2271.58_1.6477|2271.5_2,2279.63_28.479526\n"
+      "1625097601,,2279.6_0.1\n"
+      "1625097603,2271.6_3,\n");
+  HistoricalMarketDataBinaryFile::convertCsv(this->csvFilePath, this->binaryFilePath);
+  HistoricalMarketDataBinaryFile file;
+  ASSERT_TRUE(file.open(this->binaryFilePath));
+  EXPECT_EQ(file.getType(), HistoricalMarketDataBinaryFile::Type::MARKET_DEPTH);
+  EXPECT_EQ(file.getNumRows(), 3);
+  EXPECT_EQ(file.getNumColumns(), 11);
+  HistoricalMarketDataRow row;
+  ASSERT_TRUE(file.read(row));
+  EXPECT_EQ(row.getSeconds(), 1625097600);
+  EXPECT_EQ(row.getInteger(HistoricalMarketDataRow::marketDepthNumBidLevelsColumn), 2);
+  EXPECT_EQ(row.getInteger(HistoricalMarketDataRow::marketDepthNumAskLevelsColumn), 1);
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthBidPriceColumn(0)), "2271.58");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthBidSizeColumn(0)), "1.6477");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthBidPriceColumn(1)), "2271.5");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthBidSizeColumn(1)), "2");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthAskPriceColumn(0)), "2279.63");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthAskSizeColumn(0)), "28.479526");
+  ASSERT_TRUE(file.read(row));
+  EXPECT_EQ(row.getSeconds(), 1625097601);
+  EXPECT_EQ(row.getInteger(HistoricalMarketDataRow::marketDepthNumBidLevelsColumn), 0);
+  EXPECT_EQ(row.getInteger(HistoricalMarketDataRow::marketDepthNumAskLevelsColumn), 1);
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthAskPriceColumn(0)), "2279.6");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthAskSizeColumn(0)), "0.1");
+  ASSERT_TRUE(file.read(row));
+  EXPECT_EQ(row.getSeconds(), 1625097603);
+  EXPECT_EQ(row.getInteger(HistoricalMarketDataRow::marketDepthNumBidLevelsColumn), 1);
+  EXPECT_EQ(row.getInteger(HistoricalMarketDataRow::marketDepthNumAskLevelsColumn), 0);
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthBidPriceColumn(0)), "2271.6");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::getMarketDepthBidSizeColumn(0)), "3");
+  EXPECT_FALSE(file.read(row));
+}
+
+TEST_F(HistoricalMarketDataBinaryFileTest, convertCsvTrade) {
+  this->writeCsv(
+      "time_seconds,price,size,is_buyer_maker\n"
+      "1625097621.647,2278.15,0.0409,1\n"
+      "1625097621.9,2272,3.6456,0\n");
+  HistoricalMarketDataBinaryFile::convertCsv(this->csvFilePath, this->binaryFilePath);
+  HistoricalMarketDataBinaryFile file;
+  ASSERT_TRUE(file.open(this->binaryFilePath));
+  EXPECT_EQ(file.getType(), HistoricalMarketDataBinaryFile::Type::TRADE);
+  HistoricalMarketDataRow row;
+  ASSERT_TRUE(file.read(row));
+  EXPECT_EQ(row.getSecondsAndNanoseconds(), std::make_pair(1625097621LL, 647000000LL));
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::tradePriceColumn), "2278.15");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::tradeSizeColumn), "0.0409");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::tradeIsBuyerMakerColumn), "1");
+  ASSERT_TRUE(file.read(row));
+  EXPECT_EQ(row.getSeconds(), 1625097621);
+  EXPECT_EQ(row.getSecondsAndNanoseconds(), std::make_pair(1625097621LL, 900000000LL));
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::tradePriceColumn), "2272");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::tradeSizeColumn), "3.6456");
+  EXPECT_EQ(row.getString(HistoricalMarketDataRow::tradeIsBuyerMakerColumn), "0");
+  EXPECT_FALSE(file.read(row));
+}
+
+TEST_F(HistoricalMarketDataBinaryFileTest, openMissingOrInvalidFile) {
+  HistoricalMarketDataBinaryFile file;
+  EXPECT_FALSE(file.open(this->binaryFilePath));
+  this->writeCsv("time_seconds,price,size,is_buyer_maker\n");
+  EXPECT_THROW(file.open(this->csvFilePath), std::runtime_error);
+}
+
+TEST(HistoricalMarketDataRowTest, getString) {
+  HistoricalMarketDataRow row;
+  row.valueList = {-5, 0, 227150, 1200, 7};
+  row.numDecimalPlacesList = {3, 2, 2, 0, 1};
+  EXPECT_EQ(row.getString(0), "-0.005");
+  EXPECT_EQ(row.getString(1), "0");
+  EXPECT_EQ(row.getString(2), "2271.5");
+  EXPECT_EQ(row.getString(3), "1200");
+  EXPECT_EQ(row.getString(4), "0.7");
+}
 } /* namespace ccapi */
@@ -91,4 +91,27 @@ TEST(DecimalTest, subtract_51) { EXPECT_EQ(Decimal("42839.6").subtract(Decimal("
 TEST(DecimalTest, subtract_52) { EXPECT_EQ(Decimal("42839").subtract(Decimal("0.1")).toString(), "42838.9"); }
 TEST(DecimalTest, subtract_61) { EXPECT_EQ(Decimal("0.0135436").subtract(Decimal("0.0135436")).toString(), "0"); }
 TEST(DecimalTest, subtract_62) { EXPECT_EQ(Decimal("1").subtract(Decimal("1")).toString(), "0"); }
+TEST(DecimalTest, keepTrailingZero) {
+  EXPECT_EQ(Decimal("0.10", true).toString(), "0.10");
+  EXPECT_EQ(Decimal("1.0", true).toString(), "1.0");
+  EXPECT_EQ(Decimal("1.50e1", true).toString(), "15");
+  EXPECT_TRUE(Decimal("0.10", true) == Decimal("0.1"));
+}
+TEST(DecimalTest, compareNegative) {
+  EXPECT_TRUE(Decimal("-1.5") < Decimal("-1.25"));
+  EXPECT_TRUE(Decimal("-1") < Decimal("0"));
+  EXPECT_FALSE(Decimal("-0") < Decimal("0"));
+  EXPECT_TRUE(Decimal("-2") < Decimal("-1.99"));
+}
+TEST(DecimalTest, maxFracLength) {
+  EXPECT_EQ(Decimal("0.9999999999999999999").toString(), "0.9999999999999999999");
+  EXPECT_EQ(Decimal("0.9999999999999999999").add(Decimal("0.9999999999999999999")).toString(), "1.9999999999999999998");
+  EXPECT_EQ(Decimal("18446744073709551615").toString(), "18446744073709551615");
+}
+TEST(DecimalTest, constructFromCharPointer) {
+  const char* data = "123.4500xyz";
+  EXPECT_EQ(Decimal(data, 8, false).toString(), "123.45");
+  EXPECT_EQ(Decimal(data, 8, true).toString(), "123.4500");
+  EXPECT_EQ(Decimal(std::string_view(data, 3)).toString(), "123");
+}
 } /* namespace ccapi */
@@ -0,0 +1,54 @@
+#include "ccapi_cpp/ccapi_element.h"
+
+#include "gtest/gtest.h"
+namespace ccapi {
+TEST(ElementTest, insertDoesNotOverwrite) {
+  Element element;
+  element.insert("BID_PRICE", "1");
+  element.insert("BID_PRICE", "2");
+  std::string name("BID_SIZE");
+  std::string value("3");
+  element.emplace(name, value);
+  EXPECT_TRUE(element.has("BID_PRICE"));
+  EXPECT_FALSE(element.has("ASK_PRICE"));
+  EXPECT_EQ(element.getValue("BID_PRICE"), "1");
+  EXPECT_EQ(element.getValue("BID_SIZE"), "3");
+  EXPECT_EQ(element.getValue("ASK_PRICE", "x"), "x");
+  EXPECT_EQ(element.getNameValueList().size(), 2);
+}
+TEST(ElementTest, getNameValueMapIsSorted) {
+  Element element;
+  element.insert("b", "2");
+  element.insert("a", "1");
+  EXPECT_EQ(element.getNameValueList().front().first, "b");
+  std::map<std::string, std::string> expected{{"a", "1"}, {"b", "2"}};
+  EXPECT_EQ(element.getNameValueMap(), expected);
+  EXPECT_EQ(element.toString(), "Element [nameValueMap = {a=1, b=2}]");
+}
+TEST(ElementTest, getNameValueMapIsCachedUntilModified) {
+  Element element;
+  element.insert("a", "1");
+  const auto& nameValueMap = element.getNameValueMap();
+  EXPECT_EQ(&element.getNameValueMap(), &nameValueMap);
+  Element copy = element;
+  copy.insert("b", "2");
+  EXPECT_EQ(element.getNameValueMap(), (std::map<std::string, std::string>{{"a", "1"}}));
+  EXPECT_EQ(copy.getNameValueMap(), (std::map<std::string, std::string>{{"a", "1"}, {"b", "2"}}));
+  element.insert("a", "3");
+  EXPECT_EQ(&element.getNameValueMap(), &nameValueMap);
+  std::string name("c");
+  std::string value("4");
+  element.emplace(name, value);
+  EXPECT_EQ(element.getNameValueMap(), (std::map<std::string, std::string>{{"a", "1"}, {"c", "4"}}));
+}
+TEST(ElementTest, tag) {
+  Element element(true);
+  element.insert(35, "8");
+  std::string value("A");
+  element.emplace(39, value);
+  element.insert(35, "9");
+  EXPECT_TRUE(element.has(39));
+  EXPECT_EQ(element.getValue(35), "8");
+  EXPECT_EQ(element.getTagValueMap(), (std::map<int, std::string>{{35, "8"}, {39, "A"}}));
+}
+} /* namespace ccapi */
@@ -0,0 +1,96 @@
+#include "ccapi_cpp/ccapi_event_dispatcher.h"
+
+#include <chrono>
+#include <map>
+
+#include "gtest/gtest.h"
+namespace ccapi {
+TEST(EventDispatcherTest, dispatch) {
+  EventDispatcher eventDispatcher(2);
+  std::atomic<int> count{};
+  for (int i = 0; i < 1000; ++i) {
+    eventDispatcher.dispatch([&count] { ++count; });
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (count.load() < 1000 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  eventDispatcher.stop();
+  EXPECT_EQ(count.load(), 1000);
+}
+TEST(EventDispatcherTest, shardedDispatchKeepsOrderPerKey) {
+  EventDispatcher eventDispatcher(4, 8);
+  EXPECT_EQ(eventDispatcher.getNumShards(), 8);
+  const int numKeys = 16;
+  const int numOperationsPerKey = 2000;
+  std::vector<std::vector<int> > resultList(numKeys);
+  std::atomic<int> count{};
+  std::vector<std::thread> producerList;
+  for (int k = 0; k < numKeys; ++k) {
+    producerList.emplace_back([&, k] {
+      for (int i = 0; i < numOperationsPerKey; ++i) {
+        eventDispatcher.dispatch("correlationId" + std::to_string(k), [&, k, i] {
+          resultList[k].push_back(i);
+          ++count;
+        });
+      }
+    });
+  }
+  for (auto& producer : producerList) {
+    producer.join();
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (count.load() < numKeys * numOperationsPerKey && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  eventDispatcher.stop();
+  ASSERT_EQ(count.load(), numKeys * numOperationsPerKey);
+  for (int k = 0; k < numKeys; ++k) {
+    ASSERT_EQ(resultList[k].size(), numOperationsPerKey);
+    for (int i = 0; i < numOperationsPerKey; ++i) {
+      EXPECT_EQ(resultList[k][i], i);
+    }
+  }
+}
+TEST(EventDispatcherTest, shardedDispatchRunsShardsInParallel) {
+  EventDispatcher eventDispatcher(2, 2);
+  std::atomic<bool> firstStarted{};
+  std::atomic<bool> secondDone{};
+  std::string firstKey = "a";
+  std::string secondKey = "b";
+  while (std::hash<std::string>()(secondKey) % 2 == std::hash<std::string>()(firstKey) % 2) {
+    secondKey += "b";
+  }
+  eventDispatcher.dispatch(firstKey, [&] {
+    firstStarted = true;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!secondDone.load() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+  });
+  while (!firstStarted.load()) {
+    std::this_thread::yield();
+  }
+  eventDispatcher.dispatch(secondKey, [&] { secondDone = true; });
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!secondDone.load() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  EXPECT_TRUE(secondDone.load());
+  eventDispatcher.stop();
+}
+TEST(EventDispatcherTest, pauseDropsOperations) {
+  EventDispatcher eventDispatcher(1, 1);
+  std::atomic<int> count{};
+  eventDispatcher.pause();
+  eventDispatcher.dispatch("x", [&count] { ++count; });
+  eventDispatcher.resume();
+  eventDispatcher.dispatch("x", [&count] { ++count; });
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (count.load() < 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  eventDispatcher.stop();
+  EXPECT_EQ(count.load(), 1);
+}
+} /* namespace ccapi */
@@ -0,0 +1,75 @@
+#include "ccapi_cpp/ccapi_fix_journal.h"
+
+#include <cstdio>
+
+#include "gtest/gtest.h"
+namespace ccapi {
+class FixJournalTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    this->filePath = ::testing::TempDir() + "ccapi_fix_journal_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".journal";
+    std::remove(this->filePath.c_str());
+  }
+  void TearDown() override { std::remove(this->filePath.c_str()); }
+  static std::vector<std::pair<int64_t, std::string> > readAll(const FixJournal& fixJournal, int64_t beginSeqNo, int64_t endSeqNo) {
+    std::vector<std::pair<int64_t, std::string> > output;
+    fixJournal.forEachMessage(beginSeqNo, endSeqNo, [&output](int64_t msgSeqNum, const char* message, size_t numBytes) {
+      output.emplace_back(msgSeqNum, std::string(message, numBytes));
+    });
+    return output;
+  }
+  std::string filePath;
+};
+TEST_F(FixJournalTest, appendAndReplayRange) {
+  FixJournal fixJournal(this->filePath, 4096);
+  EXPECT_EQ(fixJournal.getLastSequenceSent(), 0);
+  EXPECT_EQ(fixJournal.getLastSequenceReceived(), 0);
+  for (int i = 1; i <= 5; ++i) {
+    std::string message = "message " + std::to_string(i);
+    EXPECT_TRUE(fixJournal.append(i, message.data(), message.size()));
+  }
+  fixJournal.setLastSequenceReceived(7);
+  EXPECT_EQ(fixJournal.getLastSequenceSent(), 5);
+  EXPECT_EQ(fixJournal.getLastSequenceReceived(), 7);
+  auto output = readAll(fixJournal, 2, 4);
+  ASSERT_EQ(output.size(), 3);
+  EXPECT_EQ(output[0], std::make_pair(int64_t(2), std::string("message 2")));
+  EXPECT_EQ(output[2], std::make_pair(int64_t(4), std::string("message 4")));
+  EXPECT_EQ(readAll(fixJournal, 4, 0).size(), 2);
+  EXPECT_TRUE(readAll(fixJournal, 6, 0).empty());
+}
+TEST_F(FixJournalTest, survivesReopen) {
+  {
+    FixJournal fixJournal(this->filePath, 4096);
+    std::string message = "8=FIX.4.2\x01" "35=D\x01";
+    fixJournal.append(1, message.data(), message.size());
+    fixJournal.append(2, message.data(), message.size());
+    fixJournal.setLastSequenceReceived(3);
+  }
+  FixJournal fixJournal(this->filePath, 4096);
+  EXPECT_EQ(fixJournal.getLastSequenceSent(), 2);
+  EXPECT_EQ(fixJournal.getLastSequenceReceived(), 3);
+  EXPECT_EQ(fixJournal.getNumMessages(), 2);
+  auto output = readAll(fixJournal, 2, 2);
+  ASSERT_EQ(output.size(), 1);
+  EXPECT_EQ(output[0].second, "8=FIX.4.2\x01" "35=D\x01");
+  fixJournal.reset();
+  EXPECT_EQ(fixJournal.getLastSequenceSent(), 0);
+  EXPECT_EQ(fixJournal.getNumMessages(), 0);
+}
+TEST_F(FixJournalTest, fullJournalKeepsSequenceNumber) {
+  FixJournal fixJournal(this->filePath, 128);
+  std::string message(64, 'x');
+  EXPECT_TRUE(fixJournal.append(1, message.data(), message.size()));
+  EXPECT_FALSE(fixJournal.append(2, message.data(), message.size()));
+  EXPECT_EQ(fixJournal.getLastSequenceSent(), 2);
+  EXPECT_EQ(fixJournal.getNumMessages(), 1);
+}
+TEST_F(FixJournalTest, rejectsOtherFiles) {
+  {
+    std::ofstream ofs(this->filePath, std::ios::binary);
+    ofs << std::string(256, 'x');
+  }
+  EXPECT_THROW(FixJournal(this->filePath, 4096), std::runtime_error);
+}
+} /* namespace ccapi */
@@ -14,4 +14,28 @@ TEST(HmacTest, hmac256) {
       "1610078918POST/orders{\"size\": \"0.00005\", \"price\": \"20000\", \"side\": \"buy\", \"product_id\": \"BTC-USD\"}", false));
   EXPECT_EQ(result, "oh4uOQrCJXLUV1rmcnQvL6BTdqdcE5MYu0Q7osUH3ug=");
 }
+TEST(HmacTest, keyMatchesHmac) {
+  std::string longKey(200, 'k');
+  for (auto shaVersion : {Hmac::ShaVersion::SHA1, Hmac::ShaVersion::SHA224, Hmac::ShaVersion::SHA256, Hmac::ShaVersion::SHA384, Hmac::ShaVersion::SHA512}) {
+    for (const std::string& key : {std::string("key"), longKey}) {
+      Hmac::Key hmacKey(shaVersion, key);
+      for (const std::string& message : {std::string(), std::string("The quick brown fox jumps over the lazy dog"), std::string(1000, 'm')}) {
+        EXPECT_EQ(hmacKey.sign(message, true), Hmac::hmac(shaVersion, key, message, true));
+        EXPECT_EQ(hmacKey.sign(message), Hmac::hmac(shaVersion, key, message));
+      }
+    }
+  }
+}
+TEST(HmacTest, keyAppendsToOutput) {
+  Hmac::Key hmacKey(Hmac::ShaVersion::SHA256, "NhqPtmdSJYdKjVHjA7PZj4Mge3R5YNiP1e3UZjInClVN65XAbvqqM6A7H5fATj0j");
+  std::string queryString = "symbol=LTCBTC&side=BUY&type=LIMIT&timeInForce=GTC&quantity=1&price=0.1&recvWindow=5000&timestamp=1499827319559";
+  std::string output = queryString;
+  hmacKey.appendHex(output, output);
+  EXPECT_EQ(output, queryString + "c8db56825ae71d6d79447849e617115f4a920fa2acdcab2b053c4b2838bd6b71");
+  Hmac::Key base64HmacKey(Hmac::ShaVersion::SHA256,
+                          UtilAlgorithm::base64Decode("+xT7GWTDRHi09EZEhkOC8S7ktzngKtoT1ZoZ6QclGURlq3ePfUd7kLQzK4+P54685NEqYDaIerYj9cuYFILOhQ=="));
+  output = "sign=";
+  base64HmacKey.appendBase64(output, "1610078918POST/orders{\"size\": \"0.00005\", \"price\": \"20000\", \"side\": \"buy\", \"product_id\": \"BTC-USD\"}");
+  EXPECT_EQ(output, "sign=oh4uOQrCJXLUV1rmcnQvL6BTdqdcE5MYu0Q7osUH3ug=");
+}
 } /* namespace ccapi */
@@ -0,0 +1,41 @@
+#include "ccapi_cpp/ccapi_latency_histogram.h"
+
+#include "gtest/gtest.h"
+namespace ccapi {
+TEST(LatencyHistogramTest, bucketIndexRoundTrip) {
+  for (uint64_t value : {0ULL, 1ULL, 31ULL, 32ULL, 33ULL, 1000ULL, 123456789ULL, 1ULL << 40}) {
+    int index = LatencyHistogram::bucketIndex(value);
+    EXPECT_LT(index, LatencyHistogram::numBuckets);
+    uint64_t highest = LatencyHistogram::highestEquivalentValue(index);
+    EXPECT_GE(highest, value);
+    EXPECT_EQ(LatencyHistogram::bucketIndex(highest), index);
+    EXPECT_LE(highest - value, value >> (LatencyHistogram::subBucketBits - 1));
+  }
+  EXPECT_EQ(LatencyHistogram::bucketIndex(31), 31);
+  EXPECT_EQ(LatencyHistogram::bucketIndex(32), LatencyHistogram::bucketIndex(33));
+  EXPECT_LT(LatencyHistogram::bucketIndex(~0ULL), LatencyHistogram::numBuckets);
+}
+TEST(LatencyHistogramTest, percentile) {
+  LatencyHistogram latencyHistogram;
+  EXPECT_EQ(latencyHistogram.getValueAtPercentile(50), 0);
+  for (int i = 1; i <= 1000; ++i) {
+    latencyHistogram.record(i * 1000);
+  }
+  EXPECT_EQ(latencyHistogram.getCount(), 1000);
+  EXPECT_EQ(latencyHistogram.getMax(), 1000000);
+  EXPECT_NEAR(latencyHistogram.getValueAtPercentile(50), 500000, 500000 / 16);
+  EXPECT_NEAR(latencyHistogram.getValueAtPercentile(99), 990000, 990000 / 16);
+  EXPECT_EQ(latencyHistogram.getValueAtPercentile(100), 1000000);
+  latencyHistogram.reset();
+  EXPECT_EQ(latencyHistogram.getCount(), 0);
+  EXPECT_EQ(latencyHistogram.getMax(), 0);
+}
+TEST(LatencyHistogramTest, recordSmallAndNegativeValuesExactly) {
+  LatencyHistogram latencyHistogram;
+  latencyHistogram.record(-5);
+  latencyHistogram.record(7);
+  EXPECT_EQ(latencyHistogram.getValueAtPercentile(50), 0);
+  EXPECT_EQ(latencyHistogram.getValueAtPercentile(100), 7);
+  EXPECT_EQ(LatencyHistogram::stageToString(LatencyHistogram::Stage::DISPATCH), "DISPATCH");
+}
+} /* namespace ccapi */
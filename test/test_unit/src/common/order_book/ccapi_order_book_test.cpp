@@ -0,0 +1,204 @@
+#include "ccapi_cpp/ccapi_order_book.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+namespace ccapi {
+TEST(OrderBookTest, parse) {
+  int64_t mantissa;
+  int digits;
+  OrderBook::parse("123.4500", 8, mantissa, digits, false);
+  EXPECT_EQ(mantissa, 12345);
+  EXPECT_EQ(digits, 2);
+  OrderBook::parse("123.4500", 8, mantissa, digits, true);
+  EXPECT_EQ(mantissa, 1234500);
+  EXPECT_EQ(digits, 4);
+  OrderBook::parse("-0.001", 6, mantissa, digits, false);
+  EXPECT_EQ(mantissa, -1);
+  EXPECT_EQ(digits, 3);
+  OrderBook::parse("100", 3, mantissa, digits, false);
+  EXPECT_EQ(mantissa, 100);
+  EXPECT_EQ(digits, 0);
+}
+TEST(OrderBookTest, parseScientificNotation) {
+  int64_t mantissa;
+  int digits;
+  OrderBook::parse("1.51e-6", 7, mantissa, digits, false);
+  EXPECT_EQ(mantissa, 151);
+  EXPECT_EQ(digits, 8);
+  OrderBook::parse("2.00600e+003", 12, mantissa, digits, true);
+  EXPECT_EQ(mantissa, 2006);
+  EXPECT_EQ(digits, 0);
+  OrderBook::parse("1.5E2", 5, mantissa, digits, false);
+  EXPECT_EQ(mantissa, 150);
+  EXPECT_EQ(digits, 0);
+}
+TEST(OrderBookTest, append) {
+  std::string output;
+  OrderBook::append(output, 12345, 2);
+  EXPECT_EQ(output, "123.45");
+  output.clear();
+  OrderBook::append(output, -5, 3);
+  EXPECT_EQ(output, "-0.005");
+  output.clear();
+  OrderBook::append(output, 0, 0);
+  EXPECT_EQ(output, "0");
+}
+TEST(OrderBookTest, updateKeepsBestLevelAtBack) {
+  OrderBook orderBook;
+  orderBook.update(true, "100", "1");
+  orderBook.update(true, "101.5", "2");
+  orderBook.update(true, "99.25", "3");
+  orderBook.update(false, "103", "1");
+  orderBook.update(false, "102.75", "2");
+  EXPECT_EQ(orderBook.getPriceScale(), 2);
+  ASSERT_EQ(orderBook.getBids().size(), 3);
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().back()), "101.5");
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().front()), "99.25");
+  ASSERT_EQ(orderBook.getAsks().size(), 2);
+  EXPECT_EQ(orderBook.priceToString(orderBook.getAsks().back()), "102.75");
+  EXPECT_EQ(OrderBook::sizeToString(orderBook.getAsks().back()), "2");
+  EXPECT_FALSE(orderBook.isCrossed());
+  orderBook.update(true, "101.5", "0");
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().back()), "100");
+}
+TEST(OrderBookTest, sizeKeepsTrailingZero) {
+  OrderBook orderBook;
+  orderBook.update(false, "1.10", "0.00100000");
+  EXPECT_EQ(OrderBook::sizeToString(orderBook.getAsks().back()), "0.00100000");
+  orderBook.update(false, "1.1", "0.000");
+  EXPECT_TRUE(orderBook.getAsks().empty());
+}
+TEST(OrderBookTest, priceKeepsTrailingZero) {
+  OrderBook orderBook;
+  orderBook.update(true, "1.10", "1", true);
+  orderBook.update(true, "1.2", "1", true);
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().front()), "1.10");
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().back()), "1.2");
+}
+TEST(OrderBookTest, insertUnsortedAndSort) {
+  OrderBook orderBook;
+  orderBook.insertUnsorted(false, "3", "1");
+  orderBook.insertUnsorted(false, "1", "1");
+  orderBook.insertUnsorted(false, "2", "0");
+  orderBook.insertUnsorted(false, "1", "2");
+  orderBook.sort();
+  ASSERT_EQ(orderBook.getAsks().size(), 2);
+  EXPECT_EQ(orderBook.priceToString(orderBook.getAsks().back()), "1");
+  EXPECT_EQ(OrderBook::sizeToString(orderBook.getAsks().back()), "1");
+  EXPECT_EQ(orderBook.priceToString(orderBook.getAsks().front()), "3");
+}
+TEST(OrderBookTest, keepTopNAndCopyTopN) {
+  OrderBook orderBook;
+  for (int i = 1; i <= 5; ++i) {
+    orderBook.update(true, std::to_string(i), "1");
+    orderBook.update(false, std::to_string(i + 5), "1");
+  }
+  OrderBook copy;
+  orderBook.copyTopN(copy, 2);
+  EXPECT_EQ(copy.topNToString(10), "OrderBook [priceScale = 0, bid = [5:1, 4:1], ask = [6:1, 7:1]]");
+  EXPECT_TRUE(orderBook.topNSame(true, copy, 2));
+  EXPECT_FALSE(orderBook.topNSame(true, copy, 3));
+  orderBook.keepTopN(3);
+  EXPECT_EQ(orderBook.toString(), "OrderBook [priceScale = 0, bid = [5:1, 4:1, 3:1], ask = [6:1, 7:1, 8:1]]");
+}
+TEST(OrderBookTest, comparePriceAcrossScales) {
+  OrderBook a;
+  a.update(true, "1.5", "1");
+  OrderBook b;
+  b.update(true, "1.50001", "1");
+  EXPECT_LT(a.comparePrice(a.getBids().back(), b, b.getBids().back()), 0);
+  EXPECT_GT(b.comparePrice(b.getBids().back(), a, a.getBids().back()), 0);
+  b.update(true, "1.5", "1");
+  EXPECT_EQ(a.comparePrice(a.getBids().back(), b, b.getBids().front()), 0);
+}
+TEST(OrderBookTest, trackTopNChange) {
+  OrderBook orderBook;
+  for (int i = 1; i <= 5; ++i) {
+    orderBook.update(true, std::to_string(i), "1");
+    orderBook.update(false, std::to_string(i + 5), "1");
+  }
+  orderBook.startTrackingTopN(2);
+  orderBook.update(true, "2", "3");
+  orderBook.update(false, "9", "2");
+  EXPECT_FALSE(orderBook.topNChanged(true));
+  EXPECT_FALSE(orderBook.topNChanged(false));
+  orderBook.update(true, "5", "0");
+  orderBook.update(false, "5.5", "2");
+  std::string output;
+  for (bool isBid : {true, false}) {
+    orderBook.forEachTopNChange(isBid, [&](const OrderBook::Level& level, bool isRemoved) {
+      output += orderBook.priceToString(level) + ":" + (isRemoved ? std::string("0") : OrderBook::sizeToString(level)) + " ";
+    });
+  }
+  EXPECT_EQ(output, "3:1 5:0 5.5:2 7:0 ");
+  EXPECT_TRUE(orderBook.topNChanged(true));
+  EXPECT_TRUE(orderBook.topNChanged(false));
+}
+TEST(OrderBookTest, trackTopNChangeMatchesCopy) {
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> priceDistribution(1, 30);
+  std::uniform_int_distribution<int> sizeDistribution(0, 3);
+  std::uniform_int_distribution<int> actionDistribution(0, 19);
+  OrderBook orderBook;
+  for (int round = 0; round < 2000; ++round) {
+    const size_t n = 1 + round % 5;
+    OrderBook copy;
+    orderBook.copyTopN(copy, n);
+    orderBook.startTrackingTopN(n);
+    const int numUpdates = 1 + round % 4;
+    for (int i = 0; i < numUpdates; ++i) {
+      bool isBid = actionDistribution(generator) % 2 == 0;
+      int action = actionDistribution(generator);
+      if (action == 0) {
+        orderBook.clear(isBid);
+      } else if (action == 1) {
+        orderBook.keepTopN(n - 1 + actionDistribution(generator) % 3);
+      } else if (action == 2) {
+        orderBook.update(isBid, std::to_string(priceDistribution(generator)) + ".25", std::to_string(sizeDistribution(generator)));
+      } else {
+        orderBook.update(isBid, std::to_string(isBid ? priceDistribution(generator) : priceDistribution(generator) + 30),
+                         std::to_string(sizeDistribution(generator)));
+      }
+    }
+    for (bool isBid : {true, false}) {
+      ASSERT_EQ(orderBook.topNChanged(isBid), !orderBook.topNSame(isBid, copy, n)) << round;
+      std::string actualOutput;
+      orderBook.forEachTopNChange(isBid, [&](const OrderBook::Level& level, bool isRemoved) {
+        actualOutput += orderBook.priceToString(level) + ":" + (isRemoved ? std::string("0") : OrderBook::sizeToString(level)) + " ";
+      });
+      std::map<std::string, std::string> current;
+      std::map<std::string, std::string> previous;
+      const auto& side = orderBook.getSide(isBid);
+      for (size_t i = 0; i < n && i < side.size(); ++i) {
+        current[orderBook.priceToString(side[side.size() - 1 - i])] = OrderBook::sizeToString(side[side.size() - 1 - i]);
+      }
+      const auto& copySide = copy.getSide(isBid);
+      for (const auto& level : copySide) {
+        previous[copy.priceToString(level)] = OrderBook::sizeToString(level);
+      }
+      std::vector<std::pair<double, std::string> > expectedList;
+      for (const auto& x : current) {
+        auto it = previous.find(x.first);
+        if (it == previous.end() || it->second != x.second) {
+          expectedList.emplace_back(std::stod(x.first), x.first + ":" + x.second + " ");
+        }
+      }
+      for (const auto& x : previous) {
+        if (current.find(x.first) == current.end()) {
+          expectedList.emplace_back(std::stod(x.first), x.first + ":0 ");
+        }
+      }
+      std::sort(expectedList.begin(), expectedList.end());
+      std::string expectedOutput;
+      for (const auto& x : expectedList) {
+        expectedOutput += x.second;
+      }
+      ASSERT_EQ(actualOutput, expectedOutput) << round;
+    }
+    orderBook.stopTrackingTopN();
+  }
+}
+} /* namespace ccapi */
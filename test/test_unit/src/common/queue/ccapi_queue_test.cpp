@@ -0,0 +1,75 @@
+#include "ccapi_cpp/ccapi_queue.h"
+
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+namespace ccapi {
+TEST(QueueTest, pushBackMovesElement) {
+  Queue<std::unique_ptr<int>> queue;
+  queue.pushBack(std::unique_ptr<int>(new int(1)));
+  queue.pushBack(std::unique_ptr<int>(new int(2)));
+  EXPECT_EQ(queue.size(), 2);
+  std::vector<std::unique_ptr<int>> output = queue.purge();
+  ASSERT_EQ(output.size(), 2);
+  EXPECT_EQ(*output.at(0), 1);
+  EXPECT_EQ(*output.at(1), 2);
+  EXPECT_TRUE(queue.empty());
+}
+TEST(QueueTest, removeAllAppends) {
+  Queue<int> queue;
+  std::vector<int> output{0};
+  queue.pushBack(1);
+  queue.pushBack(2);
+  queue.removeAll(output);
+  EXPECT_EQ(output, std::vector<int>({0, 1, 2}));
+  queue.pushBack(3);
+  queue.removeAll(output);
+  EXPECT_EQ(output, std::vector<int>({0, 1, 2, 3}));
+}
+TEST(QueueTest, throwWhenFull) {
+  Queue<int> queue(2);
+  queue.pushBack(1);
+  queue.pushBack(2);
+  EXPECT_THROW(queue.pushBack(3), std::runtime_error);
+  EXPECT_EQ(queue.purge().size(), 2);
+  queue.pushBack(3);
+  EXPECT_EQ(queue.purge(), std::vector<int>({3}));
+}
+TEST(QueueTest, removeAllWithTimeout) {
+  Queue<int> queue;
+  std::vector<int> output;
+  EXPECT_EQ(queue.removeAll(output, Queue<int>::WaitStrategy::BUSY_POLL, std::chrono::milliseconds(1)), 0);
+  std::thread producer([&queue] { queue.pushBack(1); });
+  size_t n = 0;
+  while (n == 0) {
+    n = queue.removeAll(output, Queue<int>::WaitStrategy::YIELD, std::chrono::seconds(1));
+  }
+  producer.join();
+  EXPECT_EQ(output, std::vector<int>({1}));
+}
+TEST(QueueTest, multipleProducers) {
+  Queue<int> queue(1 << 12);
+  std::vector<std::thread> producerList;
+  for (int i = 0; i < 4; ++i) {
+    producerList.emplace_back([&queue, i] {
+      for (int j = 0; j < 1000; ++j) {
+        queue.pushBack(i * 1000 + j);
+      }
+    });
+  }
+  std::vector<int> output;
+  while (output.size() < 4000) {
+    queue.removeAll(output, Queue<int>::WaitStrategy::YIELD, std::chrono::milliseconds(10));
+  }
+  for (auto& producer : producerList) {
+    producer.join();
+  }
+  std::vector<int> lastByProducer(4, -1);
+  for (int x : output) {
+    EXPECT_GT(x % 1000, lastByProducer.at(x / 1000));
+    lastByProducer.at(x / 1000) = x % 1000;
+  }
+  EXPECT_EQ(lastByProducer, std::vector<int>(4, 999));
+}
+} /* namespace ccapi */
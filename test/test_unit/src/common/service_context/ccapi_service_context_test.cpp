@@ -0,0 +1,51 @@
+#include "boost/asio/executor_work_guard.hpp"
+#include "boost/asio/io_context.hpp"
+#include "boost/asio/post.hpp"
+#include "boost/asio/ssl.hpp"
+#include "ccapi_cpp/service/ccapi_service_context.h"
+
+#include <atomic>
+#include <set>
+
+#include "gtest/gtest.h"
+namespace ccapi {
+TEST(ServiceContextTest, nextServiceContextPtrWithoutPool) {
+  ServiceContext serviceContext;
+  EXPECT_EQ(serviceContext.nextServiceContextPtr(), &serviceContext);
+  EXPECT_EQ(serviceContext.nextServiceContextPtr(), &serviceContext);
+}
+TEST(ServiceContextTest, nextServiceContextPtrRoundRobin) {
+  ServiceContext serviceContext(3);
+  ServiceContext* a = serviceContext.nextServiceContextPtr();
+  ServiceContext* b = serviceContext.nextServiceContextPtr();
+  ServiceContext* c = serviceContext.nextServiceContextPtr();
+  EXPECT_EQ(a, &serviceContext);
+  EXPECT_NE(b, a);
+  EXPECT_NE(c, a);
+  EXPECT_NE(c, b);
+  EXPECT_NE(b->ioContextPtr, a->ioContextPtr);
+  EXPECT_EQ(b->sslContextPtr, a->sslContextPtr);
+  EXPECT_EQ(serviceContext.nextServiceContextPtr(), a);
+}
+TEST(ServiceContextTest, eachIoContextRunsOnItsOwnThread) {
+  ServiceContext serviceContext(3);
+  std::thread t([&serviceContext] { serviceContext.start(); });
+  std::mutex m;
+  std::set<std::thread::id> threadIdSet;
+  std::atomic<int> count{};
+  for (int i = 0; i < 3; ++i) {
+    boost::asio::post(*serviceContext.nextServiceContextPtr()->ioContextPtr, [&] {
+      std::lock_guard<std::mutex> lock(m);
+      threadIdSet.insert(std::this_thread::get_id());
+      ++count;
+    });
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (count.load() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  serviceContext.stop();
+  t.join();
+  EXPECT_EQ(threadIdSet.size(), 3);
+}
+} /* namespace ccapi */
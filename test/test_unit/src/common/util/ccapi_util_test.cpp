@@ -29,6 +29,21 @@ TEST(UtilAlgorithmTest, base64FromBase64Url) {
   auto result = UtilAlgorithm::base64FromBase64Url(original);
   EXPECT_EQ(result, "TJVA95OrM7E2cBab30RMHrHDcEfxjoYZgeFONFh7HgQ=");
 }
+TEST(UtilAlgorithmTest, crc32) {
+  std::string input("The quick brown fox jumps over the lazy dog");
+  EXPECT_EQ(UtilAlgorithm::crc32(input.data(), input.size()), 0x414FA339u);
+  EXPECT_EQ(UtilAlgorithm::crc32(input.data(), 0), 0u);
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::string data;
+  for (size_t size = 0; size < 300; ++size) {
+    uint32_t expected = UtilAlgorithm::crc(data.begin(), data.end());
+    EXPECT_EQ(UtilAlgorithm::crc32(data.data(), data.size()), expected) << size;
+    size_t split = size / 3;
+    EXPECT_EQ(UtilAlgorithm::crc32(data.data() + split, data.size() - split, UtilAlgorithm::crc32(data.data(), split)), expected) << size;
+    data += static_cast<char>(distribution(generator));
+  }
+}
 TEST(UtilStringTest, roundInputBySignificantFigure) {
   EXPECT_EQ(UtilString::roundInputBySignificantFigure(12345.01, 5, 1), "12346");
   EXPECT_EQ(UtilString::roundInputBySignificantFigure(12345.01, 5, -1), "12345");
@@ -200,6 +215,37 @@ TEST(UtilTimeTest, getISOTimestamp_11) {
   std::string str("2019-11-21T01:38:23Z");
   EXPECT_EQ(UtilTime::getISOTimestamp<std::chrono::milliseconds>(UtilTime::parse(str)), "2019-11-21T01:38:23.000Z");
 }
+TEST(UtilTimeTest, convertTimePointToFIXTime) {
+  EXPECT_EQ(UtilTime::convertTimePointToFIXTime(UtilTime::parse("2019-11-21T01:38:23.123456789Z")), "20191121-01:38:23.123");
+  EXPECT_EQ(UtilTime::convertTimePointToFIXTime(UtilTime::parse("2019-11-21T01:38:23.004Z")), "20191121-01:38:23.004");
+}
+TEST(TimestampFormatterTest, matchesTimePointToParts) {
+  TimestampFormatter timestampFormatter;
+  std::mt19937_64 gen(1);
+  std::uniform_int_distribution<int64_t> distribution(0, 4102444800LL * 1000000000LL);
+  // consecutive time points within the same second exercise the cached prefix
+  for (int i = 0; i < 10000; ++i) {
+    TimePoint tp(std::chrono::nanoseconds(i % 2 == 0 ? distribution(gen) : distribution(gen) / 1000000000 * 1000000000 + i));
+    int year, month, day, hour, minute, second, fractionalSecond;
+    UtilTime::timePointToParts<std::chrono::nanoseconds>(tp, year, month, day, hour, minute, second, fractionalSecond);
+    char expected[64];
+    std::snprintf(expected, sizeof(expected), "%04d-%02d-%02dT%02d:%02d:%02d.%09dZ", year, month, day, hour, minute, second, fractionalSecond);
+    char output[TimestampFormatter::maxLength];
+    ASSERT_EQ(std::string(output, timestampFormatter.format(tp, output)), expected);
+  }
+}
+TEST(TimestampFormatterTest, sameSecondAndRollover) {
+  TimestampFormatter timestampFormatter(TimestampFormatter::Format::FIX, 6);
+  TimePoint tp = UtilTime::parse("2019-12-31T23:59:59.999998Z");
+  std::string output;
+  timestampFormatter.format(tp, output);
+  EXPECT_EQ(output, "20191231-23:59:59.999998");
+  timestampFormatter.format(tp + std::chrono::microseconds(1), output);
+  EXPECT_EQ(output, "20191231-23:59:59.999999");
+  timestampFormatter.format(tp + std::chrono::microseconds(2), output);
+  EXPECT_EQ(output, "20200101-00:00:00.000000");
+  EXPECT_EQ(TimestampFormatter(TimestampFormatter::Format::ISO, 0).format(UtilTime::makeTimePointFromSeconds(-1)), "1969-12-31T23:59:59Z");
+}
 TEST(UtilTimeTest, convertMillisecondsStrToSecondsStr) {
   EXPECT_EQ(UtilTime::convertMillisecondsStrToSecondsStr("169782573039"), "169782573.039");
   EXPECT_EQ(UtilTime::convertMillisecondsStrToSecondsStr("169782573030"), "169782573.030");
@@ -52,6 +52,22 @@ TEST_F(ExecutionManagementServiceCoinbaseTest, signRequest) {
   EXPECT_EQ(req.base().at("CB-ACCESS-SIGN").to_string(), "QLKK5AWZ5akrAiaH5ugZzm3uRs5XnbsChlojmAs78Wk=");
 }
 
+TEST_F(ExecutionManagementServiceCoinbaseTest, signRequestWithDefaultCredential) {
+  SessionConfigs sessionConfigs;
+  sessionConfigs.setCredential(this->credential);
+  auto service = std::make_shared<ExecutionManagementServiceCoinbase>([](Event&, Queue<Event>*) {}, SessionOptions(), sessionConfigs, &this->serviceContext);
+  const auto& apiSecret = this->credential.at(CCAPI_COINBASE_API_SECRET);
+  EXPECT_EQ(&service->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret, true), &service->hmacKeyDefault);
+  EXPECT_EQ(&this->service->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret, true), &this->service->getHmacKey(Hmac::ShaVersion::SHA256, apiSecret, true));
+  http::request<http::string_body> req;
+  req.set("CB-ACCESS-TIMESTAMP", "1610075590");
+  req.method(http::verb::post);
+  req.target("/orders");
+  std::string body("{\"size\": \"1.0\", \"price\": \"1.0\", \"side\": \"buy\", \"product_id\": \"BTC-USD\"}");
+  service->signRequest(req, body, service->credentialDefault);
+  EXPECT_EQ(req.base().at("CB-ACCESS-SIGN").to_string(), "QLKK5AWZ5akrAiaH5ugZzm3uRs5XnbsChlojmAs78Wk=");
+}
+
 TEST_F(ExecutionManagementServiceCoinbaseTest, convertRequestCreateOrder) {
   Request request(Request::Operation::CREATE_ORDER, CCAPI_EXCHANGE_NAME_COINBASE, "BTC-USD", "foo", this->credential);
   std::map<std::string, std::string> param{
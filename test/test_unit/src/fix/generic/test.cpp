@@ -0,0 +1,251 @@
+#ifdef CCAPI_ENABLE_SERVICE_FIX
+#include "ccapi_cpp/ccapi_test_fix_helper.h"
+#include "gtest/gtest.h"
+namespace ccapi {
+class TestFixHandler : public FixHandler {
+ public:
+  void onFixReport(const FixReport& fixReport) override {
+    this->msgTypeList.push_back(fixReport.msgType);
+    this->clOrdIdList.emplace_back(fixReport.clOrdId);
+  }
+  std::vector<char> msgTypeList;
+  std::vector<std::string> clOrdIdList;
+};
+class FixServiceTest : public ::testing::Test {
+ public:
+  void SetUp() override { this->createService(SessionOptions()); }
+  void TearDown() override { std::remove(this->fixJournalFilePath.c_str()); }
+  void createService(const SessionOptions& sessionOptions) {
+    this->eventList.clear();
+    this->service = std::make_shared<FixServiceGeneric>([this](Event& event, Queue<Event>*) { this->eventList.push_back(event); }, sessionOptions,
+                                                        SessionConfigs(), &this->serviceContext);
+    this->fixConnectionPtr = this->createConnection();
+  }
+  // The connection id is the subscription's correlation id.
+  std::shared_ptr<FixConnection<beast::tcp_stream> > createConnection(const std::string& correlationId = "1") {
+    auto streamPtr = std::make_shared<beast::tcp_stream>(*this->serviceContext.ioContextPtr);
+    auto fixConnectionPtr =
+        std::make_shared<FixConnection<beast::tcp_stream> >("localhost", "443", Subscription("generic", "", CCAPI_FIX, "", correlationId), streamPtr);
+    fixConnectionPtr->status = FixConnection<beast::tcp_stream>::Status::OPEN;
+    this->service->isLogonResponseReceivedByConnectionIdMap[fixConnectionPtr->id] = true;
+    return fixConnectionPtr;
+  }
+  // Creates the service with a FIX journal in a fresh file and logs on.
+  void createServiceWithFixJournal() {
+    std::remove(this->fixJournalFilePath.c_str());
+    SessionOptions sessionOptions;
+    sessionOptions.fixJournalDirectory = ::testing::TempDir();
+    this->createService(sessionOptions);
+    this->service->start(this->fixConnectionPtr, UtilTime::now());
+  }
+  // Returns the messages written to the connection's write buffer from offset begin on, each as a map from tag to value.
+  std::vector<std::map<int, std::string> > getWrittenMessageList(std::shared_ptr<FixConnection<beast::tcp_stream> > fixConnectionPtr, size_t begin = 0) {
+    const auto& writeMessageBuffer = this->service->writeMessageBufferByConnectionIdMap[fixConnectionPtr->id];
+    size_t writeMessageBufferWrittenLength = this->service->writeMessageBufferWrittenLengthByConnectionIdMap[fixConnectionPtr->id];
+    std::vector<std::map<int, std::string> > output;
+    for (hff::message_reader reader(writeMessageBuffer.data() + begin, writeMessageBuffer.data() + writeMessageBufferWrittenLength); reader.is_complete();
+         reader = reader.next_message_reader()) {
+      EXPECT_TRUE(reader.is_valid());
+      std::map<int, std::string> message;
+      for (auto it = reader.message_type(); it != reader.end(); ++it) {
+        message[it->tag()] = it->value().as_string();
+      }
+      output.push_back(message);
+    }
+    return output;
+  }
+  // Delivers data to the service as if it had been received by one read.
+  void read(const std::string& data) {
+    auto& readMessageBuffer = this->service->readMessageBufferByConnectionIdMap[this->fixConnectionPtr->id];
+    auto readMessageBufferReadLength = this->service->readMessageBufferReadLengthByConnectionIdMap[this->fixConnectionPtr->id];
+    std::memcpy(readMessageBuffer.data() + readMessageBufferReadLength, data.data(), data.size());
+    // onRead_3 starts the next read, and the io context isn't run, so every read needs a stream without a pending read
+    this->fixConnectionPtr->streamPtr = std::make_shared<beast::tcp_stream>(*this->serviceContext.ioContextPtr);
+    this->service->onRead_3(this->fixConnectionPtr, boost::system::error_code(), data.size());
+  }
+  static std::string createExecutionReport(int msgSeqNum, const std::string& clOrdId) {
+    return createFixMessage("35=8|49=target|56=sender|34=" + std::to_string(msgSeqNum) + "|52=20211228-07:56:31.125|37=73797746498585286|11=" + clOrdId +
+                            "|17=73797746498585288|150=F|39=1|55=BTCUSD|54=1|44=50000.00|38=0.2|31=50000.00|32=0.1|151=0.1|14=0.1|6=50000.00"
+                            "|60=20211228-07:56:31.124|");
+  }
+  static std::string createResendRequest(int msgSeqNum, int beginSeqNo, int endSeqNo) {
+    return createFixMessage("35=2|49=target|56=sender|34=" + std::to_string(msgSeqNum) + "|52=20211228-07:56:31.125|7=" + std::to_string(beginSeqNo) +
+                            "|16=" + std::to_string(endSeqNo) + "|");
+  }
+  std::string fixJournalFilePath{::testing::TempDir() + "/generic__target.journal"};
+  ServiceContext serviceContext;
+  std::shared_ptr<FixServiceGeneric> service{nullptr};
+  std::shared_ptr<FixConnection<beast::tcp_stream> > fixConnectionPtr{nullptr};
+  std::vector<Event> eventList;
+};
+TEST_F(FixServiceTest, decodeFixReportExecutionReport) {
+  std::string data = createExecutionReport(5, "my-order-1");
+  hff::message_reader reader(data.data(), data.data() + data.size());
+  ASSERT_TRUE(reader.is_valid());
+  FixReport fixReport;
+  FixServiceGeneric::decodeFixReport(reader, fixReport);
+  EXPECT_EQ(fixReport.msgType, '8');
+  EXPECT_EQ(fixReport.msgSeqNum, 5);
+  EXPECT_EQ(fixReport.sendingTime, "20211228-07:56:31.125");
+  EXPECT_EQ(fixReport.clOrdId, "my-order-1");
+  EXPECT_TRUE(fixReport.origClOrdId.empty());
+  EXPECT_EQ(fixReport.orderId, "73797746498585286");
+  EXPECT_EQ(fixReport.execId, "73797746498585288");
+  EXPECT_EQ(fixReport.execType, 'F');
+  EXPECT_EQ(fixReport.ordStatus, '1');
+  EXPECT_EQ(fixReport.symbol, "BTCUSD");
+  EXPECT_EQ(fixReport.side, '1');
+  EXPECT_EQ(fixReport.price, "50000.00");
+  EXPECT_EQ(fixReport.orderQty, "0.2");
+  EXPECT_EQ(fixReport.lastPx, "50000.00");
+  EXPECT_EQ(fixReport.lastQty, "0.1");
+  EXPECT_EQ(fixReport.leavesQty, "0.1");
+  EXPECT_EQ(fixReport.cumQty, "0.1");
+  EXPECT_EQ(fixReport.avgPx, "50000.00");
+  EXPECT_EQ(fixReport.transactTime, "20211228-07:56:31.124");
+  EXPECT_TRUE(fixReport.rejectReason.empty());
+  EXPECT_EQ(fixReport.refSeqNum, 0);
+  EXPECT_GE(fixReport.clOrdId.data(), data.data());
+  EXPECT_LT(fixReport.clOrdId.data(), data.data() + data.size());
+}
+TEST_F(FixServiceTest, decodeFixReportOrderCancelReject) {
+  std::string data =
+      createFixMessage("35=9|49=target|56=sender|34=6|52=20211228-07:56:32.000|37=NONE|11=my-order-2|41=my-order-1|39=8|434=1|102=1|58=unknown|");
+  hff::message_reader reader(data.data(), data.data() + data.size());
+  FixReport fixReport;
+  FixServiceGeneric::decodeFixReport(reader, fixReport);
+  EXPECT_EQ(fixReport.msgType, '9');
+  EXPECT_EQ(fixReport.clOrdId, "my-order-2");
+  EXPECT_EQ(fixReport.origClOrdId, "my-order-1");
+  EXPECT_EQ(fixReport.ordStatus, '8');
+  EXPECT_EQ(fixReport.rejectReason, "1");
+  EXPECT_EQ(fixReport.text, "unknown");
+  EXPECT_EQ(fixReport.execType, '\0');
+}
+TEST_F(FixServiceTest, readBatchingEmitsOneEventPerRead) {
+  SessionOptions sessionOptions;
+  sessionOptions.enableFixReadBatching = true;
+  this->createService(sessionOptions);
+  this->read(createExecutionReport(1, "a") + createFixMessage("35=0|49=target|56=sender|34=2|52=20211228-07:56:31.125|") + createExecutionReport(3, "b"));
+  ASSERT_EQ(this->eventList.size(), 1);
+  EXPECT_EQ(this->eventList.at(0).getType(), Event::Type::FIX);
+  const auto& messageList = this->eventList.at(0).getMessageList();
+  ASSERT_EQ(messageList.size(), 2);
+  EXPECT_EQ(messageList.at(0).getElementList().at(0).getValue(hff::tag::ClOrdID), "a");
+  EXPECT_EQ(messageList.at(1).getElementList().at(0).getValue(hff::tag::ClOrdID), "b");
+  EXPECT_EQ(messageList.at(1).getCorrelationIdList(), std::vector<std::string>{"1"});
+  this->eventList.clear();
+  std::string invalidMessage = createFixMessage("35=8|49=target|56=sender|34=5|52=20211228-07:56:31.125|");
+  invalidMessage[invalidMessage.size() - 2] ^= 1;
+  this->read(createExecutionReport(4, "c") + invalidMessage + createExecutionReport(6, "d"));
+  ASSERT_EQ(this->eventList.size(), 3);
+  EXPECT_EQ(this->eventList.at(0).getMessageList().at(0).getElementList().at(0).getValue(hff::tag::ClOrdID), "c");
+  EXPECT_EQ(this->eventList.at(1).getType(), Event::Type::FIX_STATUS);
+  EXPECT_EQ(this->eventList.at(1).getMessageList().at(0).getType(), Message::Type::GENERIC_ERROR);
+  EXPECT_EQ(this->eventList.at(2).getMessageList().at(0).getElementList().at(0).getValue(hff::tag::ClOrdID), "d");
+}
+TEST_F(FixServiceTest, readWithoutBatchingEmitsOneEventPerMessage) {
+  this->read(createExecutionReport(1, "a") + createExecutionReport(2, "b"));
+  ASSERT_EQ(this->eventList.size(), 2);
+  EXPECT_EQ(this->eventList.at(0).getMessageList().size(), 1);
+  EXPECT_EQ(this->eventList.at(1).getMessageList().at(0).getElementList().at(0).getValue(hff::tag::ClOrdID), "b");
+}
+TEST_F(FixServiceTest, fixHandlerSkipsEventsOnlyIfRequested) {
+  SessionOptions sessionOptions;
+  sessionOptions.enableFixReadBatching = true;
+  this->createService(sessionOptions);
+  TestFixHandler fixHandler;
+  this->service->setFixHandler(&fixHandler, false);
+  this->read(createExecutionReport(1, "a") + createExecutionReport(2, "b"));
+  EXPECT_EQ(fixHandler.clOrdIdList, std::vector<std::string>({"a", "b"}));
+  ASSERT_EQ(this->eventList.size(), 1);
+  EXPECT_EQ(this->eventList.at(0).getMessageList().size(), 2);
+  this->eventList.clear();
+  this->service->setFixHandler(&fixHandler, true);
+  this->read(createExecutionReport(3, "c"));
+  EXPECT_EQ(fixHandler.msgTypeList, std::vector<char>({'8', '8', '8'}));
+  EXPECT_TRUE(this->eventList.empty());
+}
+TEST_F(FixServiceTest, resendRequestResendsApplicationMessagesAndGapFillsTheRest) {
+  this->createServiceWithFixJournal();
+  auto nowFixTimeStr = UtilTime::convertTimePointToFIXTime(UtilTime::now());
+  this->service->writeMessage(this->fixConnectionPtr, nowFixTimeStr,
+                              {{{hff::tag::MsgType, "D"}, {hff::tag::ClOrdID, "a"}},
+                               {{hff::tag::MsgType, "0"}},
+                               {{hff::tag::MsgType, "D"}, {hff::tag::ClOrdID, "b"}},
+                               {{hff::tag::MsgType, "0"}}});
+  size_t writeMessageBufferWrittenLength = this->service->writeMessageBufferWrittenLengthByConnectionIdMap[this->fixConnectionPtr->id];
+  this->read(createResendRequest(1, 1, 0));
+  auto messageList = this->getWrittenMessageList(this->fixConnectionPtr, writeMessageBufferWrittenLength);
+  ASSERT_EQ(messageList.size(), 5);
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgType), "4");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgSeqNum), "1");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::GapFillFlag), "Y");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::NewSeqNo), "2");
+  EXPECT_EQ(messageList.at(1).at(hff::tag::MsgType), "D");
+  EXPECT_EQ(messageList.at(1).at(hff::tag::MsgSeqNum), "2");
+  EXPECT_EQ(messageList.at(1).at(hff::tag::ClOrdID), "a");
+  EXPECT_EQ(messageList.at(1).at(hff::tag::PossDupFlag), "Y");
+  EXPECT_EQ(messageList.at(1).count(hff::tag::OrigSendingTime), 1);
+  EXPECT_EQ(messageList.at(2).at(hff::tag::MsgType), "4");
+  EXPECT_EQ(messageList.at(2).at(hff::tag::MsgSeqNum), "3");
+  EXPECT_EQ(messageList.at(2).at(hff::tag::NewSeqNo), "4");
+  EXPECT_EQ(messageList.at(3).at(hff::tag::ClOrdID), "b");
+  EXPECT_EQ(messageList.at(3).at(hff::tag::MsgSeqNum), "4");
+  EXPECT_EQ(messageList.at(4).at(hff::tag::MsgSeqNum), "5");
+  EXPECT_EQ(messageList.at(4).at(hff::tag::NewSeqNo), "6");
+  EXPECT_EQ(this->service->sequenceSentByConnectionIdMap[this->fixConnectionPtr->id], 5);
+  writeMessageBufferWrittenLength = this->service->writeMessageBufferWrittenLengthByConnectionIdMap[this->fixConnectionPtr->id];
+  this->read(createResendRequest(2, 5, 5));
+  messageList = this->getWrittenMessageList(this->fixConnectionPtr, writeMessageBufferWrittenLength);
+  ASSERT_EQ(messageList.size(), 1);
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgSeqNum), "5");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::NewSeqNo), "6");
+  EXPECT_EQ(this->service->sequenceSentByConnectionIdMap[this->fixConnectionPtr->id], 5);
+}
+TEST_F(FixServiceTest, resendRequestStopsWhereTheWriteBufferIsFull) {
+  this->createServiceWithFixJournal();
+  auto nowFixTimeStr = UtilTime::convertTimePointToFIXTime(UtilTime::now());
+  this->service->writeMessage(this->fixConnectionPtr, nowFixTimeStr, {{{hff::tag::MsgType, "D"}, {hff::tag::ClOrdID, "a"}}});
+  size_t writeMessageBufferSize = this->service->writeMessageBufferByConnectionIdMap[this->fixConnectionPtr->id].size();
+  auto& writeMessageBufferWrittenLength = this->service->writeMessageBufferWrittenLengthByConnectionIdMap[this->fixConnectionPtr->id];
+  size_t gapFillNumBytesMax = this->service->getGapFillNumBytesMax(this->fixConnectionPtr->id, nowFixTimeStr);
+  // room for the gap fill of the logon, but not for the order
+  writeMessageBufferWrittenLength = writeMessageBufferSize - gapFillNumBytesMax - 1;
+  size_t begin = writeMessageBufferWrittenLength;
+  this->read(createResendRequest(1, 1, 0));
+  auto messageList = this->getWrittenMessageList(this->fixConnectionPtr, begin);
+  ASSERT_EQ(messageList.size(), 1);
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgType), "4");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgSeqNum), "1");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::NewSeqNo), "2");
+  EXPECT_LE(writeMessageBufferWrittenLength, writeMessageBufferSize);
+  writeMessageBufferWrittenLength = writeMessageBufferSize - gapFillNumBytesMax + 1;
+  begin = writeMessageBufferWrittenLength;
+  this->read(createResendRequest(2, 1, 0));
+  EXPECT_EQ(writeMessageBufferWrittenLength, begin);
+  EXPECT_EQ(this->service->sequenceSentByConnectionIdMap[this->fixConnectionPtr->id], 2);
+}
+TEST_F(FixServiceTest, logonResumesTheFixJournalUnlessItResetsSequenceNumbers) {
+  this->createServiceWithFixJournal();
+  auto nowFixTimeStr = UtilTime::convertTimePointToFIXTime(UtilTime::now());
+  this->service->writeMessage(this->fixConnectionPtr, nowFixTimeStr, {{{hff::tag::MsgType, "D"}, {hff::tag::ClOrdID, "a"}}});
+  auto fixConnectionPtr = this->createConnection("2");
+  this->service->start(fixConnectionPtr, UtilTime::now());
+  auto messageList = this->getWrittenMessageList(fixConnectionPtr);
+  ASSERT_EQ(messageList.size(), 1);
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgType), "A");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgSeqNum), "3");
+  // the reset is decided by the logon as it is sent, not only by the subscription's logon options
+  this->service->resetSeqNumOnLogon = true;
+  fixConnectionPtr = this->createConnection("3");
+  this->service->start(fixConnectionPtr, UtilTime::now());
+  messageList = this->getWrittenMessageList(fixConnectionPtr);
+  ASSERT_EQ(messageList.size(), 1);
+  EXPECT_EQ(messageList.at(0).at(hff::tag::ResetSeqNumFlag), "Y");
+  EXPECT_EQ(messageList.at(0).at(hff::tag::MsgSeqNum), "1");
+  EXPECT_EQ(this->service->sequenceSentByConnectionIdMap[fixConnectionPtr->id], 1);
+  EXPECT_EQ(this->service->fixJournalByConnectionIdMap[fixConnectionPtr->id]->getLastSequenceSent(), 1);
+}
+} /* namespace ccapi */
+#endif
@@ -1,56 +1,635 @@
 #ifdef CCAPI_ENABLE_SERVICE_MARKET_DATA
+#include "ccapi_cpp/ccapi_session.h"
 #include "ccapi_cpp/ccapi_test_market_data_helper.h"
 #include "ccapi_cpp/service/ccapi_market_data_service.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
-using ::testing::ElementsAre;
-using ::testing::Pair;
 namespace ccapi {
 class MarketDataServiceTest : public ::testing::Test {
  public:
   typedef Service::ServiceContextPtr ServiceContextPtr;
   void SetUp() override {
     this->service = std::make_shared<MarketDataServiceGeneric>([](Event&, Queue<Event>*) {}, SessionOptions(), SessionConfigs(), &this->serviceContext);
+    this->wsConnectionPtr = std::make_shared<WsConnection>();
+    this->wsConnectionPtr->id = "1";
+  }
+  // Registers a subscription of correlationId to channelId and symbolId, which the exchange calls exchangeSubscriptionId, on wsConnection the way a
+  // subscription response does. A positive depthMax subscribes to the market depth with that many levels, otherwise the subscription is to trades.
+  static void subscribe(MarketDataService& service, const WsConnection& wsConnection, const std::string& channelId, const std::string& symbolId, int depthMax,
+                        const std::string& exchangeSubscriptionId = "a", const std::string& correlationId = "x") {
+    service.channelIdSymbolIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id][exchangeSubscriptionId] = {{CCAPI_CHANNEL_ID, channelId},
+                                                                                                                   {CCAPI_SYMBOL_ID, symbolId}};
+    std::map<std::string, std::string> optionMap = {{CCAPI_CONFLATE_INTERVAL_MILLISECONDS, CCAPI_CONFLATE_INTERVAL_MILLISECONDS_DEFAULT},
+                                                    {CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS, CCAPI_CONFLATE_GRACE_PERIOD_MILLISECONDS_DEFAULT}};
+    if (depthMax > 0) {
+      optionMap[CCAPI_MARKET_DEPTH_MAX] = std::to_string(depthMax);
+      optionMap[CCAPI_MARKET_DEPTH_RETURN_UPDATE] = CCAPI_MARKET_DEPTH_RETURN_UPDATE_ENABLE;
+      optionMap[CCAPI_FETCH_MARKET_DEPTH_INITIAL_SNAPSHOT_DELAY_MILLISECONDS] = "60000";
+    }
+    service.fieldByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = depthMax > 0 ? CCAPI_MARKET_DEPTH : CCAPI_TRADE;
+    service.optionMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = optionMap;
+    service.correlationIdListByConnectionIdChannelIdSymbolIdMap[wsConnection.id][channelId][symbolId] = {correlationId};
+  }
+  // Subscribes on the fixture's connection and returns it.
+  std::shared_ptr<WsConnection> subscribe(const std::string& channelId, const std::string& symbolId, int depthMax,
+                                          const std::string& exchangeSubscriptionId = "a", const std::string& correlationId = "x") {
+    subscribe(*this->service, *this->wsConnectionPtr, channelId, symbolId, depthMax, exchangeSubscriptionId, correlationId);
+    return this->wsConnectionPtr;
   }
   ServiceContext serviceContext;
   std::shared_ptr<MarketDataServiceGeneric> service{nullptr};
+  std::shared_ptr<WsConnection> wsConnectionPtr{nullptr};
 };
 
 TEST_F(MarketDataServiceTest, updateOrderBookInsert) {
-  std::map<Decimal, std::string> snapshot;
-  Decimal p("1");
-  auto pc = p;
-  std::string s("2");
-  auto sc = s;
-  this->service->updateOrderBook(snapshot, p, s);
-  EXPECT_THAT(snapshot, ElementsAre(Pair(pc, sc)));
+  OrderBook orderBook;
+  this->service->updateOrderBook(orderBook, true, "1", "2");
+  ASSERT_EQ(orderBook.getBids().size(), 1);
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().back()), "1");
+  EXPECT_EQ(OrderBook::sizeToString(orderBook.getBids().back()), "2");
+  EXPECT_TRUE(orderBook.getAsks().empty());
 }
 TEST_F(MarketDataServiceTest, updateOrderBookUpdate) {
-  std::map<Decimal, std::string> snapshot{
-      {Decimal("1"), std::string("2")},
-  };
-  Decimal p("1");
-  auto pc = p;
-  std::string s("3");
-  auto sc = s;
-  this->service->updateOrderBook(snapshot, p, s);
-  EXPECT_THAT(snapshot, ElementsAre(Pair(pc, sc)));
+  OrderBook orderBook;
+  orderBook.update(true, "1", "2");
+  this->service->updateOrderBook(orderBook, true, "1", "3");
+  ASSERT_EQ(orderBook.getBids().size(), 1);
+  EXPECT_EQ(orderBook.priceToString(orderBook.getBids().back()), "1");
+  EXPECT_EQ(OrderBook::sizeToString(orderBook.getBids().back()), "3");
 }
 TEST_F(MarketDataServiceTest, updateOrderBookDelete) {
-  std::map<Decimal, std::string> snapshot{
-      {Decimal("1"), std::string("2")},
-  };
-  Decimal price("1");
-  std::string size("0");
-  this->service->updateOrderBook(snapshot, price, size);
-  EXPECT_TRUE(snapshot.empty());
+  OrderBook orderBook;
+  orderBook.update(true, "1", "2");
+  this->service->updateOrderBook(orderBook, true, "1", "0");
+  EXPECT_TRUE(orderBook.empty());
 }
 TEST_F(MarketDataServiceTest, updateOrderBookNoInsert) {
-  std::map<Decimal, std::string> snapshot;
-  Decimal price("1");
-  std::string size("0");
-  this->service->updateOrderBook(snapshot, price, size);
-  EXPECT_TRUE(snapshot.empty());
+  OrderBook orderBook;
+  this->service->updateOrderBook(orderBook, true, "1", "0");
+  EXPECT_TRUE(orderBook.empty());
+}
+TEST_F(MarketDataServiceTest, calculateMarketDepthUpdate) {
+  OrderBook orderBookPrevious;
+  orderBookPrevious.update(true, "1", "1");
+  orderBookPrevious.update(true, "2", "1");
+  orderBookPrevious.update(false, "3", "1");
+  OrderBook orderBook;
+  orderBook.update(true, "1", "2");
+  orderBook.update(true, "1.5", "1");
+  orderBook.update(false, "3", "1");
+  std::vector<Element> elementList;
+  this->service->calculateMarketDepthUpdate(true, orderBook, orderBookPrevious, 10, elementList);
+  this->service->calculateMarketDepthUpdate(false, orderBook, orderBookPrevious, 10, elementList);
+  ASSERT_EQ(elementList.size(), 3);
+  EXPECT_EQ(elementList.at(0).getValue(CCAPI_BEST_BID_N_PRICE), "1");
+  EXPECT_EQ(elementList.at(0).getValue(CCAPI_BEST_BID_N_SIZE), "2");
+  EXPECT_EQ(elementList.at(1).getValue(CCAPI_BEST_BID_N_PRICE), "1.5");
+  EXPECT_EQ(elementList.at(1).getValue(CCAPI_BEST_BID_N_SIZE), "1");
+  EXPECT_EQ(elementList.at(2).getValue(CCAPI_BEST_BID_N_PRICE), "2");
+  EXPECT_EQ(elementList.at(2).getValue(CCAPI_BEST_BID_N_SIZE), "0");
+}
+TEST_F(MarketDataServiceTest, calculateOrderBookCrc32) {
+  OrderBook orderBook;
+  EXPECT_EQ(this->service->calculateOrderBookCrc32(orderBook, 25), 0u);
+  orderBook.update(true, "1", "2");
+  orderBook.update(true, "0.5", "1");
+  orderBook.update(true, "0.25", "1");
+  orderBook.update(false, "3", "1.5");
+  std::string expected("1:2:3:1.5:0.5:1");
+  EXPECT_EQ(this->service->calculateOrderBookCrc32(orderBook, 2), UtilAlgorithm::crc(expected.begin(), expected.end()));
+  expected = "1:2:3:-1.5:0.5:1:0.25:1";
+  EXPECT_EQ(this->service->calculateOrderBookCrc32(orderBook, 25, true), UtilAlgorithm::crc(expected.begin(), expected.end()));
+}
+TEST_F(MarketDataServiceTest, processOrderBookUpdateReturnsTopNChanges) {
+  auto wsConnectionPtr = this->subscribe("depth", "btc", 2);
+  TimePoint tp = UtilTime::makeTimePointFromMilliseconds(1000);
+  std::vector<MarketDataMessage> marketDataMessageList(3);
+  for (auto& marketDataMessage : marketDataMessageList) {
+    marketDataMessage.type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+    marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
+    marketDataMessage.exchangeSubscriptionId = "a";
+    marketDataMessage.tp = tp;
+  }
+  marketDataMessageList[0].recapType = MarketDataMessage::RecapType::SOLICITED;
+  marketDataMessageList[0].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "1"}, {MarketDataMessage::DataFieldType::SIZE, "1"}},
+      {{MarketDataMessage::DataFieldType::PRICE, "2"}, {MarketDataMessage::DataFieldType::SIZE, "1"}},
+      {{MarketDataMessage::DataFieldType::PRICE, "3"}, {MarketDataMessage::DataFieldType::SIZE, "1"}}};
+  marketDataMessageList[1].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "1"}, {MarketDataMessage::DataFieldType::SIZE, "5"}}};
+  marketDataMessageList[2].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "3"}, {MarketDataMessage::DataFieldType::SIZE, "0"}},
+      {{MarketDataMessage::DataFieldType::PRICE, "2"}, {MarketDataMessage::DataFieldType::SIZE, "4"}}};
+  Event event;
+  this->service->processMarketDataMessageList(wsConnectionPtr, "", tp, event, marketDataMessageList);
+  const auto& messageList = event.getMessageList();
+  ASSERT_EQ(messageList.size(), 2);
+  EXPECT_EQ(messageList.at(0).getRecapType(), Message::RecapType::SOLICITED);
+  const auto& elementList = messageList.at(1).getElementList();
+  ASSERT_EQ(elementList.size(), 3);
+  EXPECT_EQ(elementList.at(0).getValue(CCAPI_BEST_BID_N_PRICE), "1");
+  EXPECT_EQ(elementList.at(0).getValue(CCAPI_BEST_BID_N_SIZE), "5");
+  EXPECT_EQ(elementList.at(1).getValue(CCAPI_BEST_BID_N_PRICE), "2");
+  EXPECT_EQ(elementList.at(1).getValue(CCAPI_BEST_BID_N_SIZE), "4");
+  EXPECT_EQ(elementList.at(2).getValue(CCAPI_BEST_BID_N_PRICE), "3");
+  EXPECT_EQ(elementList.at(2).getValue(CCAPI_BEST_BID_N_SIZE), "0");
+}
+TEST_F(MarketDataServiceTest, processMarketDataMessageListConsumesRecords) {
+  auto wsConnectionPtr = this->subscribe("depth", "btc", 2);
+  this->subscribe("trade", "btc", 0, "b", "y");
+  TimePoint tp = UtilTime::makeTimePointFromMilliseconds(1000);
+  MarketDataMessage::RecordList recordList;
+  recordList.push_back({MarketDataMessage::DataType::BID, "1", "1"});
+  recordList.push_back({MarketDataMessage::DataType::BID, "1.5", "1"});
+  recordList.push_back({MarketDataMessage::DataType::ASK, "3.1", "1"});
+  recordList.push_back({MarketDataMessage::DataType::BID, "1.5", "0"});
+  recordList.push_back({MarketDataMessage::DataType::BID, "1", "2"});
+  recordList.push_back({MarketDataMessage::DataType::TRADE, "3.1", "1.5", "7", true});
+  std::vector<MarketDataMessage> marketDataMessageList(3);
+  for (auto& marketDataMessage : marketDataMessageList) {
+    marketDataMessage.type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+    marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
+    marketDataMessage.exchangeSubscriptionId = "a";
+    marketDataMessage.tp = tp;
+  }
+  marketDataMessageList[0].recapType = MarketDataMessage::RecapType::SOLICITED;
+  marketDataMessageList[0].setRecords(recordList, 0);
+  marketDataMessageList[0].recordEnd = 3;
+  marketDataMessageList[1].setRecords(recordList, 3);
+  marketDataMessageList[1].recordEnd = 5;
+  marketDataMessageList[1].data[MarketDataMessage::DataType::ASK] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "4"}, {MarketDataMessage::DataFieldType::SIZE, "1"}}};
+  marketDataMessageList[2].type = MarketDataMessage::Type::MARKET_DATA_EVENTS_TRADE;
+  marketDataMessageList[2].exchangeSubscriptionId = "b";
+  marketDataMessageList[2].setRecords(recordList, 5);
+  EXPECT_TRUE(marketDataMessageList[1].hasDataType(MarketDataMessage::DataType::BID));
+  EXPECT_TRUE(marketDataMessageList[1].hasDataType(MarketDataMessage::DataType::ASK));
+  EXPECT_FALSE(marketDataMessageList[1].hasDataType(MarketDataMessage::DataType::TRADE));
+  Event event;
+  this->service->processMarketDataMessageList(wsConnectionPtr, "", tp, event, marketDataMessageList);
+  const auto& subscriptionState = this->service->getSubscriptionState(*wsConnectionPtr, "a");
+  EXPECT_EQ(subscriptionState.orderBook.toString(), "OrderBook [priceScale = 1, bid = [1:2], ask = [3.1:1, 4:1]]");
+  const auto& messageList = event.getMessageList();
+  ASSERT_EQ(messageList.size(), 3);
+  EXPECT_EQ(messageList.at(0).getRecapType(), Message::RecapType::SOLICITED);
+  const auto& elementList = messageList.at(1).getElementList();
+  ASSERT_EQ(elementList.size(), 3);
+  EXPECT_EQ(elementList.at(0).getValue(CCAPI_BEST_BID_N_PRICE), "1");
+  EXPECT_EQ(elementList.at(0).getValue(CCAPI_BEST_BID_N_SIZE), "2");
+  EXPECT_EQ(elementList.at(1).getValue(CCAPI_BEST_BID_N_PRICE), "1.5");
+  EXPECT_EQ(elementList.at(1).getValue(CCAPI_BEST_BID_N_SIZE), "0");
+  EXPECT_EQ(elementList.at(2).getValue(CCAPI_BEST_ASK_N_PRICE), "4");
+  EXPECT_EQ(elementList.at(2).getValue(CCAPI_BEST_ASK_N_SIZE), "1");
+  const auto& tradeElementList = messageList.at(2).getElementList();
+  ASSERT_EQ(tradeElementList.size(), 1);
+  EXPECT_EQ(tradeElementList.at(0).getValue(CCAPI_LAST_PRICE), "3.1");
+  EXPECT_EQ(tradeElementList.at(0).getValue(CCAPI_LAST_SIZE), "1.5");
+  EXPECT_EQ(tradeElementList.at(0).getValue(CCAPI_TRADE_ID), "7");
+  EXPECT_EQ(tradeElementList.at(0).getValue(CCAPI_IS_BUYER_MAKER), "1");
+}
+TEST_F(MarketDataServiceTest, resyncOrderBookKeepsOtherSubscriptions) {
+  std::shared_ptr<WsConnection> wsConnectionPtr;
+  for (const std::string& symbolId : {"btc", "eth"}) {
+    const std::string exchangeSubscriptionId = symbolId == "btc" ? "a" : "b";
+    wsConnectionPtr = this->subscribe("depth", symbolId, 1, exchangeSubscriptionId, symbolId);
+    auto& subscriptionState = this->service->getSubscriptionState(*wsConnectionPtr, exchangeSubscriptionId);
+    subscriptionState.orderBook.update(true, "1", "1");
+    subscriptionState.orderBook.update(false, "2", "1");
+    *subscriptionState.processedInitialSnapshot = true;
+    this->service->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnectionPtr->id][exchangeSubscriptionId] = 10;
+  }
+  this->service->shouldFetchMarketDepthInitialSnapshot = true;
+  TimePoint tp = UtilTime::makeTimePointFromMilliseconds(1000);
+  std::vector<MarketDataMessage> marketDataMessageList(2);
+  for (auto& marketDataMessage : marketDataMessageList) {
+    marketDataMessage.type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+    marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
+    marketDataMessage.tp = tp;
+  }
+  marketDataMessageList[0].exchangeSubscriptionId = "a";
+  marketDataMessageList[0].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "3"}, {MarketDataMessage::DataFieldType::SIZE, "1"}}};
+  marketDataMessageList[1].exchangeSubscriptionId = "b";
+  marketDataMessageList[1].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "1.5"}, {MarketDataMessage::DataFieldType::SIZE, "1"}}};
+  Event event;
+  this->service->processMarketDataMessageList(wsConnectionPtr, "", tp, event, marketDataMessageList);
+  const auto& subscriptionStateA = this->service->getSubscriptionState(*wsConnectionPtr, "a");
+  EXPECT_FALSE(*subscriptionStateA.processedInitialSnapshot);
+  EXPECT_TRUE(subscriptionStateA.orderBook.empty());
+  const auto& subscriptionStateB = this->service->getSubscriptionState(*wsConnectionPtr, "b");
+  EXPECT_TRUE(*subscriptionStateB.processedInitialSnapshot);
+  EXPECT_EQ(subscriptionStateB.orderBook.priceToString(subscriptionStateB.orderBook.getBids().back()), "1.5");
+  EXPECT_FALSE(this->service->shouldProcessRemainingMessageOnClosingByConnectionIdMap.count(wsConnectionPtr->id));
+  this->service->sessionOptions.enableCheckSequence = true;
+  const auto& optionMap = this->service->optionMapByConnectionIdChannelIdSymbolIdMap[wsConnectionPtr->id]["depth"]["eth"];
+  std::vector<MarketDataMessage> bufferedMarketDataMessageList;
+  this->service->processOrderBookWithVersionId(11, *wsConnectionPtr, "depth", "eth", "b", optionMap, bufferedMarketDataMessageList, marketDataMessageList[1],
+                                               11);
+  EXPECT_EQ(bufferedMarketDataMessageList.size(), 1);
+  this->service->processOrderBookWithVersionId(14, *wsConnectionPtr, "depth", "eth", "b", optionMap, bufferedMarketDataMessageList, marketDataMessageList[1],
+                                               13);
+  EXPECT_EQ(bufferedMarketDataMessageList.size(), 1);
+  EXPECT_FALSE(*subscriptionStateB.processedInitialSnapshot);
+  EXPECT_TRUE(subscriptionStateB.orderBook.empty());
+  EXPECT_EQ(this->service->marketDataMessageDataBufferByConnectionIdExchangeSubscriptionIdVersionIdMap[wsConnectionPtr->id]["b"].count(14), 1);
+  EXPECT_EQ(this->service->fetchMarketDepthInitialSnapshotTimerByConnectionIdExchangeSubscriptionIdMap[wsConnectionPtr->id].count("b"), 1);
+}
+class MarketDataServiceRestSnapshot : public MarketDataService {
+ public:
+  MarketDataServiceRestSnapshot(std::function<void(Event&, Queue<Event>*)> eventHandler, ServiceContext* serviceContextPtr)
+      : MarketDataService(eventHandler, SessionOptions(), SessionConfigs(), serviceContextPtr) {
+    this->shouldFetchMarketDepthInitialSnapshot = true;
+  }
+  void extractOrderBookInitialVersionId(int64_t& versionId, const rj::Document& document) override { versionId = this->snapshotVersionId; }
+  void extractOrderBookInitialData(MarketDataMessage::TypeForData& input, const rj::Document& document) override { input = this->snapshotData; }
+  int64_t snapshotVersionId{};
+  MarketDataMessage::TypeForData snapshotData;
+};
+class TestMarketDataHandler : public MarketDataHandler {
+ public:
+  void onBookUpdate(const BookUpdate& bookUpdate) override { this->bookUpdateList.push_back(bookUpdate); }
+  void onTrade(const Trade& trade) override { this->tradeList.push_back(trade); }
+  std::vector<BookUpdate> bookUpdateList;
+  std::vector<Trade> tradeList;
+};
+TEST_F(MarketDataServiceTest, orderBookSnapshotIsDispatchedAndStaleSnapshotIsDiscarded) {
+  std::vector<Event> eventList;
+  auto service = std::make_shared<MarketDataServiceRestSnapshot>([&eventList](Event& event, Queue<Event>*) { eventList.push_back(event); },
+                                                                 &this->serviceContext);
+  TestMarketDataHandler marketDataHandler;
+  service->setMarketDataHandler(&marketDataHandler, false);
+  WsConnection& wsConnection = *this->wsConnectionPtr;
+  subscribe(*service, wsConnection, "depth", "btc", 10);
+  const auto& optionMap = service->optionMapByConnectionIdChannelIdSymbolIdMap[wsConnection.id]["depth"]["btc"];
+  auto& subscriptionState = service->getSubscriptionState(wsConnection, "a");
+  MarketDataMessage marketDataMessage;
+  marketDataMessage.type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+  marketDataMessage.recapType = MarketDataMessage::RecapType::NONE;
+  marketDataMessage.exchangeSubscriptionId = "a";
+  marketDataMessage.data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "1.5"}, {MarketDataMessage::DataFieldType::SIZE, "2"}}};
+  std::vector<MarketDataMessage> marketDataMessageList;
+  service->processOrderBookWithVersionId(11, wsConnection, "depth", "btc", "a", optionMap, marketDataMessageList, marketDataMessage);
+  size_t staleGeneration = subscriptionState.orderBookResyncGeneration;
+  service->resyncOrderBook(wsConnection, "a", "test");
+  eventList.clear();
+  service->snapshotVersionId = 12;
+  service->snapshotData[MarketDataMessage::DataType::BID] = {{{MarketDataMessage::DataFieldType::PRICE, "1"}, {MarketDataMessage::DataFieldType::SIZE, "1"}}};
+  service->snapshotData[MarketDataMessage::DataType::ASK] = {{{MarketDataMessage::DataFieldType::PRICE, "2"}, {MarketDataMessage::DataFieldType::SIZE, "1"}}};
+  http::response<http::string_body> res{http::status::ok, 11};
+  res.body() = "{}";
+  service->processOrderBookInitialResponse(wsConnection, "a", 60000, staleGeneration, res);
+  EXPECT_FALSE(*subscriptionState.processedInitialSnapshot);
+  EXPECT_TRUE(eventList.empty());
+  EXPECT_TRUE(marketDataHandler.bookUpdateList.empty());
+  service->processOrderBookWithVersionId(12, wsConnection, "depth", "btc", "a", optionMap, marketDataMessageList, marketDataMessage);
+  service->processOrderBookWithVersionId(13, wsConnection, "depth", "btc", "a", optionMap, marketDataMessageList, marketDataMessage);
+  service->processOrderBookInitialResponse(wsConnection, "a", 60000, subscriptionState.orderBookResyncGeneration, res);
+  EXPECT_TRUE(*subscriptionState.processedInitialSnapshot);
+  EXPECT_EQ(service->orderbookVersionIdByConnectionIdExchangeSubscriptionIdMap[wsConnection.id]["a"], 13);
+  ASSERT_EQ(subscriptionState.orderBook.getBids().size(), 2);
+  EXPECT_EQ(subscriptionState.orderBook.priceToString(subscriptionState.orderBook.getBids().back()), "1.5");
+  ASSERT_EQ(eventList.size(), 1);
+  ASSERT_EQ(eventList.at(0).getMessageList().size(), 2);
+  EXPECT_EQ(eventList.at(0).getMessageList().at(0).getRecapType(), Message::RecapType::SOLICITED);
+  EXPECT_EQ(eventList.at(0).getMessageList().at(1).getRecapType(), Message::RecapType::NONE);
+  ASSERT_EQ(marketDataHandler.bookUpdateList.size(), 3);
+  EXPECT_TRUE(marketDataHandler.bookUpdateList.at(0).isSnapshot);
+  EXPECT_TRUE(marketDataHandler.bookUpdateList.at(1).isSnapshot);
+  EXPECT_FALSE(marketDataHandler.bookUpdateList.at(2).isSnapshot);
+  EXPECT_EQ(marketDataHandler.bookUpdateList.at(2).priceTicks, 15);
+  service->resyncOrderBook(wsConnection, "a", "test");
+  eventList.clear();
+  service->processOrderBookInitialResponse(wsConnection, "a", 60000, subscriptionState.orderBookResyncGeneration, res);
+  EXPECT_TRUE(*subscriptionState.processedInitialSnapshot);
+  EXPECT_EQ(subscriptionState.orderBook.getBids().size(), 1);
+  ASSERT_EQ(eventList.size(), 1);
+  EXPECT_EQ(eventList.at(0).getMessageList().size(), 1);
+}
+TEST_F(MarketDataServiceTest, writeMessageQueuesSharedPayloads) {
+  std::vector<Event> eventList;
+  SessionOptions sessionOptions;
+  sessionOptions.websocketWriteQueueHighWaterMarkBytes = 8;
+  this->service = std::make_shared<MarketDataServiceGeneric>([&eventList](Event& event, Queue<Event>*) { eventList.push_back(event); }, sessionOptions,
+                                                             SessionConfigs(), &this->serviceContext);
+  auto wsConnectionPtr = std::make_shared<WsConnection>();
+  wsConnectionPtr->id = "1";
+  wsConnectionPtr->status = WsConnection::Status::OPEN;
+  wsConnectionPtr->streamPtr = std::make_shared<beast::websocket::stream<beast::ssl_stream<beast::tcp_stream> > >(*this->serviceContext.ioContextPtr,
+                                                                                                                  *this->serviceContext.sslContextPtr);
+  auto payloadPtr = std::make_shared<const std::string>("12345");
+  Service::ErrorCode ec;
+  this->service->send(wsConnectionPtr, payloadPtr, ec);
+  this->service->send(wsConnectionPtr, payloadPtr, ec);
+  this->service->send(wsConnectionPtr, "123", ec);
+  const auto& writeMessageQueue = this->service->writeMessageQueueByConnectionIdMap.at(wsConnectionPtr->id);
+  EXPECT_EQ(writeMessageQueue.payloadList.size(), 3);
+  EXPECT_EQ(writeMessageQueue.payloadList.at(1), payloadPtr);
+  EXPECT_EQ(writeMessageQueue.numBytes, 13);
+  ASSERT_EQ(eventList.size(), 1);
+  EXPECT_EQ(eventList.at(0).getType(), Event::Type::SESSION_STATUS);
+  const auto& message = eventList.at(0).getMessageList().at(0);
+  EXPECT_EQ(message.getType(), Message::Type::WEBSOCKET_WRITE_QUEUE_HIGH_WATER_MARK);
+  EXPECT_EQ(message.getElementList().at(0).getValue(CCAPI_WRITE_QUEUE_NUM_BYTES), "10");
+  for (size_t n : {5, 5, 3}) {
+    this->service->onWriteWs(wsConnectionPtr, Service::ErrorCode(), n);
+  }
+  EXPECT_TRUE(writeMessageQueue.payloadList.empty());
+  EXPECT_EQ(writeMessageQueue.numBytes, 0);
+  EXPECT_EQ(writeMessageQueue.peakSize, 3);
+  EXPECT_EQ(writeMessageQueue.peakNumBytes, 13);
+  EXPECT_FALSE(writeMessageQueue.isAboveHighWaterMark);
+}
+TEST_F(MarketDataServiceTest, writeMessageFailureFailsConnection) {
+  std::vector<Event> eventList;
+  this->service = std::make_shared<MarketDataServiceGeneric>([&eventList](Event& event, Queue<Event>*) { eventList.push_back(event); }, SessionOptions(),
+                                                             SessionConfigs(), &this->serviceContext);
+  auto wsConnectionPtr = std::make_shared<WsConnection>();
+  wsConnectionPtr->id = "1";
+  wsConnectionPtr->status = WsConnection::Status::OPEN;
+  wsConnectionPtr->streamPtr = std::make_shared<beast::websocket::stream<beast::ssl_stream<beast::tcp_stream> > >(*this->serviceContext.ioContextPtr,
+                                                                                                                  *this->serviceContext.sslContextPtr);
+  Service::ErrorCode ec;
+  this->service->send(wsConnectionPtr, "1", ec);
+  this->service->send(wsConnectionPtr, "2", ec);
+  this->service->onWriteWs(wsConnectionPtr, net::error::make_error_code(net::error::broken_pipe), 0);
+  EXPECT_FALSE(this->service->writeMessageQueueByConnectionIdMap.count(wsConnectionPtr->id));
+  EXPECT_EQ(wsConnectionPtr->status, WsConnection::Status::FAILED);
+  ASSERT_FALSE(eventList.empty());
+  EXPECT_EQ(eventList.at(0).getMessageList().at(0).getType(), Message::Type::GENERIC_ERROR);
+  eventList.clear();
+  this->service->onWriteWs(wsConnectionPtr, net::error::make_error_code(net::error::operation_aborted), 0);
+  EXPECT_TRUE(eventList.empty());
+}
+TEST_F(MarketDataServiceTest, textMessageWithLatencyHistogramCountsAsApplicationLevelPong) {
+  SessionOptions sessionOptions;
+  sessionOptions.enableLatencyHistogram = true;
+  this->service = std::make_shared<MarketDataServiceGeneric>([](Event&, Queue<Event>*) {}, sessionOptions, SessionConfigs(), &this->serviceContext);
+  auto wsConnectionPtr = this->subscribe("trade", "btc", 0);
+  TimePoint timeReceived = UtilTime::makeTimePointFromMilliseconds(1000);
+  this->service->onTextMessage(wsConnectionPtr, "{}", timeReceived);
+  EXPECT_EQ(this->service->getLatencyHistogram(LatencyHistogram::Stage::PROCESS_TEXT_MESSAGE)->getCount(), 1);
+  EXPECT_EQ(this->service->lastPongTpByMethodByConnectionIdMap[wsConnectionPtr->id][Service::PingPongMethod::WEBSOCKET_APPLICATION_LEVEL], timeReceived);
+}
+TEST_F(MarketDataServiceTest, httpConnectionPoolRetiresIdleConnections) {
+  SessionOptions sessionOptions;
+  sessionOptions.httpConnectionPoolMaxSize = 2;
+  sessionOptions.httpConnectionKeepAliveTimeoutSeconds = 10;
+  this->service = std::make_shared<MarketDataServiceGeneric>([](Event&, Queue<Event>*) {}, sessionOptions, SessionConfigs(), &this->serviceContext);
+  auto now = UtilTime::now();
+  auto& httpConnectionPool = this->service->httpConnectionPool[""][""];
+  std::vector<std::shared_ptr<HttpConnection> > httpConnectionPtrList;
+  for (int i = 0; i < 3; ++i) {
+    auto streamPtr = std::make_shared<beast::ssl_stream<beast::tcp_stream> >(*this->serviceContext.ioContextPtr, *this->serviceContext.sslContextPtr);
+    httpConnectionPtrList.push_back(std::make_shared<HttpConnection>("a", "443", streamPtr));
+    httpConnectionPtrList.back()->lastReceiveDataTp = now - std::chrono::seconds(9 - i);
+    this->service->pushHttpConnectionToPool(httpConnectionPool, httpConnectionPtrList.back());
+  }
+  ASSERT_EQ(httpConnectionPool.httpConnectionList.size(), 2);
+  EXPECT_EQ(httpConnectionPool.httpConnectionList.front(), httpConnectionPtrList.at(1));
+  httpConnectionPtrList.at(2)->lastReceiveDataTp = now;
+  this->service->httpConnectionPoolTimerPtr = std::make_shared<boost::asio::steady_timer>(*this->serviceContext.ioContextPtr);
+  this->service->maintainHttpConnectionPool();
+  ASSERT_EQ(httpConnectionPool.httpConnectionList.size(), 1);
+  EXPECT_EQ(httpConnectionPool.httpConnectionList.back(), httpConnectionPtrList.at(2));
+  EXPECT_EQ(*httpConnectionPool.numWarmingUpPtr, 0);
+  this->service->httpConnectionPoolTimerPtr->cancel();
+  Request request(Request::Operation::GET_RECENT_TRADES, "generic", "btc");
+  request.setTimeSent(now);
+  http::request<http::string_body> req;
+  this->service->tryRequest(request, req, HttpRetry(), nullptr);
+  EXPECT_TRUE(httpConnectionPool.httpConnectionList.empty());
+  EXPECT_EQ(this->service->getHttpConnectionPoolNumHits(), 1);
+  EXPECT_EQ(this->service->getHttpConnectionPoolNumMisses(), 0);
+}
+TEST_F(MarketDataServiceTest, httpConnectionPoolWarmUpIsCountedOncePerPool) {
+  SessionOptions sessionOptions;
+  sessionOptions.httpConnectionPoolMinSize = 1;
+  this->service = std::make_shared<MarketDataServiceGeneric>([](Event&, Queue<Event>*) {}, sessionOptions, SessionConfigs(), &this->serviceContext);
+  auto& httpConnectionPool = this->service->httpConnectionPool[""][""];
+  httpConnectionPool.host = "localhost";
+  httpConnectionPool.port = "443";
+  this->service->warmUpHttpConnectionPool("", "");
+  auto numWarmingUpPtr = httpConnectionPool.numWarmingUpPtr;
+  EXPECT_EQ(*numWarmingUpPtr, 1);
+  this->service->warmUpHttpConnectionPool("", "");
+  EXPECT_EQ(*numWarmingUpPtr, 1);
+  this->service->purgeHttpConnectionPool("", "");
+  auto& newHttpConnectionPool = this->service->httpConnectionPool[""][""];
+  auto streamPtr = std::make_shared<beast::ssl_stream<beast::tcp_stream> >(*this->serviceContext.ioContextPtr, *this->serviceContext.sslContextPtr);
+  this->service->onWarmUpHttpConnectionFail(std::make_shared<HttpConnection>("localhost", "443", streamPtr), numWarmingUpPtr,
+                                            net::error::make_error_code(net::error::host_not_found), "DNS resolve");
+  EXPECT_EQ(*numWarmingUpPtr, 0);
+  EXPECT_EQ(*newHttpConnectionPool.numWarmingUpPtr, 0);
+}
+TEST_F(MarketDataServiceTest, setSocketOptionsAppliesSessionOptions) {
+  SessionOptions sessionOptions;
+  sessionOptions.enableTcpNoDelay = false;
+  sessionOptions.tcpReceiveBufferSizeBytes = 1 << 16;
+  this->service = std::make_shared<MarketDataServiceGeneric>([](Event&, Queue<Event>*) {}, sessionOptions, SessionConfigs(), &this->serviceContext);
+  tcp::socket socket(*this->serviceContext.ioContextPtr);
+  socket.open(tcp::v4());
+  this->service->setSocketOptions(socket);
+  tcp::no_delay noDelay;
+  socket.get_option(noDelay);
+  EXPECT_FALSE(noDelay.value());
+  net::socket_base::receive_buffer_size receiveBufferSize;
+  socket.get_option(receiveBufferSize);
+  EXPECT_GE(receiveBufferSize.value(), 1 << 16);
+}
+TEST_F(MarketDataServiceTest, tlsSessionResumedOnReconnect) {
+  EVP_PKEY* pkey = nullptr;
+  EVP_PKEY_CTX* pkeyCtx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+  EVP_PKEY_keygen_init(pkeyCtx);
+  EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pkeyCtx, NID_X9_62_prime256v1);
+  EVP_PKEY_keygen(pkeyCtx, &pkey);
+  EVP_PKEY_CTX_free(pkeyCtx);
+  X509* x509 = X509_new();
+  ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+  X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+  X509_gmtime_adj(X509_getm_notAfter(x509), 3600);
+  X509_set_pubkey(x509, pkey);
+  X509_NAME_add_entry_by_txt(X509_get_subject_name(x509), "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(x509, X509_get_subject_name(x509));
+  X509_sign(x509, pkey, EVP_sha256());
+  ssl::context serverSslContext(ssl::context::tls_server);
+  SSL_CTX_use_certificate(serverSslContext.native_handle(), x509);
+  SSL_CTX_use_PrivateKey(serverSslContext.native_handle(), pkey);
+  X509_free(x509);
+  EVP_PKEY_free(pkey);
+  net::io_context serverIoContext;
+  tcp::acceptor acceptor(serverIoContext, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+  const auto endpoint = acceptor.local_endpoint();
+  std::thread serverThread([&acceptor, &serverIoContext, &serverSslContext]() {
+    for (int i = 0; i < 2; ++i) {
+      beast::ssl_stream<beast::tcp_stream> stream(serverIoContext, serverSslContext);
+      acceptor.accept(beast::get_lowest_layer(stream).socket());
+      stream.handshake(ssl::stream_base::server);
+      net::write(stream, net::buffer("x", 1));
+      char c;
+      beast::error_code ec;
+      stream.read_some(net::buffer(&c, 1), ec);
+    }
+  });
+  std::vector<bool> isReusedList;
+  for (int i = 0; i < 2; ++i) {
+    auto streamPtr = this->service->createStream<beast::ssl_stream<beast::tcp_stream> >(this->serviceContext.ioContextPtr, this->serviceContext.sslContextPtr,
+                                                                                         "localhost", std::to_string(endpoint.port()));
+    beast::get_lowest_layer(*streamPtr).connect(endpoint);
+    this->service->setSocketOptions(beast::get_lowest_layer(*streamPtr).socket());
+    streamPtr->handshake(ssl::stream_base::client);
+    isReusedList.push_back(SSL_session_reused(streamPtr->native_handle()) == 1);
+    char c;
+    streamPtr->read_some(net::buffer(&c, 1));
+    beast::get_lowest_layer(*streamPtr).close();
+  }
+  serverThread.join();
+  EXPECT_EQ(this->service->tlsSessionByHostPortMap.count("localhost:" + std::to_string(endpoint.port())), 1);
+  EXPECT_FALSE(isReusedList.at(0));
+  EXPECT_TRUE(isReusedList.at(1));
+}
+TEST_F(MarketDataServiceTest, tlsSessionArrivingAfterServiceIsDestroyedIsDropped) {
+  auto streamPtr = this->service->createStream<beast::ssl_stream<beast::tcp_stream> >(this->serviceContext.ioContextPtr, this->serviceContext.sslContextPtr,
+                                                                                       "localhost", "443");
+  SSL_SESSION* session = SSL_SESSION_new();
+  Service::onNewTlsSession(streamPtr->native_handle(), session);
+  EXPECT_EQ(this->service->tlsSessionByHostPortMap.count("localhost:443"), 1);
+  EXPECT_EQ(this->service->tlsSessionByHostPortMap.count("localhost:8443"), 0);
+  this->service.reset();
+  EXPECT_EQ(Service::onNewTlsSession(streamPtr->native_handle(), session), 0);
+  SSL_SESSION_free(session);
+}
+TEST_F(MarketDataServiceTest, getSubscriptionStateReusesHandle) {
+  WsConnection& wsConnection = *this->subscribe("depth", "btc", 10);
+  this->subscribe("depth", "btc", 10, "b");
+  auto& subscriptionState = this->service->getSubscriptionState(wsConnection, "a");
+  EXPECT_EQ(subscriptionState.channelId, "depth");
+  EXPECT_EQ(subscriptionState.symbolId, "btc");
+  EXPECT_EQ(*subscriptionState.field, CCAPI_MARKET_DEPTH);
+  EXPECT_EQ(subscriptionState.correlationIdList->at(0), "x");
+  EXPECT_FALSE(*subscriptionState.processedInitialSnapshot);
+  subscriptionState.orderBook.update(true, "1", "1");
+  EXPECT_EQ(&this->service->getSubscriptionState(wsConnection, "b"), &subscriptionState);
+  EXPECT_EQ(this->service->findSubscriptionState(wsConnection.id, "depth", "btc"), &subscriptionState);
+  this->service->releaseSubscriptionStates(wsConnection);
+  EXPECT_EQ(this->service->findSubscriptionState(wsConnection.id, "depth", "btc"), nullptr);
+  EXPECT_EQ(this->service->freeSubscriptionStateHandleList.size(), 1);
+  EXPECT_TRUE(this->service->getSubscriptionState(wsConnection, "a").orderBook.empty());
+  EXPECT_TRUE(this->service->freeSubscriptionStateHandleList.empty());
+}
+TEST_F(MarketDataServiceTest, marketDataHandlerSkipsEvents) {
+  auto wsConnectionPtr = this->subscribe("depth", "btc", 10);
+  TestMarketDataHandler marketDataHandler;
+  this->service->setMarketDataHandler(&marketDataHandler, true);
+  TimePoint tp = UtilTime::makeTimePointFromMilliseconds(1000);
+  TimePoint timeReceived = UtilTime::makeTimePointFromMilliseconds(1001);
+  std::vector<MarketDataMessage> marketDataMessageList(2);
+  marketDataMessageList[0].type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+  marketDataMessageList[0].recapType = MarketDataMessage::RecapType::SOLICITED;
+  marketDataMessageList[0].exchangeSubscriptionId = "a";
+  marketDataMessageList[0].tp = tp;
+  marketDataMessageList[0].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "100.5"}, {MarketDataMessage::DataFieldType::SIZE, "2"}}};
+  marketDataMessageList[0].data[MarketDataMessage::DataType::ASK] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "101"}, {MarketDataMessage::DataFieldType::SIZE, "1.25"}}};
+  marketDataMessageList[1].type = MarketDataMessage::Type::MARKET_DATA_EVENTS_MARKET_DEPTH;
+  marketDataMessageList[1].recapType = MarketDataMessage::RecapType::NONE;
+  marketDataMessageList[1].exchangeSubscriptionId = "a";
+  marketDataMessageList[1].tp = tp;
+  marketDataMessageList[1].data[MarketDataMessage::DataType::BID] = {
+      {{MarketDataMessage::DataFieldType::PRICE, "100.5"}, {MarketDataMessage::DataFieldType::SIZE, "0"}}};
+  Event event;
+  this->service->processMarketDataMessageList(wsConnectionPtr, "", timeReceived, event, marketDataMessageList);
+  EXPECT_TRUE(event.getMessageList().empty());
+  const auto& subscriptionState = this->service->getSubscriptionState(*wsConnectionPtr, "a");
+  EXPECT_TRUE(subscriptionState.orderBook.getBids().empty());
+  ASSERT_EQ(subscriptionState.orderBook.getAsks().size(), 1);
+  ASSERT_EQ(marketDataHandler.bookUpdateList.size(), 3);
+  const BookUpdate& bid = marketDataHandler.bookUpdateList.at(0);
+  EXPECT_EQ(bid.instrumentHandle, subscriptionState.handle);
+  EXPECT_EQ(bid.correlationIdList->at(0), "x");
+  EXPECT_TRUE(bid.isBid);
+  EXPECT_EQ(bid.priceTicks, 1005);
+  EXPECT_EQ(bid.priceScale, 1);
+  EXPECT_EQ(bid.sizeLots, 2);
+  EXPECT_EQ(bid.sizeScale, 0);
+  EXPECT_TRUE(bid.isSnapshot);
+  EXPECT_FALSE(bid.isLastInMessage);
+  EXPECT_EQ(bid.exchangeTs, tp);
+  EXPECT_EQ(bid.recvTs, timeReceived);
+  const BookUpdate& ask = marketDataHandler.bookUpdateList.at(1);
+  EXPECT_FALSE(ask.isBid);
+  EXPECT_EQ(ask.sizeLots, 125);
+  EXPECT_EQ(ask.sizeScale, 2);
+  EXPECT_TRUE(ask.isLastInMessage);
+  const BookUpdate& removed = marketDataHandler.bookUpdateList.at(2);
+  EXPECT_FALSE(removed.isSnapshot);
+  EXPECT_EQ(removed.sizeLots, 0);
+  EXPECT_TRUE(removed.isLastInMessage);
+  std::vector<MarketDataMessage> tradeMessageList(1);
+  tradeMessageList[0].type = MarketDataMessage::Type::MARKET_DATA_EVENTS_TRADE;
+  tradeMessageList[0].recapType = MarketDataMessage::RecapType::NONE;
+  tradeMessageList[0].exchangeSubscriptionId = "a";
+  tradeMessageList[0].tp = tp;
+  tradeMessageList[0].data[MarketDataMessage::DataType::TRADE] = {{{MarketDataMessage::DataFieldType::PRICE, "100.75"},
+                                                                    {MarketDataMessage::DataFieldType::SIZE, "0.5"},
+                                                                    {MarketDataMessage::DataFieldType::TRADE_ID, "7"},
+                                                                    {MarketDataMessage::DataFieldType::IS_BUYER_MAKER, "1"}}};
+  this->service->processMarketDataMessageList(wsConnectionPtr, "", timeReceived, event, tradeMessageList);
+  EXPECT_TRUE(event.getMessageList().empty());
+  ASSERT_EQ(marketDataHandler.tradeList.size(), 1);
+  const Trade& trade = marketDataHandler.tradeList.at(0);
+  EXPECT_EQ(trade.priceTicks, 10075);
+  EXPECT_EQ(trade.priceScale, 2);
+  EXPECT_EQ(trade.sizeLots, 5);
+  EXPECT_EQ(trade.sizeScale, 1);
+  EXPECT_TRUE(trade.isBuyerMaker);
+  EXPECT_FALSE(trade.isAggregated);
+  EXPECT_EQ(trade.tradeId, "7");
+}
+TEST(MarketDataHandlerSessionTest, batchingModeStillReceivesEvents) {
+  Session session;
+  auto service = std::make_shared<MarketDataServiceGeneric>(session.internalEventHandler, SessionOptions(), SessionConfigs(), session.serviceContextPtr);
+  session.serviceByServiceNameExchangeMap[CCAPI_MARKET_DATA]["generic"] = service;
+  TestMarketDataHandler marketDataHandler;
+  session.setMarketDataHandler(&marketDataHandler);
+  auto wsConnectionPtr = std::make_shared<WsConnection>();
+  wsConnectionPtr->id = "1";
+  MarketDataServiceTest::subscribe(*service, *wsConnectionPtr, "trade", "btc", 0);
+  std::vector<MarketDataMessage> marketDataMessageList(1);
+  marketDataMessageList[0].type = MarketDataMessage::Type::MARKET_DATA_EVENTS_TRADE;
+  marketDataMessageList[0].recapType = MarketDataMessage::RecapType::NONE;
+  marketDataMessageList[0].exchangeSubscriptionId = "a";
+  marketDataMessageList[0].tp = UtilTime::makeTimePointFromMilliseconds(1000);
+  marketDataMessageList[0].data[MarketDataMessage::DataType::TRADE] = {{{MarketDataMessage::DataFieldType::PRICE, "100.75"},
+                                                                         {MarketDataMessage::DataFieldType::SIZE, "0.5"},
+                                                                         {MarketDataMessage::DataFieldType::TRADE_ID, "7"},
+                                                                         {MarketDataMessage::DataFieldType::IS_BUYER_MAKER, "1"}}};
+  Event event;
+  service->processMarketDataMessageList(wsConnectionPtr, "", UtilTime::makeTimePointFromMilliseconds(1001), event, marketDataMessageList);
+  ASSERT_FALSE(event.getMessageList().empty());
+  service->eventHandler(event, nullptr);
+  EXPECT_EQ(marketDataHandler.tradeList.size(), 1);
+  std::vector<Event> eventList = session.getEventQueue().purge();
+  ASSERT_EQ(eventList.size(), 1);
+  ASSERT_EQ(eventList.at(0).getMessageList().size(), 1);
+  const Message& message = eventList.at(0).getMessageList().at(0);
+  EXPECT_EQ(message.getType(), Message::Type::MARKET_DATA_EVENTS_TRADE);
+  EXPECT_EQ(message.getElementList().at(0).getValue(CCAPI_LAST_PRICE), "100.75");
+  session.setMarketDataHandler(&marketDataHandler, true);
+  EXPECT_TRUE(service->skipMarketDataEvents);
+  session.stop();
+}
+TEST_F(MarketDataServiceTest, parseJsonDocumentReusesConnectionDocument) {
+  rj::Document& document = this->service->parseJsonDocument<rj::kParseNumbersAsStringsFlag>("1", "{\"a\":1.50}");
+  ASSERT_TRUE(document.IsObject());
+  EXPECT_EQ(std::string(document["a"].GetString()), "1.50");
+  std::string textMessage = "[\"b\"]garbage";
+  rj::Document& documentNext = this->service->parseJsonDocument<rj::kParseNumbersAsStringsFlag>("1", boost::beast::string_view(textMessage.data(), 5));
+  EXPECT_EQ(&documentNext, &document);
+  ASSERT_TRUE(documentNext.IsArray());
+  EXPECT_EQ(std::string(documentNext[0].GetString()), "b");
 }
 } /* namespace ccapi */
 #endif